@@ -49,6 +49,7 @@ namespace zsLib
     interaction IRemoteEventingTypes
     {
       typedef zsLib::Log::Level Level;
+      typedef std::set<uint16_t> EventIDSet;
 
       enum States
       {
@@ -68,9 +69,137 @@ namespace zsLib
       {
         Port_Default = 63311
       };
+
+      enum CPUs : uint32_t
+      {
+        CPU_Unknown = 0xFFFFFFFF
+      };
+
+      struct EventOrigin
+      {
+        uint64_t mTimestamp {};          // nanoseconds on the emitting process's monotonic clock
+        uint64_t mThreadID {};
+        uint32_t mCPU {CPU_Unknown};
+        bool mBacklog {};                // spooled by the remote party while it could not send and replayed later
+      };
+
+      enum DropReasons
+      {
+        DropReason_First,
+
+        DropReason_NotAuthorized          = DropReason_First,
+        DropReason_InvalidEvent,
+        DropReason_EventRingFull,
+        DropReason_AsyncQueueFull,
+        DropReason_OutgoingQueueFull,
+        DropReason_ProviderShareExceeded,
+        DropReason_SpoolFull,
+
+        DropReason_Last                   = DropReason_SpoolFull
+      };
+
+      //-----------------------------------------------------------------------
+      // Bucket N counts durations from 2^N up to 2^(N+1) nanoseconds (bucket
+      // 0 also counts durations under 1 nanosecond).
+      struct TimeHistogram
+      {
+        enum Buckets
+        {
+          Buckets_Total = 32
+        };
+
+        uint64_t mCount {};
+        uint64_t mTotalNanoseconds {};
+        uint64_t mBuckets[Buckets_Total] {};
+
+        TimeHistogram() {}
+        TimeHistogram(const ElementPtr &rootEl);
+
+        ElementPtr createElement(const char *objectName = NULL) const;
+      };
+
+      struct ProviderStatistics
+      {
+        uint64_t mEventsSent {};
+        uint64_t mBytesSent {};
+        uint64_t mEventsReceived {};
+        uint64_t mBytesReceived {};
+
+        ProviderStatistics() {}
+        ProviderStatistics(const ElementPtr &rootEl);
+
+        ElementPtr createElement(const char *objectName = NULL) const;
+      };
+
+      typedef String ProviderName;
+      typedef std::map<ProviderName, ProviderStatistics> ProviderStatisticsMap;
+
+      struct Statistics
+      {
+        ProviderStatisticsMap mProviders;
+
+        size_t mAsyncQueueBytes {};
+        size_t mAsyncQueueBytesHighWater {};
+        size_t mOutgoingQueueBytes {};
+        size_t mOutgoingQueueBytesHighWater {};
+
+        size_t mOutgoingSegmentPoolSegments {};   // idle outgoing segments kept for reuse
+        size_t mOutgoingSegmentPoolBytes {};
+
+        size_t mSpoolBytes {};                    // events waiting in the spool to be replayed
+        uint64_t mSpooledEvents {};
+        uint64_t mReplayedEvents {};
+
+        uint64_t mDroppedEvents[DropReason_Last + 1] {};
+
+        uint64_t mSendCalls {};
+        uint64_t mSendWouldBlockCalls {};
+        uint64_t mReceiveCalls {};
+
+        TimeHistogram mEncodeTime;       // socket thread transcoding into the wire format
+        TimeHistogram mDecodeTime;       // parsing up to delivery to the eventing listeners
+
+        Statistics() {}
+        Statistics(const ElementPtr &rootEl);
+
+        ElementPtr createElement(const char *objectName = NULL) const;
+      };
+
+      // the event frame pool is shared by every connection in the process
+      struct FramePoolStatistics
+      {
+        size_t mFrames {};                // event frames held by the pool
+        size_t mFramesInUse {};
+        size_t mBytes {};                 // frames and their control blocks
+        size_t mBytesInUse {};
+
+        FramePoolStatistics() {}
+        FramePoolStatistics(const ElementPtr &rootEl);
+
+        ElementPtr createElement(const char *objectName = NULL) const;
+      };
+
+      struct TraceProvider
+      {
+        UUID mProviderID {};
+        String mProviderName;
+        String mProviderUniqueHash;
+      };
+
+      struct TraceIndexEntry
+      {
+        uint64_t mOffset {};              // of the index record in the trace
+        uint64_t mTime {};                // nanoseconds since recording started
+        uint64_t mFrames {};              // messages recorded before the entry
+      };
+
+      typedef std::vector<TraceIndexEntry> TraceIndex;
       
       static const char *toString(States state);
-      States toState(const char *state) throw (InvalidArgument);      
+      States toState(const char *state) throw (InvalidArgument);
+
+      static const char *toString(DropReasons reason);
+      static DropReasons toDropReason(const char *reason) throw (InvalidArgument);
     };
 
     //-------------------------------------------------------------------------
@@ -89,12 +218,84 @@ namespace zsLib
                                                 const char *connectionSharedSecret
                                                 );
 
+      //-----------------------------------------------------------------------
+      // PURPOSE: Listens for remote parties to connect. Every authorized
+      //          party receives the local events independently with its own
+      //          subscriptions and subsystem levels; the connection count is
+      //          limited by the "max-listen-clients" setting.
       static IRemoteEventingPtr listenForRemote(
                                                 IRemoteEventingDelegatePtr connectionDelegate,
                                                 WORD localPort,
                                                 const char *connectionSharedSecret,
                                                 Seconds maxWaitToBindTimeInSeconds = Seconds(60)
                                                 );
+
+      //-----------------------------------------------------------------------
+      // PURPOSE: Connects to a party on the same host listening with
+      //          listenForLocal() under the same local name. The handshake
+      //          and event format are identical to a remote connection but
+      //          the data travels through shared memory instead of a socket.
+      static IRemoteEventingPtr connectToLocal(
+                                               IRemoteEventingDelegatePtr connectionDelegate,
+                                               const char *localName,
+                                               const char *connectionSharedSecret
+                                               );
+
+      //-----------------------------------------------------------------------
+      // PURPOSE: Listens for a single party on the same host to connect with
+      //          connectToLocal() using the same local name. Once the party
+      //          disconnects the name becomes available for a new party.
+      static IRemoteEventingPtr listenForLocal(
+                                               IRemoteEventingDelegatePtr connectionDelegate,
+                                               const char *localName,
+                                               const char *connectionSharedSecret
+                                               );
+
+      //-----------------------------------------------------------------------
+      // PURPOSE: Obtains the emission timestamp, thread and CPU of the remote
+      //          event currently being written to the eventing listeners on
+      //          the calling thread.
+      //          Events the remote party spooled while it could not send
+      //          them are flagged as backlog.
+      // RETURNS: false if no remote event is being delivered on this thread
+      //          or the remote party sent neither the event origin nor the
+      //          backlog flag.
+      static bool getCurrentEventOrigin(EventOrigin &outOrigin);
+
+      //-----------------------------------------------------------------------
+      // PURPOSE: Obtains a snapshot of the event frame pool shared by every
+      //          connection in the process (which is why it is not part of
+      //          any connection's statistics).
+      static FramePoolStatistics getFramePoolStatistics();
+
+      //-----------------------------------------------------------------------
+      // PURPOSE: Reads the header element and the index of a trace file
+      //          written by startRecording() held entirely in memory (e.g.
+      //          memory mapped). The index of a trace which was never
+      //          completed is rebuilt by walking its records.
+      // RETURNS: false if the data is not a trace file.
+      static bool readTraceIndex(
+                                 const BYTE *trace,
+                                 size_t traceSize,
+                                 ElementPtr &outHeaderEl,
+                                 TraceIndex &outIndex
+                                 );
+
+      //-----------------------------------------------------------------------
+      // PURPOSE: Decodes the events recorded from the index entry at the
+      //          start offset up to the end offset (exclusive) and delivers
+      //          them synchronously and in order to the delegate. The trace
+      //          is only read so separate ranges can be decoded on separate
+      //          threads at the same time.
+      // RETURNS: the number of events delivered.
+      static size_t decodeTrace(
+                                const BYTE *trace,
+                                size_t traceSize,
+                                uint64_t startOffset,
+                                uint64_t endOffset,
+                                IRemoteEventingTraceDelegate &delegate
+                                );
+
       virtual PUID getID() const = 0;
 
       virtual void shutdown() = 0;
@@ -105,6 +306,46 @@ namespace zsLib
                                   const char *remoteSubsystemName,
                                   Level level
                                   ) = 0;
+
+      //-----------------------------------------------------------------------
+      // PURPOSE: Limits the events the remote party sends for a provider to
+      //          the listed event IDs. The remote party discards every other
+      //          event of the provider before it is serialized. An empty set
+      //          removes the limit.
+      virtual void setRemoteProviderEvents(
+                                           const char *remoteProviderName,
+                                           const EventIDSet &enabledEventIDs
+                                           ) = 0;
+
+      //-----------------------------------------------------------------------
+      // PURPOSE: Obtains a snapshot of the transport counters for this side
+      //          of the connection.
+      virtual Statistics getStatistics() const = 0;
+
+      //-----------------------------------------------------------------------
+      // PURPOSE: Obtains the most recent snapshot pushed by the remote party
+      //          with its periodic notification, which the remote party
+      //          only sends with its "notify-statistics" setting enabled
+      //          (off by default).
+      // RETURNS: false if the remote party has not sent any statistics.
+      virtual bool getRemoteStatistics(Statistics &outStatistics) const = 0;
+
+      //-----------------------------------------------------------------------
+      // PURPOSE: Records every message received from the remote party into a
+      //          binary trace file (.zstrace) exactly as it arrived. Only
+      //          connections starting their handshake after this call are
+      //          recorded and they do not negotiate the compact encoding.
+      //          The optional header element is adopted into the file
+      //          header.
+      // RETURNS: false if the trace file could not be created.
+      virtual bool startRecording(
+                                  const char *path,
+                                  ElementPtr headerEl = ElementPtr()
+                                  ) = 0;
+
+      //-----------------------------------------------------------------------
+      // PURPOSE: Stops recording and completes the trace file's index.
+      virtual void stopRecording() = 0;
     };
 
     //-------------------------------------------------------------------------
@@ -152,6 +393,40 @@ namespace zsLib
                                                        size_t totalDropped
                                                        ) {}
     };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IRemoteEventingTraceDelegate
+    #pragma mark
+
+    interaction IRemoteEventingTraceDelegate
+    {
+      typedef zsLib::Log::Severity Severity;
+      typedef zsLib::Log::Level Level;
+      typedef IRemoteEventingTypes::EventOrigin EventOrigin;
+      typedef IRemoteEventingTypes::TraceProvider TraceProvider;
+
+      //-----------------------------------------------------------------------
+      // PURPOSE: Called on the decoding thread for every recorded event with
+      //          the same descriptors the eventing listeners received live.
+      //          The origin is NULL if the recorded party did not send it;
+      //          the receive time is in nanoseconds since recording started.
+      //          The provider and the data remain valid only for the call.
+      virtual void onRemoteEventingTraceEvent(
+                                              const TraceProvider &provider,
+                                              const EventOrigin *origin,
+                                              uint64_t receiveTime,
+                                              Severity severity,
+                                              Level level,
+                                              EVENT_DESCRIPTOR_HANDLE descriptor,
+                                              EVENT_PARAMETER_DESCRIPTOR_HANDLE paramDescriptor,
+                                              EVENT_DATA_DESCRIPTOR_HANDLE dataDescriptor,
+                                              size_t dataDescriptorCount
+                                              ) = 0;
+    };
   }
 }
 
@@ -42,10 +42,175 @@ either expressed or implied, of the FreeBSD Project.
 #include <zsLib/Socket.h>
 #include <zsLib/Singleton.h>
 
+#if defined(WINUWP) || defined(WINRT)
+#define ZSLIB_EVENTING_REMOTE_EVENTING_NO_LOCAL_CHANNEL
+#define ZSLIB_EVENTING_REMOTE_EVENTING_NO_SPOOL
+#endif //defined(WINUWP) || defined(WINRT)
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#endif //ndef _WIN32
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <climits>
+#endif //__linux__
+
+#ifdef __APPLE__
+#include <pthread.h>
+#endif //__APPLE__
+
+#if defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define ZSLIB_EVENTING_REMOTE_EVENTING_HAS_TSC
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define ZSLIB_EVENTING_REMOTE_EVENTING_HAS_TSC
+#endif //defined(_M_X64) || defined(_M_IX86)
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
 namespace zsLib { namespace eventing { ZS_DECLARE_SUBSYSTEM(zsLib_eventing); } }
 
 
-#define ZSLIB_EVENTING_REMOTE_EVENTING_MAX_DATA_DESCRIPTORS (80)
+#define ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_RING_WRAP_MARKER (0xFFFFFFFF)
+
+// severity, level, descriptor (id, version, channel, level, opcode, task, keyword) and data descriptor count
+#define ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_HEADER_SIZE ((sizeof(CryptoPP::word16)*5) + (sizeof(uint8_t)*4) + sizeof(uint64_t))
+
+// timestamp, thread id and cpu id
+#define ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_ORIGIN_SIZE ((sizeof(uint64_t)*2) + sizeof(uint32_t))
+#define ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_ORIGIN_VERSION "1"
+
+#define ZSLIB_EVENTING_REMOTE_EVENTING_TSC_CALIBRATION_NANOSECONDS (10*1000*1000)
+
+// percentage of a queue budget an event may fill, by severity (and by level for informational events)
+#define ZSLIB_EVENTING_REMOTE_EVENTING_LOAD_SHEDDING_WARNING_PERCENT (90)
+#define ZSLIB_EVENTING_REMOTE_EVENTING_LOAD_SHEDDING_BASIC_PERCENT (75)
+#define ZSLIB_EVENTING_REMOTE_EVENTING_LOAD_SHEDDING_DETAIL_PERCENT (60)
+#define ZSLIB_EVENTING_REMOTE_EVENTING_LOAD_SHEDDING_DEBUG_PERCENT (45)
+#define ZSLIB_EVENTING_REMOTE_EVENTING_LOAD_SHEDDING_TRACE_PERCENT (30)
+#define ZSLIB_EVENTING_REMOTE_EVENTING_LOAD_SHEDDING_INSANE_PERCENT (20)
+
+// provider shares are only enforced once the outgoing queue is this full
+#define ZSLIB_EVENTING_REMOTE_EVENTING_LOAD_SHEDDING_PRESSURE_PERCENT (50)
+
+// received events kept for reuse by each receive worker (each holds a full set of data descriptors)
+#define ZSLIB_EVENTING_REMOTE_EVENTING_RECEIVE_WORKER_MAX_FREE_EVENTS (16)
+
+#define ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_BATCH_VERSION "1"
+#define ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_BATCH_FLAG_PROVIDER (0x01)
+#define ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_BATCH_FLAG_HEADER (0x02)
+
+#define ZSLIB_EVENTING_REMOTE_EVENTING_COMPACT_EVENTS_VERSION "1"
+#define ZSLIB_EVENTING_REMOTE_EVENTING_COMPACT_RECORD_PROVIDER (0x01)
+#define ZSLIB_EVENTING_REMOTE_EVENTING_COMPACT_RECORD_DESCRIPTOR (0x02)
+#define ZSLIB_EVENTING_REMOTE_EVENTING_COMPACT_RECORD_EVENT (0x03)
+#define ZSLIB_EVENTING_REMOTE_EVENTING_COMPACT_RECORD_STRING (0x04)
+#define ZSLIB_EVENTING_REMOTE_EVENTING_COMPACT_MAX_DESCRIPTORS (256)
+
+// generated events place the subsystem name and function name as the first two string parameters
+#define ZSLIB_EVENTING_REMOTE_EVENTING_COMPACT_INTERNED_PARAMETERS (2)
+#define ZSLIB_EVENTING_REMOTE_EVENTING_COMPACT_MAX_INTERNED_STRINGS (4096)
+#define ZSLIB_EVENTING_REMOTE_EVENTING_COMPACT_MAX_INTERNED_STRING_SIZE (256)
+#define ZSLIB_EVENTING_REMOTE_EVENTING_COMPACT_INLINE_STRING (0)
+#define ZSLIB_EVENTING_REMOTE_EVENTING_MAX_VARINT_SIZE (10)
+
+#define ZSLIB_EVENTING_REMOTE_EVENTING_MAX_SEND_SEGMENTS (64)
+
+// hello, challenge, challenge reply and welcome are small documents so an
+// unauthorized party can never force a larger incoming buffer than this
+#define ZSLIB_EVENTING_REMOTE_EVENTING_MAX_HANDSHAKE_MESSAGE_SIZE (4*1024)
+
+// once authorized every frame (its size includes the message type) is bound
+// by the protocol rather than by either party's settings; neither party
+// sends anything larger so large documents always fit and a party is never
+// disconnected for a frame sized by settings the other party does not share
+#define ZSLIB_EVENTING_REMOTE_EVENTING_MAX_MESSAGE_SIZE (16*1024*1024)
+
+// event frames are pooled in power of two size classes from 64 bytes to 64KB
+#define ZSLIB_EVENTING_REMOTE_EVENTING_SLAB_SMALLEST_CLASS_SHIFT (6)
+#define ZSLIB_EVENTING_REMOTE_EVENTING_SLAB_CLASSES (11)
+#define ZSLIB_EVENTING_REMOTE_EVENTING_SLAB_THREAD_CACHE_BYTES (256*1024)
+#define ZSLIB_EVENTING_REMOTE_EVENTING_SLAB_THREAD_CACHE_MAX_BLOCKS (64)
+#define ZSLIB_EVENTING_REMOTE_EVENTING_SLAB_DEPOT_BYTES (4*1024*1024)
+
+// the provider field of trace event frames carries the dense provider index
+// announced with the provider instead of the provider handle
+#define ZSLIB_EVENTING_REMOTE_EVENTING_DENSE_PROVIDERS_VERSION "1"
+#define ZSLIB_EVENTING_REMOTE_EVENTING_MAX_DENSE_PROVIDERS (0xFFFF)
+#define ZSLIB_EVENTING_REMOTE_EVENTING_UNKNOWN_PROVIDER_INDEX (0xFFFFFFFF)
+#define ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_HEADER_CACHE_SIZE (32)
+
+// scalar parameters travel in the sender's byte order and the receiver swaps
+// them only when its byte order differs
+#define ZSLIB_EVENTING_REMOTE_EVENTING_NATIVE_BYTE_ORDER_VERSION "1"
+#define ZSLIB_EVENTING_REMOTE_EVENTING_SCALAR_FLAG (0x80000000)
+
+// events replayed from the spool are framed as single trace events of their own type
+#define ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_BACKLOG_VERSION "1"
+
+#define ZSLIB_EVENTING_REMOTE_EVENTING_SPOOL_MAGIC (0x7A735350)
+#define ZSLIB_EVENTING_REMOTE_EVENTING_SPOOL_VERSION (1)
+
+// trace file: header, records of [BE32 size (includes type)][type][payload],
+// the table of index records and a trailer locating the table
+#define ZSLIB_EVENTING_REMOTE_EVENTING_TRACE_MAGIC (0x7A735452)
+#define ZSLIB_EVENTING_REMOTE_EVENTING_TRACE_TRAILER_MAGIC (0x7A735449)
+#define ZSLIB_EVENTING_REMOTE_EVENTING_TRACE_VERSION (1)
+#define ZSLIB_EVENTING_REMOTE_EVENTING_TRACE_RECORD_FRAME (0x01)
+#define ZSLIB_EVENTING_REMOTE_EVENTING_TRACE_RECORD_CONNECTION (0x02)
+#define ZSLIB_EVENTING_REMOTE_EVENTING_TRACE_RECORD_CONNECTION_END (0x03)
+#define ZSLIB_EVENTING_REMOTE_EVENTING_TRACE_RECORD_INDEX (0x04)
+#define ZSLIB_EVENTING_REMOTE_EVENTING_TRACE_RECORD_INDEX_TABLE (0x05)
+#define ZSLIB_EVENTING_REMOTE_EVENTING_TRACE_STATE_EVENT_ORIGIN (0x01)
+#define ZSLIB_EVENTING_REMOTE_EVENTING_TRACE_STATE_DENSE_PROVIDERS (0x02)
+#define ZSLIB_EVENTING_REMOTE_EVENTING_TRACE_STATE_SWAP_INTEGERS (0x04)
+#define ZSLIB_EVENTING_REMOTE_EVENTING_TRACE_STATE_SWAP_FLOATS (0x08)
+
+#define ZSLIB_EVENTING_REMOTE_EVENTING_SESSION_TOKEN_LENGTH (32)
+#define ZSLIB_EVENTING_REMOTE_EVENTING_SESSION_RECORD_SUBSYSTEM (0x01)
+#define ZSLIB_EVENTING_REMOTE_EVENTING_SESSION_RECORD_PROVIDER (0x02)
+#define ZSLIB_EVENTING_REMOTE_EVENTING_SESSION_RECORD_PROVIDER_GONE (0x03)
+#define ZSLIB_EVENTING_REMOTE_EVENTING_SESSION_RECORD_PROVIDER_KEYWORDS (0x04)
+
+// one bit for every possible 16 bit event ID
+#define ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_ID_BITMAP_WORDS ((0xFFFF + 1) / 64)
+
+#define ZSLIB_EVENTING_REMOTE_EVENTING_LOCAL_CHANNEL_MAGIC (0x7A734C45)
+#define ZSLIB_EVENTING_REMOTE_EVENTING_LOCAL_CHANNEL_VERSION (1)
+#define ZSLIB_EVENTING_REMOTE_EVENTING_LOCAL_CHANNEL_CLAIMED (1)
+#define ZSLIB_EVENTING_REMOTE_EVENTING_LOCAL_CHANNEL_ATTACHED (2)
+#define ZSLIB_EVENTING_REMOTE_EVENTING_LOCAL_CHANNEL_CACHE_LINE (64)
+
+// without futex support an idle waiter polls its doorbell instead of sleeping on it
+#define ZSLIB_EVENTING_REMOTE_EVENTING_LOCAL_CHANNEL_WAIT_MILLISECONDS (250)
+#define ZSLIB_EVENTING_REMOTE_EVENTING_LOCAL_CHANNEL_POLL_MILLISECONDS (1)
+
+#ifdef _WIN32
+#define ZSLIB_EVENTING_REMOTE_EVENTING_LOCAL_CHANNEL_PREFIX "Local\\zsle."
+#else
+// kept short as some systems limit shared memory names to 31 characters
+#define ZSLIB_EVENTING_REMOTE_EVENTING_LOCAL_CHANNEL_PREFIX "/zsle."
+#endif //_WIN32
+
+#ifdef MSG_NOSIGNAL
+#define ZSLIB_EVENTING_REMOTE_EVENTING_SEND_FLAGS (MSG_NOSIGNAL)
+#else
+#define ZSLIB_EVENTING_REMOTE_EVENTING_SEND_FLAGS (0)
+#endif //MSG_NOSIGNAL
 
 #define ZSLIB_EVENTING_REMOTE_EVENTING_NOTIFY_SUBSYSTEM "subsystem"
 #define ZSLIB_EVENTING_REMOTE_EVENTING_NOTIFY_PROVIDER "provider"
@@ -54,6 +219,7 @@ namespace zsLib { namespace eventing { ZS_DECLARE_SUBSYSTEM(zsLib_eventing); } }
 
 #define ZSLIB_EVENTING_REMOTE_EVENTING_REQUEST_SET_SUBSYSTEM_LEVEL "setSubsystemLevel"
 #define ZSLIB_EVENTING_REMOTE_EVENTING_REQUEST_SET_EVENT_PROVIDER_LOGGING "setEventProviderLogging"
+#define ZSLIB_EVENTING_REMOTE_EVENTING_REQUEST_SET_EVENT_PROVIDER_EVENTS "setEventProviderEvents"
 
 namespace zsLib
 {
@@ -107,6 +273,29 @@ namespace zsLib
           ISettings::setUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_MAX_QUEUED_OUTGOING_DATA_BEFORED_EVENTS_DROPPED, (100*1024));
           ISettings::setUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_NOTIFY_TIMER, 5);
           ISettings::setBool(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_USE_IPV6, false);
+          ISettings::setBool(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_USE_EVENT_RINGS, false);
+          ISettings::setUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_EVENT_RING_SIZE, (256*1024));
+          ISettings::setBool(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_USE_EVENT_BATCHES, true);
+          ISettings::setUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_MAX_EVENT_BATCH_SIZE, (64*1024));
+          ISettings::setUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_OUTGOING_SEGMENT_SIZE, (64*1024));
+          ISettings::setUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_MAX_POOLED_OUTGOING_SEGMENTS, 32);
+          ISettings::setUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_INCOMING_BUFFER_SIZE, (256*1024));
+          ISettings::setBool(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_USE_COMPACT_EVENTS, true);
+          ISettings::setBool(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_USE_TSC_CLOCK, false);
+          ISettings::setBool(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_USE_SEVERITY_LOAD_SHEDDING, true);
+          ISettings::setUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_MAX_PROVIDER_SHARE_PERCENT, 50);
+          ISettings::setBool(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_NOTIFY_STATISTICS, false);
+          ISettings::setUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_MAX_LISTEN_CLIENTS, 8);
+          ISettings::setUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_LOCAL_CHANNEL_RING_SIZE, (4*1024*1024));
+          ISettings::setUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_MAX_RESUMABLE_SESSIONS, 16);
+          ISettings::setUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_RECEIVE_WORKER_THREADS, 0);
+          ISettings::setUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_MAX_RECEIVE_WORKER_QUEUED_EVENTS, 4096);
+          ISettings::setString(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_SPOOL_PATH, "");
+          ISettings::setUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_SPOOL_SIZE, (16*1024*1024));
+          ISettings::setUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_SPOOL_KEYWORDS, 0);
+          ISettings::setUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_RECORD_BUFFER_SIZE, (1024*1024));
+          ISettings::setUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_RECORD_INDEX_INTERVAL_SIZE, (8*1024*1024));
+          ISettings::setUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_RECORD_INDEX_INTERVAL_TIME, 1000);
         }
       };
 
@@ -115,801 +304,1265 @@ namespace zsLib
       {
         RemoteEventingSettingsDefaults::singleton();
       }
-      
+
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
       #pragma mark
-      #pragma mark RemoteEventing (types)
+      #pragma mark (helpers)
       #pragma mark
 
       //-----------------------------------------------------------------------
-      const char *RemoteEventing::toString(MessageTypes messageType)
+      struct EventRingThreadCache
       {
-        switch (messageType)
+        typedef std::map<PUID, RemoteEventing::EventRingPtr> EventRingMap;
+
+        ~EventRingThreadCache()
         {
-          case MessageType_Hello:           return "Hello";
-          case MessageType_Welcome:         return "Welcome";
-          case MessageType_Challenge:       return "Challenge";
-          case MessageType_ChallengeReply:  return "Challenge reply";
-          case MessageType_Goodbye:         return "Goodbye";
-          case MessageType_Notify:          return "Notify";
-          case MessageType_Request:         return "Request";
-          case MessageType_RequestAck:      return "Request ack";
-          case MessageType_TraceEvent:      return "Trace event";
+          for (auto iter = mRings.begin(); iter != mRings.end(); ++iter) {
+            auto &ring = (*iter).second;
+            ring->mThreadGone = true;
+          }
         }
-        
-        return "unknown";
-      }
-      
+
+        PUID mLastOwnerID {};
+        RemoteEventing::EventRing *mLastRing {};
+        EventRingMap mRings;
+      };
+
       //-----------------------------------------------------------------------
-      RemoteEventing::MessageTypes RemoteEventing::toMessageType(const char *messageType) throw (InvalidArgument)
+      static EventRingThreadCache &getEventRingThreadCache()
       {
-        String str(messageType);
-        for (RemoteEventing::MessageTypes index = RemoteEventing::MessageType_First; index <= RemoteEventing::MessageType_Last; index = static_cast<RemoteEventing::MessageTypes>(static_cast<std::underlying_type<RemoteEventing::MessageTypes>::type>(index) + 1)) {
-          if (0 == str.compareNoCase(RemoteEventing::toString(index))) return index;
-        }
-        
-        ZS_THROW_INVALID_ARGUMENT(String("Not a message type: ") + str);
-        return MessageType_First;
+        static thread_local EventRingThreadCache cache;
+        return cache;
       }
 
       //-----------------------------------------------------------------------
+      struct ResumeInfoCache
+      {
+        typedef std::map<String, RemoteEventing::ResumeInfoPtr> ResumeInfoMap;
+
+        Lock mLock;
+        ResumeInfoMap mResumes;   // by connection target
+      };
+
       //-----------------------------------------------------------------------
+      static ResumeInfoCache &getResumeInfoCache()
+      {
+        static ResumeInfoCache cache;
+        return cache;
+      }
+
       //-----------------------------------------------------------------------
-      //-----------------------------------------------------------------------
-      #pragma mark
-      #pragma mark RemoteEventing
-      #pragma mark
+      // Process wide pools of event frames and of the small blocks holding
+      // their shared pointer control blocks, with one free list per size
+      // class. Every thread caches a few blocks of each class so acquiring
+      // and recycling a block takes no lock; the thread caches exchange
+      // blocks with the shared depot in batches.
+      struct SlabPools
+      {
+        enum Pools
+        {
+          Pool_First,
+
+          Pool_Frames = Pool_First,   // SecureByteBlock objects owning a class sized buffer
+          Pool_Blocks,                // raw memory
+
+          Pool_Last = Pool_Blocks
+        };
+
+        struct Depot
+        {
+          Lock mLock;
+          std::vector<void *> mFree[ZSLIB_EVENTING_REMOTE_EVENTING_SLAB_CLASSES];
+        };
+
+        Depot mDepots[Pool_Last + 1];
+
+        std::atomic<size_t> mReserved[Pool_Last + 1] {};       // blocks created and not yet destroyed
+        std::atomic<size_t> mReservedBytes[Pool_Last + 1] {};
+        std::atomic<size_t> mInUse[Pool_Last + 1] {};
+        std::atomic<size_t> mInUseBytes[Pool_Last + 1] {};
+      };
 
       //-----------------------------------------------------------------------
-      RemoteEventing::RemoteEventing(
-                                     const make_private &,
-                                     IMessageQueuePtr queue,
-                                     IRemoteEventingDelegatePtr connectionDelegate,
-                                     const char *connectionSharedSecret,
-                                     const IPAddress &serverIP,
-                                     WORD listenPort,
-                                     Seconds maxWaitToBindTime
-                                     ) :
-        MessageQueueAssociator(queue),
-        mDelegate(IRemoteEventingDelegateProxy::createWeak(connectionDelegate)),
-        mMaxDataSize(static_cast<decltype(mMaxDataSize)>(ISettings::getUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_MAX_DATA_SIZE))),
-        mMaxPackedSize(static_cast<decltype(mMaxPackedSize)>(ISettings::getUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_MAX_PACKED_SIZE))),
-        mMaxOutstandingEvents(static_cast<decltype(mMaxOutstandingEvents)>(ISettings::getUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_MAX_OUTSTANDING_EVENTS))),
-        mMaxQueuedAsyncDataBeforeEventsDropped(static_cast<decltype(mMaxQueuedAsyncDataBeforeEventsDropped)>(ISettings::getUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_MAX_QUEUED_ASYNC_DATA_BEFORED_EVENTS_DROPPED))),
-        mMaxQueuedOutgoingDataBeforeEventsDropped(static_cast<decltype(mMaxQueuedOutgoingDataBeforeEventsDropped)>(ISettings::getUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_MAX_QUEUED_OUTGOING_DATA_BEFORED_EVENTS_DROPPED))),
-        mUseIPv6(ISettings::getBool(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_USE_IPV6)),
-        mServerIP(serverIP),
-        mListenPort(listenPort),
-        mSharedSecret(connectionSharedSecret),
-        mMaxWaitToBindTime(maxWaitToBindTime)
+      static SlabPools &getSlabPools()
       {
-        ZS_LOG_DETAIL(log("Created"));
+        // never destroyed as threads may still recycle blocks while the process exits
+        static SlabPools *pools = new SlabPools;
+        return *pools;
       }
 
       //-----------------------------------------------------------------------
-      RemoteEventing::~RemoteEventing()
+      static size_t getSlabClass(size_t size)
       {
-        mThisWeak.reset();
-        ZS_LOG_DETAIL(log("Destroyed"));
-        cancel();
-        
-        for (auto iter = mCleanUpProviderInfos.begin(); iter != mCleanUpProviderInfos.end(); ++iter)
-        {
-          auto info = (*iter);
-          Log::EventingAtomDataArray providerArray;
-          if (Log::getEventingWriterInfo(info->mHandle, info->mProviderID, info->mProviderName, info->mProviderHash, &providerArray)) {
-            providerArray[mEventingAtomIndex] = 0;
-          }
-          delete info;
+        size_t classSize = static_cast<size_t>(1) << ZSLIB_EVENTING_REMOTE_EVENTING_SLAB_SMALLEST_CLASS_SHIFT;
+        for (size_t slabClass = 0; slabClass < ZSLIB_EVENTING_REMOTE_EVENTING_SLAB_CLASSES; ++slabClass, classSize <<= 1) {
+          if (size <= classSize) return slabClass;
         }
-        mCleanUpProviderInfos.clear();
+        return ZSLIB_EVENTING_REMOTE_EVENTING_SLAB_CLASSES;    // too large to pool
       }
 
       //-----------------------------------------------------------------------
-      void RemoteEventing::init()
+      static size_t getSlabClassSize(size_t slabClass)
       {
-        mEventingAtomIndex = zsLib::Log::registerEventingAtom("org.zsLib.eventing.RemoteEventing");
-        IWakeDelegateProxy::create(mThisWeak.lock())->onWake();
+        return static_cast<size_t>(1) << (slabClass + ZSLIB_EVENTING_REMOTE_EVENTING_SLAB_SMALLEST_CLASS_SHIFT);
       }
 
       //-----------------------------------------------------------------------
+      static size_t getSlabThreadCacheLimit(size_t slabClass)
+      {
+        size_t limit = ZSLIB_EVENTING_REMOTE_EVENTING_SLAB_THREAD_CACHE_BYTES / getSlabClassSize(slabClass);
+        if (limit > ZSLIB_EVENTING_REMOTE_EVENTING_SLAB_THREAD_CACHE_MAX_BLOCKS) limit = ZSLIB_EVENTING_REMOTE_EVENTING_SLAB_THREAD_CACHE_MAX_BLOCKS;
+        if (limit < 2) limit = 2;
+        return limit;
+      }
+
       //-----------------------------------------------------------------------
-      //-----------------------------------------------------------------------
-      //-----------------------------------------------------------------------
-      #pragma mark
-      #pragma mark RemoteEventing => IRemoteEventing
-      #pragma mark
+      static void *createSlab(
+                              SlabPools::Pools pool,
+                              size_t slabClass
+                              )
+      {
+        auto &pools = getSlabPools();
+        size_t classSize = getSlabClassSize(slabClass);
+
+        void *block = (SlabPools::Pool_Frames == pool ? static_cast<void *>(new SecureByteBlock(classSize)) : ::operator new(classSize));
+
+        pools.mReserved[pool].fetch_add(1, std::memory_order_relaxed);
+        pools.mReservedBytes[pool].fetch_add(classSize, std::memory_order_relaxed);
+        return block;
+      }
 
       //-----------------------------------------------------------------------
-      RemoteEventingPtr RemoteEventing::connectToRemote(
-                                                        IRemoteEventingDelegatePtr connectionDelegate,
-                                                        const IPAddress &serverIP,
-                                                        const char *connectionSharedSecret
-                                                        )
+      static void destroySlab(
+                              SlabPools::Pools pool,
+                              size_t slabClass,
+                              void *block
+                              )
       {
-        auto queue = IMessageQueueManager::getMessageQueue("org.zsLib.eventing.RemoteEventing");
-        auto pThis = make_shared<RemoteEventing>(make_private{}, queue, connectionDelegate, connectionSharedSecret, serverIP, static_cast<WORD>(0), Seconds());
-        pThis->mThisWeak = pThis;
-        pThis->init();
-        return pThis;
+        auto &pools = getSlabPools();
+
+        if (SlabPools::Pool_Frames == pool) {
+          delete static_cast<SecureByteBlock *>(block);
+        } else {
+          ::operator delete(block);
+        }
+
+        pools.mReserved[pool].fetch_sub(1, std::memory_order_relaxed);
+        pools.mReservedBytes[pool].fetch_sub(getSlabClassSize(slabClass), std::memory_order_relaxed);
       }
 
       //-----------------------------------------------------------------------
-      RemoteEventingPtr RemoteEventing::listenForRemote(
-                                                        IRemoteEventingDelegatePtr connectionDelegate,
-                                                        WORD localPort,
-                                                        const char *connectionSharedSecret,
-                                                        Seconds maxWaitToBindTimeInSeconds
-                                                        )
+      static void returnSlabsToDepot(
+                                     SlabPools::Pools pool,
+                                     size_t slabClass,
+                                     std::vector<void *> &ioBlocks,
+                                     size_t keepTotal
+                                     )
       {
-        auto queue = IMessageQueueManager::getMessageQueue("org.zsLib.eventing.RemoteEventing");
-        auto pThis = make_shared<RemoteEventing>(make_private{}, queue, connectionDelegate, connectionSharedSecret, IPAddress(), localPort, maxWaitToBindTimeInSeconds);
-        pThis->mThisWeak = pThis;
-        pThis->init();
-        return pThis;
+        auto &depot = getSlabPools().mDepots[pool];
+        size_t maxDepotBlocks = ZSLIB_EVENTING_REMOTE_EVENTING_SLAB_DEPOT_BYTES / getSlabClassSize(slabClass);
+
+        AutoLock lock(depot.mLock);
+        auto &depotFree = depot.mFree[slabClass];
+        while (ioBlocks.size() > keepTotal) {
+          void *block = ioBlocks.back();
+          ioBlocks.pop_back();
+          if (depotFree.size() >= maxDepotBlocks) {
+            destroySlab(pool, slabClass, block);
+            continue;
+          }
+          depotFree.push_back(block);
+        }
       }
-      
+
       //-----------------------------------------------------------------------
-      void RemoteEventing::shutdown()
+      struct SlabThreadCache
       {
-        ZS_LOG_DEBUG(log("shutdown called"));
+        ~SlabThreadCache()
+        {
+          for (size_t pool = SlabPools::Pool_First; pool <= SlabPools::Pool_Last; ++pool) {
+            for (size_t slabClass = 0; slabClass < ZSLIB_EVENTING_REMOTE_EVENTING_SLAB_CLASSES; ++slabClass) {
+              returnSlabsToDepot(static_cast<SlabPools::Pools>(pool), slabClass, mFree[pool][slabClass], 0);
+            }
+          }
+        }
 
-        AutoRecursiveLock lock(mLock);
-        cancel();
+        std::vector<void *> mFree[SlabPools::Pool_Last + 1][ZSLIB_EVENTING_REMOTE_EVENTING_SLAB_CLASSES];
+      };
+
+      //-----------------------------------------------------------------------
+      static SlabThreadCache &getSlabThreadCache()
+      {
+        static thread_local SlabThreadCache cache;
+        return cache;
       }
 
       //-----------------------------------------------------------------------
-      IRemoteEventing::States RemoteEventing::getState() const
+      static void *acquireSlab(
+                               SlabPools::Pools pool,
+                               size_t slabClass
+                               )
       {
-        AutoRecursiveLock lock(mLock);
-        return mState;
+        auto &pools = getSlabPools();
+        auto &cacheFree = getSlabThreadCache().mFree[pool][slabClass];
+
+        if (cacheFree.size() < 1) {
+          // refill half the thread cache at once so the depot lock is rarely taken
+          size_t batch = getSlabThreadCacheLimit(slabClass) / 2;
+
+          auto &depot = pools.mDepots[pool];
+          AutoLock lock(depot.mLock);
+          auto &depotFree = depot.mFree[slabClass];
+          while ((depotFree.size() > 0) && (cacheFree.size() < batch)) {
+            cacheFree.push_back(depotFree.back());
+            depotFree.pop_back();
+          }
+        }
+
+        void *block {};
+        if (cacheFree.size() > 0) {
+          block = cacheFree.back();
+          cacheFree.pop_back();
+        } else {
+          block = createSlab(pool, slabClass);
+        }
+
+        pools.mInUse[pool].fetch_add(1, std::memory_order_relaxed);
+        pools.mInUseBytes[pool].fetch_add(getSlabClassSize(slabClass), std::memory_order_relaxed);
+        return block;
       }
-      
+
       //-----------------------------------------------------------------------
-      void RemoteEventing::setRemoteLevel(
-                                          const char *remoteSubsystemName,
-                                          Level level
-                                          )
+      static void releaseSlab(
+                              SlabPools::Pools pool,
+                              size_t slabClass,
+                              void *block
+                              )
       {
-        AutoRecursiveLock lock(mLock);
-        
-        auto info = make_shared<SubsystemInfo>();
-        info->mName = String(remoteSubsystemName);
-        info->mLevel = level;
+        auto &pools = getSlabPools();
+        auto &cacheFree = getSlabThreadCache().mFree[pool][slabClass];
 
-        mSetRemoteSubsystemsLevels[info->mName] = info;
+        pools.mInUse[pool].fetch_sub(1, std::memory_order_relaxed);
+        pools.mInUseBytes[pool].fetch_sub(getSlabClassSize(slabClass), std::memory_order_relaxed);
 
-        if (!isAuthorized()) return;
+        cacheFree.push_back(block);
 
-        requestSetRemoteSubsystemLevel(info);
+        // frames are mostly recycled on the socket thread and acquired on
+        // the emitting threads so a full cache hands half back to the depot
+        size_t limit = getSlabThreadCacheLimit(slabClass);
+        if (cacheFree.size() <= limit) return;
+        returnSlabsToDepot(pool, slabClass, cacheFree, limit / 2);
       }
-      
 
       //-----------------------------------------------------------------------
+      // Allocates shared pointer control blocks from the slab pool.
+      template <typename T>
+      struct SlabAllocator
+      {
+        typedef T value_type;
+
+        SlabAllocator() {}
+        template <typename U>
+        SlabAllocator(const SlabAllocator<U> &) {}
+
+        T *allocate(size_t count)
+        {
+          size_t size = sizeof(T) * count;
+          size_t slabClass = getSlabClass(size);
+          if (slabClass >= ZSLIB_EVENTING_REMOTE_EVENTING_SLAB_CLASSES) return static_cast<T *>(::operator new(size));
+          return static_cast<T *>(acquireSlab(SlabPools::Pool_Blocks, slabClass));
+        }
+
+        void deallocate(T *block, size_t count)
+        {
+          size_t slabClass = getSlabClass(sizeof(T) * count);
+          if (slabClass >= ZSLIB_EVENTING_REMOTE_EVENTING_SLAB_CLASSES) {
+            ::operator delete(block);
+            return;
+          }
+          releaseSlab(SlabPools::Pool_Blocks, slabClass, block);
+        }
+
+        template <typename U>
+        bool operator==(const SlabAllocator<U> &) const { return true; }
+        template <typename U>
+        bool operator!=(const SlabAllocator<U> &) const { return false; }
+      };
+
       //-----------------------------------------------------------------------
+      struct EventFrameRecycler
+      {
+        size_t mSlabClass {};
+
+        void operator()(SecureByteBlock *frame) const
+        {
+          releaseSlab(SlabPools::Pool_Frames, mSlabClass, frame);
+        }
+      };
+
       //-----------------------------------------------------------------------
+      // The frame may be larger than requested; the frame returns to the
+      // pool once the last reference to it is released.
+      static SecureByteBlockPtr acquireEventFrame(size_t size)
+      {
+        size_t slabClass = getSlabClass(size);
+        if (slabClass >= ZSLIB_EVENTING_REMOTE_EVENTING_SLAB_CLASSES) return make_shared<SecureByteBlock>(size);
+
+        auto frame = static_cast<SecureByteBlock *>(acquireSlab(SlabPools::Pool_Frames, slabClass));
+        return SecureByteBlockPtr(frame, EventFrameRecycler {slabClass}, SlabAllocator<SecureByteBlock>());
+      }
+
       //-----------------------------------------------------------------------
-      #pragma mark
-      #pragma mark RemoteEventing => IWakeDelegate
-      #pragma mark
+      static const IRemoteEventingTypes::EventOrigin * &getCurrentEventOriginRef()
+      {
+        static thread_local const IRemoteEventingTypes::EventOrigin *origin {};
+        return origin;
+      }
 
       //-----------------------------------------------------------------------
-      void RemoteEventing::onWake()
+      static void writeRemoteEvent(
+                                   Log::ProviderHandle handle,
+                                   const RemoteEventing::EventHeader &header,
+                                   const USE_EVENT_DATA_DESCRIPTOR *dataDescriptors,
+                                   const IRemoteEventingTypes::EventOrigin *origin
+                                   )
       {
-        ZS_LOG_DEBUG(log("on wake"));
+        // listeners are called synchronously so they can query the origin while the event is written
+        auto &currentOrigin = getCurrentEventOriginRef();
+        auto previousOrigin = currentOrigin;
+        currentOrigin = origin;
 
-        AutoRecursiveLock lock(mLock);
-        step();
+        // write the remote event as if it was generated locally
+        Log::writeEvent(
+                        handle,
+                        header.mSeverity,
+                        header.mLevel,
+                        (&(header.mDescriptor)),
+                        (&(header.mParamDescriptors[0])),
+                        dataDescriptors,
+                        header.mDescriptorCount
+                        );
+
+        currentOrigin = previousOrigin;
       }
 
       //-----------------------------------------------------------------------
+      static uint64_t getMonotonicTimestamp()
+      {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+      }
+
       //-----------------------------------------------------------------------
+      static uint64_t getTSC()
+      {
+#ifdef ZSLIB_EVENTING_REMOTE_EVENTING_HAS_TSC
+        return static_cast<uint64_t>(__rdtsc());
+#else
+        return getMonotonicTimestamp();
+#endif //ZSLIB_EVENTING_REMOTE_EVENTING_HAS_TSC
+      }
+
       //-----------------------------------------------------------------------
+      // Shared by every remote eventing object in the process; published
+      // once the calibration thread has measured the tick rate.
+      struct TSCCalibration
+      {
+        std::atomic<bool> mReady {};
+        uint64_t mTSCBase {};
+        uint64_t mMonotonicBase {};
+        double mNanosecondsPerTick {};
+      };
+
       //-----------------------------------------------------------------------
-      #pragma mark
-      #pragma mark RemoteEventing => ITimerDelegate
-      #pragma mark
+      static TSCCalibration &getTSCCalibration()
+      {
+        static TSCCalibration calibration;
+        return calibration;
+      }
 
       //-----------------------------------------------------------------------
-      void RemoteEventing::onTimer(ITimerPtr timer)
+      static void startTSCCalibration()
       {
-        ZS_LOG_DEBUG(log("on timer") + ZS_PARAM("timer id", timer->getID()));
-        
-        AutoRecursiveLock lock(mLock);
-        if (timer == mNotifyTimer) {
-          sendNotify();
-          return;
-        }
-        if (mRebindTimer) {
-          if (mRebindTimer->getID() == timer->getID()) {
-            ZS_LOG_TRACE(log("rebind timer"));
-            mRebindTimer->cancel();
-            mRebindTimer.reset();
-            step();
-            return;
+        static std::once_flag once;
+        std::call_once(once, []() {
+          // sleeps through the sample period so no socket thread is held up
+          std::thread([]() {
+            uint64_t tscBase = getTSC();
+            uint64_t monotonicBase = getMonotonicTimestamp();
+
+            std::this_thread::sleep_for(std::chrono::nanoseconds(ZSLIB_EVENTING_REMOTE_EVENTING_TSC_CALIBRATION_NANOSECONDS));
+
+            uint64_t tsc = getTSC();
+            uint64_t elapsed = getMonotonicTimestamp() - monotonicBase;
+
+            // a tsc that did not advance leaves every capture on the monotonic clock
+            if ((tsc <= tscBase) ||
+                (0 == elapsed)) return;
+
+            auto &calibration = getTSCCalibration();
+            calibration.mTSCBase = tscBase;
+            calibration.mMonotonicBase = monotonicBase;
+            calibration.mNanosecondsPerTick = static_cast<double>(elapsed) / static_cast<double>(tsc - tscBase);
+            calibration.mReady.store(true, std::memory_order_release);
+          }).detach();
+        });
+      }
+
+      //-----------------------------------------------------------------------
+      // Always in monotonic nanoseconds; the tsc is only read once calibrated.
+      static uint64_t getOriginTimestamp(bool useTSC)
+      {
+        if (useTSC) {
+          auto &calibration = getTSCCalibration();
+          if (calibration.mReady.load(std::memory_order_acquire)) {
+            auto ticks = static_cast<int64_t>(getTSC() - calibration.mTSCBase);
+            return calibration.mMonotonicBase + static_cast<uint64_t>(static_cast<double>(ticks) * calibration.mNanosecondsPerTick);
           }
         }
+        return getMonotonicTimestamp();
       }
-      
+
       //-----------------------------------------------------------------------
+      static uint64_t getCurrentThreadNumericID()
+      {
+        static thread_local uint64_t threadID {};
+        if (0 != threadID) return threadID;
+
+#ifdef _WIN32
+        threadID = static_cast<uint64_t>(GetCurrentThreadId());
+#elif defined(__APPLE__)
+        uint64_t value {};
+        pthread_threadid_np(NULL, &value);
+        threadID = static_cast<uint64_t>(value);
+#elif defined(__linux__)
+        threadID = static_cast<uint64_t>(syscall(SYS_gettid));
+#else
+        threadID = static_cast<uint64_t>(std::hash<std::thread::id>()(std::this_thread::get_id()));
+#endif //_WIN32
+        return threadID;
+      }
+
       //-----------------------------------------------------------------------
+      static uint32_t getCurrentCPU()
+      {
+#ifdef _WIN32
+        return static_cast<uint32_t>(GetCurrentProcessorNumber());
+#elif defined(__linux__)
+        int cpu = sched_getcpu();
+        if (cpu < 0) return IRemoteEventingTypes::CPU_Unknown;
+        return static_cast<uint32_t>(cpu);
+#else
+        return IRemoteEventingTypes::CPU_Unknown;
+#endif //_WIN32
+      }
+
       //-----------------------------------------------------------------------
+      static uint64_t getCurrentProcessNumericID()
+      {
+#ifdef _WIN32
+        return static_cast<uint64_t>(GetCurrentProcessId());
+#else
+        return static_cast<uint64_t>(getpid());
+#endif //_WIN32
+      }
+
       //-----------------------------------------------------------------------
-      #pragma mark
-      #pragma mark RemoteEventing => ISocketDelegate
-      #pragma mark
+      static bool isProcessAlive(uint64_t processID)
+      {
+        if (0 == processID) return true;
+
+#ifdef ZSLIB_EVENTING_REMOTE_EVENTING_NO_LOCAL_CHANNEL
+        return true;
+#elif defined(_WIN32)
+        HANDLE process = OpenProcess(SYNCHRONIZE, FALSE, static_cast<DWORD>(processID));
+        if (NULL == process) return false;
+        bool alive = (WAIT_TIMEOUT == WaitForSingleObject(process, 0));
+        CloseHandle(process);
+        return alive;
+#else
+        if (0 == kill(static_cast<pid_t>(processID), 0)) return true;
+        return EPERM == errno;
+#endif //ZSLIB_EVENTING_REMOTE_EVENTING_NO_LOCAL_CHANNEL
+      }
 
       //-----------------------------------------------------------------------
-      void RemoteEventing::onReadReady(SocketPtr socket)
+      // Shared by both parties of a local channel; every field is only ever
+      // accessed atomically as the two sides live in different processes.
+      struct LocalChannelSide
       {
-        AutoRecursiveLock lock(mLock);
-        if (socket == mBindSocket) {
-          disconnect();
-          
-          try {
-            mAcceptedSocket = mBindSocket->accept(mRemoteIP);
-            if (!mAcceptedSocket) {
-              ZS_LOG_WARNING(Debug, log("incoming socket rejected"));
-              return;
-            }
-            mAcceptedSocket->setBlocking(false);
-            mAcceptedSocket->setDelegate(mThisWeak.lock());
-            ZS_LOG_DEBUG(log("incoming socket accepted") + ZS_PARAM("ip", mRemoteIP.string()));
-          } catch (const Socket::Exceptions::Unspecified &) {
-            ZS_LOG_WARNING(Debug, log("incoming socket rejected"));
-            return;
-          }
-          setState(State_Connecting);
-          step();
-          return;
-        }
-        
-        auto activeSocket = getActiveSocket();
-        if (socket == activeSocket) {
-          if (isConnectingMode()) {
-            if (!mConnected) {
-              ZS_LOG_WARNING(Trace, log("notified read ready before connected"));
-              return;
-            }
-          }
-          try {
-            BYTE buffer[4096];
+        std::atomic<uint32_t> mDoorbell {};
+        std::atomic<uint32_t> mWaiting {};
+        std::atomic<uint32_t> mReadArmed {};
+        std::atomic<uint32_t> mWriteArmed {};
+        std::atomic<uint32_t> mAttached {};
+        std::atomic<uint32_t> mClosed {};
+        std::atomic<uint64_t> mProcessID {};
+        BYTE mPadding[ZSLIB_EVENTING_REMOTE_EVENTING_LOCAL_CHANNEL_CACHE_LINE - (sizeof(uint32_t)*6) - sizeof(uint64_t)];
+      };
 
-            auto read = activeSocket->receive(&(buffer[0]), sizeof(buffer));
-            mIncomingQueue.Put(&(buffer[0]), read);
-          } catch (const Socket::Exceptions::Unspecified &) {
-            ZS_LOG_WARNING(Debug, log("could not read active socket"));
-          }
-          readIncomingMessage();
-          return;
-        }
+      //-----------------------------------------------------------------------
+      // Monotonic byte positions; only the writing side moves mHead and
+      // only the reading side moves mTail.
+      struct LocalChannelRing
+      {
+        std::atomic<uint64_t> mHead {};
+        BYTE mHeadPadding[ZSLIB_EVENTING_REMOTE_EVENTING_LOCAL_CHANNEL_CACHE_LINE - sizeof(uint64_t)];
+        std::atomic<uint64_t> mTail {};
+        BYTE mTailPadding[ZSLIB_EVENTING_REMOTE_EVENTING_LOCAL_CHANNEL_CACHE_LINE - sizeof(uint64_t)];
+      };
 
-        ZS_LOG_WARNING(Debug, log("read ready on obsolete socket") + ZS_PARAM("socket", static_cast<uintptr_t>(socket->getSocket())));
-      }
-      
       //-----------------------------------------------------------------------
-      void RemoteEventing::onWriteReady(SocketPtr socket)
+      // Start of the shared segment; the data of ring 0 followed by the data
+      // of ring 1 comes directly after. Side 0 is the listener and ring n is
+      // written by side n.
+      struct LocalChannelLayout
       {
-        AutoRecursiveLock lock(mLock);
-        
-        if (socket == mConnectSocket) {
-          if (!mConnected) {
-            ZS_LOG_DEBUG(log("connecting socket connected"));
-            mConnected = true;
-            mWriteReady = true;
-            step();
-            return;
-          }
-        }
+        std::atomic<uint32_t> mMagic {};
+        uint32_t mVersion {};
+        uint64_t mRingSize {};
+        BYTE mPadding[ZSLIB_EVENTING_REMOTE_EVENTING_LOCAL_CHANNEL_CACHE_LINE - (sizeof(uint32_t)*2) - sizeof(uint64_t)];
 
-        auto activeSocket = getActiveSocket();
-        if (socket == activeSocket) {
-          mWriteReady = true;
-          sendOutgoingData();
-          return;
-        }
+        LocalChannelSide mSides[2];
+        LocalChannelRing mRings[2];
+      };
 
-        ZS_LOG_WARNING(Debug, log("read ready on obsolete socket") + ZS_PARAM("socket", static_cast<uintptr_t>(socket->getSocket())));
-      }
-      
       //-----------------------------------------------------------------------
-      void RemoteEventing::onException(SocketPtr socket)
+      static LocalChannelLayout *getLocalChannelLayout(void *mapping)
       {
-        AutoRecursiveLock lock(mLock);
-        
-        auto activeSocket = getActiveSocket();
-        if (socket == activeSocket) {
-          ZS_LOG_WARNING(Detail, log("active socket closed"));
-
-          if (isListeningMode()) {
-            try {
-              mAcceptedSocket->close();
-            } catch (const Socket::Exceptions::Unspecified &) {
-              ZS_LOG_WARNING(Debug, log("could not read active socket"));
-            }
-            mAcceptedSocket.reset();
-            disconnect();
-            return;
-          }
-          try {
-            mConnectSocket->close();
-          } catch (const Socket::Exceptions::Unspecified &) {
-            ZS_LOG_WARNING(Debug, log("could not read active socket"));
-          }
-          mConnectSocket.reset();
-          disconnect();
-          return;
-        }
-        
-        if (socket == mBindSocket) {
-          ZS_LOG_WARNING(Detail, log("bind socket failed"));
-          cancel();
-          return;
-        }
+        return reinterpret_cast<LocalChannelLayout *>(mapping);
       }
 
       //-----------------------------------------------------------------------
+      static BYTE *getLocalChannelRingData(
+                                           LocalChannelLayout *layout,
+                                           size_t ringSize,
+                                           size_t ring
+                                           )
+      {
+        return reinterpret_cast<BYTE *>(layout) + sizeof(LocalChannelLayout) + (ringSize * ring);
+      }
+
       //-----------------------------------------------------------------------
-      //-----------------------------------------------------------------------
-      //-----------------------------------------------------------------------
-      #pragma mark
-      #pragma mark RemoteEventing => ILogEventingProviderDelegate
-      #pragma mark
+      // Start of the spool file with the ring data directly after. Positions
+      // only ever grow; the offset into the ring is the position modulo the
+      // capacity and records never straddle the end of the ring.
+      struct EventSpoolLayout
+      {
+        uint32_t mMagic {};
+        uint32_t mVersion {};
+        uint64_t mCapacity {};
+        uint64_t mHead {};
+        uint64_t mTail {};
+        BYTE mPadding[ZSLIB_EVENTING_REMOTE_EVENTING_LOCAL_CHANNEL_CACHE_LINE - (sizeof(uint32_t)*2) - (sizeof(uint64_t)*3)];
+      };
 
       //-----------------------------------------------------------------------
-      void RemoteEventing::notifyNewSubsystem(zsLib::Subsystem &inSubsystem)
+      static EventSpoolLayout *getEventSpoolLayout(const RemoteEventing::EventSpool &spool)
       {
-        AutoRecursiveLock lock(mAsyncSelfLock);
-        if (!mAsyncSelf) return;
-        mAsyncSelf->onRemoteEventingNewSubsystem(inSubsystem.getName());
+        return reinterpret_cast<EventSpoolLayout *>(spool.mMapping);
       }
-      
+
       //-----------------------------------------------------------------------
-      void RemoteEventing::notifyEventingProviderRegistered(
-                                                            ProviderHandle handle,
-                                                            EventingAtomDataArray eventingAtomDataArray
-                                                            )
+      // Skips the wrap padding at the tail.
+      // RETURNS: the size of the oldest message or 0 if the spool is empty.
+      static size_t getOldestSpoolMessage(const RemoteEventing::EventSpool &spool)
       {
-        ProviderInfo *info = reinterpret_cast<ProviderInfo *>(eventingAtomDataArray[mEventingAtomIndex]);
-        
-        bool constructed = false;
+        auto layout = getEventSpoolLayout(spool);
 
-        if (info) {
-          if (info->mRelatedToRemoteEventingObjectID != mID) {
-            // ignore provider infos related to other remote evening engines running
-            return;
-          }
-          if (info->mSelfRegistered) {
-            // ignore re-entrant self registered provider infos
-            return;
+        while (layout->mTail != layout->mHead) {
+          size_t offset = static_cast<size_t>(layout->mTail % spool.mCapacity);
+          size_t contiguous = spool.mCapacity - offset;
+
+          if (contiguous < sizeof(CryptoPP::word32)) {
+            layout->mTail += contiguous;
+            continue;
           }
-        } else {
-          constructed = true;
-          info = new ProviderInfo;
-          info->mHandle = handle;
-          info->mRelatedToRemoteEventingObjectID = mID;
-          if (!Log::getEventingWriterInfo(handle, info->mProviderID, info->mProviderName, info->mProviderHash)) {
-            ZS_LOG_WARNING(Detail, log("told about provider that does not exist") + ZS_PARAM("provider handle", string(handle)));
-            delete info;
-            return;
+
+          CryptoPP::word32 messageSize = IHelper::getBE32(spool.mData + offset);
+          if (ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_RING_WRAP_MARKER == messageSize) {
+            layout->mTail += contiguous;
+            continue;
           }
+          return sizeof(messageSize) + static_cast<size_t>(messageSize);
         }
-        
-        IRemoteEventingAsyncDelegatePtr pAsyncThis;
+        return 0;
+      }
 
-        {
-          AutoRecursiveLock lock(mAsyncSelfLock);
-          pAsyncThis = mAsyncSelf;
+      //-----------------------------------------------------------------------
+      static String getLocalChannelName(const String &name)
+      {
+        String result(ZSLIB_EVENTING_REMOTE_EVENTING_LOCAL_CHANNEL_PREFIX);
+        for (auto iter = name.begin(); iter != name.end(); ++iter) {
+          char value = (*iter);
+          if (('/' == value) || ('\\' == value)) value = '_';
+          result += value;
         }
-        
-        {
-          AutoRecursiveLock lock(mLock);
-          if (constructed) {
-            eventingAtomDataArray[mEventingAtomIndex] = reinterpret_cast<uintptr_t>(info);
-            mCleanUpProviderInfos.insert(info);
-          }
-          auto found = mRemoteRegisteredProvidersByUUID.find(info->mProviderID);
-          if (found != mRemoteRegisteredProvidersByUUID.end()) {
-            // ignore any providers announced by the remote party
-            info->mSelfRegistered = true;
-            return;
+        return result;
+      }
+
+#if !defined(_WIN32) && !defined(ZSLIB_EVENTING_REMOTE_EVENTING_NO_LOCAL_CHANNEL)
+      //-----------------------------------------------------------------------
+      // A segment is only stale if it was fully created by a listener which
+      // is no longer running; anything else may belong to a live listener.
+      static bool isStaleLocalChannel(const String &channelName)
+      {
+        int descriptor = shm_open(channelName.c_str(), O_RDONLY, 0);
+        if (descriptor < 0) return false;
+
+        bool stale = false;
+
+        struct stat info {};
+        if ((0 == fstat(descriptor, &info)) &&
+            (static_cast<size_t>(info.st_size) >= sizeof(LocalChannelLayout))) {
+          void *mapping = mmap(NULL, sizeof(LocalChannelLayout), PROT_READ, MAP_SHARED, descriptor, 0);
+          if (MAP_FAILED != mapping) {
+            auto layout = getLocalChannelLayout(mapping);
+            stale = (ZSLIB_EVENTING_REMOTE_EVENTING_LOCAL_CHANNEL_MAGIC == layout->mMagic.load(std::memory_order_acquire)) &&
+                    (!isProcessAlive(layout->mSides[0].mProcessID.load()));
+            munmap(mapping, sizeof(LocalChannelLayout));
           }
         }
 
-        if (!pAsyncThis) return;
-        pAsyncThis->onRemoteEventingProviderRegistered(info);
+        ::close(descriptor);
+        return stale;
       }
-      
+#endif //!defined(_WIN32) && !defined(ZSLIB_EVENTING_REMOTE_EVENTING_NO_LOCAL_CHANNEL)
+
       //-----------------------------------------------------------------------
-      void RemoteEventing::notifyEventingProviderUnregistered(
-                                                              ProviderHandle handle,
-                                                              EventingAtomDataArray eventingAtomDataArray
-                                                              )
+      static void ringLocalChannelDoorbell(LocalChannelSide &side)
       {
-        ProviderInfo *info = reinterpret_cast<ProviderInfo *>(eventingAtomDataArray[mEventingAtomIndex]);
-        if (!info) return;
+        side.mDoorbell.fetch_add(1);
 
-        if (info->mRelatedToRemoteEventingObjectID != mID) {
-          // ignore provider infos related to other remote evening engines running
-          return;
-        }
+        // a side that is not waiting re-checks the doorbell before it waits
+        if (0 == side.mWaiting.load()) return;
 
-        eventingAtomDataArray[mEventingAtomIndex] = static_cast<uintptr_t>(0);
+#if defined(__linux__)
+        syscall(SYS_futex, reinterpret_cast<uint32_t *>(&side.mDoorbell), FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+#endif //defined(__linux__)
+      }
 
-        if (info->mSelfRegistered) {
-          // ignore re-entrant self registered provider infos
-          return;
-        }
+      //-----------------------------------------------------------------------
+      static void waitLocalChannelDoorbell(
+                                           LocalChannelSide &side,
+                                           uint32_t doorbell
+                                           )
+      {
+#if defined(__linux__)
+        struct timespec timeout {};
+        timeout.tv_sec = ZSLIB_EVENTING_REMOTE_EVENTING_LOCAL_CHANNEL_WAIT_MILLISECONDS / 1000;
+        timeout.tv_nsec = (ZSLIB_EVENTING_REMOTE_EVENTING_LOCAL_CHANNEL_WAIT_MILLISECONDS % 1000) * 1000 * 1000;
+        syscall(SYS_futex, reinterpret_cast<uint32_t *>(&side.mDoorbell), FUTEX_WAIT, doorbell, &timeout, NULL, 0);
+#else
+        if (doorbell != side.mDoorbell.load()) return;
+        std::this_thread::sleep_for(Milliseconds(ZSLIB_EVENTING_REMOTE_EVENTING_LOCAL_CHANNEL_POLL_MILLISECONDS));
+#endif //defined(__linux__)
+      }
 
-        {
-          AutoRecursiveLock lock(mAsyncSelfLock);
-          if (!mAsyncSelf) return;
-          mAsyncSelf->onRemoteEventingProviderUnregistered(info);
+      //-----------------------------------------------------------------------
+      static void recordTime(
+                             IRemoteEventingTypes::TimeHistogram &histogram,
+                             uint64_t nanoseconds
+                             )
+      {
+        size_t bucket = 0;
+        for (uint64_t value = nanoseconds >> 1; 0 != value; value >>= 1) {
+          ++bucket;
         }
+        if (bucket >= IRemoteEventingTypes::TimeHistogram::Buckets_Total) bucket = IRemoteEventingTypes::TimeHistogram::Buckets_Total - 1;
+
+        ++(histogram.mCount);
+        histogram.mTotalNanoseconds += nanoseconds;
+        ++(histogram.mBuckets[bucket]);
       }
 
       //-----------------------------------------------------------------------
-      void RemoteEventing::notifyEventingProviderLoggingStateChanged(
-                                                                     ProviderHandle handle,
-                                                                     EventingAtomDataArray eventingAtomDataArray,
-                                                                     KeywordBitmaskType keywords
-                                                                     )
+      static void mergeTime(
+                            IRemoteEventingTypes::TimeHistogram &ioHistogram,
+                            const IRemoteEventingTypes::TimeHistogram &source
+                            )
       {
-        ProviderInfo *info = reinterpret_cast<ProviderInfo *>(eventingAtomDataArray[mEventingAtomIndex]);
-        if (!info) return;
-        
-        if (info->mRelatedToRemoteEventingObjectID != mID) {
-          // ignore provider infos related to other remote evening engines running
-          return;
+        ioHistogram.mCount += source.mCount;
+        ioHistogram.mTotalNanoseconds += source.mTotalNanoseconds;
+        for (size_t index = 0; index < IRemoteEventingTypes::TimeHistogram::Buckets_Total; ++index) {
+          ioHistogram.mBuckets[index] += source.mBuckets[index];
         }
+      }
 
-        {
-          AutoRecursiveLock lock(mAsyncSelfLock);
-          if (!mAsyncSelf) return;
-          mAsyncSelf->onRemoteEventingProviderLoggingStateChanged(info, keywords);
+      //-----------------------------------------------------------------------
+      static void mergeStatistics(
+                                  IRemoteEventingTypes::Statistics &ioStatistics,
+                                  const IRemoteEventingTypes::Statistics &source
+                                  )
+      {
+        for (auto iter = source.mProviders.begin(); iter != source.mProviders.end(); ++iter) {
+          auto &sourceStatistics = (*iter).second;
+          auto &statistics = ioStatistics.mProviders[(*iter).first];
+          statistics.mEventsSent += sourceStatistics.mEventsSent;
+          statistics.mBytesSent += sourceStatistics.mBytesSent;
+          statistics.mEventsReceived += sourceStatistics.mEventsReceived;
+          statistics.mBytesReceived += sourceStatistics.mBytesReceived;
+        }
+
+        ioStatistics.mAsyncQueueBytes += source.mAsyncQueueBytes;
+        if (source.mAsyncQueueBytesHighWater > ioStatistics.mAsyncQueueBytesHighWater) ioStatistics.mAsyncQueueBytesHighWater = source.mAsyncQueueBytesHighWater;
+        ioStatistics.mOutgoingQueueBytes += source.mOutgoingQueueBytes;
+        if (source.mOutgoingQueueBytesHighWater > ioStatistics.mOutgoingQueueBytesHighWater) ioStatistics.mOutgoingQueueBytesHighWater = source.mOutgoingQueueBytesHighWater;
+
+        ioStatistics.mOutgoingSegmentPoolSegments += source.mOutgoingSegmentPoolSegments;
+        ioStatistics.mOutgoingSegmentPoolBytes += source.mOutgoingSegmentPoolBytes;
+        ioStatistics.mSpoolBytes += source.mSpoolBytes;
+        ioStatistics.mSpooledEvents += source.mSpooledEvents;
+        ioStatistics.mReplayedEvents += source.mReplayedEvents;
+
+        for (size_t index = IRemoteEventingTypes::DropReason_First; index <= IRemoteEventingTypes::DropReason_Last; ++index) {
+          ioStatistics.mDroppedEvents[index] += source.mDroppedEvents[index];
+        }
+
+        ioStatistics.mSendCalls += source.mSendCalls;
+        ioStatistics.mSendWouldBlockCalls += source.mSendWouldBlockCalls;
+        ioStatistics.mReceiveCalls += source.mReceiveCalls;
+        mergeTime(ioStatistics.mEncodeTime, source.mEncodeTime);
+        mergeTime(ioStatistics.mDecodeTime, source.mDecodeTime);
+      }
+
+      //-----------------------------------------------------------------------
+      template <typename T>
+      static T getElementNumber(
+                                const ElementPtr &parentEl,
+                                const char *name
+                                )
+      {
+        if (!parentEl) return 0;
+
+        String str = IHelper::getElementText(parentEl->findFirstChildElement(name));
+        if (str.isEmpty()) return 0;
+
+        try {
+          return Numeric<T>(str);
+        } catch (const typename Numeric<T>::ValueOutOfRange &) {
         }
+        return 0;
       }
 
+      //-----------------------------------------------------------------------
+      static size_t getPercentOf(
+                                 size_t value,
+                                 size_t percent
+                                 )
+      {
+        // avoids overflowing when the budget is configured as "unlimited"
+        return ((value / 100) * percent) + (((value % 100) * percent) / 100);
+      }
 
       //-----------------------------------------------------------------------
+      static bool isCriticalSeverity(Log::Severity severity)
+      {
+        return ((Log::Error == severity) ||
+                (Log::Fatal == severity));
+      }
+
       //-----------------------------------------------------------------------
+      static size_t getLoadSheddingBudget(
+                                          size_t budget,
+                                          Log::Severity severity,
+                                          Log::Level level
+                                          )
+      {
+        if (isCriticalSeverity(severity)) return budget;
+        if (Log::Warning == severity) return getPercentOf(budget, ZSLIB_EVENTING_REMOTE_EVENTING_LOAD_SHEDDING_WARNING_PERCENT);
+
+        switch (level) {
+          case Log::None:
+          case Log::Basic:    return getPercentOf(budget, ZSLIB_EVENTING_REMOTE_EVENTING_LOAD_SHEDDING_BASIC_PERCENT);
+          case Log::Detail:   return getPercentOf(budget, ZSLIB_EVENTING_REMOTE_EVENTING_LOAD_SHEDDING_DETAIL_PERCENT);
+          case Log::Debug:    return getPercentOf(budget, ZSLIB_EVENTING_REMOTE_EVENTING_LOAD_SHEDDING_DEBUG_PERCENT);
+          case Log::Trace:    return getPercentOf(budget, ZSLIB_EVENTING_REMOTE_EVENTING_LOAD_SHEDDING_TRACE_PERCENT);
+          case Log::Insane:   break;
+        }
+        return getPercentOf(budget, ZSLIB_EVENTING_REMOTE_EVENTING_LOAD_SHEDDING_INSANE_PERCENT);
+      }
+
       //-----------------------------------------------------------------------
+      static void putBE16(
+                          BYTE * &ioPos,
+                          uint16_t value
+                          )
+      {
+        ioPos[0] = static_cast<BYTE>((value >> 8) & 0xFF);
+        ioPos[1] = static_cast<BYTE>(value & 0xFF);
+        ioPos += sizeof(value);
+      }
+
       //-----------------------------------------------------------------------
-      #pragma mark
-      #pragma mark RemoteEventing => ILogEventingDelegate
-      #pragma mark
+      static void putBE32(
+                          BYTE * &ioPos,
+                          uint32_t value
+                          )
+      {
+        putBE16(ioPos, static_cast<uint16_t>((value >> 16) & 0xFFFF));
+        putBE16(ioPos, static_cast<uint16_t>(value & 0xFFFF));
+      }
 
       //-----------------------------------------------------------------------
-      void RemoteEventing::notifyWriteEvent(
-                                            ProviderHandle handle,
-                                            EventingAtomDataArray eventingAtomDataArray,
-                                            Severity severity,
-                                            Level level,
-                                            EVENT_DESCRIPTOR_HANDLE descriptor,
-                                            EVENT_PARAMETER_DESCRIPTOR_HANDLE parameterDescriptor,
-                                            EVENT_DATA_DESCRIPTOR_HANDLE dataDescriptor,
-                                            size_t dataDescriptorCount
-                                            )
+      static void putBE64(
+                          BYTE * &ioPos,
+                          uint64_t value
+                          )
       {
-        ProviderInfo *info = reinterpret_cast<ProviderInfo *>(eventingAtomDataArray[mEventingAtomIndex]);
-        if (!info) return;
+        putBE32(ioPos, static_cast<uint32_t>((value >> 32) & 0xFFFFFFFF));
+        putBE32(ioPos, static_cast<uint32_t>(value & 0xFFFFFFFF));
+      }
 
-        if (info->mRelatedToRemoteEventingObjectID != mID) {
-          // ignore provider infos related to other remote evening engines running
-          return;
-        }
-        if (info->mSelfRegistered) {
-          // ignore re-entrant self registered provider infos
-          return;
-        }
-        if (dataDescriptorCount > ZSLIB_EVENTING_REMOTE_EVENTING_MAX_DATA_DESCRIPTORS) {
-          ++mTotalDroppedEvents;
-          ZS_LOG_WARNING(Debug, log("total descriptors exceed maximum") + ZS_PARAMIZE(dataDescriptorCount));
-          return;
+      //-----------------------------------------------------------------------
+      static void putVarint(
+                            BYTE * &ioPos,
+                            uint64_t value
+                            )
+      {
+        while (value >= 0x80) {
+          *ioPos = static_cast<BYTE>((value & 0x7F) | 0x80);
+          ++ioPos;
+          value >>= 7;
         }
+        *ioPos = static_cast<BYTE>(value);
+        ++ioPos;
+      }
 
-        ByteQueuePtr packed(make_shared<ByteQueue>());
-
-        ByteQueue &usePacked = *packed;
+      //-----------------------------------------------------------------------
+      static bool getVarint(
+                            BYTE * &ioPos,
+                            size_t &ioRemaining,
+                            uint64_t &outValue
+                            )
+      {
+        outValue = 0;
+        for (size_t shift = 0; shift < 64; shift += 7) {
+          if (ioRemaining < 1) return false;
 
-        size_t packedSize = (sizeof(CryptoPP::word16)*5) +
-                            (sizeof(uint8_t)*4) +
-                            (sizeof(uint64_t)*2) +
-                            (sizeof(CryptoPP::word16)*dataDescriptorCount) +
-                            (sizeof(CryptoPP::word32)*(1+dataDescriptorCount));
+          BYTE value = *ioPos;
+          ++ioPos;
+          --ioRemaining;
 
-        for (size_t index = 0; index < dataDescriptorCount; ++index) {
-          auto &data = dataDescriptor[index];
-          
-          CryptoPP::word32 dataSize = static_cast<CryptoPP::word32>(data.Size);
-          if (dataSize > mMaxDataSize) {
-            dataSize = static_cast<decltype(dataSize)>(mMaxDataSize);
-          }
-          if (data.Ptr) {
-            packedSize += dataSize;
-          }
+          outValue |= (static_cast<uint64_t>(value & 0x7F) << shift);
+          if (0 == (value & 0x80)) return true;
         }
+        return false;
+      }
 
-        if (packedSize > mMaxPackedSize) {
-          ++mTotalDroppedEvents;
-          ZS_LOG_WARNING(Debug, log("packed size exceeds maximum size") + ZS_PARAMIZE(packedSize));
-          return;
-        }
-
-        size_t putSize = packedSize + (sizeof(CryptoPP::word32)); // message size not included in packedSize
-        usePacked.CreatePutSpace(putSize);
-        
-        usePacked.PutWord32(static_cast<CryptoPP::word32>(packedSize));
-        usePacked.PutWord32(static_cast<CryptoPP::word32>(MessageType_TraceEvent));
-
-        uint64_t data64 {};
-        uint64_t eventingHandle {static_cast<uint64_t>(handle)};
+      //-----------------------------------------------------------------------
+      static uint64_t zigzagEncode(uint64_t value)
+      {
+        return (value << 1) ^ static_cast<uint64_t>(static_cast<int64_t>(value) >> 63);
+      }
 
-        IHelper::setBE64(&data64, eventingHandle);
-        usePacked.Put((const BYTE *)(&data64), sizeof(data64));
+      //-----------------------------------------------------------------------
+      static uint64_t zigzagDecode(uint64_t value)
+      {
+        return (value >> 1) ^ (~(value & 1) + 1);
+      }
 
-        usePacked.PutWord16(static_cast<CryptoPP::word16>(severity));
-        usePacked.PutWord16(static_cast<CryptoPP::word16>(level));
-        usePacked.PutWord16(descriptor->Id);
-        usePacked.Put(descriptor->Version);
-        usePacked.Put(descriptor->Channel);
-        usePacked.Put(descriptor->Level);
-        usePacked.Put(descriptor->Opcode);
-        usePacked.PutWord16(descriptor->Task);
+      //-----------------------------------------------------------------------
+      static bool isCompactInteger(
+                                   EventParameterTypes type,
+                                   size_t size
+                                   )
+      {
+        switch (type) {
+          case EventParameterType_Boolean:
+          case EventParameterType_UnsignedInteger:
+          case EventParameterType_SignedInteger:
+          case EventParameterType_Pointer:          break;
+          default:                                  return false;
+        }
+        switch (size) {
+          case 1:
+          case 2:
+          case 4:
+          case 8:   return true;
+          default:  break;
+        }
+        return false;
+      }
 
-        IHelper::setBE64(&data64, descriptor->Keyword);
-        usePacked.Put((const BYTE *)(&data64), sizeof(data64));
+      //-----------------------------------------------------------------------
+      static uint64_t getPackedInteger(
+                                       const BYTE *pos,
+                                       size_t size,
+                                       bool signExtend
+                                       )
+      {
+        // packed scalars are in host byte order
+        switch (size) {
+          case 1:   { int8_t value {}; memcpy(&value, pos, sizeof(value)); return signExtend ? static_cast<uint64_t>(static_cast<int64_t>(value)) : static_cast<uint64_t>(static_cast<uint8_t>(value)); }
+          case 2:   { int16_t value {}; memcpy(&value, pos, sizeof(value)); return signExtend ? static_cast<uint64_t>(static_cast<int64_t>(value)) : static_cast<uint64_t>(static_cast<uint16_t>(value)); }
+          case 4:   { int32_t value {}; memcpy(&value, pos, sizeof(value)); return signExtend ? static_cast<uint64_t>(static_cast<int64_t>(value)) : static_cast<uint64_t>(static_cast<uint32_t>(value)); }
+          default:  break;
+        }
+        uint64_t value {};
+        memcpy(&value, pos, sizeof(value));
+        return value;
+      }
 
-        usePacked.PutWord16(static_cast<CryptoPP::word16>(dataDescriptorCount));
+      //-----------------------------------------------------------------------
+      static bool isLittleEndianHost()
+      {
+        uint16_t value = 1;
+        BYTE first {};
+        memcpy(&first, &value, sizeof(first));
+        return 0 != first;
+      }
 
-        for (size_t index = 0; index < dataDescriptorCount; ++index) {
-          auto &param = parameterDescriptor[index];
-          usePacked.PutWord16(static_cast<uint16_t>(param.Type));
+      //-----------------------------------------------------------------------
+      static void swapScalarBytes(
+                                  BYTE *pos,
+                                  size_t size
+                                  )
+      {
+        switch (size) {
+          case 2:
+          case 4:
+          case 8:   std::reverse(pos, pos + size); break;
+          default:  break;  // other sizes are left in their original format
         }
+      }
 
-        for (size_t index = 0; index < dataDescriptorCount; ++index) {
-          auto &data = dataDescriptor[index];
-          
-          uint32_t dataSize = static_cast<uint32_t>(data.Size);
-          if (dataSize > mMaxDataSize) {
-            dataSize = static_cast<decltype(dataSize)>(mMaxDataSize);
-          }
-          
-          if (data.Ptr) {
-            bool endianFlip {true};
-
-            switch (parameterDescriptor[index].Type) {
-              case EventParameterType_Boolean:
-              case EventParameterType_UnsignedInteger:
-              case EventParameterType_SignedInteger:
-              case EventParameterType_Pointer:
-              case EventParameterType_FloatingPoint:  {
-                dataSize |= (1 << 31);
-                break;
-              }
-              default:                                {
-                endianFlip = false;
-                break;
-              }
-            }
+      //-----------------------------------------------------------------------
+      static void setHostInteger(
+                                 BYTE *pos,
+                                 uint64_t value,
+                                 size_t size
+                                 )
+      {
+        switch (size) {
+          case 1:   { uint8_t result = static_cast<uint8_t>(value); memcpy(pos, &result, sizeof(result)); break; }
+          case 2:   { uint16_t result = static_cast<uint16_t>(value); memcpy(pos, &result, sizeof(result)); break; }
+          case 4:   { uint32_t result = static_cast<uint32_t>(value); memcpy(pos, &result, sizeof(result)); break; }
+          default:  { memcpy(pos, &value, sizeof(value)); break; }
+        }
+      }
 
-            usePacked.PutWord32(dataSize);
+      //-----------------------------------------------------------------------
+      static uint64_t hashBytes(
+                                const BYTE *pos,
+                                size_t size
+                                )
+      {
+        // FNV-1a
+        uint64_t hash = 14695981039346656037ULL;
+        for (size_t index = 0; index < size; ++index) {
+          hash ^= static_cast<uint64_t>(pos[index]);
+          hash *= 1099511628211ULL;
+        }
+        return hash;
+      }
 
-            if (endianFlip) {
-              switch (data.Size) {
-                case 2:  {
-                  uint16_t value {};
-                  memcpy(&value, (const void *)(data.Ptr), sizeof(value));
-                  usePacked.PutWord16(value);
-                  break;
-                }
-                case 4:  {
-                  uint32_t value {};
-                  memcpy(&value, (const void *)(data.Ptr), sizeof(value));
-                  usePacked.PutWord32(value);
-                  break;
-                }
-                case 8:  {
-                  memcpy(&data64, (const void *)(data.Ptr), sizeof(data64));
-                  IHelper::setBE64(&data64, data64);
-                  usePacked.Put((const BYTE *)(&data64), sizeof(data64));
-                  break;
-                }
-                default: {
-                  // just put in raw format
-                  usePacked.Put((const BYTE *)(data.Ptr), data.Size);
-                }
-              }
-            } else {
-              usePacked.Put((const BYTE *)(data.Ptr), data.Size);
+      //-----------------------------------------------------------------------
+      template <typename ProviderMap>
+      static uint64_t getSessionDigest(
+                                       const ProviderMap &providers,
+                                       const RemoteEventing::SessionSubsystemSet &subsystems
+                                       )
+      {
+        // both sides digest what the listening side announced (and the event
+        // filters it was asked to apply) in the same order
+        std::string digest;
+        for (auto iter = providers.begin(); iter != providers.end(); ++iter) {
+          auto &info = (*iter).second;
+          digest += string(static_cast<uint64_t>((*iter).first)) + ":" + string(info.mProviderID);
+          if (info.mEnabledEvents) {
+            auto &bitmap = *(info.mEnabledEvents);
+            for (auto iterWord = bitmap.begin(); iterWord != bitmap.end(); ++iterWord) {
+              digest += "/" + string(*iterWord);
             }
-          } else {
-            usePacked.PutWord32(static_cast<CryptoPP::word32>(0));
           }
+          digest += ";";
         }
-
-        {
-          AutoRecursiveLock lock(mAsyncSelfLock);
-          if (!mAsyncSelf) return;
-          if (mOutstandingEvents > mMaxOutstandingEvents) {
-            ++mTotalDroppedEvents;
-            ZS_LOG_WARNING(Insane, log("too many outstanding events (event dropped)") + ZS_PARAM("events", mOutstandingEvents));
-            return;
-          }
-          
-          size_t currentSize = static_cast<decltype(currentSize)>(packed->CurrentSize());
-
-          if (mEventDataInAsyncQueue + currentSize > mMaxQueuedAsyncDataBeforeEventsDropped) {
-            ++mTotalDroppedEvents;
-            ZS_LOG_WARNING(Insane, log("too many outstanding events (event dropped)") + ZS_PARAM("in queue", mEventDataInAsyncQueue) + ZS_PARAM("size", currentSize));
-            return;
-          }
-
-          ++mOutstandingEvents;
-          mEventDataInAsyncQueue += currentSize;
-          mAsyncSelf->onRemoteEventingWriteEvent(packed, currentSize);
+        for (auto iter = subsystems.begin(); iter != subsystems.end(); ++iter) {
+          digest += (*iter) + ";";
         }
+        return hashBytes(reinterpret_cast<const BYTE *>(digest.c_str()), digest.length());
       }
 
       //-----------------------------------------------------------------------
+      static void appendSessionVarint(
+                                      std::string &ioBuffer,
+                                      uint64_t value
+                                      )
+      {
+        BYTE buffer[ZSLIB_EVENTING_REMOTE_EVENTING_MAX_VARINT_SIZE] {};
+        BYTE *pos = &(buffer[0]);
+        putVarint(pos, value);
+        ioBuffer.append(reinterpret_cast<const char *>(&(buffer[0])), static_cast<size_t>(pos - &(buffer[0])));
+      }
+
       //-----------------------------------------------------------------------
+      static void appendSessionString(
+                                      std::string &ioBuffer,
+                                      const String &value
+                                      )
+      {
+        appendSessionVarint(ioBuffer, value.length());
+        ioBuffer.append(value);
+      }
+
       //-----------------------------------------------------------------------
+      static bool getSessionString(
+                                   BYTE * &ioPos,
+                                   size_t &ioRemaining,
+                                   String &outValue
+                                   )
+      {
+        uint64_t length {};
+        if (!getVarint(ioPos, ioRemaining, length)) return false;
+        if (length > ioRemaining) return false;
+
+        outValue = String(std::string(reinterpret_cast<const char *>(ioPos), static_cast<size_t>(length)));
+        ioPos += length;
+        ioRemaining -= static_cast<size_t>(length);
+        return true;
+      }
+
       //-----------------------------------------------------------------------
-      #pragma mark
-      #pragma mark RemoteEventing => IRemoteEventingAsyncDelegate
-      #pragma mark
+      static String encodeEventIDSet(const IRemoteEventingTypes::EventIDSet &eventIDs)
+      {
+        if (eventIDs.size() < 1) return String();
+
+        // bit (id % 8) of byte (id / 8) is set for every enabled event ID
+        SecureByteBlock bitmap((static_cast<size_t>(*(eventIDs.rbegin())) / 8) + 1);
+        memset(bitmap.BytePtr(), 0, bitmap.SizeInBytes());
+
+        for (auto iter = eventIDs.begin(); iter != eventIDs.end(); ++iter) {
+          auto eventID = (*iter);
+          bitmap.BytePtr()[eventID / 8] |= static_cast<BYTE>(1 << (eventID % 8));
+        }
+        return IHelper::convertToBase64(bitmap);
+      }
 
       //-----------------------------------------------------------------------
-      void RemoteEventing::onRemoteEventingSubscribeLogger()
+      static bool decodeEventIDBitmap(
+                                      const String &encoded,
+                                      RemoteEventing::EventIDBitmapPtr &outBitmap
+                                      )
       {
-        auto pThis = mThisWeak.lock();
-        ZS_THROW_BAD_STATE_IF(!pThis);
+        outBitmap.reset();
+        if (encoded.isEmpty()) return true;
 
-        {
-          AutoRecursiveLock lock(mAsyncSelfLock);
-          mAsyncSelf = IRemoteEventingAsyncDelegateProxy::create(pThis);
-          ZS_THROW_BAD_STATE_IF(!mAsyncSelf);
+        auto buffer = IHelper::convertFromBase64(encoded);
+        if (!buffer) return false;
+        if (buffer->SizeInBytes() > (ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_ID_BITMAP_WORDS * sizeof(uint64_t))) return false;
+
+        outBitmap = make_shared<RemoteEventing::EventIDBitmap>(ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_ID_BITMAP_WORDS);
+
+        const BYTE *pos = buffer->BytePtr();
+        for (size_t index = 0; index < buffer->SizeInBytes(); ++index) {
+          (*outBitmap)[index / 8] |= (static_cast<uint64_t>(pos[index]) << ((index % 8) * 8));
         }
+        return true;
+      }
 
-        Log::addEventingProviderListener(pThis);
-        Log::addEventingListener(pThis);
+      //-----------------------------------------------------------------------
+      static bool isEventIDEnabled(
+                                   const RemoteEventing::EventIDBitmap &bitmap,
+                                   uint16_t eventID
+                                   )
+      {
+        return 0 != (bitmap[eventID / 64] & (static_cast<uint64_t>(1) << (eventID % 64)));
       }
-      
+
       //-----------------------------------------------------------------------
-      void RemoteEventing::onRemoteEventingUnsubscribeLogger()
+      static void setProviderEventFilter(
+                                         IRemoteEventingInternalTypes::ProviderInfo *provider,
+                                         const RemoteEventing::EventIDBitmap *bitmap
+                                         )
       {
-        if (!mAsyncSelf) return;
-        
-        auto pThis = mThisWeak.lock();
-        ZS_THROW_BAD_STATE_IF(!pThis);
-        
-        Log::removeEventingProviderListener(pThis);
-        Log::removeEventingListener(pThis);
+        if (!bitmap) {
+          provider->mFilterEventIDs.store(false, std::memory_order_release);
+          return;
+        }
 
-        {
-          AutoRecursiveLock lock(mAsyncSelfLock);
-          mAsyncSelf.reset();
+        // the bitmap is allocated once so producers never see it replaced
+        if (!provider->mEnabledEventIDs) provider->mEnabledEventIDs = new std::atomic<uint64_t>[ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_ID_BITMAP_WORDS]();
+
+        for (size_t index = 0; index < ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_ID_BITMAP_WORDS; ++index) {
+          provider->mEnabledEventIDs[index].store((*bitmap)[index], std::memory_order_relaxed);
         }
+        provider->mFilterEventIDs.store(true, std::memory_order_release);
       }
-      
+
       //-----------------------------------------------------------------------
-      void RemoteEventing::onRemoteEventingNewSubsystem(const char *subsystemName)
+      static void applyProviderEventFilter(const RemoteEventing::ProviderEventFilter &filter)
       {
-        String subsystemStr(subsystemName);
-        
-        {
-          AutoRecursiveLock lock(mLock);
-          auto found = mLocalSubsystems.find(subsystemStr);
-          if (found != mLocalSubsystems.end()) {
-            ZS_LOG_TRACE(log("subsystem already announced") + ZS_PARAMIZE(subsystemStr));
+        // a listener filters on the union of what every subscribed client wants
+        RemoteEventing::EventIDBitmap combined;
+        bool filtered = false;
+
+        for (auto iter = filter.mClients.begin(); iter != filter.mClients.end(); ++iter) {
+          auto &client = (*iter).second;
+          if (!client.mSubscribed) continue;
+
+          if (!client.mEnabledEvents) {
+            setProviderEventFilter(filter.mProvider, NULL);
             return;
           }
-          
-          auto info = make_shared<SubsystemInfo>();
-          info->mName = subsystemStr;
 
-          mLocalSubsystems[info->mName] = info;
-          if (isAuthorized()) {
-            announceSubsystemToRemote(info);
+          if (!filtered) {
+            combined = *(client.mEnabledEvents);
+            filtered = true;
+            continue;
+          }
+
+          for (size_t index = 0; index < combined.size(); ++index) {
+            combined[index] |= (*(client.mEnabledEvents))[index];
           }
         }
+
+        setProviderEventFilter(filter.mProvider, filtered ? &combined : NULL);
       }
 
       //-----------------------------------------------------------------------
-      void RemoteEventing::onRemoteEventingProviderRegistered(ProviderInfo *provider)
+      static size_t getMinimumPackedEventSize(size_t dataDescriptorCount)
       {
-        AutoRecursiveLock lock(mLock);
-        auto found = mLocalAnnouncedProviders.find(provider->mProviderID);
-        if (found != mLocalAnnouncedProviders.end()) {
-          ZS_LOG_DEBUG(log("local provider already announced") + ZS_PARAM("provider", provider->mProviderName));
-          return;
-        }
-
-        mLocalAnnouncedProviders[provider->mProviderID] = provider;
-        announceProviderToRemote(provider);
+        // message size word is not included in the packed size
+        return ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_ORIGIN_SIZE +
+               (sizeof(CryptoPP::word16)*5) +
+               (sizeof(uint8_t)*4) +
+               (sizeof(uint64_t)*2) +
+               (sizeof(CryptoPP::word16)*dataDescriptorCount) +
+               (sizeof(CryptoPP::word32)*(1+dataDescriptorCount));
       }
 
       //-----------------------------------------------------------------------
-      void RemoteEventing::onRemoteEventingProviderUnregistered(ProviderInfo *provider)
+      static size_t getPackedEventSize(
+                                       EVENT_DATA_DESCRIPTOR_HANDLE dataDescriptor,
+                                       size_t dataDescriptorCount,
+                                       size_t maxDataSize
+                                       )
       {
-        AutoRecursiveLock lock(mLock);
-        auto found = mLocalAnnouncedProviders.find(provider->mProviderID);
-        if (found == mLocalAnnouncedProviders.end()) {
-          ZS_LOG_DEBUG(log("local provider not announced") + ZS_PARAM("provider", provider->mProviderName));
-          return;
+        size_t packedSize = getMinimumPackedEventSize(dataDescriptorCount);
+
+        for (size_t index = 0; index < dataDescriptorCount; ++index) {
+          auto &data = dataDescriptor[index];
+          if (!data.Ptr) continue;
+          packedSize += (data.Size > maxDataSize ? maxDataSize : data.Size);
         }
-        
-        mLocalAnnouncedProviders.erase(found);
-        announceProviderToRemote(provider, false);
+        return packedSize;
       }
-      
+
       //-----------------------------------------------------------------------
-      void RemoteEventing::onRemoteEventingProviderLoggingStateChanged(
-                                                                       ProviderInfo *provider,
-                                                                       KeywordBitmaskType keywords
-                                                                       )
+      static void packEvent(
+                            BYTE *pos,
+                            size_t packedSize,
+                            const IRemoteEventingTypes::EventOrigin &origin,
+                            Log::ProviderHandle handle,
+                            Log::Severity severity,
+                            Log::Level level,
+                            EVENT_DESCRIPTOR_HANDLE descriptor,
+                            EVENT_PARAMETER_DESCRIPTOR_HANDLE parameterDescriptor,
+                            EVENT_DATA_DESCRIPTOR_HANDLE dataDescriptor,
+                            size_t dataDescriptorCount,
+                            size_t maxDataSize
+                            )
       {
-        AutoRecursiveLock lock(mLock);
+        putBE32(pos, static_cast<uint32_t>(packedSize));
+        putBE32(pos, static_cast<uint32_t>(RemoteEventing::MessageType_TraceEvent));
 
-        auto found = mLocalAnnouncedProviders.find(provider->mProviderID);
-        if (found != mLocalAnnouncedProviders.end()) {
-          if (isAuthorized()) {
-            announceProviderLoggingStateChangedToRemote(provider, keywords);
-          }
-          return;
-        }
+        // the timestamp is in raw clock units until converted on the sending thread
+        putBE64(pos, origin.mTimestamp);
+        putBE64(pos, origin.mThreadID);
+        putBE32(pos, origin.mCPU);
 
-        if (!isAuthorized()) {
-          mRequestRemoteProviderKeywordLevel[provider->mProviderName] = keywords;
-          return;
+        putBE64(pos, static_cast<uint64_t>(handle));
+
+        putBE16(pos, static_cast<uint16_t>(severity));
+        putBE16(pos, static_cast<uint16_t>(level));
+        putBE16(pos, descriptor->Id);
+        *pos = descriptor->Version; ++pos;
+        *pos = descriptor->Channel; ++pos;
+        *pos = descriptor->Level; ++pos;
+        *pos = descriptor->Opcode; ++pos;
+        putBE16(pos, descriptor->Task);
+        putBE64(pos, descriptor->Keyword);
+
+        putBE16(pos, static_cast<uint16_t>(dataDescriptorCount));
+
+        for (size_t index = 0; index < dataDescriptorCount; ++index) {
+          putBE16(pos, static_cast<uint16_t>(parameterDescriptor[index].Type));
         }
 
-        bool requested = false;
-        for (auto iter = mRemoteRegisteredProvidersByUUID.begin(); iter != mRemoteRegisteredProvidersByUUID.end(); ++iter) {
-          auto checkProvider = (*iter).second;
-          if (provider->mProviderName == checkProvider->mProviderName) {
-            requestSetRemoteEventProviderLogging(provider->mProviderName, keywords);
-            requested = true;
+        for (size_t index = 0; index < dataDescriptorCount; ++index) {
+          auto &data = dataDescriptor[index];
+
+          if (!data.Ptr) {
+            putBE32(pos, 0);
+            continue;
           }
-        }
-        
-        if (!requested) {
-          mRequestRemoteProviderKeywordLevel[provider->mProviderName] = keywords;
-          return;
+
+          uint32_t dataSize = static_cast<uint32_t>(data.Size > maxDataSize ? maxDataSize : data.Size);
+
+          bool endianFlip {true};
+
+          switch (parameterDescriptor[index].Type) {
+            case EventParameterType_Boolean:
+            case EventParameterType_UnsignedInteger:
+            case EventParameterType_SignedInteger:
+            case EventParameterType_Pointer:
+            case EventParameterType_FloatingPoint:  break;
+            default:                                endianFlip = false; break;
+          }
+
+          // scalars are flagged and kept in host byte order; the socket thread
+          // converts them only for a remote party expecting big endian
+          putBE32(pos, endianFlip ? (dataSize | ZSLIB_EVENTING_REMOTE_EVENTING_SCALAR_FLAG) : dataSize);
+
+          memcpy(pos, (const void *)(data.Ptr), dataSize);
+          pos += dataSize;
         }
       }
       
       //-----------------------------------------------------------------------
-      void RemoteEventing::onRemoteEventingWriteEvent(
-                                                      ByteQueuePtr message,
-                                                      size_t currentSize
-                                                      )
-      {
-        --mOutstandingEvents;
-        mEventDataInAsyncQueue -= currentSize;
-        
-        if (mEventDataInOutgoingQueue + currentSize > mMaxQueuedOutgoingDataBeforeEventsDropped) {
-          ++mTotalDroppedEvents;
-          ZS_LOG_WARNING(Trace, log("too much data in outgoing queue (event dropped)"));
-          return;
-        }
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RemoteEventing (types)
+      #pragma mark
 
-        AutoRecursiveLock lock(mLock);
-        if (!isAuthorized()) {
-          ++mTotalDroppedEvents;
-          ZS_LOG_WARNING(Insane, log("ignoring event as not in authorized connection state (event dropped)"));
-          return;
+      //-----------------------------------------------------------------------
+      const char *RemoteEventing::toString(MessageTypes messageType)
+      {
+        switch (messageType)
+        {
+          case MessageType_Hello:           return "Hello";
+          case MessageType_Welcome:         return "Welcome";
+          case MessageType_Challenge:       return "Challenge";
+          case MessageType_ChallengeReply:  return "Challenge reply";
+          case MessageType_Goodbye:         return "Goodbye";
+          case MessageType_Notify:          return "Notify";
+          case MessageType_SessionDelta:    return "Session delta";
+          case MessageType_Request:         return "Request";
+          case MessageType_RequestAck:      return "Request ack";
+          case MessageType_TraceEvent:      return "Trace event";
+          case MessageType_TraceEventBatch: return "Trace event batch";
+          case MessageType_TraceEventCompact: return "Trace event compact";
+          case MessageType_TraceEventBacklog: return "Trace event backlog";
         }
-
-        mEventDataInOutgoingQueue += currentSize;
-        message->TransferTo(mOutgoingQueue);
-
-        if (mWriteReady) {
-          sendOutgoingData();
+        
+        return "unknown";
+      }
+      
+      //-----------------------------------------------------------------------
+      RemoteEventing::MessageTypes RemoteEventing::toMessageType(const char *messageType) throw (InvalidArgument)
+      {
+        String str(messageType);
+        for (RemoteEventing::MessageTypes index = RemoteEventing::MessageType_First; index <= RemoteEventing::MessageType_Last; index = static_cast<RemoteEventing::MessageTypes>(static_cast<std::underlying_type<RemoteEventing::MessageTypes>::type>(index) + 1)) {
+          if (0 == str.compareNoCase(RemoteEventing::toString(index))) return index;
         }
+        
+        ZS_THROW_INVALID_ARGUMENT(String("Not a message type: ") + str);
+        return MessageType_First;
       }
 
       //-----------------------------------------------------------------------
@@ -917,334 +1570,5802 @@ namespace zsLib
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
       #pragma mark
-      #pragma mark RemoteEventing => (internal)
+      #pragma mark RemoteEventing::EventRing
       #pragma mark
 
       //-----------------------------------------------------------------------
-      Log::Params RemoteEventing::slog(const char *message)
+      RemoteEventing::EventRing::EventRing(
+                                           PUID ownerID,
+                                           size_t size
+                                           ) :
+        mOwnerID(ownerID),
+        mBuffer(size)
       {
-        return Log::Params(message, "eventing::RemoteEventing");
       }
 
       //-----------------------------------------------------------------------
-      Log::Params RemoteEventing::log(const char *message)
+      BYTE *RemoteEventing::EventRing::reserve(
+                                               size_t messageSize,
+                                               size_t &outHead
+                                               )
       {
-        ElementPtr objectEl = Element::create("eventing::RemoteEventing");
-        objectEl->adoptAsLastChild(UseEventingHelper::createElementWithNumber("id", string(mID)));
-        return Log::Params(message, objectEl);
+        size_t capacity = mBuffer.SizeInBytes();
+        size_t head = mHead.load(std::memory_order_relaxed);
+        size_t tail = mTail.load(std::memory_order_acquire);
+
+        size_t offset = head % capacity;
+        size_t contiguous = capacity - offset;
+        size_t skip = (contiguous < messageSize ? contiguous : 0);
+
+        if (capacity - (head - tail) < skip + messageSize) return NULL;
+
+        BYTE *buffer = mBuffer.BytePtr();
+        if (0 != skip) {
+          if (contiguous >= sizeof(CryptoPP::word32)) {
+            BYTE *marker = buffer + offset;
+            putBE32(marker, ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_RING_WRAP_MARKER);
+          }
+          offset = 0;
+        }
+
+        outHead = head + skip + messageSize;
+        return buffer + offset;
       }
 
       //-----------------------------------------------------------------------
-      void RemoteEventing::disconnect()
+      void RemoteEventing::EventRing::commit(size_t head)
       {
-        auto pThis = mThisWeak.lock();
-        if (!pThis) {
-          ZS_LOG_WARNING(Detail, log("disconnect as pThis is null (shutting down)"));
-          cancel();
-          return;
-        }
-        
-        IRemoteEventingAsyncDelegateProxy::create(pThis)->onRemoteEventingUnsubscribeLogger();
-        
-        if (!isListeningMode()) {
-          ZS_LOG_DEBUG(log("disconnecting forwarding to cancel"));
-          cancel();
-          return;
-        }
-
-        if (isShuttingDown()) {
-          ZS_LOG_TRACE(log("disconnect forwarding to shutdown"));
-          cancel();
-          return;
-        }
+        // sequentially consistent to pair with mEventRingDrainPending
+        mHead.store(head);
+      }
 
-        if (mAcceptedSocket) {
-          if (MessageType_Welcome == mHandshakeState) {
-            sendData(MessageType_Goodbye, SecureByteBlock());
-            mHandshakeState = MessageType_Goodbye;
-          }
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RemoteEventing::LocalChannel
+      #pragma mark
 
-          ZS_LOG_TRACE(log("disconnecting accepted socket"));
-          try {
-            mAcceptedSocket->close();
-          } catch (const Socket::Exceptions::Unspecified &) {
-            ZS_LOG_WARNING(Debug, log("could not read active socket"));
-          }
-          mAcceptedSocket.reset();
-        }
+      //-----------------------------------------------------------------------
+      RemoteEventing::LocalChannelPtr RemoteEventing::LocalChannel::create(
+                                                                         const String &name,
+                                                                         size_t ringSize
+                                                                         )
+      {
+#ifdef ZSLIB_EVENTING_REMOTE_EVENTING_NO_LOCAL_CHANNEL
+        return LocalChannelPtr();
+#else
+        auto pThis = make_shared<LocalChannel>();
+        pThis->mName = getLocalChannelName(name);
+        pThis->mSide = 0;
+        pThis->mRingSize = ringSize;
+        pThis->mMappingSize = sizeof(LocalChannelLayout) + (ringSize * 2);
+
+#ifdef _WIN32
+        uint64_t mappingSize = static_cast<uint64_t>(pThis->mMappingSize);
+        HANDLE handle = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, static_cast<DWORD>(mappingSize >> 32), static_cast<DWORD>(mappingSize & 0xFFFFFFFF), pThis->mName.c_str());
+        if (NULL == handle) return LocalChannelPtr();
+        if (ERROR_ALREADY_EXISTS == GetLastError()) {
+          // another listener owns the name
+          CloseHandle(handle);
+          return LocalChannelPtr();
+        }
+        pThis->mMappingHandle = handle;
+        pThis->mMapping = MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, pThis->mMappingSize);
+        if (NULL == pThis->mMapping) return LocalChannelPtr();
+#else
+        pThis->mDescriptor = shm_open(pThis->mName.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+        if ((pThis->mDescriptor < 0) &&
+            (EEXIST == errno)) {
+          // a segment left behind by a listener that did not exit cleanly
+          // would otherwise block the name forever; like on Windows a live
+          // listener keeps its name
+          if (!isStaleLocalChannel(pThis->mName)) return LocalChannelPtr();
+
+          shm_unlink(pThis->mName.c_str());
+          pThis->mDescriptor = shm_open(pThis->mName.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+        }
+        if (pThis->mDescriptor < 0) return LocalChannelPtr();
+        pThis->mLinked = true;
+
+        if (0 != ftruncate(pThis->mDescriptor, static_cast<off_t>(pThis->mMappingSize))) return LocalChannelPtr();
+
+        void *mapping = mmap(NULL, pThis->mMappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, pThis->mDescriptor, 0);
+        if (MAP_FAILED == mapping) return LocalChannelPtr();
+        pThis->mMapping = mapping;
+#endif //_WIN32
+
+        auto layout = new (pThis->mMapping) LocalChannelLayout();
+        layout->mVersion = ZSLIB_EVENTING_REMOTE_EVENTING_LOCAL_CHANNEL_VERSION;
+        layout->mRingSize = static_cast<uint64_t>(ringSize);
+        layout->mSides[0].mProcessID = getCurrentProcessNumericID();
+        layout->mSides[0].mAttached = ZSLIB_EVENTING_REMOTE_EVENTING_LOCAL_CHANNEL_ATTACHED;
+        layout->mMagic.store(ZSLIB_EVENTING_REMOTE_EVENTING_LOCAL_CHANNEL_MAGIC, std::memory_order_release);
+
+        pThis->mOpen = true;
+        return pThis;
+#endif //ZSLIB_EVENTING_REMOTE_EVENTING_NO_LOCAL_CHANNEL
+      }
 
-        prepareNewConnection();
+      //-----------------------------------------------------------------------
+      RemoteEventing::LocalChannelPtr RemoteEventing::LocalChannel::attach(const String &name)
+      {
+#ifdef ZSLIB_EVENTING_REMOTE_EVENTING_NO_LOCAL_CHANNEL
+        return LocalChannelPtr();
+#else
+        auto pThis = make_shared<LocalChannel>();
+        pThis->mName = getLocalChannelName(name);
+        pThis->mSide = 1;
+
+#ifdef _WIN32
+        HANDLE handle = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, pThis->mName.c_str());
+        if (NULL == handle) return LocalChannelPtr();
+        pThis->mMappingHandle = handle;
+        pThis->mMapping = MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+        if (NULL == pThis->mMapping) return LocalChannelPtr();
+
+        MEMORY_BASIC_INFORMATION info {};
+        if (0 == VirtualQuery(pThis->mMapping, &info, sizeof(info))) return LocalChannelPtr();
+        pThis->mMappingSize = static_cast<size_t>(info.RegionSize);
+#else
+        pThis->mDescriptor = shm_open(pThis->mName.c_str(), O_RDWR, 0);
+        if (pThis->mDescriptor < 0) return LocalChannelPtr();
+
+        struct stat info {};
+        if (0 != fstat(pThis->mDescriptor, &info)) return LocalChannelPtr();
+        if (static_cast<size_t>(info.st_size) < sizeof(LocalChannelLayout)) return LocalChannelPtr();
+
+        void *mapping = mmap(NULL, static_cast<size_t>(info.st_size), PROT_READ | PROT_WRITE, MAP_SHARED, pThis->mDescriptor, 0);
+        if (MAP_FAILED == mapping) return LocalChannelPtr();
+        pThis->mMapping = mapping;
+        pThis->mMappingSize = static_cast<size_t>(info.st_size);
+#endif //_WIN32
+
+        auto layout = getLocalChannelLayout(pThis->mMapping);
+        if (ZSLIB_EVENTING_REMOTE_EVENTING_LOCAL_CHANNEL_MAGIC != layout->mMagic.load(std::memory_order_acquire)) return LocalChannelPtr();
+        if (ZSLIB_EVENTING_REMOTE_EVENTING_LOCAL_CHANNEL_VERSION != layout->mVersion) return LocalChannelPtr();
+
+        // the ring size is kept locally as the segment is writable by the peer
+        uint64_t ringSize = layout->mRingSize;
+        if (0 == ringSize) return LocalChannelPtr();
+        if (ringSize > static_cast<uint64_t>((pThis->mMappingSize - sizeof(LocalChannelLayout)) / 2)) return LocalChannelPtr();
+        pThis->mRingSize = static_cast<size_t>(ringSize);
+
+        if (!isProcessAlive(layout->mSides[0].mProcessID)) return LocalChannelPtr();
+
+        // only a single party may ever attach to a channel
+        uint32_t expected = 0;
+        auto &side = layout->mSides[1];
+        if (!side.mAttached.compare_exchange_strong(expected, ZSLIB_EVENTING_REMOTE_EVENTING_LOCAL_CHANNEL_CLAIMED)) return LocalChannelPtr();
+        side.mProcessID = getCurrentProcessNumericID();
+        side.mAttached = ZSLIB_EVENTING_REMOTE_EVENTING_LOCAL_CHANNEL_ATTACHED;
+
+        pThis->mOpen = true;
+        ringLocalChannelDoorbell(layout->mSides[0]);
+        return pThis;
+#endif //ZSLIB_EVENTING_REMOTE_EVENTING_NO_LOCAL_CHANNEL
       }
-      
+
       //-----------------------------------------------------------------------
-      void RemoteEventing::cancel()
+      RemoteEventing::LocalChannel::~LocalChannel()
       {
-        ZS_LOG_TRACE(log("cancel called"));
-        
-        if (isShutdown()) {
-          ZS_LOG_TRACE(log("already shutdown"));
-          return;
-        }
-        
-        setState(State_ShuttingDown);
-        
-        for (auto iter = mRemoteRegisteredProvidersByUUID.begin(); iter != mRemoteRegisteredProvidersByUUID.end(); ++iter) {
-          auto provider = (*iter).second;
-          Log::setEventingLogging(provider->mHandle, mID, false);
-          Log::unregisterEventingWriter(provider->mHandle);
-        }
-        
-        mRemoteRegisteredProvidersByUUID.clear();
-        mRemoteRegisteredProvidersByRemoteHandle.clear();
+        close();
+
+#ifndef ZSLIB_EVENTING_REMOTE_EVENTING_NO_LOCAL_CHANNEL
+#ifdef _WIN32
+        if (mMapping) UnmapViewOfFile(mMapping);
+        if (mMappingHandle) CloseHandle(reinterpret_cast<HANDLE>(mMappingHandle));
+#else
+        if (mMapping) munmap(mMapping, mMappingSize);
+        if (mDescriptor >= 0) ::close(mDescriptor);
+#endif //_WIN32
+#endif //ndef ZSLIB_EVENTING_REMOTE_EVENTING_NO_LOCAL_CHANNEL
+        mMapping = NULL;
+        mMappingHandle = NULL;
+        mDescriptor = -1;
+
+        unlink();
+      }
 
-        auto pThis = mThisWeak.lock();
-        mGracefulShutdownReference = pThis;
+      //-----------------------------------------------------------------------
+      void RemoteEventing::LocalChannel::startWaiter(IRemoteEventingAsyncDelegatePtr delegate)
+      {
+        mDelegate = delegate;
+        mWaiter = std::thread([this]() { waitLoop(); });
+      }
 
-        if (mGracefulShutdownReference) {
-          IRemoteEventingAsyncDelegateProxy::create(pThis)->onRemoteEventingUnsubscribeLogger();
+      //-----------------------------------------------------------------------
+      void RemoteEventing::LocalChannel::close()
+      {
+        if (!mMapping) return;
 
-          if (MessageType_Welcome == mHandshakeState) {
-            sendData(MessageType_Goodbye, SecureByteBlock());
-            mHandshakeState = MessageType_Goodbye;
-          }
+        auto layout = getLocalChannelLayout(mMapping);
 
-          if (mOutgoingQueue.AnyRetrievable()) {
-            auto activeSocket = getActiveSocket();
-            if (activeSocket) {
-              ZS_LOG_TRACE(log("waiting until shutdown"));
-              return;
-            }
-          }
+        if (mWaiter.joinable()) {
+          mStop = true;
+          ringLocalChannelDoorbell(layout->mSides[mSide]);
+          mWaiter.join();
         }
-        
-        resetConnection();
 
-        try {
-          if (mAcceptedSocket) mAcceptedSocket->close();
-        } catch (const Socket::Exceptions::Unspecified &) {
-          ZS_LOG_WARNING(Debug, log("failed to close accepted socket"));
-        }
-        try {
-          if (mBindSocket) mBindSocket->close();
-        } catch (const Socket::Exceptions::Unspecified &) {
-          ZS_LOG_WARNING(Debug, log("failed to close bind socket"));
-        }
-        try {
-          if (mConnectSocket) mConnectSocket->close();
-        } catch (const Socket::Exceptions::Unspecified &) {
-          ZS_LOG_WARNING(Debug, log("failed to close connect socket"));
-        }
-        
-        mAcceptedSocket.reset();
-        mBindSocket.reset();
-        mConnectSocket.reset();
+        // a channel that never finished opening must not touch the sides
+        if (!mOpen) return;
+        mOpen = false;
 
-        if (mRebindTimer) {
-          mRebindTimer->cancel();
-          mRebindTimer.reset();
-        }
-        
-        setState(State_Shutdown);
-        
-        mGracefulShutdownReference.reset();
+        layout->mSides[mSide].mClosed = 1;
+        ringLocalChannelDoorbell(layout->mSides[1 - mSide]);
       }
 
       //-----------------------------------------------------------------------
-      void RemoteEventing::step()
+      void RemoteEventing::LocalChannel::unlink()
       {
-        ZS_LOG_DEBUG(log("step"));
-        
-        if ((isShuttingDown()) ||
-            (isShutdown())) {
-          ZS_LOG_TRACE(log("step forwarding to cancel"));
-          return;
-        }
-        
-        {
-          if (isListeningMode()) {
-            if (!stepSocketBind()) return;
-            if (!stepWaitForAccept()) return;
-          } else {
-            if (!stepSocketConnect()) return;
-            if (!stepWaitConnected()) return;
-            if (!stepHello()) return;
-          }
-          if (!stepNotifyTimer()) return;
-          if (!stepAuthorized()) return;
-        }
+        if (!mLinked) return;
+        mLinked = false;
 
-        setState(State_Connected);
+#if !defined(_WIN32) && !defined(ZSLIB_EVENTING_REMOTE_EVENTING_NO_LOCAL_CHANNEL)
+        shm_unlink(mName.c_str());
+#endif //!defined(_WIN32) && !defined(ZSLIB_EVENTING_REMOTE_EVENTING_NO_LOCAL_CHANNEL)
       }
 
       //-----------------------------------------------------------------------
-      bool RemoteEventing::stepSocketBind()
+      bool RemoteEventing::LocalChannel::isPeerAttached() const
       {
-        if (mBindSocket) {
-          ZS_LOG_TRACE(log("step - already bound"));
-          return true;
-        }
-        
-        if (mRebindTimer) {
-          ZS_LOG_TRACE(log("step - waiting for rebind timer"));
-          return true;
-        }
-        
-        ZS_LOG_DEBUG(log("step - attempting to bind"));
-        
-        IPAddress bindIP(mUseIPv6 ? IPAddress::anyV6() : IPAddress::anyV4(), mListenPort);
+        auto layout = getLocalChannelLayout(mMapping);
+        return ZSLIB_EVENTING_REMOTE_EVENTING_LOCAL_CHANNEL_ATTACHED == layout->mSides[1 - mSide].mAttached.load();
+      }
 
-        if (Time() == mBindFailureTime) {
-          mBindFailureTime = zsLib::now() + mMaxWaitToBindTime;
-        }
+      //-----------------------------------------------------------------------
+      size_t RemoteEventing::LocalChannel::receive(
+                                                   BYTE *buffer,
+                                                   size_t size
+                                                   )
+      {
+        if (mFailed) return 0;
 
-        try {
-          mBindSocket = Socket::createTCP(mUseIPv6 ? Socket::Create::Family::IPv6 : Socket::Create::Family::IPv4);
-          mBindSocket->setBlocking(false);
-          mBindSocket->setDelegate(mThisWeak.lock());
-          mBindSocket->bind(bindIP);
-          mBindSocket->listen();
-        } catch (const Socket::Exceptions::Unspecified &) {
-          auto tick = zsLib::now();
-          if (tick > mBindFailureTime) {
-            ZS_LOG_ERROR(Detail, log("failed to bind to socket") + ZS_PARAM("port", string(mListenPort)));
-            cancel();
-            return false;
-          }
-          
-          ZS_LOG_WARNING(Debug, log("failed to bind (will attempt again in 1 second)"));
-          mRebindTimer = ITimer::create(mThisWeak.lock(), Seconds(1), false);
-          try {
-            if (mBindSocket) mBindSocket->close();
-          } catch (const Socket::Exceptions::Unspecified &) {
-            ZS_LOG_WARNING(Debug, log("failed to close listen socket"));
-          }
-          mBindSocket.reset();
-          return false;
+        auto layout = getLocalChannelLayout(mMapping);
+        auto &ring = layout->mRings[1 - mSide];
+        size_t ringSize = mRingSize;
+
+        uint64_t tail = ring.mTail.load(std::memory_order_relaxed);
+        uint64_t head = ring.mHead.load(std::memory_order_acquire);
+
+        // the peer can never have written more than the ring holds
+        uint64_t used = head - tail;
+        if (used > static_cast<uint64_t>(ringSize)) {
+          mFailed = true;
+          return 0;
         }
 
-        mBindFailureTime = Time();
+        size_t available = static_cast<size_t>(used);
+        if (available > size) available = size;
+        if (0 == available) return 0;
 
-        setState(State_Listening);
-        return true;
+        const BYTE *data = getLocalChannelRingData(layout, ringSize, 1 - mSide);
+        size_t offset = static_cast<size_t>(tail % ringSize);
+        size_t contiguous = ringSize - offset;
+        if (contiguous > available) contiguous = available;
+
+        memcpy(buffer, data + offset, contiguous);
+        if (available > contiguous) memcpy(buffer + contiguous, data, available - contiguous);
+
+        // sequentially consistent to pair with the peer arming write ready
+        ring.mTail.store(tail + available);
+
+        auto &peer = layout->mSides[1 - mSide];
+        if (0 != peer.mWriteArmed.load()) ringLocalChannelDoorbell(peer);
+        return available;
       }
-      
+
       //-----------------------------------------------------------------------
-      bool RemoteEventing::stepWaitForAccept()
+      size_t RemoteEventing::LocalChannel::send(
+                                                const BYTE *data,
+                                                size_t size
+                                                )
       {
-        if (!mAcceptedSocket) {
-          ZS_LOG_TRACE(log("step - waiting for socket to accept"));
-          return false;
+        if (mFailed) return 0;
+
+        auto layout = getLocalChannelLayout(mMapping);
+        auto &ring = layout->mRings[mSide];
+        size_t ringSize = mRingSize;
+
+        uint64_t head = ring.mHead.load(std::memory_order_relaxed);
+        uint64_t tail = ring.mTail.load(std::memory_order_acquire);
+
+        // the peer can never have read more than was written
+        uint64_t used = head - tail;
+        if (used > static_cast<uint64_t>(ringSize)) {
+          mFailed = true;
+          return 0;
         }
-        
-        ZS_LOG_TRACE(log("step - have accepted socket"));
-        return true;
+
+        size_t space = ringSize - static_cast<size_t>(used);
+        if (space > size) space = size;
+        if (0 == space) return 0;
+
+        BYTE *buffer = getLocalChannelRingData(layout, ringSize, mSide);
+        size_t offset = static_cast<size_t>(head % ringSize);
+        size_t contiguous = ringSize - offset;
+        if (contiguous > space) contiguous = space;
+
+        memcpy(buffer + offset, data, contiguous);
+        if (space > contiguous) memcpy(buffer, data + contiguous, space - contiguous);
+
+        // sequentially consistent to pair with the peer arming read ready
+        ring.mHead.store(head + space);
+
+        auto &peer = layout->mSides[1 - mSide];
+        if (0 != peer.mReadArmed.load()) ringLocalChannelDoorbell(peer);
+        return space;
       }
-      
+
       //-----------------------------------------------------------------------
-      bool RemoteEventing::stepSocketConnect()
+      bool RemoteEventing::LocalChannel::armRead()
       {
-        if (mConnectSocket) {
-          ZS_LOG_TRACE(log("step - already have a socket connecting"));
-          return true;
-        }
-        
-        ZS_LOG_DEBUG(log("conencting"));
+        auto layout = getLocalChannelLayout(mMapping);
+        auto &self = layout->mSides[mSide];
+        auto &ring = layout->mRings[1 - mSide];
 
-        try {
-          mConnectSocket = Socket::createTCP(mServerIP.isIPv4() ? Socket::Create::Family::IPv4 : Socket::Create::Family::IPv6);
-          mConnectSocket->setBlocking(false);
-          mConnectSocket->setDelegate(mThisWeak.lock());
-          bool wouldBlock = false;
-          mConnectSocket->connect(mServerIP, &wouldBlock);
-        } catch (const Socket::Exceptions::Unspecified &) {
-          ZS_LOG_WARNING(Detail, log("failed to connect (shutting down)"));
-          disconnect();
-          return false;
-        }
-        
-        setState(State_Connecting);
+        self.mReadArmed.store(1);
+        if (ring.mHead.load() == ring.mTail.load()) return true;
 
-        return true;
+        // data arrived while arming; the notification only remains armed if
+        // the waiter already claimed it
+        return 0 == self.mReadArmed.exchange(0);
       }
 
       //-----------------------------------------------------------------------
-      bool RemoteEventing::stepWaitConnected()
+      bool RemoteEventing::LocalChannel::armWrite()
       {
-        if (!mConnected) {
-          ZS_LOG_TRACE(log("step waiting to connect"));
-          return false;
-        }
-        
-        ZS_LOG_TRACE(log("step - connected"));
-        return true;
+        auto layout = getLocalChannelLayout(mMapping);
+        auto &self = layout->mSides[mSide];
+        auto &ring = layout->mRings[mSide];
+
+        self.mWriteArmed.store(1);
+        if (ring.mHead.load() - ring.mTail.load() >= mRingSize) return true;
+
+        // space was freed while arming; the notification only remains armed
+        // if the waiter already claimed it
+        return 0 == self.mWriteArmed.exchange(0);
       }
-      
+
       //-----------------------------------------------------------------------
-      bool RemoteEventing::stepHello()
+      void RemoteEventing::LocalChannel::waitLoop()
       {
-        if (MessageType_Hello != mHandshakeState) {
-          ZS_LOG_TRACE(log("step - skipping hello"));
-          return true;
-        }
-
-        ElementPtr rootEl = Element::create("hello");
+        auto layout = getLocalChannelLayout(mMapping);
+        auto &self = layout->mSides[mSide];
+        auto &peer = layout->mSides[1 - mSide];
+        auto &incoming = layout->mRings[1 - mSide];
+        auto &outgoing = layout->mRings[mSide];
 
-        mHelloSalt = IHelper::randomString(IHasher::sha256DigestSize()*8/5);
-        rootEl->adoptAsFirstChild(IHelper::createElementWithNumber("version", "1"));
-        rootEl->adoptAsFirstChild(IHelper::createElementWithText("salt", mHelloSalt));
+        bool attached = false;
+        auto lastAliveCheck = std::chrono::steady_clock::now();
 
-        String helloProof = IHasher::hashAsString("hello:proof:" + mSharedSecret + ":" + mHelloSalt, IHasher::sha256());
-        rootEl->adoptAsFirstChild(IHelper::createElementWithText("proof", helloProof));
+        try {
+          while (true) {
+            // snapshot before testing conditions so no ring is ever missed
+            uint32_t doorbell = self.mDoorbell.load();
+            if (mStop) return;
+
+            bool readReady = false;
+            bool writeReady = false;
+
+            if (!attached) {
+              if (isPeerAttached()) {
+                attached = true;
+                readReady = true;
+              }
+            } else if (0 != peer.mClosed.load()) {
+              mDelegate->onRemoteEventingLocalChannelClosed(mID);
+              return;
+            }
+
+            if ((0 != self.mReadArmed.load()) &&
+                (incoming.mHead.load() != incoming.mTail.load())) {
+              if (0 != self.mReadArmed.exchange(0)) readReady = true;
+            }
+            if ((0 != self.mWriteArmed.load()) &&
+                (outgoing.mHead.load() - outgoing.mTail.load() < mRingSize)) {
+              if (0 != self.mWriteArmed.exchange(0)) writeReady = true;
+            }
+
+            if (readReady) mDelegate->onRemoteEventingLocalChannelReadReady(mID);
+            if (writeReady) mDelegate->onRemoteEventingLocalChannelWriteReady(mID);
+            if ((readReady) || (writeReady)) continue;
+
+            self.mWaiting.store(1);
+            waitLocalChannelDoorbell(self, doorbell);
+            self.mWaiting.store(0);
+
+            if (doorbell != self.mDoorbell.load()) continue;
+            if (!attached) continue;
+
+            // quiet; notice a local party that exited without closing
+            auto now = std::chrono::steady_clock::now();
+            if (now - lastAliveCheck < Milliseconds(ZSLIB_EVENTING_REMOTE_EVENTING_LOCAL_CHANNEL_WAIT_MILLISECONDS)) continue;
+            lastAliveCheck = now;
+
+            if (!isProcessAlive(peer.mProcessID.load())) {
+              mDelegate->onRemoteEventingLocalChannelClosed(mID);
+              return;
+            }
+          }
+        } catch (const IRemoteEventingAsyncDelegateProxy::Exceptions::DelegateGone &) {
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RemoteEventing::EventSpool
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      RemoteEventing::EventSpoolPtr RemoteEventing::EventSpool::open(
+                                                                    const String &path,
+                                                                    size_t size
+                                                                    )
+      {
+#ifdef ZSLIB_EVENTING_REMOTE_EVENTING_NO_SPOOL
+        return EventSpoolPtr();
+#else
+        auto pThis = make_shared<EventSpool>();
+        pThis->mPath = path;
+        pThis->mCapacity = size;
+        pThis->mMappingSize = sizeof(EventSpoolLayout) + size;
+
+        // provider handles are only meaningful to the process which spooled
+        // the events so a spool left behind by a previous run is discarded
+#ifdef _WIN32
+        uint64_t mappingSize = static_cast<uint64_t>(pThis->mMappingSize);
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, NULL);
+        if (INVALID_HANDLE_VALUE == file) return EventSpoolPtr();
+        pThis->mFileHandle = file;
+
+        HANDLE handle = CreateFileMappingA(file, NULL, PAGE_READWRITE, static_cast<DWORD>(mappingSize >> 32), static_cast<DWORD>(mappingSize & 0xFFFFFFFF), NULL);
+        if (NULL == handle) return EventSpoolPtr();
+        pThis->mMappingHandle = handle;
+        pThis->mMapping = MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, pThis->mMappingSize);
+        if (NULL == pThis->mMapping) return EventSpoolPtr();
+#else
+        pThis->mDescriptor = ::open(path.c_str(), O_CREAT | O_TRUNC | O_RDWR, S_IRUSR | S_IWUSR);
+        if (pThis->mDescriptor < 0) return EventSpoolPtr();
+
+        if (0 != ftruncate(pThis->mDescriptor, static_cast<off_t>(pThis->mMappingSize))) return EventSpoolPtr();
+
+        void *mapping = mmap(NULL, pThis->mMappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, pThis->mDescriptor, 0);
+        if (MAP_FAILED == mapping) return EventSpoolPtr();
+        pThis->mMapping = mapping;
+#endif //_WIN32
+
+        auto layout = new (pThis->mMapping) EventSpoolLayout();
+        layout->mMagic = ZSLIB_EVENTING_REMOTE_EVENTING_SPOOL_MAGIC;
+        layout->mVersion = ZSLIB_EVENTING_REMOTE_EVENTING_SPOOL_VERSION;
+        layout->mCapacity = static_cast<uint64_t>(size);
+
+        pThis->mData = reinterpret_cast<BYTE *>(pThis->mMapping) + sizeof(EventSpoolLayout);
+        return pThis;
+#endif //ZSLIB_EVENTING_REMOTE_EVENTING_NO_SPOOL
+      }
+
+      //-----------------------------------------------------------------------
+      RemoteEventing::EventSpool::~EventSpool()
+      {
+#ifndef ZSLIB_EVENTING_REMOTE_EVENTING_NO_SPOOL
+#ifdef _WIN32
+        if (mMapping) UnmapViewOfFile(mMapping);
+        if (mMappingHandle) CloseHandle(reinterpret_cast<HANDLE>(mMappingHandle));
+        if (mFileHandle) CloseHandle(reinterpret_cast<HANDLE>(mFileHandle));
+#else
+        if (mMapping) munmap(mMapping, mMappingSize);
+        if (mDescriptor >= 0) {
+          ::close(mDescriptor);
+          ::unlink(mPath.c_str());
+        }
+#endif //_WIN32
+#endif //ndef ZSLIB_EVENTING_REMOTE_EVENTING_NO_SPOOL
+        mMapping = NULL;
+        mMappingHandle = NULL;
+        mFileHandle = NULL;
+        mDescriptor = -1;
+        mData = NULL;
+      }
+
+      //-----------------------------------------------------------------------
+      bool RemoteEventing::EventSpool::append(
+                                             const BYTE *message,
+                                             size_t messageSize,
+                                             size_t &outOverwrittenEvents
+                                             )
+      {
+        outOverwrittenEvents = 0;
+        if (messageSize + sizeof(CryptoPP::word32) > mCapacity) return false;
+
+        auto layout = getEventSpoolLayout(*this);
+
+        uint64_t head = layout->mHead;
+        size_t offset = static_cast<size_t>(head % mCapacity);
+        size_t contiguous = mCapacity - offset;
+        size_t skip = (contiguous < messageSize ? contiguous : 0);
+
+        // the oldest events make room for the newest
+        while ((head + skip + messageSize) - layout->mTail > mCapacity) {
+          size_t oldestSize = getOldestSpoolMessage(*this);
+          if (0 == oldestSize) break;
+          layout->mTail += oldestSize;
+          ++outOverwrittenEvents;
+        }
+
+        if (0 != skip) {
+          if (contiguous >= sizeof(CryptoPP::word32)) {
+            BYTE *pos = mData + offset;
+            putBE32(pos, ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_RING_WRAP_MARKER);
+          }
+          head += skip;
+        }
+
+        memcpy(mData + static_cast<size_t>(head % mCapacity), message, messageSize);
+        layout->mHead = head + messageSize;
+        return true;
+      }
+
+      //-----------------------------------------------------------------------
+      const BYTE *RemoteEventing::EventSpool::peek(size_t &outMessageSize)
+      {
+        outMessageSize = getOldestSpoolMessage(*this);
+        if (0 == outMessageSize) return NULL;
+
+        auto layout = getEventSpoolLayout(*this);
+        return mData + static_cast<size_t>(layout->mTail % mCapacity);
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::EventSpool::consume(size_t messageSize)
+      {
+        getEventSpoolLayout(*this)->mTail += messageSize;
+      }
+
+      //-----------------------------------------------------------------------
+      bool RemoteEventing::EventSpool::isEmpty() const
+      {
+        auto layout = getEventSpoolLayout(*this);
+        return layout->mHead == layout->mTail;
+      }
+
+      //-----------------------------------------------------------------------
+      size_t RemoteEventing::EventSpool::getUsedBytes() const
+      {
+        auto layout = getEventSpoolLayout(*this);
+        return static_cast<size_t>(layout->mHead - layout->mTail);
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RemoteEventing::TraceRecorder
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      RemoteEventing::TraceRecorderPtr RemoteEventing::TraceRecorder::open(
+                                                                          const String &path,
+                                                                          ElementPtr headerEl,
+                                                                          size_t bufferSize,
+                                                                          size_t indexIntervalSize,
+                                                                          Milliseconds indexIntervalTime
+                                                                          )
+      {
+        FILE *file = fopen(path.c_str(), "wb");
+        if (!file) return TraceRecorderPtr();
+
+        // the recorder does its own buffering so every write is one large append
+        setvbuf(file, NULL, _IONBF, 0);
+
+        auto pThis = make_shared<TraceRecorder>();
+        pThis->mPath = path;
+        pThis->mFile = file;
+        pThis->mBuffer.CleanNew(bufferSize > 0 ? bufferSize : 1);
+        pThis->mIndexIntervalSize = indexIntervalSize;
+        pThis->mIndexIntervalTime = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(indexIntervalTime).count());
+        pThis->mIndexDue = true;
+        pThis->mStartTime = getMonotonicTimestamp();
+
+        ElementPtr traceEl = Element::create("trace");
+        traceEl->adoptAsLastChild(IHelper::createElementWithNumber("version", string(ZSLIB_EVENTING_REMOTE_EVENTING_TRACE_VERSION)));
+        traceEl->adoptAsLastChild(IHelper::createElementWithNumber("created", string(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count()))));
+        traceEl->adoptAsLastChild(IHelper::createElementWithNumber("littleEndian", isLittleEndianHost() ? "true" : "false"));
+        if (headerEl) traceEl->adoptAsLastChild(headerEl);
+
+        std::string header(IHelper::toString(traceEl));
+
+        BYTE prefix[sizeof(CryptoPP::word32)*3] {};
+        BYTE *pos = &(prefix[0]);
+        putBE32(pos, ZSLIB_EVENTING_REMOTE_EVENTING_TRACE_MAGIC);
+        putBE32(pos, ZSLIB_EVENTING_REMOTE_EVENTING_TRACE_VERSION);
+        putBE32(pos, static_cast<uint32_t>(header.length()));
+
+        AutoLock lock(pThis->mLock);
+        pThis->append(&(prefix[0]), sizeof(prefix));
+        pThis->append(reinterpret_cast<const BYTE *>(header.c_str()), header.length());
+        if (!pThis->mFile) return TraceRecorderPtr();
+        return pThis;
+      }
+
+      //-----------------------------------------------------------------------
+      RemoteEventing::TraceRecorder::~TraceRecorder()
+      {
+        close();
+      }
+
+      //-----------------------------------------------------------------------
+      bool RemoteEventing::TraceRecorder::isOpen() const
+      {
+        AutoLock lock(mLock);
+        return NULL != mFile;
+      }
+
+      //-----------------------------------------------------------------------
+      uint32_t RemoteEventing::TraceRecorder::beginConnection()
+      {
+        AutoLock lock(mLock);
+        uint32_t connectionID = ++mNextConnectionID;
+        mConnections[connectionID] = std::string();
+
+        // decoding from the next index onward needs to know about the connection
+        mIndexDue = true;
+        return connectionID;
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::TraceRecorder::setConnectionState(
+                                                            uint32_t connectionID,
+                                                            const std::string &state
+                                                            )
+      {
+        AutoLock lock(mLock);
+        if (!mFile) return;
+
+        auto found = mConnections.find(connectionID);
+        if (found == mConnections.end()) return;
+        if ((*found).second == state) return;
+        (*found).second = state;
+
+        BYTE prefix[sizeof(CryptoPP::word32)] {};
+        BYTE *pos = &(prefix[0]);
+        putBE32(pos, connectionID);
+        writeRecord(ZSLIB_EVENTING_REMOTE_EVENTING_TRACE_RECORD_CONNECTION, &(prefix[0]), sizeof(prefix), reinterpret_cast<const BYTE *>(state.c_str()), state.length());
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::TraceRecorder::endConnection(uint32_t connectionID)
+      {
+        AutoLock lock(mLock);
+
+        auto found = mConnections.find(connectionID);
+        if (found == mConnections.end()) return;
+        mConnections.erase(found);
+
+        if (!mFile) return;
+
+        BYTE prefix[sizeof(CryptoPP::word32)] {};
+        BYTE *pos = &(prefix[0]);
+        putBE32(pos, connectionID);
+        writeRecord(ZSLIB_EVENTING_REMOTE_EVENTING_TRACE_RECORD_CONNECTION_END, &(prefix[0]), sizeof(prefix), NULL, 0);
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::TraceRecorder::recordFrame(
+                                                     uint32_t connectionID,
+                                                     const BYTE *frame,
+                                                     size_t frameSize
+                                                     )
+      {
+        AutoLock lock(mLock);
+        if (!mFile) return;
+
+        uint64_t now = getMonotonicTimestamp() - mStartTime;
+
+        // the index precedes the frame so its snapshot covers every frame before it
+        if ((mIndexDue) ||
+            ((0 != mIndexIntervalSize) && (mOffset - mLastIndexOffset >= mIndexIntervalSize)) ||
+            ((0 != mIndexIntervalTime) && (now - mLastIndexTime >= mIndexIntervalTime))) {
+          writeIndex(now);
+        }
+
+        BYTE prefix[sizeof(CryptoPP::word32) + sizeof(uint64_t)] {};
+        BYTE *pos = &(prefix[0]);
+        putBE32(pos, connectionID);
+        putBE64(pos, now);
+        writeRecord(ZSLIB_EVENTING_REMOTE_EVENTING_TRACE_RECORD_FRAME, &(prefix[0]), sizeof(prefix), frame, frameSize);
+        ++mFrames;
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::TraceRecorder::close()
+      {
+        AutoLock lock(mLock);
+        if (!mFile) return;
+
+        uint64_t tableOffset = mOffset;
+
+        std::string table;
+        table.resize(sizeof(uint64_t) + (mIndex.size() * sizeof(uint64_t) * 3));
+        BYTE *pos = reinterpret_cast<BYTE *>(&(table[0]));
+        putBE64(pos, static_cast<uint64_t>(mIndex.size()));
+        for (auto iter = mIndex.begin(); iter != mIndex.end(); ++iter) {
+          auto &entry = (*iter);
+          putBE64(pos, entry.mOffset);
+          putBE64(pos, entry.mTime);
+          putBE64(pos, entry.mFrames);
+        }
+        writeRecord(ZSLIB_EVENTING_REMOTE_EVENTING_TRACE_RECORD_INDEX_TABLE, NULL, 0, reinterpret_cast<const BYTE *>(table.c_str()), table.length());
+
+        BYTE trailer[sizeof(uint64_t) + (sizeof(CryptoPP::word32)*2)] {};
+        pos = &(trailer[0]);
+        putBE64(pos, tableOffset);
+        putBE32(pos, ZSLIB_EVENTING_REMOTE_EVENTING_TRACE_TRAILER_MAGIC);
+        putBE32(pos, ZSLIB_EVENTING_REMOTE_EVENTING_TRACE_VERSION);
+        append(&(trailer[0]), sizeof(trailer));
+        flush();
+
+        if (!mFile) return;
+        fclose(mFile);
+        mFile = NULL;
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::TraceRecorder::writeRecord(
+                                                     BYTE recordType,
+                                                     const BYTE *prefix,
+                                                     size_t prefixSize,
+                                                     const BYTE *data,
+                                                     size_t dataSize
+                                                     )
+      {
+        BYTE header[sizeof(CryptoPP::word32) + sizeof(BYTE)] {};
+        BYTE *pos = &(header[0]);
+
+        // record size does include the size of the record type
+        putBE32(pos, static_cast<uint32_t>(sizeof(BYTE) + prefixSize + dataSize));
+        *pos = recordType;
+
+        append(&(header[0]), sizeof(header));
+        if (0 != prefixSize) append(prefix, prefixSize);
+        if (0 != dataSize) append(data, dataSize);
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::TraceRecorder::writeIndex(uint64_t time)
+      {
+        IndexEntry entry;
+        entry.mOffset = mOffset;
+        entry.mTime = time;
+        entry.mFrames = mFrames;
+        mIndex.push_back(entry);
+
+        std::string index;
+        index.resize(sizeof(uint64_t)*2);
+        BYTE *pos = reinterpret_cast<BYTE *>(&(index[0]));
+        putBE64(pos, time);
+        putBE64(pos, mFrames);
+
+        appendSessionVarint(index, mConnections.size());
+        for (auto iter = mConnections.begin(); iter != mConnections.end(); ++iter) {
+          BYTE connectionID[sizeof(CryptoPP::word32)] {};
+          pos = &(connectionID[0]);
+          putBE32(pos, (*iter).first);
+          index.append(reinterpret_cast<const char *>(&(connectionID[0])), sizeof(connectionID));
+          appendSessionVarint(index, (*iter).second.length());
+          index.append((*iter).second);
+        }
+
+        writeRecord(ZSLIB_EVENTING_REMOTE_EVENTING_TRACE_RECORD_INDEX, NULL, 0, reinterpret_cast<const BYTE *>(index.c_str()), index.length());
+
+        mIndexDue = false;
+        mLastIndexTime = time;
+        mLastIndexOffset = entry.mOffset;
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::TraceRecorder::append(
+                                                const BYTE *data,
+                                                size_t size
+                                                )
+      {
+        if (!mFile) return;
+
+        size_t capacity = mBuffer.SizeInBytes();
+        if (size > capacity - mBuffered) flush();
+        if (!mFile) return;
+
+        mOffset += size;
+
+        if (size >= capacity) {
+          // larger than the buffer so copying it first gains nothing
+          if (size != fwrite(data, 1, size, mFile)) {
+            fclose(mFile);
+            mFile = NULL;
+          }
+          return;
+        }
+
+        memcpy(mBuffer.BytePtr() + mBuffered, data, size);
+        mBuffered += size;
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::TraceRecorder::flush()
+      {
+        if (!mFile) return;
+        if (0 == mBuffered) return;
+
+        size_t written = fwrite(mBuffer.BytePtr(), 1, mBuffered, mFile);
+        bool failed = (written != mBuffered);
+        mBuffered = 0;
+
+        if (failed) {
+          // a partial trace stays readable up to the last complete record
+          fclose(mFile);
+          mFile = NULL;
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RemoteEventing::ReceiveWorker
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      RemoteEventing::ReceiveWorker::ReceiveWorker(
+                                                   IRemoteEventingAsyncDelegatePtr delegate,
+                                                   size_t maxQueued,
+                                                   size_t passedBarrier
+                                                   ) :
+        mDelegate(delegate),
+        mMaxQueued(maxQueued > 0 ? maxQueued : 1),
+        mPassedBarrier(passedBarrier)
+      {
+        mThread = std::thread([this]() { run(); });
+      }
+
+      //-----------------------------------------------------------------------
+      RemoteEventing::ReceiveWorker::~ReceiveWorker()
+      {
+        stop();
+        join();
+      }
+
+      //-----------------------------------------------------------------------
+      RemoteEventing::ReceivedEventPtr RemoteEventing::ReceiveWorker::acquire()
+      {
+        {
+          AutoLock lock(mLock);
+          if (!mFree.empty()) {
+            auto event = mFree.front();
+            mFree.pop_front();
+            return event;
+          }
+        }
+        return make_shared<ReceivedEvent>();
+      }
+
+      //-----------------------------------------------------------------------
+      bool RemoteEventing::ReceiveWorker::queue(ReceivedEventPtr event)
+      {
+        bool paused {};
+
+        {
+          AutoLock lock(mLock);
+          mPending.push_back(event);
+          if (mPending.size() >= mMaxQueued) mPaused = true;
+          paused = mPaused;
+        }
+        mCondition.notify_all();
+        return !paused;
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::ReceiveWorker::queueBarrier(size_t barrier)
+      {
+        auto event = make_shared<ReceivedEvent>();
+        event->mBarrier = barrier;
+
+        {
+          AutoLock lock(mLock);
+          mPending.push_back(event);
+        }
+        mCondition.notify_all();
+      }
+
+      //-----------------------------------------------------------------------
+      size_t RemoteEventing::ReceiveWorker::getPassedBarrier() const
+      {
+        AutoLock lock(mLock);
+        return mPassedBarrier;
+      }
+
+      //-----------------------------------------------------------------------
+      bool RemoteEventing::ReceiveWorker::isPaused() const
+      {
+        AutoLock lock(mLock);
+        return mPaused;
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::ReceiveWorker::stop()
+      {
+        {
+          AutoLock lock(mLock);
+          mStop = true;
+        }
+        mCondition.notify_all();
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::ReceiveWorker::join()
+      {
+        if (mThread.joinable()) mThread.join();
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::ReceiveWorker::run()
+      {
+        while (true) {
+          ReceivedEventPtr event;
+
+          {
+            std::unique_lock<Lock> lock(mLock);
+            mCondition.wait(lock, [this]() { return (mStop) || (!mPending.empty()); });
+            if (mPending.empty()) return;
+
+            event = mPending.front();
+            mPending.pop_front();
+          }
+
+          bool notify {};
+
+          if (0 != event->mBarrier) {
+            AutoLock lock(mLock);
+            mPassedBarrier = event->mBarrier;
+            notify = true;
+          } else {
+            writeRemoteEvent(event->mHandle, event->mHeader, &(event->mDataDescriptors[0]), event->mHasOrigin ? &(event->mOrigin) : NULL);
+
+            AutoLock lock(mLock);
+            if (mFree.size() < ZSLIB_EVENTING_REMOTE_EVENTING_RECEIVE_WORKER_MAX_FREE_EVENTS) mFree.push_back(event);
+            if ((mPaused) &&
+                (mPending.size() <= (mMaxQueued / 2))) {
+              mPaused = false;
+              notify = true;
+            }
+          }
+
+          if (!notify) continue;
+
+          // the owner is told asynchronously so no lock is ever held here
+          try {
+            mDelegate->onRemoteEventingReceiveWorkerProgress();
+          } catch (const IRemoteEventingAsyncDelegateProxy::Exceptions::DelegateGone &) {
+          }
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RemoteEventing
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      RemoteEventing::RemoteEventing(
+                                     const make_private &,
+                                     IMessageQueuePtr queue,
+                                     IRemoteEventingDelegatePtr connectionDelegate,
+                                     const char *connectionSharedSecret,
+                                     const IPAddress &serverIP,
+                                     WORD listenPort,
+                                     Seconds maxWaitToBindTime
+                                     ) :
+        MessageQueueAssociator(queue),
+        mDelegate(IRemoteEventingDelegateProxy::createWeak(connectionDelegate)),
+        mMaxDataSize(static_cast<decltype(mMaxDataSize)>(ISettings::getUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_MAX_DATA_SIZE))),
+        mMaxPackedSize(static_cast<decltype(mMaxPackedSize)>(ISettings::getUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_MAX_PACKED_SIZE))),
+        mMaxOutstandingEvents(static_cast<decltype(mMaxOutstandingEvents)>(ISettings::getUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_MAX_OUTSTANDING_EVENTS))),
+        mMaxQueuedAsyncDataBeforeEventsDropped(static_cast<decltype(mMaxQueuedAsyncDataBeforeEventsDropped)>(ISettings::getUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_MAX_QUEUED_ASYNC_DATA_BEFORED_EVENTS_DROPPED))),
+        mMaxQueuedOutgoingDataBeforeEventsDropped(static_cast<decltype(mMaxQueuedOutgoingDataBeforeEventsDropped)>(ISettings::getUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_MAX_QUEUED_OUTGOING_DATA_BEFORED_EVENTS_DROPPED))),
+        mUseIPv6(ISettings::getBool(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_USE_IPV6)),
+        mUseEventRings(ISettings::getBool(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_USE_EVENT_RINGS)),
+        mEventRingSize(static_cast<decltype(mEventRingSize)>(ISettings::getUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_EVENT_RING_SIZE))),
+        mUseEventBatches(ISettings::getBool(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_USE_EVENT_BATCHES)),
+        mMaxEventBatchSize(static_cast<decltype(mMaxEventBatchSize)>(ISettings::getUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_MAX_EVENT_BATCH_SIZE))),
+        mOutgoingSegmentSize(static_cast<decltype(mOutgoingSegmentSize)>(ISettings::getUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_OUTGOING_SEGMENT_SIZE))),
+        mMaxPooledOutgoingSegments(static_cast<decltype(mMaxPooledOutgoingSegments)>(ISettings::getUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_MAX_POOLED_OUTGOING_SEGMENTS))),
+        mIncomingBufferSize(static_cast<decltype(mIncomingBufferSize)>(ISettings::getUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_INCOMING_BUFFER_SIZE))),
+        mUseCompactEvents(ISettings::getBool(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_USE_COMPACT_EVENTS)),
+        mUseTSCClock(ISettings::getBool(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_USE_TSC_CLOCK)),
+        mUseLoadShedding(ISettings::getBool(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_USE_SEVERITY_LOAD_SHEDDING)),
+        mMaxProviderSharePercent(static_cast<decltype(mMaxProviderSharePercent)>(ISettings::getUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_MAX_PROVIDER_SHARE_PERCENT))),
+        mNotifyStatistics(ISettings::getBool(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_NOTIFY_STATISTICS)),
+        mMaxListenClients(static_cast<decltype(mMaxListenClients)>(ISettings::getUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_MAX_LISTEN_CLIENTS))),
+        mLocalChannelRingSize(static_cast<decltype(mLocalChannelRingSize)>(ISettings::getUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_LOCAL_CHANNEL_RING_SIZE))),
+        mMaxResumableSessions(static_cast<decltype(mMaxResumableSessions)>(ISettings::getUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_MAX_RESUMABLE_SESSIONS))),
+        mReceiveWorkerThreads(static_cast<decltype(mReceiveWorkerThreads)>(ISettings::getUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_RECEIVE_WORKER_THREADS))),
+        mMaxReceiveWorkerQueuedEvents(static_cast<decltype(mMaxReceiveWorkerQueuedEvents)>(ISettings::getUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_MAX_RECEIVE_WORKER_QUEUED_EVENTS))),
+        mSpoolPath(ISettings::getString(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_SPOOL_PATH)),
+        mSpoolSize(static_cast<decltype(mSpoolSize)>(ISettings::getUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_SPOOL_SIZE))),
+        mSpoolKeywords(static_cast<decltype(mSpoolKeywords)>(ISettings::getUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_SPOOL_KEYWORDS))),
+        mRecordBufferSize(static_cast<decltype(mRecordBufferSize)>(ISettings::getUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_RECORD_BUFFER_SIZE))),
+        mRecordIndexIntervalSize(static_cast<decltype(mRecordIndexIntervalSize)>(ISettings::getUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_RECORD_INDEX_INTERVAL_SIZE))),
+        mRecordIndexIntervalTime(Milliseconds(ISettings::getUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_RECORD_INDEX_INTERVAL_TIME))),
+        mServerIP(serverIP),
+        mListenPort(listenPort),
+        mSharedSecret(connectionSharedSecret),
+        mMaxWaitToBindTime(maxWaitToBindTime),
+        mClients(make_shared<RemoteEventingList>()),
+        mEventRings(make_shared<EventRingList>())
+      {
+        ZS_LOG_DETAIL(log("Created"));
+
+        // a packed event or a full batch (plus its framing) always fits a frame
+        size_t maxEventSize = ZSLIB_EVENTING_REMOTE_EVENTING_MAX_MESSAGE_SIZE / 2;
+        if (mMaxPackedSize > maxEventSize) mMaxPackedSize = maxEventSize;
+        if (mMaxEventBatchSize > maxEventSize) mMaxEventBatchSize = maxEventSize;
+
+        // every ring must be able to hold at least a couple of maximum sized messages
+        size_t minRingSize = (mMaxPackedSize + sizeof(CryptoPP::word32)) * 2;
+        if (mEventRingSize < minRingSize) mEventRingSize = minRingSize;
+
+        if (mOutgoingSegmentSize < 1024) mOutgoingSegmentSize = 1024;
+        if (mIncomingBufferSize < 4096) mIncomingBufferSize = 4096;
+        if (mMaxListenClients < 1) mMaxListenClients = 1;
+        if (mLocalChannelRingSize < (64*1024)) mLocalChannelRingSize = (64*1024);
+
+        // the spool must be able to hold at least a couple of maximum sized messages
+        size_t minSpoolSize = (mMaxPackedSize + sizeof(CryptoPP::word32)) * 2;
+        if (mSpoolSize < minSpoolSize) mSpoolSize = minSpoolSize;
+
+#ifndef ZSLIB_EVENTING_REMOTE_EVENTING_HAS_TSC
+        mUseTSCClock = false;
+#endif //ndef ZSLIB_EVENTING_REMOTE_EVENTING_HAS_TSC
+
+        if (mUseTSCClock.load()) startTSCCalibration();
+      }
+
+      //-----------------------------------------------------------------------
+      RemoteEventing::~RemoteEventing()
+      {
+        mThisWeak.reset();
+        ZS_LOG_DETAIL(log("Destroyed"));
+        cancel();
+
+        {
+          AutoLock lock(mEventRingsLock);
+          for (auto iter = mEventRings->begin(); iter != mEventRings->end(); ++iter) {
+            auto &ring = (*iter);
+            ring->mOwnerGone = true;
+          }
+        }
+        
+        for (auto iter = mCleanUpProviderInfos.begin(); iter != mCleanUpProviderInfos.end(); ++iter)
+        {
+          auto info = (*iter);
+          Log::EventingAtomDataArray providerArray;
+          if (Log::getEventingWriterInfo(info->mHandle, info->mProviderID, info->mProviderName, info->mProviderHash, &providerArray)) {
+            // a listener may have claimed the slot for the same provider
+            if (reinterpret_cast<ProviderInfo *>(providerArray[mEventingAtomIndex]) == info) providerArray[mEventingAtomIndex] = 0;
+          }
+          delete info;
+        }
+        mCleanUpProviderInfos.clear();
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::init()
+      {
+        mEventingAtomIndex = zsLib::Log::registerEventingAtom("org.zsLib.eventing.RemoteEventing");
+        mAsyncNotify = IRemoteEventingAsyncDelegateProxy::createWeak(mThisWeak.lock());
+        if (!mIsClient) openSpool();
+        IWakeDelegateProxy::create(mThisWeak.lock())->onWake();
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RemoteEventing => IRemoteEventing
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      RemoteEventingPtr RemoteEventing::connectToRemote(
+                                                        IRemoteEventingDelegatePtr connectionDelegate,
+                                                        const IPAddress &serverIP,
+                                                        const char *connectionSharedSecret
+                                                        )
+      {
+        auto queue = IMessageQueueManager::getMessageQueue("org.zsLib.eventing.RemoteEventing");
+        auto pThis = make_shared<RemoteEventing>(make_private{}, queue, connectionDelegate, connectionSharedSecret, serverIP, static_cast<WORD>(0), Seconds());
+        pThis->mThisWeak = pThis;
+        pThis->init();
+        return pThis;
+      }
+
+      //-----------------------------------------------------------------------
+      RemoteEventingPtr RemoteEventing::listenForRemote(
+                                                        IRemoteEventingDelegatePtr connectionDelegate,
+                                                        WORD localPort,
+                                                        const char *connectionSharedSecret,
+                                                        Seconds maxWaitToBindTimeInSeconds
+                                                        )
+      {
+        auto queue = IMessageQueueManager::getMessageQueue("org.zsLib.eventing.RemoteEventing");
+        auto pThis = make_shared<RemoteEventing>(make_private{}, queue, connectionDelegate, connectionSharedSecret, IPAddress(), localPort, maxWaitToBindTimeInSeconds);
+        pThis->mThisWeak = pThis;
+        pThis->init();
+        return pThis;
+      }
+
+      //-----------------------------------------------------------------------
+      RemoteEventingPtr RemoteEventing::connectToLocal(
+                                                       IRemoteEventingDelegatePtr connectionDelegate,
+                                                       const char *localName,
+                                                       const char *connectionSharedSecret
+                                                       )
+      {
+        auto queue = IMessageQueueManager::getMessageQueue("org.zsLib.eventing.RemoteEventing");
+        auto pThis = make_shared<RemoteEventing>(make_private{}, queue, connectionDelegate, connectionSharedSecret, IPAddress(), static_cast<WORD>(0), Seconds());
+        pThis->mThisWeak = pThis;
+        pThis->mLocalName = String(localName);
+        pThis->init();
+        return pThis;
+      }
+
+      //-----------------------------------------------------------------------
+      RemoteEventingPtr RemoteEventing::listenForLocal(
+                                                       IRemoteEventingDelegatePtr connectionDelegate,
+                                                       const char *localName,
+                                                       const char *connectionSharedSecret
+                                                       )
+      {
+        auto queue = IMessageQueueManager::getMessageQueue("org.zsLib.eventing.RemoteEventing");
+        auto pThis = make_shared<RemoteEventing>(make_private{}, queue, connectionDelegate, connectionSharedSecret, IPAddress(), static_cast<WORD>(0), Seconds());
+        pThis->mThisWeak = pThis;
+        pThis->mLocalName = String(localName);
+        pThis->mLocalListen = true;
+        pThis->init();
+        return pThis;
+      }
+
+      //-----------------------------------------------------------------------
+      IRemoteEventingTypes::FramePoolStatistics RemoteEventing::getFramePoolStatistics()
+      {
+        FramePoolStatistics result;
+
+        auto &pools = getSlabPools();
+        result.mFrames = pools.mReserved[SlabPools::Pool_Frames].load(std::memory_order_relaxed);
+        result.mFramesInUse = pools.mInUse[SlabPools::Pool_Frames].load(std::memory_order_relaxed);
+        result.mBytes = pools.mReservedBytes[SlabPools::Pool_Frames].load(std::memory_order_relaxed) + pools.mReservedBytes[SlabPools::Pool_Blocks].load(std::memory_order_relaxed);
+        result.mBytesInUse = pools.mInUseBytes[SlabPools::Pool_Frames].load(std::memory_order_relaxed) + pools.mInUseBytes[SlabPools::Pool_Blocks].load(std::memory_order_relaxed);
+        return result;
+      }
+
+      //-----------------------------------------------------------------------
+      bool RemoteEventing::getCurrentEventOrigin(EventOrigin &outOrigin)
+      {
+        auto origin = getCurrentEventOriginRef();
+        if (!origin) return false;
+        outOrigin = *origin;
+        return true;
+      }
+
+      //-----------------------------------------------------------------------
+      bool RemoteEventing::readTraceIndex(
+                                          const BYTE *trace,
+                                          size_t traceSize,
+                                          ElementPtr &outHeaderEl,
+                                          TraceIndex &outIndex
+                                          )
+      {
+        static const size_t recordHeaderSize = sizeof(CryptoPP::word32) + sizeof(BYTE);
+        static const size_t trailerSize = sizeof(uint64_t) + (sizeof(CryptoPP::word32)*2);
+        static const size_t indexEntrySize = sizeof(uint64_t)*3;
+
+        outHeaderEl.reset();
+        outIndex.clear();
+
+        size_t headerSize = sizeof(CryptoPP::word32)*3;
+        if ((!trace) ||
+            (traceSize < headerSize)) return false;
+
+        if (ZSLIB_EVENTING_REMOTE_EVENTING_TRACE_MAGIC != IHelper::getBE32(trace)) return false;
+        uint32_t version = IHelper::getBE32(trace + sizeof(CryptoPP::word32));
+        if (ZSLIB_EVENTING_REMOTE_EVENTING_TRACE_VERSION != version) {
+          ZS_LOG_WARNING(Detail, slog("trace file version is not understood") + ZS_PARAMIZE(version));
+          return false;
+        }
+
+        size_t headerLength = static_cast<size_t>(IHelper::getBE32(trace + (sizeof(CryptoPP::word32)*2)));
+        if (traceSize - headerSize < headerLength) return false;
+
+        outHeaderEl = IHelper::toJSON(std::string(reinterpret_cast<const char *>(trace + headerSize), headerLength).c_str());
+        headerSize += headerLength;
+
+        // a completed trace ends with a trailer locating the table of index records
+        if (traceSize - headerSize >= trailerSize + recordHeaderSize) {
+          const BYTE *trailer = trace + traceSize - trailerSize;
+          uint64_t tableOffset = IHelper::getBE64(trailer);
+          size_t tableEnd = traceSize - trailerSize;
+
+          if ((ZSLIB_EVENTING_REMOTE_EVENTING_TRACE_TRAILER_MAGIC == IHelper::getBE32(trailer + sizeof(uint64_t))) &&
+              (tableOffset >= headerSize) &&
+              (tableOffset + recordHeaderSize + sizeof(uint64_t) <= tableEnd)) {
+            const BYTE *pos = trace + static_cast<size_t>(tableOffset);
+            size_t recordSize = static_cast<size_t>(IHelper::getBE32(pos));
+            uint64_t count = IHelper::getBE64(pos + recordHeaderSize);
+
+            if ((ZSLIB_EVENTING_REMOTE_EVENTING_TRACE_RECORD_INDEX_TABLE == pos[sizeof(CryptoPP::word32)]) &&
+                (tableOffset + sizeof(CryptoPP::word32) + recordSize == tableEnd) &&
+                (count == (recordSize - sizeof(BYTE) - sizeof(uint64_t)) / indexEntrySize)) {
+              pos += recordHeaderSize + sizeof(uint64_t);
+
+              outIndex.resize(static_cast<size_t>(count));
+              for (auto iter = outIndex.begin(); iter != outIndex.end(); ++iter) {
+                auto &entry = (*iter);
+                entry.mOffset = IHelper::getBE64(pos);
+                entry.mTime = IHelper::getBE64(pos + sizeof(uint64_t));
+                entry.mFrames = IHelper::getBE64(pos + (sizeof(uint64_t)*2));
+                pos += indexEntrySize;
+              }
+              return true;
+            }
+          }
+        }
+
+        ZS_LOG_DEBUG(slog("trace file was not completed (rebuilding index)") + ZS_PARAMIZE(traceSize));
+
+        size_t offset = headerSize;
+        while (traceSize - offset >= recordHeaderSize) {
+          const BYTE *pos = trace + offset;
+          size_t recordSize = static_cast<size_t>(IHelper::getBE32(pos));
+          if ((recordSize < sizeof(BYTE)) ||
+              (traceSize - offset - sizeof(CryptoPP::word32) < recordSize)) break;
+
+          if ((ZSLIB_EVENTING_REMOTE_EVENTING_TRACE_RECORD_INDEX == pos[sizeof(CryptoPP::word32)]) &&
+              (recordSize >= sizeof(BYTE) + (sizeof(uint64_t)*2))) {
+            TraceIndexEntry entry;
+            entry.mOffset = offset;
+            entry.mTime = IHelper::getBE64(pos + recordHeaderSize);
+            entry.mFrames = IHelper::getBE64(pos + recordHeaderSize + sizeof(uint64_t));
+            outIndex.push_back(entry);
+          }
+
+          offset += sizeof(CryptoPP::word32) + recordSize;
+        }
+        return true;
+      }
+
+      //-----------------------------------------------------------------------
+      size_t RemoteEventing::decodeTrace(
+                                         const BYTE *trace,
+                                         size_t traceSize,
+                                         uint64_t startOffset,
+                                         uint64_t endOffset,
+                                         IRemoteEventingTraceDelegate &delegate
+                                         )
+      {
+        static const size_t recordHeaderSize = sizeof(CryptoPP::word32) + sizeof(BYTE);
+
+        size_t headerSize = sizeof(CryptoPP::word32)*3;
+        if ((!trace) ||
+            (traceSize < headerSize)) return 0;
+        if (ZSLIB_EVENTING_REMOTE_EVENTING_TRACE_MAGIC != IHelper::getBE32(trace)) return 0;
+
+        size_t headerLength = static_cast<size_t>(IHelper::getBE32(trace + (sizeof(CryptoPP::word32)*2)));
+        if (traceSize - headerSize < headerLength) return 0;
+
+        // the recorded swap decisions are relative to the recording host's byte order
+        bool swapByteOrder {};
+        {
+          ElementPtr headerEl = IHelper::toJSON(std::string(reinterpret_cast<const char *>(trace + headerSize), headerLength).c_str());
+          if (headerEl) {
+            bool littleEndian = ("true" == IHelper::getElementText(headerEl->findFirstChildElement("littleEndian")));
+            swapByteOrder = (littleEndian != isLittleEndianHost());
+          }
+        }
+        headerSize += headerLength;
+
+        if (startOffset < headerSize) startOffset = headerSize;
+        if (endOffset > traceSize) endOffset = traceSize;
+
+        TraceConnectionMap connections;
+        SecureByteBlock scratch;
+        bool started {};
+        size_t total {};
+
+        size_t offset = static_cast<size_t>(startOffset);
+        while ((offset < endOffset) &&
+               (traceSize - offset >= recordHeaderSize)) {
+          const BYTE *pos = trace + offset;
+          size_t recordSize = static_cast<size_t>(IHelper::getBE32(pos));
+
+          // a trace which was cut short ends with a partial record
+          if ((recordSize < sizeof(BYTE)) ||
+              (traceSize - offset - sizeof(CryptoPP::word32) < recordSize)) break;
+
+          BYTE recordType = pos[sizeof(CryptoPP::word32)];
+          const BYTE *payload = pos + recordHeaderSize;
+          size_t payloadSize = recordSize - sizeof(BYTE);
+          offset += sizeof(CryptoPP::word32) + recordSize;
+
+          switch (recordType) {
+            case ZSLIB_EVENTING_REMOTE_EVENTING_TRACE_RECORD_FRAME: {
+              if (payloadSize < sizeof(CryptoPP::word32) + sizeof(uint64_t)) break;
+
+              auto found = connections.find(IHelper::getBE32(payload));
+              if (found == connections.end()) break;
+
+              uint64_t receiveTime = IHelper::getBE64(payload + sizeof(CryptoPP::word32));
+              total += decodeTraceFrame((*found).second, payload + sizeof(CryptoPP::word32) + sizeof(uint64_t), payloadSize - sizeof(CryptoPP::word32) - sizeof(uint64_t), receiveTime, scratch, delegate);
+              break;
+            }
+            case ZSLIB_EVENTING_REMOTE_EVENTING_TRACE_RECORD_CONNECTION: {
+              if (payloadSize < sizeof(CryptoPP::word32)) break;
+              decodeTraceConnection(payload + sizeof(CryptoPP::word32), payloadSize - sizeof(CryptoPP::word32), swapByteOrder, connections[IHelper::getBE32(payload)]);
+              break;
+            }
+            case ZSLIB_EVENTING_REMOTE_EVENTING_TRACE_RECORD_CONNECTION_END: {
+              if (payloadSize < sizeof(CryptoPP::word32)) break;
+              connections.erase(IHelper::getBE32(payload));
+              break;
+            }
+            case ZSLIB_EVENTING_REMOTE_EVENTING_TRACE_RECORD_INDEX: {
+              // the state is tracked record by record after the first index
+              if (started) break;
+              started = true;
+
+              if (payloadSize < sizeof(uint64_t)*2) break;
+
+              // only read although the varint helpers take a mutable position
+              BYTE *statePos = const_cast<BYTE *>(payload) + (sizeof(uint64_t)*2);
+              size_t remaining = payloadSize - (sizeof(uint64_t)*2);
+
+              uint64_t count {};
+              if (!getVarint(statePos, remaining, count)) break;
+
+              for (uint64_t index = 0; index < count; ++index) {
+                if (remaining < sizeof(CryptoPP::word32)) break;
+                uint32_t connectionID = IHelper::getBE32(statePos);
+                statePos += sizeof(CryptoPP::word32);
+                remaining -= sizeof(CryptoPP::word32);
+
+                uint64_t stateSize {};
+                if (!getVarint(statePos, remaining, stateSize)) break;
+                if (stateSize > remaining) break;
+
+                decodeTraceConnection(statePos, static_cast<size_t>(stateSize), swapByteOrder, connections[connectionID]);
+                statePos += stateSize;
+                remaining -= static_cast<size_t>(stateSize);
+              }
+              break;
+            }
+            default: break;
+          }
+        }
+
+        return total;
+      }
+      
+      //-----------------------------------------------------------------------
+      void RemoteEventing::shutdown()
+      {
+        ZS_LOG_DEBUG(log("shutdown called"));
+
+        AutoRecursiveLock lock(mLock);
+        cancel();
+      }
+
+      //-----------------------------------------------------------------------
+      IRemoteEventing::States RemoteEventing::getState() const
+      {
+        AutoRecursiveLock lock(mLock);
+        return mState;
+      }
+      
+      //-----------------------------------------------------------------------
+      void RemoteEventing::setRemoteLevel(
+                                          const char *remoteSubsystemName,
+                                          Level level
+                                          )
+      {
+        RemoteEventingListPtr clients;
+
+        {
+          AutoRecursiveLock lock(mLock);
+
+          auto info = make_shared<SubsystemInfo>();
+          info->mName = String(remoteSubsystemName);
+          info->mLevel = level;
+
+          mSetRemoteSubsystemsLevels[info->mName] = info;
+
+          if (isListener()) {
+            clients = mClients;
+          } else if (isAuthorized()) {
+            requestSetRemoteSubsystemLevel(info);
+          }
+        }
+
+        if (!clients) return;
+
+        // the listener lock is never held while calling into a client
+        for (auto iter = clients->begin(); iter != clients->end(); ++iter) {
+          auto &client = (*iter);
+          client->setRemoteLevel(remoteSubsystemName, level);
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::setRemoteProviderEvents(
+                                                   const char *remoteProviderName,
+                                                   const EventIDSet &enabledEventIDs
+                                                   )
+      {
+        RemoteEventingListPtr clients;
+
+        {
+          AutoRecursiveLock lock(mLock);
+
+          String providerName(remoteProviderName);
+
+          if (enabledEventIDs.size() > 0) {
+            mSetRemoteProviderEvents[providerName] = enabledEventIDs;
+          } else {
+            auto found = mSetRemoteProviderEvents.find(providerName);
+            if (found != mSetRemoteProviderEvents.end()) mSetRemoteProviderEvents.erase(found);
+          }
+
+          if (isListener()) {
+            clients = mClients;
+          } else if ((isAuthorized()) &&
+                     (isRemoteProviderRegistered(providerName))) {
+            requestSetRemoteEventProviderEvents(providerName, enabledEventIDs);
+          }
+        }
+
+        if (!clients) return;
+
+        // the listener lock is never held while calling into a client
+        for (auto iter = clients->begin(); iter != clients->end(); ++iter) {
+          auto &client = (*iter);
+          client->setRemoteProviderEvents(remoteProviderName, enabledEventIDs);
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      IRemoteEventingTypes::Statistics RemoteEventing::getStatistics() const
+      {
+        Statistics result;
+        RemoteEventingListPtr clients;
+
+        {
+          AutoRecursiveLock lock(mLock);
+
+          for (auto iter = mSentCounters.begin(); iter != mSentCounters.end(); ++iter) {
+            auto &counters = (*iter).second;
+            auto &statistics = result.mProviders[counters.mName];
+            statistics.mEventsSent += counters.mStatistics.mEventsSent;
+            statistics.mBytesSent += counters.mStatistics.mBytesSent;
+          }
+          for (auto iter = mReceivedCounters.begin(); iter != mReceivedCounters.end(); ++iter) {
+            auto &counters = (*iter).second;
+            if (0 == counters.mStatistics.mEventsReceived) continue;   // registered when announced
+            auto &statistics = result.mProviders[counters.mName];
+            statistics.mEventsReceived += counters.mStatistics.mEventsReceived;
+            statistics.mBytesReceived += counters.mStatistics.mBytesReceived;
+          }
+
+          result.mAsyncQueueBytes = mEventDataInAsyncQueue;
+          result.mAsyncQueueBytesHighWater = mAsyncQueueBytesHighWater;
+          result.mOutgoingQueueBytes = mEventDataInOutgoingQueue + mEventBatchSize;
+          result.mOutgoingQueueBytesHighWater = mOutgoingQueueBytesHighWater;
+          result.mOutgoingSegmentPoolSegments = mOutgoingSegmentPool.size();
+          result.mOutgoingSegmentPoolBytes = mOutgoingSegmentPool.size() * mOutgoingSegmentSize;
+          result.mSpoolBytes = (mSpool ? mSpool->getUsedBytes() : 0);
+          result.mSpooledEvents = mSpooledEvents;
+          result.mReplayedEvents = mReplayedEvents;
+
+          for (size_t index = DropReason_First; index <= DropReason_Last; ++index) {
+            result.mDroppedEvents[index] = mDroppedEventsByReason[index];
+          }
+
+          result.mSendCalls = mSendCalls;
+          result.mSendWouldBlockCalls = mSendWouldBlockCalls;
+          result.mReceiveCalls = mReceiveCalls;
+          result.mEncodeTime = mEncodeTime;
+          result.mDecodeTime = mDecodeTime;
+
+          clients = mClients;
+        }
+
+        // a listener includes the connections of every accepted party
+        for (auto iter = clients->begin(); iter != clients->end(); ++iter) {
+          auto &client = (*iter);
+          mergeStatistics(result, client->getStatistics());
+        }
+
+        return result;
+      }
+
+      //-----------------------------------------------------------------------
+      bool RemoteEventing::getRemoteStatistics(Statistics &outStatistics) const
+      {
+        RemoteEventingListPtr clients;
+
+        {
+          AutoRecursiveLock lock(mLock);
+          if (mHasRemoteStatistics) {
+            outStatistics = mRemoteStatistics;
+            return true;
+          }
+          clients = mClients;
+        }
+
+        // a listener merges the statistics sent by every accepted party
+        Statistics result;
+        bool found = false;
+        for (auto iter = clients->begin(); iter != clients->end(); ++iter) {
+          auto &client = (*iter);
+          Statistics statistics;
+          if (!client->getRemoteStatistics(statistics)) continue;
+          mergeStatistics(result, statistics);
+          found = true;
+        }
+
+        if (found) outStatistics = result;
+        return found;
+      }
+
+      //-----------------------------------------------------------------------
+      bool RemoteEventing::startRecording(
+                                          const char *path,
+                                          ElementPtr headerEl
+                                          )
+      {
+        AutoRecursiveLock lock(mLock);
+
+        if (mRecorder) mRecorder->close();
+
+        // a listener shares the recorder with the parties accepted from now on
+        mRecorder = TraceRecorder::open(String(path), headerEl, mRecordBufferSize, mRecordIndexIntervalSize, mRecordIndexIntervalTime);
+        if (!mRecorder) {
+          ZS_LOG_WARNING(Basic, log("unable to create trace file") + ZS_PARAM("path", path));
+          return false;
+        }
+
+        ZS_LOG_DEBUG(log("recording started") + ZS_PARAM("path", path));
+        return true;
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::stopRecording()
+      {
+        AutoRecursiveLock lock(mLock);
+        if (!mRecorder) return;
+
+        ZS_LOG_DEBUG(log("recording stopped") + ZS_PARAM("path", mRecorder->mPath));
+
+        mRecorder->close();
+        mRecorder.reset();
+      }
+      
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RemoteEventing => IWakeDelegate
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::onWake()
+      {
+        ZS_LOG_DEBUG(log("on wake"));
+
+        AutoRecursiveLock lock(mLock);
+        step();
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RemoteEventing => ITimerDelegate
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::onTimer(ITimerPtr timer)
+      {
+        ZS_LOG_DEBUG(log("on timer") + ZS_PARAM("timer id", timer->getID()));
+        
+        AutoRecursiveLock lock(mLock);
+        if (timer == mNotifyTimer) {
+          sendNotify();
+          return;
+        }
+        if (mRebindTimer) {
+          if (mRebindTimer->getID() == timer->getID()) {
+            ZS_LOG_TRACE(log("rebind timer"));
+            mRebindTimer->cancel();
+            mRebindTimer.reset();
+            step();
+            return;
+          }
+        }
+      }
+      
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RemoteEventing => ISocketDelegate
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::onReadReady(SocketPtr socket)
+      {
+        AutoRecursiveLock lock(mLock);
+        if (socket == mBindSocket) {
+          IPAddress remoteIP;
+          SocketPtr acceptedSocket;
+
+          try {
+            acceptedSocket = mBindSocket->accept(remoteIP);
+            if (!acceptedSocket) {
+              ZS_LOG_WARNING(Debug, log("incoming socket rejected"));
+              return;
+            }
+            acceptedSocket->setBlocking(false);
+          } catch (const Socket::Exceptions::Unspecified &) {
+            ZS_LOG_WARNING(Debug, log("incoming socket rejected"));
+            return;
+          }
+
+          if (pruneClients() >= mMaxListenClients) {
+            ZS_LOG_WARNING(Detail, log("too many connected clients (incoming socket rejected)") + ZS_PARAM("ip", remoteIP.string()) + ZS_PARAM("max", mMaxListenClients));
+            try {
+              acceptedSocket->close();
+            } catch (const Socket::Exceptions::Unspecified &) {
+              ZS_LOG_WARNING(Debug, log("failed to close rejected socket"));
+            }
+            return;
+          }
+
+          auto client = createClient(acceptedSocket, remoteIP);
+
+          RemoteEventingListPtr replacement(make_shared<RemoteEventingList>(*mClients));
+          replacement->push_back(client);
+          mClients = replacement;
+
+          ZS_LOG_DEBUG(log("incoming socket accepted") + ZS_PARAM("ip", remoteIP.string()) + ZS_PARAM("client", client->getID()) + ZS_PARAM("clients", mClients->size()));
+          return;
+        }
+        
+        auto activeSocket = getActiveSocket();
+        if (socket == activeSocket) {
+          if (isConnectingMode()) {
+            if (!mConnected) {
+              ZS_LOG_WARNING(Trace, log("notified read ready before connected"));
+              return;
+            }
+          }
+          readActiveSocket();
+          return;
+        }
+
+        ZS_LOG_WARNING(Debug, log("read ready on obsolete socket") + ZS_PARAM("socket", static_cast<uintptr_t>(socket->getSocket())));
+      }
+      
+      //-----------------------------------------------------------------------
+      void RemoteEventing::onWriteReady(SocketPtr socket)
+      {
+        AutoRecursiveLock lock(mLock);
+        
+        if (socket == mConnectSocket) {
+          if (!mConnected) {
+            ZS_LOG_DEBUG(log("connecting socket connected"));
+            mConnected = true;
+            mWriteReady = true;
+            step();
+            return;
+          }
+        }
+
+        auto activeSocket = getActiveSocket();
+        if (socket == activeSocket) {
+          mWriteReady = true;
+          sendOutgoingData();
+          return;
+        }
+
+        ZS_LOG_WARNING(Debug, log("read ready on obsolete socket") + ZS_PARAM("socket", static_cast<uintptr_t>(socket->getSocket())));
+      }
+      
+      //-----------------------------------------------------------------------
+      void RemoteEventing::onException(SocketPtr socket)
+      {
+        AutoRecursiveLock lock(mLock);
+        
+        auto activeSocket = getActiveSocket();
+        if (socket == activeSocket) {
+          ZS_LOG_WARNING(Detail, log("active socket closed"));
+
+          if (isListeningMode()) {
+            try {
+              mAcceptedSocket->close();
+            } catch (const Socket::Exceptions::Unspecified &) {
+              ZS_LOG_WARNING(Debug, log("could not read active socket"));
+            }
+            mAcceptedSocket.reset();
+            disconnect();
+            return;
+          }
+          try {
+            mConnectSocket->close();
+          } catch (const Socket::Exceptions::Unspecified &) {
+            ZS_LOG_WARNING(Debug, log("could not read active socket"));
+          }
+          mConnectSocket.reset();
+          disconnect();
+          return;
+        }
+        
+        if (socket == mBindSocket) {
+          ZS_LOG_WARNING(Detail, log("bind socket failed"));
+          cancel();
+          return;
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RemoteEventing => ILogEventingProviderDelegate
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::notifyNewSubsystem(zsLib::Subsystem &inSubsystem)
+      {
+        if (0 == mSubscribeEpoch.load()) return;
+
+        try {
+          mAsyncNotify->onRemoteEventingNewSubsystem(inSubsystem.getName());
+        } catch (const IRemoteEventingAsyncDelegateProxy::Exceptions::DelegateGone &) {
+          ZS_LOG_TRACE(log("remote eventing gone (new subsystem ignored)"));
+        }
+      }
+      
+      //-----------------------------------------------------------------------
+      void RemoteEventing::notifyEventingProviderRegistered(
+                                                            ProviderHandle handle,
+                                                            EventingAtomDataArray eventingAtomDataArray
+                                                            )
+      {
+        ProviderInfo *info = reinterpret_cast<ProviderInfo *>(eventingAtomDataArray[mEventingAtomIndex]);
+        
+        bool constructed = false;
+
+        if (info) {
+          if (info->mRelatedToRemoteEventingObjectID != mID) {
+            // ignore provider infos related to other remote evening engines running
+            return;
+          }
+          if (info->mSelfRegistered) {
+            // ignore re-entrant self registered provider infos
+            return;
+          }
+        } else {
+          constructed = true;
+          info = new ProviderInfo;
+          info->mHandle = handle;
+          info->mRelatedToRemoteEventingObjectID = mID;
+          if (!Log::getEventingWriterInfo(handle, info->mProviderID, info->mProviderName, info->mProviderHash)) {
+            ZS_LOG_WARNING(Detail, log("told about provider that does not exist") + ZS_PARAM("provider handle", string(handle)));
+            delete info;
+            return;
+          }
+        }
+        
+        bool subscribed = (0 != mSubscribeEpoch.load());
+
+        {
+          AutoRecursiveLock lock(mLock);
+          if (constructed) {
+            if (mFreeProviderIndexes.size() > 0) {
+              info->mIndex = mFreeProviderIndexes.back();
+              mFreeProviderIndexes.pop_back();
+            } else {
+              info->mIndex = mNextProviderIndex++;
+            }
+            info->mLocalIndex = true;
+            eventingAtomDataArray[mEventingAtomIndex] = reinterpret_cast<uintptr_t>(info);
+            mCleanUpProviderInfos.insert(info);
+          }
+          auto found = mRemoteRegisteredProvidersByUUID.find(info->mProviderID);
+          if (found != mRemoteRegisteredProvidersByUUID.end()) {
+            // ignore any providers announced by the remote party
+            info->mSelfRegistered = true;
+            return;
+          }
+          if (isClientRemoteProvider(info->mProviderID)) {
+            // ignore any providers announced by the parties connected to a listener
+            info->mSelfRegistered = true;
+            return;
+          }
+        }
+
+        if (!subscribed) return;
+
+        try {
+          mAsyncNotify->onRemoteEventingProviderRegistered(info);
+        } catch (const IRemoteEventingAsyncDelegateProxy::Exceptions::DelegateGone &) {
+          ZS_LOG_TRACE(log("remote eventing gone (provider registration ignored)"));
+        }
+      }
+      
+      //-----------------------------------------------------------------------
+      void RemoteEventing::notifyEventingProviderUnregistered(
+                                                              ProviderHandle handle,
+                                                              EventingAtomDataArray eventingAtomDataArray
+                                                              )
+      {
+        ProviderInfo *info = reinterpret_cast<ProviderInfo *>(eventingAtomDataArray[mEventingAtomIndex]);
+        if (!info) return;
+
+        if (info->mRelatedToRemoteEventingObjectID != mID) {
+          // ignore provider infos related to other remote evening engines running
+          return;
+        }
+
+        eventingAtomDataArray[mEventingAtomIndex] = static_cast<uintptr_t>(0);
+
+        if (info->mLocalIndex) {
+          // the provider gone announcement is queued ahead of any provider reusing the index
+          AutoRecursiveLock lock(mLock);
+          mFreeProviderIndexes.push_back(info->mIndex);
+          info->mLocalIndex = false;
+        }
+
+        if (info->mSelfRegistered) {
+          // ignore re-entrant self registered provider infos
+          return;
+        }
+
+        if (0 == mSubscribeEpoch.load()) return;
+
+        try {
+          mAsyncNotify->onRemoteEventingProviderUnregistered(info);
+        } catch (const IRemoteEventingAsyncDelegateProxy::Exceptions::DelegateGone &) {
+          ZS_LOG_TRACE(log("remote eventing gone (provider unregistration ignored)"));
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::notifyEventingProviderLoggingStateChanged(
+                                                                     ProviderHandle handle,
+                                                                     EventingAtomDataArray eventingAtomDataArray,
+                                                                     KeywordBitmaskType keywords
+                                                                     )
+      {
+        ProviderInfo *info = reinterpret_cast<ProviderInfo *>(eventingAtomDataArray[mEventingAtomIndex]);
+        if (!info) return;
+        
+        if (info->mRelatedToRemoteEventingObjectID != mID) {
+          // ignore provider infos related to other remote evening engines running
+          return;
+        }
+
+        if (0 == mSubscribeEpoch.load()) return;
+
+        try {
+          mAsyncNotify->onRemoteEventingProviderLoggingStateChanged(info, keywords);
+        } catch (const IRemoteEventingAsyncDelegateProxy::Exceptions::DelegateGone &) {
+          ZS_LOG_TRACE(log("remote eventing gone (provider logging state change ignored)"));
+        }
+      }
+
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RemoteEventing => ILogEventingDelegate
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::notifyWriteEvent(
+                                            ProviderHandle handle,
+                                            EventingAtomDataArray eventingAtomDataArray,
+                                            Severity severity,
+                                            Level level,
+                                            EVENT_DESCRIPTOR_HANDLE descriptor,
+                                            EVENT_PARAMETER_DESCRIPTOR_HANDLE parameterDescriptor,
+                                            EVENT_DATA_DESCRIPTOR_HANDLE dataDescriptor,
+                                            size_t dataDescriptorCount
+                                            )
+      {
+        ProviderInfo *info = reinterpret_cast<ProviderInfo *>(eventingAtomDataArray[mEventingAtomIndex]);
+        if (!info) return;
+
+        if (info->mRelatedToRemoteEventingObjectID != mID) {
+          // ignore provider infos related to other remote evening engines running
+          return;
+        }
+        if (info->mSelfRegistered) {
+          // ignore re-entrant self registered provider infos
+          return;
+        }
+
+        if (info->mFilterEventIDs.load(std::memory_order_acquire)) {
+          uint16_t eventID = descriptor->Id;
+          if (0 == (info->mEnabledEventIDs[eventID / 64].load(std::memory_order_relaxed) & (static_cast<uint64_t>(1) << (eventID % 64)))) return;
+        }
+
+        EventRing *ring {};
+        if (mUseEventRings) {
+          if (!mEventRingsActive) return;
+          ring = getThreadEventRing();
+        }
+
+        if (dataDescriptorCount > ZSLIB_EVENTING_REMOTE_EVENTING_MAX_DATA_DESCRIPTORS) {
+          noteDroppedEvent(ring);
+          ++(mDroppedEventsByReason[DropReason_InvalidEvent]);
+          ZS_LOG_WARNING(Debug, log("total descriptors exceed maximum") + ZS_PARAMIZE(dataDescriptorCount));
+          return;
+        }
+
+        // admission is decided before the event is sized or serialized so a
+        // rejected event costs no more than a few atomic operations; the
+        // smallest possible message is predicted from the descriptor count
+        size_t predictedSize = getMinimumPackedEventSize(dataDescriptorCount) + sizeof(CryptoPP::word32);
+        size_t epoch {};
+        size_t maxQueuedAsyncData {};
+
+        if (ring) {
+          size_t ringBudget = ring->mBuffer.SizeInBytes();
+          if (mUseLoadShedding) ringBudget = getLoadSheddingBudget(ringBudget, severity, level);
+
+          size_t used = ring->mHead.load(std::memory_order_relaxed) - ring->mTail.load(std::memory_order_acquire);
+          if (used + predictedSize > ringBudget) {
+            noteDroppedEvent(ring);
+            noteDroppedEvent(info, severity);
+            ++(mDroppedEventsByReason[DropReason_EventRingFull]);
+            ZS_LOG_WARNING(Insane, log("event ring budget for severity exceeded (event dropped)") + ZS_PARAM("used", used));
+            return;
+          }
+        } else {
+          epoch = mSubscribeEpoch.load();
+          if (0 == epoch) return;
+
+          size_t maxOutstandingEvents = mMaxOutstandingEvents;
+          maxQueuedAsyncData = mMaxQueuedAsyncDataBeforeEventsDropped;
+          if (mUseLoadShedding) {
+            maxOutstandingEvents = getLoadSheddingBudget(maxOutstandingEvents, severity, level);
+            maxQueuedAsyncData = getLoadSheddingBudget(maxQueuedAsyncData, severity, level);
+          }
+
+          // reserve before checking so concurrent producers can never overshoot the limits
+          size_t outstanding = ++mOutstandingEvents;
+          if ((outstanding > maxOutstandingEvents) ||
+              (mEventDataInAsyncQueue + predictedSize > maxQueuedAsyncData)) {
+            --mOutstandingEvents;
+            ++mTotalDroppedEvents;
+            noteDroppedEvent(info, severity);
+            ++(mDroppedEventsByReason[DropReason_AsyncQueueFull]);
+            ZS_LOG_WARNING(Insane, log("too many outstanding events (event dropped)") + ZS_PARAM("events", outstanding) + ZS_PARAM("in queue", mEventDataInAsyncQueue));
+            return;
+          }
+        }
+
+        size_t packedSize = getPackedEventSize(dataDescriptor, dataDescriptorCount, mMaxDataSize);
+
+        if (packedSize > mMaxPackedSize) {
+          if (!ring) --mOutstandingEvents;
+          noteDroppedEvent(ring);
+          ++(mDroppedEventsByReason[DropReason_InvalidEvent]);
+          ZS_LOG_WARNING(Debug, log("packed size exceeds maximum size") + ZS_PARAMIZE(packedSize));
+          return;
+        }
+
+        size_t messageSize = packedSize + (sizeof(CryptoPP::word32)); // message size not included in packedSize
+
+        if (!ring) {
+          // the destination queue space is claimed before serializing
+          size_t queued = (mEventDataInAsyncQueue += messageSize);
+          if (queued > maxQueuedAsyncData) {
+            --mOutstandingEvents;
+            mEventDataInAsyncQueue -= messageSize;
+            ++mTotalDroppedEvents;
+            noteDroppedEvent(info, severity);
+            ++(mDroppedEventsByReason[DropReason_AsyncQueueFull]);
+            ZS_LOG_WARNING(Insane, log("too many outstanding events (event dropped)") + ZS_PARAM("in queue", queued - messageSize) + ZS_PARAM("size", messageSize));
+            return;
+          }
+        }
+
+        // the origin slot stays zeroed unless some party can receive it
+        EventOrigin origin;
+        if (0 != mEventOriginParties.load(std::memory_order_relaxed)) {
+          origin.mTimestamp = getOriginTimestamp(mUseTSCClock.load(std::memory_order_relaxed));
+          origin.mThreadID = getCurrentThreadNumericID();
+          origin.mCPU = getCurrentCPU();
+        }
+
+        if (ring) {
+          if (mUseLoadShedding) {
+            // keep the remainder of the ring in reserve for higher priority events
+            size_t used = ring->mHead.load(std::memory_order_relaxed) - ring->mTail.load(std::memory_order_acquire);
+            if (used + messageSize > getLoadSheddingBudget(ring->mBuffer.SizeInBytes(), severity, level)) {
+              noteDroppedEvent(ring);
+              noteDroppedEvent(info, severity);
+              ++(mDroppedEventsByReason[DropReason_EventRingFull]);
+              ZS_LOG_WARNING(Insane, log("event ring budget for severity exceeded (event dropped)") + ZS_PARAMIZE(messageSize) + ZS_PARAM("used", used));
+              return;
+            }
+          }
+
+          size_t head {};
+          BYTE *dest = ring->reserve(messageSize, head);
+          if (!dest) {
+            noteDroppedEvent(ring);
+            noteDroppedEvent(info, severity);
+            ++(mDroppedEventsByReason[DropReason_EventRingFull]);
+            ZS_LOG_WARNING(Insane, log("event ring is full (event dropped)") + ZS_PARAMIZE(messageSize));
+            return;
+          }
+
+          packEvent(dest, packedSize, origin, handle, severity, level, descriptor, parameterDescriptor, dataDescriptor, dataDescriptorCount, mMaxDataSize);
+          ring->commit(head);
+
+          // only one drain request is ever outstanding for all the rings
+          if (mEventRingDrainPending) return;
+          if (mEventRingDrainPending.exchange(true)) return;
+
+          auto pThis = mThisWeak.lock();
+          if (!pThis) return;
+
+          IRemoteEventingAsyncDelegateProxy::create(pThis)->onRemoteEventingDrainEventRings();
+          return;
+        }
+
+        SecureByteBlockPtr packed(acquireEventFrame(messageSize));
+        packEvent(packed->BytePtr(), packedSize, origin, handle, severity, level, descriptor, parameterDescriptor, dataDescriptor, dataDescriptorCount, mMaxDataSize);
+
+        try {
+          mAsyncNotify->onRemoteEventingWriteEvent(packed, messageSize, epoch);
+        } catch (const IRemoteEventingAsyncDelegateProxy::Exceptions::DelegateGone &) {
+          --mOutstandingEvents;
+          mEventDataInAsyncQueue -= messageSize;
+          ZS_LOG_TRACE(log("remote eventing gone (event dropped)"));
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RemoteEventing => IRemoteEventingAsyncDelegate
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::onRemoteEventingSubscribeLogger()
+      {
+        // the listener subscribes once on behalf of all its accepted parties
+        if (mIsClient) return;
+
+        auto pThis = mThisWeak.lock();
+        ZS_THROW_BAD_STATE_IF(!pThis);
+
+        if (mAsyncSelf) return;   // already subscribed
+
+        mAsyncSelf = IRemoteEventingAsyncDelegateProxy::create(pThis);
+        ZS_THROW_BAD_STATE_IF(!mAsyncSelf);
+
+        mSubscribeEpoch = ++mLastSubscribeEpoch;
+        mEventRingsActive = true;
+
+        Log::addEventingProviderListener(pThis);
+        Log::addEventingListener(pThis);
+      }
+      
+      //-----------------------------------------------------------------------
+      void RemoteEventing::onRemoteEventingUnsubscribeLogger()
+      {
+        if (mIsClient) return;
+        if (!mAsyncSelf) return;
+
+        if ((0 != mSpoolKeywords) &&
+            (!isShuttingDown()) &&
+            (!isShutdown())) {
+          ZS_LOG_TRACE(log("remaining subscribed to feed the spool"));
+          return;
+        }
+        
+        auto pThis = mThisWeak.lock();
+        ZS_THROW_BAD_STATE_IF(!pThis);
+        
+        Log::removeEventingProviderListener(pThis);
+        Log::removeEventingListener(pThis);
+
+        // producers still in flight post with the old epoch and are discarded
+        mEventRingsActive = false;
+        mSubscribeEpoch = 0;
+        mAsyncSelf.reset();
+      }
+      
+      //-----------------------------------------------------------------------
+      void RemoteEventing::onRemoteEventingNewSubsystem(const char *subsystemName)
+      {
+        String subsystemStr(subsystemName);
+        RemoteEventingListPtr clients;
+
+        {
+          AutoRecursiveLock lock(mLock);
+          auto found = mLocalSubsystems.find(subsystemStr);
+          if (found != mLocalSubsystems.end()) {
+            ZS_LOG_TRACE(log("subsystem already announced") + ZS_PARAMIZE(subsystemStr));
+            return;
+          }
+          
+          auto info = make_shared<SubsystemInfo>();
+          info->mName = subsystemStr;
+
+          mLocalSubsystems[info->mName] = info;
+          if (hasSentWelcome()) {
+            announceSubsystemToRemote(info);
+          }
+
+          clients = mClients;
+        }
+
+        // the clients are called without the listener lock held
+        for (auto iter = clients->begin(); iter != clients->end(); ++iter) {
+          auto &client = (*iter);
+          client->onRemoteEventingNewSubsystem(subsystemName);
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::onRemoteEventingProviderRegistered(ProviderInfo *provider)
+      {
+        RemoteEventingListPtr clients;
+
+        {
+          AutoRecursiveLock lock(mLock);
+          auto found = mLocalAnnouncedProviders.find(provider->mProviderID);
+          if (found != mLocalAnnouncedProviders.end()) {
+            ZS_LOG_DEBUG(log("local provider already announced") + ZS_PARAM("provider", provider->mProviderName));
+            return;
+          }
+
+          mLocalAnnouncedProviders[provider->mProviderID] = provider;
+          mLocalAnnouncedProviderIndexes[provider->mHandle] = provider->mIndex;
+          if (hasSentWelcome()) {
+            announceProviderToRemote(provider);
+          }
+
+          if (0 != mSpoolKeywords) {
+            Log::setEventingLogging(provider->mHandle, mSpoolSubscriptionID, true, mSpoolKeywords);
+          }
+
+          clients = mClients;
+        }
+
+        for (auto iter = clients->begin(); iter != clients->end(); ++iter) {
+          auto &client = (*iter);
+          client->onRemoteEventingProviderRegistered(provider);
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::onRemoteEventingProviderUnregistered(ProviderInfo *provider)
+      {
+        RemoteEventingListPtr clients;
+
+        {
+          AutoRecursiveLock lock(mLock);
+          auto found = mLocalAnnouncedProviders.find(provider->mProviderID);
+          if (found == mLocalAnnouncedProviders.end()) {
+            ZS_LOG_DEBUG(log("local provider not announced") + ZS_PARAM("provider", provider->mProviderName));
+            return;
+          }
+
+          mLocalAnnouncedProviders.erase(found);
+          mLocalAnnouncedProviderIndexes.erase(provider->mHandle);
+          mProviderLoadShedding.erase(provider->mHandle);
+          if (provider->mHandle == mLastOutgoingProviderHandle) mLastOutgoingProviderHandle = 0;
+          if (0 != mSpoolKeywords) {
+            Log::setEventingLogging(provider->mHandle, mSpoolSubscriptionID, false);
+          }
+          if (hasSentWelcome()) {
+            announceProviderToRemote(provider, false);
+          }
+
+          clients = mClients;
+        }
+
+        for (auto iter = clients->begin(); iter != clients->end(); ++iter) {
+          auto &client = (*iter);
+          client->onRemoteEventingProviderUnregistered(provider);
+        }
+      }
+      
+      //-----------------------------------------------------------------------
+      void RemoteEventing::onRemoteEventingProviderLoggingStateChanged(
+                                                                       ProviderInfo *provider,
+                                                                       KeywordBitmaskType keywords
+                                                                       )
+      {
+        if (isListener()) {
+          RemoteEventingListPtr clients;
+
+          {
+            AutoRecursiveLock lock(mLock);
+            clients = mClients;
+          }
+
+          for (auto iter = clients->begin(); iter != clients->end(); ++iter) {
+            auto &client = (*iter);
+            client->onRemoteEventingProviderLoggingStateChanged(provider, keywords);
+          }
+          return;
+        }
+
+        AutoRecursiveLock lock(mLock);
+
+        auto found = mLocalAnnouncedProviders.find(provider->mProviderID);
+        if (found != mLocalAnnouncedProviders.end()) {
+          if (isAuthorized()) {
+            announceProviderLoggingStateChangedToRemote(provider, keywords);
+          }
+          return;
+        }
+
+        if (!isAuthorized()) {
+          mRequestRemoteProviderKeywordLevel[provider->mProviderName] = keywords;
+          return;
+        }
+
+        bool requested = false;
+        for (auto iter = mRemoteRegisteredProvidersByUUID.begin(); iter != mRemoteRegisteredProvidersByUUID.end(); ++iter) {
+          auto checkProvider = (*iter).second;
+          if (provider->mProviderName == checkProvider->mProviderName) {
+            requestSetRemoteEventProviderLogging(provider->mProviderName, keywords);
+            requested = true;
+          }
+        }
+        
+        if (!requested) {
+          mRequestRemoteProviderKeywordLevel[provider->mProviderName] = keywords;
+          return;
+        }
+      }
+      
+      //-----------------------------------------------------------------------
+      void RemoteEventing::onRemoteEventingWriteEvent(
+                                                      SecureByteBlockPtr message,
+                                                      size_t currentSize,
+                                                      size_t subscribeEpoch
+                                                      )
+      {
+        size_t asyncQueued = mEventDataInAsyncQueue;
+        --mOutstandingEvents;
+        mEventDataInAsyncQueue -= currentSize;
+
+        if (subscribeEpoch != mSubscribeEpoch.load()) {
+          // the logger was unsubscribed when the connection lost its authorized state
+          ++mTotalDroppedEvents;
+          ++(mDroppedEventsByReason[DropReason_NotAuthorized]);
+          ZS_LOG_TRACE(log("discarding event posted by a previous subscription (event dropped)") + ZS_PARAM("epoch", subscribeEpoch));
+          return;
+        }
+
+        if (isListener()) {
+          RemoteEventingListPtr clients;
+
+          {
+            AutoRecursiveLock lock(mLock);
+            if (asyncQueued > mAsyncQueueBytesHighWater) mAsyncQueueBytesHighWater = asyncQueued;
+            clients = mClients;
+          }
+
+          if (!forwardListenerEvent(*clients, message->BytePtr(), currentSize)) {
+            ++mTotalDroppedEvents;
+            return;
+          }
+
+          for (auto iter = clients->begin(); iter != clients->end(); ++iter) {
+            auto &client = (*iter);
+            client->completeForwardedEvents(false);
+          }
+          return;
+        }
+
+        AutoRecursiveLock lock(mLock);
+        if (asyncQueued > mAsyncQueueBytesHighWater) mAsyncQueueBytesHighWater = asyncQueued;
+
+        if (isSpoolOnlyEvent(message->BytePtr())) return;
+
+        if (shouldSpoolEvent(currentSize)) {
+          if (spoolEvent(message->BytePtr(), currentSize)) {
+            // an idle connection replays the spool straight away
+            if ((isAuthorized()) && (mWriteReady)) sendOutgoingData();
+            return;
+          }
+        }
+
+        if (!isAuthorized()) {
+          ++mTotalDroppedEvents;
+          ++(mDroppedEventsByReason[DropReason_NotAuthorized]);
+          ZS_LOG_WARNING(Insane, log("ignoring event as not in authorized connection state (event dropped)"));
+          return;
+        }
+
+        if (!admitOutgoingEvent(message->BytePtr(), currentSize)) {
+          ++mTotalDroppedEvents;
+          return;
+        }
+
+        queueOutgoingEvent(message->BytePtr(), currentSize);
+
+        if (mEventBatchSize > 0) {
+          // events already posted to the queue ahead of the flush join the same batch
+          if (mEventBatchFlushPending) return;
+
+          auto pThis = mThisWeak.lock();
+          if (pThis) {
+            mEventBatchFlushPending = true;
+            IRemoteEventingAsyncDelegateProxy::create(pThis)->onRemoteEventingFlushEventBatch();
+            return;
+          }
+
+          // being destroyed so the batch cannot wait for a flush
+          flushEventBatch();
+        }
+
+        if (mWriteReady) {
+          sendOutgoingData();
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::onRemoteEventingDrainEventRings()
+      {
+        // cleared before draining so any event committed afterwards causes another drain
+        mEventRingDrainPending = false;
+
+        if (isListener()) {
+          // a listener forwards to its clients without holding its own lock
+          drainEventRings();
+          return;
+        }
+
+        AutoRecursiveLock lock(mLock);
+        drainEventRings();
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::onRemoteEventingFlushEventBatch()
+      {
+        AutoRecursiveLock lock(mLock);
+        mEventBatchFlushPending = false;
+
+        flushEventBatch();
+
+        if (mWriteReady) {
+          sendOutgoingData();
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::onRemoteEventingClientStateChanged()
+      {
+        {
+          AutoRecursiveLock lock(mLock);
+
+          if ((isShuttingDown()) ||
+              (isShutdown())) {
+            ZS_LOG_TRACE(log("ignoring client state change as shutting down"));
+            return;
+          }
+
+          size_t authorized = 0;
+          pruneClients();
+          for (auto iter = mClients->begin(); iter != mClients->end(); ++iter) {
+            auto &client = (*iter);
+            if (State_Connected == client->getState()) ++authorized;
+          }
+
+          ZS_LOG_DEBUG(log("client state changed") + ZS_PARAM("clients", mClients->size()) + ZS_PARAM("authorized", authorized));
+
+          if (0 == authorized) {
+            onRemoteEventingUnsubscribeLogger();
+            if (mBindSocket) setState(State_Listening);
+            return;
+          }
+
+          onRemoteEventingSubscribeLogger();
+          setState(State_Connected);
+        }
+
+        // the backlog is fanned out to the clients without the listener lock held
+        replayListenerSpool();
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::onRemoteEventingListenerShutdown()
+      {
+        ZS_LOG_DEBUG(log("listener shutdown"));
+
+        AutoRecursiveLock lock(mLock);
+        cancel();
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::onRemoteEventingLocalChannelReadReady(PUID channelID)
+      {
+        AutoRecursiveLock lock(mLock);
+
+        if ((!mLocalChannel) ||
+            (channelID != mLocalChannel->mID)) {
+          ZS_LOG_TRACE(log("read ready on obsolete local channel") + ZS_PARAM("channel", channelID));
+          return;
+        }
+
+        if (!mLocalChannel->mReady) step();
+        if ((!mLocalChannel) ||
+            (!mLocalChannel->mReady)) return;
+
+        readLocalChannel();
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::onRemoteEventingLocalChannelWriteReady(PUID channelID)
+      {
+        AutoRecursiveLock lock(mLock);
+
+        if ((!mLocalChannel) ||
+            (channelID != mLocalChannel->mID) ||
+            (!mLocalChannel->mReady)) {
+          ZS_LOG_TRACE(log("write ready on obsolete local channel") + ZS_PARAM("channel", channelID));
+          return;
+        }
+
+        mWriteReady = true;
+        sendOutgoingData();
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::onRemoteEventingLocalChannelClosed(PUID channelID)
+      {
+        AutoRecursiveLock lock(mLock);
+
+        if ((!mLocalChannel) ||
+            (channelID != mLocalChannel->mID)) {
+          ZS_LOG_TRACE(log("obsolete local channel closed") + ZS_PARAM("channel", channelID));
+          return;
+        }
+
+        ZS_LOG_WARNING(Detail, log("local party closed the local channel"));
+        closeLocalChannel();
+        disconnect();
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::onRemoteEventingReceiveWorkerProgress()
+      {
+        ReceiveWorkerList stopped;
+
+        {
+          AutoRecursiveLock lock(mLock);
+
+          releaseRetiredRemoteProviders();
+          resumeReceiving();
+
+          // stopping workers exit right after passing their final barrier
+          bool drained = true;
+          for (auto iter = mStoppingReceiveWorkers.begin(); iter != mStoppingReceiveWorkers.end(); ++iter) {
+            if ((*iter)->getPassedBarrier() < mReceiveBarrier) drained = false;
+          }
+          if (drained) stopped.swap(mStoppingReceiveWorkers);
+        }
+
+        if (stopped.empty()) return;
+
+        // joined without holding any lock as a worker may still be inside a
+        // listener which is waiting on a lock held by whoever called cancel
+        for (auto iter = stopped.begin(); iter != stopped.end(); ++iter) {
+          (*iter)->join();
+        }
+
+        ZS_LOG_DEBUG(log("receive workers stopped"));
+
+        AutoRecursiveLock lock(mLock);
+        cancel();
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RemoteEventing => (internal)
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      Log::Params RemoteEventing::slog(const char *message)
+      {
+        return Log::Params(message, "eventing::RemoteEventing");
+      }
+
+      //-----------------------------------------------------------------------
+      Log::Params RemoteEventing::log(const char *message)
+      {
+        ElementPtr objectEl = Element::create("eventing::RemoteEventing");
+        objectEl->adoptAsLastChild(UseEventingHelper::createElementWithNumber("id", string(mID)));
+        return Log::Params(message, objectEl);
+      }
+
+      //-----------------------------------------------------------------------
+      IRemoteEventingPtr RemoteEventing::getPublicConnection() const
+      {
+        // the accepted parties of a listener are only known through the listener
+        if (mIsClient) return mParentWeak.lock();
+        return mThisWeak.lock();
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::disconnect()
+      {
+        auto pThis = mThisWeak.lock();
+        if (!pThis) {
+          ZS_LOG_WARNING(Detail, log("disconnect as pThis is null (shutting down)"));
+          cancel();
+          return;
+        }
+        
+        IRemoteEventingAsyncDelegateProxy::create(pThis)->onRemoteEventingUnsubscribeLogger();
+        
+        if ((!isListeningMode()) ||
+            (mIsClient)) {
+          ZS_LOG_DEBUG(log("disconnecting forwarding to cancel"));
+          cancel();
+          return;
+        }
+
+        if (isShuttingDown()) {
+          ZS_LOG_TRACE(log("disconnect forwarding to shutdown"));
+          cancel();
+          return;
+        }
+
+        if (mAcceptedSocket) {
+          if (MessageType_Welcome == mHandshakeState) {
+            sendData(MessageType_Goodbye, SecureByteBlock());
+            mHandshakeState = MessageType_Goodbye;
+          }
+
+          ZS_LOG_TRACE(log("disconnecting accepted socket"));
+          try {
+            mAcceptedSocket->close();
+          } catch (const Socket::Exceptions::Unspecified &) {
+            ZS_LOG_WARNING(Debug, log("could not read active socket"));
+          }
+          mAcceptedSocket.reset();
+        }
+
+        if (mLocalChannel) {
+          if (MessageType_Welcome == mHandshakeState) {
+            sendData(MessageType_Goodbye, SecureByteBlock());
+            mHandshakeState = MessageType_Goodbye;
+          }
+
+          ZS_LOG_TRACE(log("disconnecting local channel"));
+          closeLocalChannel();
+        }
+
+        prepareNewConnection();
+
+        if (isLocalMode()) {
+          // the local channel cannot be reused so a new one is offered
+          IWakeDelegateProxy::create(pThis)->onWake();
+        }
+      }
+      
+      //-----------------------------------------------------------------------
+      void RemoteEventing::cancel()
+      {
+        ZS_LOG_TRACE(log("cancel called"));
+        
+        if (isShutdown()) {
+          ZS_LOG_TRACE(log("already shutdown"));
+          return;
+        }
+        
+        setState(State_ShuttingDown);
+
+        saveResumeInfo();
+
+        if (isListener()) {
+          // the clients are shutdown asynchronously as they may be waiting for the listener lock
+          for (auto iter = mClients->begin(); iter != mClients->end(); ++iter) {
+            auto &client = (*iter);
+            IRemoteEventingAsyncDelegateProxy::create(client)->onRemoteEventingListenerShutdown();
+          }
+          mClients = make_shared<RemoteEventingList>();
+        }
+        
+        if ((!mIsClient) &&
+            (0 != mSpoolKeywords)) {
+          for (auto iter = mLocalAnnouncedProviders.begin(); iter != mLocalAnnouncedProviders.end(); ++iter) {
+            auto provider = (*iter).second;
+            Log::setEventingLogging(provider->mHandle, mSpoolSubscriptionID, false);
+          }
+        }
+        mSpoolKeywords = 0;
+        if (mSpool) --mEventOriginParties;
+        mSpool.reset();
+
+        endRecordedConnection();
+        if ((mRecorder) &&
+            (!mIsClient)) {
+          mRecorder->close();
+        }
+        mRecorder.reset();
+
+        for (auto iter = mRemoteRegisteredProvidersByUUID.begin(); iter != mRemoteRegisteredProvidersByUUID.end(); ++iter) {
+          auto provider = (*iter).second;
+          Log::setEventingLogging(provider->mHandle, mID, false);
+          retireRemoteProvider(provider);
+        }
+        
+        mRemoteRegisteredProvidersByUUID.clear();
+        mRemoteRegisteredProvidersByRemoteHandle.clear();
+        mRemoteProviders.clear();
+        mFreeRemoteProviderIndexes.clear();
+        mOverflowRemoteProviders.clear();
+
+        auto pThis = mThisWeak.lock();
+        mGracefulShutdownReference = pThis;
+
+        // queued events are written before their providers' writers go away
+        if (stopReceiveWorkers()) {
+          ZS_LOG_TRACE(log("waiting for receive workers to stop"));
+          return;
+        }
+
+        if (mGracefulShutdownReference) {
+          IRemoteEventingAsyncDelegateProxy::create(pThis)->onRemoteEventingUnsubscribeLogger();
+
+          if (MessageType_Welcome == mHandshakeState) {
+            sendData(MessageType_Goodbye, SecureByteBlock());
+            mHandshakeState = MessageType_Goodbye;
+          }
+
+          if (0 != mEventDataInOutgoingQueue) {
+            auto activeSocket = getActiveSocket();
+            if ((activeSocket) ||
+                ((mLocalChannel) && (mLocalChannel->mReady))) {
+              ZS_LOG_TRACE(log("waiting until shutdown"));
+              return;
+            }
+          }
+        }
+        
+        resetConnection();
+
+        try {
+          if (mAcceptedSocket) mAcceptedSocket->close();
+        } catch (const Socket::Exceptions::Unspecified &) {
+          ZS_LOG_WARNING(Debug, log("failed to close accepted socket"));
+        }
+        try {
+          if (mBindSocket) mBindSocket->close();
+        } catch (const Socket::Exceptions::Unspecified &) {
+          ZS_LOG_WARNING(Debug, log("failed to close bind socket"));
+        }
+        try {
+          if (mConnectSocket) mConnectSocket->close();
+        } catch (const Socket::Exceptions::Unspecified &) {
+          ZS_LOG_WARNING(Debug, log("failed to close connect socket"));
+        }
+        
+        mAcceptedSocket.reset();
+        mBindSocket.reset();
+        mConnectSocket.reset();
+
+        closeLocalChannel();
+
+        if (mRebindTimer) {
+          mRebindTimer->cancel();
+          mRebindTimer.reset();
+        }
+        
+        setState(State_Shutdown);
+        
+        mGracefulShutdownReference.reset();
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::step()
+      {
+        ZS_LOG_DEBUG(log("step"));
+        
+        if ((isShuttingDown()) ||
+            (isShutdown())) {
+          ZS_LOG_TRACE(log("step forwarding to cancel"));
+          return;
+        }
+        
+        {
+          if (isListener()) {
+            // every accepted party is stepped by its own connection
+            stepSocketBind();
+            return;
+          }
+          if (isLocalMode()) {
+            if (!stepLocalChannel()) return;
+            if (isConnectingMode()) {
+              if (!stepHello()) return;
+            }
+          } else if (isListeningMode()) {
+            if (!stepWaitForAccept()) return;
+          } else {
+            if (!stepSocketConnect()) return;
+            if (!stepWaitConnected()) return;
+            if (!stepHello()) return;
+          }
+          if (!stepNotifyTimer()) return;
+          if (!stepAuthorized()) return;
+        }
+
+        setState(State_Connected);
+      }
+
+      //-----------------------------------------------------------------------
+      bool RemoteEventing::stepSocketBind()
+      {
+        if (mBindSocket) {
+          ZS_LOG_TRACE(log("step - already bound"));
+          return true;
+        }
+        
+        if (mRebindTimer) {
+          ZS_LOG_TRACE(log("step - waiting for rebind timer"));
+          return true;
+        }
+        
+        ZS_LOG_DEBUG(log("step - attempting to bind"));
+        
+        IPAddress bindIP(mUseIPv6 ? IPAddress::anyV6() : IPAddress::anyV4(), mListenPort);
+
+        if (Time() == mBindFailureTime) {
+          mBindFailureTime = zsLib::now() + mMaxWaitToBindTime;
+        }
+
+        try {
+          mBindSocket = Socket::createTCP(mUseIPv6 ? Socket::Create::Family::IPv6 : Socket::Create::Family::IPv4);
+          mBindSocket->setBlocking(false);
+          mBindSocket->setDelegate(mThisWeak.lock());
+          mBindSocket->bind(bindIP);
+          mBindSocket->listen();
+        } catch (const Socket::Exceptions::Unspecified &) {
+          auto tick = zsLib::now();
+          if (tick > mBindFailureTime) {
+            ZS_LOG_ERROR(Detail, log("failed to bind to socket") + ZS_PARAM("port", string(mListenPort)));
+            cancel();
+            return false;
+          }
+          
+          ZS_LOG_WARNING(Debug, log("failed to bind (will attempt again in 1 second)"));
+          mRebindTimer = ITimer::create(mThisWeak.lock(), Seconds(1), false);
+          try {
+            if (mBindSocket) mBindSocket->close();
+          } catch (const Socket::Exceptions::Unspecified &) {
+            ZS_LOG_WARNING(Debug, log("failed to close listen socket"));
+          }
+          mBindSocket.reset();
+          return false;
+        }
+
+        mBindFailureTime = Time();
+
+        setState(State_Listening);
+        return true;
+      }
+      
+      //-----------------------------------------------------------------------
+      bool RemoteEventing::stepWaitForAccept()
+      {
+        if (!mAcceptedSocket) {
+          ZS_LOG_TRACE(log("step - waiting for socket to accept"));
+          return false;
+        }
+        
+        ZS_LOG_TRACE(log("step - have accepted socket"));
+        return true;
+      }
+      
+      //-----------------------------------------------------------------------
+      bool RemoteEventing::stepSocketConnect()
+      {
+        if (mConnectSocket) {
+          ZS_LOG_TRACE(log("step - already have a socket connecting"));
+          return true;
+        }
+        
+        ZS_LOG_DEBUG(log("conencting"));
+
+        try {
+          mConnectSocket = Socket::createTCP(mServerIP.isIPv4() ? Socket::Create::Family::IPv4 : Socket::Create::Family::IPv6);
+          mConnectSocket->setBlocking(false);
+          mConnectSocket->setDelegate(mThisWeak.lock());
+          bool wouldBlock = false;
+          mConnectSocket->connect(mServerIP, &wouldBlock);
+        } catch (const Socket::Exceptions::Unspecified &) {
+          ZS_LOG_WARNING(Detail, log("failed to connect (shutting down)"));
+          disconnect();
+          return false;
+        }
+        
+        setState(State_Connecting);
+
+        return true;
+      }
+
+      //-----------------------------------------------------------------------
+      bool RemoteEventing::stepWaitConnected()
+      {
+        if (!mConnected) {
+          ZS_LOG_TRACE(log("step waiting to connect"));
+          return false;
+        }
+        
+        ZS_LOG_TRACE(log("step - connected"));
+        return true;
+      }
+      
+      //-----------------------------------------------------------------------
+      bool RemoteEventing::stepHello()
+      {
+        if (MessageType_Hello != mHandshakeState) {
+          ZS_LOG_TRACE(log("step - skipping hello"));
+          return true;
+        }
+
+        // a recorded connection is started before anything is negotiated
+        beginRecordedConnection();
+
+        ElementPtr rootEl = Element::create("hello");
+
+        mHelloSalt = IHelper::randomString(IHasher::sha256DigestSize()*8/5);
+        rootEl->adoptAsFirstChild(IHelper::createElementWithNumber("version", "1"));
+        rootEl->adoptAsFirstChild(IHelper::createElementWithText("salt", mHelloSalt));
+        if (mUseEventBatches) {
+          rootEl->adoptAsFirstChild(IHelper::createElementWithNumber("eventBatch", ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_BATCH_VERSION));
+        }
+        if (useCompactEvents()) {
+          rootEl->adoptAsFirstChild(IHelper::createElementWithNumber("compactEvents", ZSLIB_EVENTING_REMOTE_EVENTING_COMPACT_EVENTS_VERSION));
+        }
+        rootEl->adoptAsFirstChild(IHelper::createElementWithNumber("eventOrigin", ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_ORIGIN_VERSION));
+        rootEl->adoptAsFirstChild(IHelper::createElementWithNumber("denseProviders", ZSLIB_EVENTING_REMOTE_EVENTING_DENSE_PROVIDERS_VERSION));
+        rootEl->adoptAsFirstChild(IHelper::createElementWithNumber("nativeByteOrder", ZSLIB_EVENTING_REMOTE_EVENTING_NATIVE_BYTE_ORDER_VERSION));
+        rootEl->adoptAsFirstChild(IHelper::createElementWithNumber("eventBacklog", ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_BACKLOG_VERSION));
+
+        if (0 != mMaxResumableSessions) {
+          ResumeInfoCache &cache = getResumeInfoCache();
+          AutoLock lock(cache.mLock);
+          auto found = cache.mResumes.find(getResumeKey());
+          if (found != cache.mResumes.end()) {
+            mResume = (*found).second;
+            cache.mResumes.erase(found);
+          }
+        }
+        if (mResume) {
+          rootEl->adoptAsFirstChild(IHelper::createElementWithText("session", mResume->mToken));
+          rootEl->adoptAsFirstChild(IHelper::createElementWithNumber("sessionEpoch", string(mResume->mEpoch)));
+          rootEl->adoptAsFirstChild(IHelper::createElementWithNumber("sessionDigest", string(getSessionDigest(mResume->mProviders, mResume->mSubsystems))));
+        }
+
+        String helloProof = IHasher::hashAsString("hello:proof:" + mSharedSecret + ":" + mHelloSalt, IHasher::sha256());
+        rootEl->adoptAsFirstChild(IHelper::createElementWithText("proof", helloProof));
 
         mExpectingHelloProofInChallenge = IHasher::hashAsString("hello:expecting:" + mSharedSecret + ":" + mHelloSalt, IHasher::sha256());
         mHandshakeState = MessageType_Challenge;
-        sendData(MessageType_Hello, rootEl);
-        return false;
+        sendData(MessageType_Hello, rootEl);
+        return false;
+      }
+      
+      //-----------------------------------------------------------------------
+      bool RemoteEventing::stepLocalChannel()
+      {
+        if (mLocalChannel) {
+          if (mLocalChannel->mReady) {
+            ZS_LOG_TRACE(log("step - local channel attached"));
+            return true;
+          }
+
+          if (!mLocalChannel->isPeerAttached()) {
+            ZS_LOG_TRACE(log("step - waiting for local party to attach"));
+            return false;
+          }
+
+          ZS_LOG_DEBUG(log("step - local party attached") + ZS_PARAM("channel", mLocalChannel->mID));
+
+          // no other party can find the channel once attached
+          mLocalChannel->unlink();
+          mLocalChannel->mReady = true;
+          mWriteReady = true;
+          setState(State_Connecting);
+          return true;
+        }
+
+        if (isListeningMode()) {
+          ZS_LOG_DEBUG(log("step - creating local channel") + ZS_PARAM("name", mLocalName));
+
+          mLocalChannel = LocalChannel::create(mLocalName, mLocalChannelRingSize);
+          if (!mLocalChannel) {
+            ZS_LOG_ERROR(Detail, log("failed to create local channel") + ZS_PARAM("name", mLocalName));
+            cancel();
+            return false;
+          }
+
+          mLocalChannel->startWaiter(IRemoteEventingAsyncDelegateProxy::createWeak(mThisWeak.lock()));
+          setState(State_Listening);
+          return false;
+        }
+
+        ZS_LOG_DEBUG(log("step - attaching to local channel") + ZS_PARAM("name", mLocalName));
+
+        mLocalChannel = LocalChannel::attach(mLocalName);
+        if (!mLocalChannel) {
+          ZS_LOG_WARNING(Detail, log("failed to attach to local channel (shutting down)") + ZS_PARAM("name", mLocalName));
+          disconnect();
+          return false;
+        }
+
+        mLocalChannel->mReady = true;
+        mLocalChannel->startWaiter(IRemoteEventingAsyncDelegateProxy::createWeak(mThisWeak.lock()));
+        mWriteReady = true;
+        setState(State_Connecting);
+        return true;
+      }
+
+      //-----------------------------------------------------------------------
+      bool RemoteEventing::stepNotifyTimer()
+      {
+        if (mNotifyTimer) {
+          ZS_LOG_TRACE(log("step - already have notify timer"));
+          return true;
+        }
+        
+        Seconds notifyTimeout(ISettings::getUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_NOTIFY_TIMER));
+        if (notifyTimeout < Seconds(1)) {
+          notifyTimeout = Seconds(1);
+        }
+
+        mNotifyTimer = ITimer::create(mThisWeak.lock(), notifyTimeout);
+        return true;
+      }
+
+      //-----------------------------------------------------------------------
+      bool RemoteEventing::stepAuthorized()
+      {
+        if (!isAuthorized()) {
+          ZS_LOG_TRACE(log("step - not authorized"));
+          return false;
+        }
+
+        ZS_LOG_TRACE(log("step - authorized"));
+        return true;
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::setState(States state)
+      {
+        if (state == mState) return;
+        
+        ZS_LOG_DEBUG(log("state changed") + ZS_PARAM("old state", IRemoteEventingTypes::toString(mState)) + ZS_PARAM("new state", state));
+        
+        mState = state;
+
+        if (mIsClient) {
+          // the listener reports a single state for all of its accepted parties
+          auto parent = mParentWeak.lock();
+          if (parent) IRemoteEventingAsyncDelegateProxy::create(parent)->onRemoteEventingClientStateChanged();
+          return;
+        }
+
+        auto pThis = mThisWeak.lock();
+        if (pThis) {
+          if (mDelegate) {
+            try {
+              mDelegate->onRemoteEventingStateChanged(pThis, mState);
+            } catch (const IRemoteEventingDelegateProxy::Exceptions::DelegateGone &) {
+              ZS_LOG_WARNING(Detail, log("delegate gone (probably okay)"));
+              mDelegate.reset();
+            }
+          }
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::resetConnection()
+      {
+        endRecordedConnection();
+
+        if (mNotifyTimer) {
+          mNotifyTimer->cancel();
+          mNotifyTimer.reset();
+        }
+        for (auto iter = mRequestedRemoteProviderKeywordLevel.begin(); iter != mRequestedRemoteProviderKeywordLevel.end(); ++iter)
+        {
+          auto provider = (*iter).second;
+          Log::setEventingLogging(provider->mHandle, mID, false);
+        }
+        mRequestedRemoteProviderKeywordLevel.clear();
+        mRequestRemoteProviderKeywordLevel.clear();
+        // the session keeps the event filters the party requested
+        closeSession();
+        resetProviderEventFilters();
+        mRequestedRemoteProviderKeywords.clear();
+        mRequestedSubsystemLevels.clear();
+
+        if (mIsClient) {
+          auto parent = mParentWeak.lock();
+          if (parent) parent->removeClientSubsystemLevels(mID);
+        }
+
+        mAnnouncedLocalDropped = 0;
+        mAnnouncedRemoteDropped = 0;
+        discardEventRings();
+        mTotalDroppedEvents = 0;
+        mProviderLoadShedding.clear();
+        mHasRemoteStatistics = false;
+        mRemoteStatistics = Statistics();
+        for (auto iter = mCleanUpProviderInfos.begin(); iter != mCleanUpProviderInfos.end(); ++iter) {
+          auto info = (*iter);
+          for (size_t index = Log::Severity_First; index <= Log::Severity_Last; ++index) {
+            info->mDroppedEvents[index] = 0;
+          }
+        }
+        mIncomingFilled = 0;
+        releaseOutgoingSegments(mOutgoingSegments);
+        mEventDataInOutgoingQueue = 0;
+
+        mPresentedSessionToken.clear();
+        mPresentedSessionEpoch = 0;
+        mPresentedSessionDigest = 0;
+
+        mHelloSalt.clear();
+        mExpectingHelloProofInChallenge.clear();
+        mChallengeSalt.clear();
+        mExpectingChallengeProofInReply.clear();
+        
+        mFlipEndianInt = false;
+        mFlipEndianFloat = false;
+
+        // until negotiated scalars are big endian on the wire
+        mRemoteUsesNativeByteOrder = false;
+        mSwapOutgoingScalars = isLittleEndianHost();
+        mSwapIncomingIntegers = isLittleEndianHost();
+        mSwapIncomingFloats = isLittleEndianHost();
+
+        mRemoteSupportsEventBacklog = false;
+
+        mRemoteSupportsEventBatches = false;
+        setEventOriginNegotiated(false);
+        resetCompactEvents(false);
+        mRemoteSupportsDenseProviders = false;
+        mLastOutgoingProviderHandle = 0;
+        mRemoteProviders.clear();
+        mFreeRemoteProviderIndexes.clear();
+        mOverflowRemoteProviders.clear();
+        releaseOutgoingSegments(mEventBatchSegments);
+        mEventBatchSize = 0;
+        mEventBatchProviderHandle = 0;
+        
+        mRemoteSubsystems.clear();
+        mReceivePaused = false;
+        for (auto iter = mRemoteRegisteredProvidersByUUID.begin(); iter != mRemoteRegisteredProvidersByUUID.end(); ++iter) {
+          auto provider = (*iter).second;
+          Log::setEventingLogging(provider->mHandle, mID, false);
+          retireRemoteProvider(provider);
+        }
+        mRemoteRegisteredProvidersByUUID.clear();
+        mRemoteRegisteredProvidersByRemoteHandle.clear();
+      }
+      
+      //-----------------------------------------------------------------------
+      void RemoteEventing::prepareNewConnection()
+      {
+        resetConnection();
+        mHandshakeState = MessageType_First;
+        setState(State_Listening);
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::readIncomingMessage()
+      {
+        size_t offset {};
+
+        // a handler that resets the connection also empties the incoming buffer
+        while ((offset < mIncomingFilled) &&
+               (MessageType_Goodbye != mHandshakeState) &&
+               (!mReceivePaused))
+        {
+          size_t available = mIncomingFilled - offset;
+          BYTE *pos = mIncomingBuffer.BytePtr() + offset;
+
+          CryptoPP::word32 messageSize{};
+          if (available < sizeof(messageSize)) {
+            ZS_LOG_INSANE(log("insufficient read size for next message") + ZS_PARAM("size", available));
+            break;
+          }
+
+          // message size does include the size of the message type
+          messageSize = IHelper::getBE32(pos);
+          if (static_cast<size_t>(messageSize) > getMaxIncomingMessageSize()) {
+            ZS_LOG_WARNING(Detail, log("incoming message exceeds maximum size (disconnecting)") + ZS_PARAM("size", messageSize) + ZS_PARAM("max", getMaxIncomingMessageSize()) + ZS_PARAM("authorized", isAuthorized()));
+            disconnect();
+            return;
+          }
+          if (available < sizeof(messageSize) + messageSize) {
+            ZS_LOG_INSANE(log("insufficient read size for next message") + ZS_PARAM("available", available) + ZS_PARAM("size", messageSize));
+            break;
+          }
+
+          CryptoPP::word32 messageType {};
+          if (messageSize < sizeof(messageType)) {
+            ZS_LOG_WARNING(Detail, log("illegal message size (disconnecting)"));
+            disconnect();
+            return;
+          }
+
+          messageType = IHelper::getBE32(pos + sizeof(messageSize));
+
+          BYTE *message = pos + sizeof(messageSize) + sizeof(messageType);
+          offset += sizeof(messageSize) + messageSize;
+          messageSize -= sizeof(messageType);
+
+          if (MessageType_Welcome == mHandshakeState) {
+            // recorded before being handled as decoding swaps scalars in place
+            if (mConnectionRecorder) mConnectionRecorder->recordFrame(mRecordConnectionID, pos, sizeof(messageSize) + sizeof(messageType) + messageSize);
+            handleAuthorizedMessage(static_cast<MessageTypes>(messageType), message, messageSize);
+          } else {
+            handleHandshakeMessage(static_cast<MessageTypes>(messageType), message, messageSize);
+          }
+        }
+
+        if (offset >= mIncomingFilled) {
+          mIncomingFilled = 0;
+          return;
+        }
+
+        // carry the partial message over to the start of the buffer
+        if (0 != offset) {
+          memmove(mIncomingBuffer.BytePtr(), mIncomingBuffer.BytePtr() + offset, mIncomingFilled - offset);
+          mIncomingFilled -= offset;
+        }
+
+        size_t required = mIncomingBuffer.SizeInBytes();
+        if (mIncomingFilled >= sizeof(CryptoPP::word32)) {
+          size_t messageSize = static_cast<size_t>(IHelper::getBE32(mIncomingBuffer.BytePtr()));
+
+          // never size the buffer from an unchecked length as read off the wire
+          if (messageSize > getMaxIncomingMessageSize()) {
+            ZS_LOG_WARNING(Detail, log("incoming message exceeds maximum size (disconnecting)") + ZS_PARAM("size", messageSize) + ZS_PARAM("max", getMaxIncomingMessageSize()) + ZS_PARAM("authorized", isAuthorized()));
+            disconnect();
+            return;
+          }
+          required = sizeof(CryptoPP::word32) + messageSize;
+        }
+        if (required >= mIncomingBuffer.SizeInBytes()) {
+          ZS_LOG_TRACE(log("growing incoming buffer to fit message") + ZS_PARAMIZE(required));
+          mIncomingBuffer.resize(required + 1);
+        }
+      }
+      
+      //-----------------------------------------------------------------------
+      void RemoteEventing::readActiveSocket()
+      {
+        auto activeSocket = getActiveSocket();
+        if (!activeSocket) return;
+
+        if (mIncomingBuffer.SizeInBytes() < mIncomingBufferSize) {
+          mIncomingBuffer.resize(mIncomingBufferSize);
+        }
+
+        // read until the socket would block; parsing after every read
+        // always leaves room at the end of the buffer for the next read
+        while (!mReceivePaused) {
+          bool wouldBlock = false;
+          size_t read {};
+
+          try {
+            ++mReceiveCalls;
+            read = activeSocket->receive(mIncomingBuffer.BytePtr() + mIncomingFilled, mIncomingBuffer.SizeInBytes() - mIncomingFilled, &wouldBlock);
+            mIncomingFilled += read;
+          } catch (const Socket::Exceptions::Unspecified &) {
+            ZS_LOG_WARNING(Debug, log("could not read active socket"));
+            wouldBlock = true;
+          }
+
+          readIncomingMessage();
+
+          if ((wouldBlock) || (0 == read)) break;
+          if (activeSocket != getActiveSocket()) break;
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      size_t RemoteEventing::getMaxIncomingMessageSize() const
+      {
+        if (!isAuthorized()) return ZSLIB_EVENTING_REMOTE_EVENTING_MAX_HANDSHAKE_MESSAGE_SIZE;
+        return ZSLIB_EVENTING_REMOTE_EVENTING_MAX_MESSAGE_SIZE;
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::sendOutgoingData()
+      {
+        if (!mWriteReady) {
+          ZS_LOG_INSANE(log("waiting for write ready to be able to send"));
+          return;
+        }
+        
+        if (0 == mEventDataInOutgoingQueue) {
+          if ((isListener()) || (!replaySpool())) {
+            ZS_LOG_INSANE(log("no data available to send"));
+            return;
+          }
+        }
+        
+        auto activeSocket = getActiveSocket();
+        if ((!activeSocket) &&
+            (!mLocalChannel)) {
+          ZS_LOG_INSANE(log("no socket available to send"));
+          return;
+        }
+        
+        try {
+          while (mWriteReady) {
+            if (mEventDataInOutgoingQueue < 1) {
+              // the spooled backlog is refilled whenever the connection drains
+              if ((isListener()) || (!replaySpool())) break;
+              continue;
+            }
+
+            bool wouldBlock = false;
+            auto written = (mLocalChannel ? writeOutgoingLocal(wouldBlock) : writeOutgoing(activeSocket, wouldBlock));
+
+            consumeOutgoing(static_cast<size_t>(written));
+            if (wouldBlock) mWriteReady = false;
+          }
+        } catch (const Socket::Exceptions::Unspecified &) {
+          ZS_LOG_WARNING(Debug, log("could not write to active socket"));
+        }
+
+        if ((mLocalChannel) &&
+            (mLocalChannel->mFailed)) {
+          ZS_LOG_WARNING(Detail, log("local channel ring positions are corrupt (disconnecting)") + ZS_PARAM("channel", mLocalChannel->mID));
+          closeLocalChannel();
+          disconnect();
+          return;
+        }
+
+        if (isShuttingDown()) {
+          ZS_LOG_TRACE(log("step after write ready"));
+          cancel();
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::readLocalChannel()
+      {
+        if (mIncomingBuffer.SizeInBytes() < mIncomingBufferSize) {
+          mIncomingBuffer.resize(mIncomingBufferSize);
+        }
+
+        // read until the ring is empty and read ready notification is armed;
+        // parsing after every read always leaves room for the next read
+        auto channel = mLocalChannel;
+        while ((channel == mLocalChannel) &&
+               (!mReceivePaused)) {
+          ++mReceiveCalls;
+          size_t read = channel->receive(mIncomingBuffer.BytePtr() + mIncomingFilled, mIncomingBuffer.SizeInBytes() - mIncomingFilled);
+          if (channel->mFailed) {
+            ZS_LOG_WARNING(Detail, log("local channel ring positions are corrupt (disconnecting)") + ZS_PARAM("channel", channel->mID));
+            closeLocalChannel();
+            disconnect();
+            return;
+          }
+          mIncomingFilled += read;
+
+          readIncomingMessage();
+
+          if (0 != read) continue;
+          if (channel != mLocalChannel) break;
+          if (channel->armRead()) break;
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::closeLocalChannel()
+      {
+        if (!mLocalChannel) return;
+
+        ZS_LOG_TRACE(log("closing local channel") + ZS_PARAM("channel", mLocalChannel->mID));
+
+        mLocalChannel->close();
+        mLocalChannel.reset();
+        mWriteReady = false;
+      }
+
+      //-----------------------------------------------------------------------
+      RemoteEventingPtr RemoteEventing::createClient(
+                                                     SocketPtr socket,
+                                                     const IPAddress &remoteIP
+                                                     )
+      {
+        auto pClient = make_shared<RemoteEventing>(make_private{}, getAssociatedMessageQueue(), IRemoteEventingDelegatePtr(), mSharedSecret.c_str(), IPAddress(), mListenPort, Seconds());
+        pClient->mThisWeak = pClient;
+        pClient->mDelegate = mDelegate;
+        pClient->mIsClient = true;
+        pClient->mParentWeak = mThisWeak;
+        pClient->mParentID = mID;
+        pClient->mParentDroppedEventsBaseline = getListenerDroppedEvents();
+
+        // already known subsystems and providers are announced after the welcome
+        pClient->mLocalSubsystems = mLocalSubsystems;
+        pClient->mLocalAnnouncedProviders = mLocalAnnouncedProviders;
+        pClient->mLocalAnnouncedProviderIndexes = mLocalAnnouncedProviderIndexes;
+        pClient->mSetRemoteSubsystemsLevels = mSetRemoteSubsystemsLevels;
+        pClient->mSetRemoteProviderEvents = mSetRemoteProviderEvents;
+        pClient->mSpoolKeywords = mSpoolKeywords;
+        pClient->mRecorder = mRecorder;
+
+        pClient->mAcceptedSocket = socket;
+        pClient->mRemoteIP = remoteIP;
+        socket->setDelegate(pClient);
+
+        pClient->setState(State_Connecting);
+        pClient->init();
+        return pClient;
+      }
+
+      //-----------------------------------------------------------------------
+      size_t RemoteEventing::pruneClients()
+      {
+        bool prune = false;
+        for (auto iter = mClients->begin(); iter != mClients->end(); ++iter) {
+          auto &client = (*iter);
+          if (State_Shutdown != client->getState()) continue;
+          prune = true;
+          break;
+        }
+
+        if (prune) {
+          RemoteEventingListPtr replacement(make_shared<RemoteEventingList>());
+          for (auto iter = mClients->begin(); iter != mClients->end(); ++iter) {
+            auto &client = (*iter);
+            if (State_Shutdown == client->getState()) continue;
+            replacement->push_back(client);
+          }
+          mClients = replacement;
+        }
+
+        return mClients->size();
+      }
+
+      //-----------------------------------------------------------------------
+      bool RemoteEventing::forwardListenerEvent(
+                                                const RemoteEventingList &clients,
+                                                const BYTE *message,
+                                                size_t messageSize
+                                                )
+      {
+        // called without the listener lock held so the clients are never
+        // locked while the listener lock is
+        {
+          AutoRecursiveLock lock(mLock);
+          // events follow a backlog still waiting for its parties into the spool to keep their order
+          if ((mSpool) &&
+              (!mSpool->isEmpty()) &&
+              (spoolEvent(message, messageSize))) return true;
+        }
+
+        if (fanOutEvent(clients, message, messageSize)) return true;
+
+        AutoRecursiveLock lock(mLock);
+        if (spoolEvent(message, messageSize)) return true;
+
+        ++(mDroppedEventsByReason[DropReason_NotAuthorized]);
+        ZS_LOG_WARNING(Insane, log("ignoring event as no client is in authorized connection state (event dropped)"));
+        return false;
+      }
+
+      //-----------------------------------------------------------------------
+      bool RemoteEventing::fanOutEvent(
+                                       const RemoteEventingList &clients,
+                                       const BYTE *message,
+                                       size_t messageSize,
+                                       bool backlog
+                                       )
+      {
+        // message is [size][type][origin][provider handle][event header][data]
+        const BYTE *handlePos = message + (sizeof(CryptoPP::word32)*2) + ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_ORIGIN_SIZE;
+        ProviderHandle handle = static_cast<ProviderHandle>(IHelper::getBE64(handlePos));
+
+        bool anySubscribed = false;
+        for (auto iter = clients.begin(); iter != clients.end(); ++iter) {
+          auto &client = (*iter);
+          if (!client->isSubscribedProvider(handle)) continue;
+          anySubscribed = true;
+          break;
+        }
+
+        // the packed message is shared by every client; only the wire
+        // encoding negotiated by each client is done per client
+        bool authorized = false;
+        for (auto iter = clients.begin(); iter != clients.end(); ++iter) {
+          auto &client = (*iter);
+          if ((backlog) &&
+              (!client->isReplayTarget())) continue;
+          if (client->forwardOutgoingEvent(message, messageSize, anySubscribed, backlog)) authorized = true;
+        }
+        return authorized;
+      }
+
+      //-----------------------------------------------------------------------
+      bool RemoteEventing::isSubscribedProvider(ProviderHandle handle) const
+      {
+        AutoRecursiveLock lock(mLock);
+        return mRequestedRemoteProviderKeywords.end() != mRequestedRemoteProviderKeywords.find(handle);
+      }
+
+      //-----------------------------------------------------------------------
+      bool RemoteEventing::isReplayTarget() const
+      {
+        AutoRecursiveLock lock(mLock);
+        if (!isAuthorized()) return false;
+        return !mRequestedRemoteProviderKeywords.empty();
+      }
+
+      //-----------------------------------------------------------------------
+      bool RemoteEventing::forwardOutgoingEvent(
+                                                const BYTE *message,
+                                                size_t messageSize,
+                                                bool anySubscribed,
+                                                bool backlog
+                                                )
+      {
+        AutoRecursiveLock lock(mLock);
+        if (!isAuthorized()) return false;
+
+        // the backlog is filtered like live events so a party only receives
+        // the spooled events of what it subscribed to
+        if (!isForwardedEventWanted(message, messageSize, anySubscribed)) return true;
+
+        // each client sheds against its own outgoing queue so a slow client never throttles the others
+        if (!admitOutgoingEvent(message, messageSize)) {
+          ++mTotalDroppedEvents;
+          return true;
+        }
+
+        queueOutgoingEvent(message, messageSize, backlog);
+        return true;
+      }
+
+      //-----------------------------------------------------------------------
+      bool RemoteEventing::isForwardedEventWanted(
+                                                  const BYTE *message,
+                                                  size_t messageSize,
+                                                  bool anySubscribed
+                                                  ) const
+      {
+        // message is [size][type][origin][provider handle][event header][data]
+        const BYTE *handlePos = message + (sizeof(CryptoPP::word32)*2) + ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_ORIGIN_SIZE;
+        const BYTE *headerPos = handlePos + sizeof(uint64_t);
+        const BYTE *endPos = message + messageSize;
+
+        ProviderHandle handle = static_cast<ProviderHandle>(IHelper::getBE64(handlePos));
+
+        auto found = mRequestedRemoteProviderKeywords.find(handle);
+        if (found == mRequestedRemoteProviderKeywords.end()) {
+          // the provider is only logging because another client (or the spool) subscribed
+          if ((anySubscribed) ||
+              (0 != mSpoolKeywords)) return false;
+        } else {
+          KeywordBitmaskType keyword = static_cast<KeywordBitmaskType>(IHelper::getBE64(headerPos + (sizeof(CryptoPP::word16)*4) + (sizeof(uint8_t)*4)));
+          if ((0 != keyword) &&
+              (0 == (keyword & (*found).second))) return false;
+        }
+
+        auto foundEvents = mRequestedRemoteProviderEvents.find(handle);
+        if (foundEvents != mRequestedRemoteProviderEvents.end()) {
+          uint16_t eventID = IHelper::getBE16(headerPos + (sizeof(CryptoPP::word16)*2));
+          if (!isEventIDEnabled(*((*foundEvents).second), eventID)) return false;
+        }
+
+        if (mRequestedSubsystemLevels.size() < 1) return true;
+
+        // the first parameter of every event is the subsystem name
+        size_t descriptorCount = IHelper::getBE16(headerPos + ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_HEADER_SIZE - sizeof(CryptoPP::word16));
+        if (descriptorCount < 1) return true;
+
+        const BYTE *typesPos = headerPos + ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_HEADER_SIZE;
+        if (EventParameterType_AString != static_cast<EventParameterTypes>(IHelper::getBE16(typesPos))) return true;
+
+        const BYTE *dataPos = typesPos + (sizeof(CryptoPP::word16)*descriptorCount);
+        if (dataPos + sizeof(CryptoPP::word32) > endPos) return true;
+
+        size_t nameSize = static_cast<size_t>(IHelper::getBE32(dataPos) & 0x7FFFFFFF);
+        const BYTE *namePos = dataPos + sizeof(CryptoPP::word32);
+        if (namePos + nameSize > endPos) return true;
+        while ((nameSize > 0) && (0 == namePos[nameSize-1])) --nameSize;
+
+        auto foundLevel = mRequestedSubsystemLevels.find(hashBytes(namePos, nameSize));
+        if (foundLevel == mRequestedSubsystemLevels.end()) return true;
+
+        Level level = static_cast<Level>(IHelper::getBE16(headerPos + sizeof(CryptoPP::word16)));
+        return level <= (*foundLevel).second;
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::completeForwardedEvents(bool batchNow)
+      {
+        AutoRecursiveLock lock(mLock);
+        if (!isAuthorized()) return;
+
+        if (mEventBatchSize > 0) {
+          if (!batchNow) {
+            // events already posted to the queue ahead of the flush join the same batch
+            if (mEventBatchFlushPending) return;
+
+            auto pThis = mThisWeak.lock();
+            if (pThis) {
+              mEventBatchFlushPending = true;
+              IRemoteEventingAsyncDelegateProxy::create(pThis)->onRemoteEventingFlushEventBatch();
+              return;
+            }
+          }
+          flushEventBatch();
+        }
+
+        if (mWriteReady) {
+          sendOutgoingData();
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::noteClientRemoteProvider(
+                                                    const UUID &providerID,
+                                                    bool registered
+                                                    )
+      {
+        AutoLock lock(mClientSharedLock);
+
+        if (registered) {
+          ++(mClientRemoteProviders[providerID]);
+          return;
+        }
+
+        auto found = mClientRemoteProviders.find(providerID);
+        if (found == mClientRemoteProviders.end()) return;
+
+        --((*found).second);
+        if (0 == (*found).second) mClientRemoteProviders.erase(found);
+      }
+
+      //-----------------------------------------------------------------------
+      bool RemoteEventing::isClientRemoteProvider(const UUID &providerID) const
+      {
+        AutoLock lock(mClientSharedLock);
+        return mClientRemoteProviders.end() != mClientRemoteProviders.find(providerID);
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::noteRemoteProviderWithListener(
+                                                          const UUID &providerID,
+                                                          bool registered
+                                                          )
+      {
+        if (!mIsClient) return;
+
+        auto parent = mParentWeak.lock();
+        if (!parent) return;
+
+        parent->noteClientRemoteProvider(providerID, registered);
+      }
+
+      //-----------------------------------------------------------------------
+      RemoteEventing::Level RemoteEventing::setClientSubsystemLevel(
+                                                                    PUID clientID,
+                                                                    const String &subsystemName,
+                                                                    Level level
+                                                                    )
+      {
+        AutoLock lock(mClientSharedLock);
+
+        auto &levels = mClientSubsystemLevels[subsystemName];
+        levels[clientID] = level;
+
+        Level result = level;
+        for (auto iter = levels.begin(); iter != levels.end(); ++iter) {
+          if ((*iter).second > result) result = (*iter).second;
+        }
+        return result;
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::removeClientSubsystemLevels(PUID clientID)
+      {
+        SubsystemMap apply;
+
+        {
+          AutoLock lock(mClientSharedLock);
+
+          for (auto iter_doNotUse = mClientSubsystemLevels.begin(); iter_doNotUse != mClientSubsystemLevels.end(); ) {
+            auto current = iter_doNotUse;
+            ++iter_doNotUse;
+
+            auto &levels = (*current).second;
+            auto found = levels.find(clientID);
+            if (found == levels.end()) continue;
+
+            levels.erase(found);
+            if (levels.size() < 1) {
+              // the level remains as the last party set it
+              mClientSubsystemLevels.erase(current);
+              continue;
+            }
+
+            auto info = make_shared<SubsystemInfo>();
+            info->mName = (*current).first;
+            for (auto iter = levels.begin(); iter != levels.end(); ++iter) {
+              if ((*iter).second > info->mLevel) info->mLevel = (*iter).second;
+            }
+            apply[info->mName] = info;
+          }
+        }
+
+        for (auto iter = apply.begin(); iter != apply.end(); ++iter) {
+          auto &info = (*iter).second;
+          Log::setEventingLevelByName(info->mName, info->mLevel);
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::updateProviderEventFilter(ProviderInfo *provider)
+      {
+        EventIDBitmapPtr enabledEvents;
+        auto found = mRequestedRemoteProviderEvents.find(provider->mHandle);
+        if (found != mRequestedRemoteProviderEvents.end()) enabledEvents = (*found).second;
+
+        if (!mIsClient) {
+          setProviderEventFilter(provider, enabledEvents.get());
+          return;
+        }
+
+        // the provider info belongs to the listener and is shared by every client
+        auto parent = mParentWeak.lock();
+        if (!parent) return;
+
+        bool subscribed = (mRequestedRemoteProviderKeywords.end() != mRequestedRemoteProviderKeywords.find(provider->mHandle));
+        parent->setClientProviderEvents(mID, provider, subscribed, enabledEvents);
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::resetProviderEventFilters()
+      {
+        if (mIsClient) {
+          auto parent = mParentWeak.lock();
+          if (parent) parent->removeClientProviderEvents(mID);
+        } else {
+          for (auto iter = mLocalAnnouncedProviders.begin(); iter != mLocalAnnouncedProviders.end(); ++iter) {
+            auto provider = (*iter).second;
+            if (mRequestedRemoteProviderEvents.end() == mRequestedRemoteProviderEvents.find(provider->mHandle)) continue;
+            setProviderEventFilter(provider, NULL);
+          }
+        }
+        mRequestedRemoteProviderEvents.clear();
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::setClientProviderEvents(
+                                                   PUID clientID,
+                                                   ProviderInfo *provider,
+                                                   bool subscribed,
+                                                   EventIDBitmapPtr enabledEvents
+                                                   )
+      {
+        AutoLock lock(mClientSharedLock);
+
+        auto &filter = mClientProviderEvents[provider->mHandle];
+        filter.mProvider = provider;
+
+        if (subscribed) {
+          auto &client = filter.mClients[clientID];
+          client.mSubscribed = true;
+          client.mEnabledEvents = enabledEvents;
+        } else {
+          auto found = filter.mClients.find(clientID);
+          if (found != filter.mClients.end()) filter.mClients.erase(found);
+        }
+
+        applyProviderEventFilter(filter);
+        if (filter.mClients.size() < 1) mClientProviderEvents.erase(provider->mHandle);
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::removeClientProviderEvents(PUID clientID)
+      {
+        AutoLock lock(mClientSharedLock);
+
+        for (auto iter_doNotUse = mClientProviderEvents.begin(); iter_doNotUse != mClientProviderEvents.end(); ) {
+          auto current = iter_doNotUse;
+          ++iter_doNotUse;
+
+          auto &filter = (*current).second;
+          auto found = filter.mClients.find(clientID);
+          if (found == filter.mClients.end()) continue;
+
+          filter.mClients.erase(found);
+          applyProviderEventFilter(filter);
+          if (filter.mClients.size() < 1) mClientProviderEvents.erase(current);
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      RemoteEventing::SessionInfoPtr RemoteEventing::claimSession(
+                                                                  const String &token,
+                                                                  uint32_t epoch,
+                                                                  uint64_t digest,
+                                                                  bool &outResumed
+                                                                  )
+      {
+        AutoLock lock(mClientSharedLock);
+
+        outResumed = false;
+
+        if (token.hasData()) {
+          auto found = mSessions.find(token);
+          if (found != mSessions.end()) {
+            auto session = (*found).second;
+            if ((!session->mActive) &&
+                (session->mEpoch == epoch) &&
+                (getSessionDigest(session->mProviders, session->mSubsystems) == digest)) {
+              ++(session->mEpoch);
+              session->mActive = true;
+              outResumed = true;
+              return session;
+            }
+            // the party holds a different view than what was announced
+            if (!session->mActive) mSessions.erase(found);
+          }
+        }
+
+        while (mSessions.size() >= mMaxResumableSessions) {
+          auto oldest = mSessions.end();
+          for (auto iter = mSessions.begin(); iter != mSessions.end(); ++iter) {
+            auto &session = (*iter).second;
+            if (session->mActive) continue;
+            if ((oldest == mSessions.end()) ||
+                (session->mLastUsed < (*oldest).second->mLastUsed)) oldest = iter;
+          }
+          if (oldest == mSessions.end()) break;
+          mSessions.erase(oldest);
+        }
+
+        auto session = make_shared<SessionInfo>();
+        session->mToken = IHelper::randomString(ZSLIB_EVENTING_REMOTE_EVENTING_SESSION_TOKEN_LENGTH);
+        session->mEpoch = 1;
+        session->mActive = true;
+        mSessions[session->mToken] = session;
+        return session;
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::releaseSession(
+                                          SessionInfoPtr session,
+                                          SessionProviderMap &ioProviders,
+                                          SessionSubsystemSet &ioSubsystems
+                                          )
+      {
+        AutoLock lock(mClientSharedLock);
+
+        session->mProviders.swap(ioProviders);
+        session->mSubsystems.swap(ioSubsystems);
+        session->mLastUsed = zsLib::now();
+        session->mActive = false;
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::closeSession()
+      {
+        if (!mSession) return;
+
+        auto session = mSession;
+        mSession.reset();
+
+        // everything in the announced maps was sent after the welcome
+        SessionProviderMap providers;
+        for (auto iter = mLocalAnnouncedProviders.begin(); iter != mLocalAnnouncedProviders.end(); ++iter) {
+          auto provider = (*iter).second;
+          auto &info = providers[provider->mHandle];
+          info.mProviderID = provider->mProviderID;
+          info.mBitmask = provider->mBitmask;
+
+          auto foundEvents = mRequestedRemoteProviderEvents.find(provider->mHandle);
+          if (foundEvents != mRequestedRemoteProviderEvents.end()) info.mEnabledEvents = (*foundEvents).second;
+        }
+
+        SessionSubsystemSet subsystems;
+        for (auto iter = mLocalSubsystems.begin(); iter != mLocalSubsystems.end(); ++iter) {
+          subsystems.insert((*iter).first);
+        }
+
+        RemoteEventingPtr owner = (mIsClient ? mParentWeak.lock() : mThisWeak.lock());
+        if (!owner) return;
+
+        owner->releaseSession(session, providers, subsystems);
+      }
+
+      //-----------------------------------------------------------------------
+      String RemoteEventing::getResumeKey() const
+      {
+        if (isLocalMode()) return String("local:") + mLocalName;
+        return String("remote:") + mServerIP.string();
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::saveResumeInfo()
+      {
+        if (!isConnectingMode()) return;
+        if (0 == mMaxResumableSessions) return;
+
+        ResumeInfoPtr resume = mResume;
+        mResume.reset();
+
+        if (mSessionToken.hasData()) {
+          resume = make_shared<ResumeInfo>();
+          resume->mToken = mSessionToken;
+          resume->mEpoch = mSessionEpoch;
+
+          for (auto iter = mRemoteRegisteredProvidersByRemoteHandle.begin(); iter != mRemoteRegisteredProvidersByRemoteHandle.end(); ++iter) {
+            auto provider = (*iter).second;
+            auto &info = resume->mProviders[(*iter).first];
+            info.mProviderID = provider->mProviderID;
+            info.mProviderName = provider->mProviderName;
+            info.mProviderHash = provider->mProviderHash;
+            info.mBitmask = provider->mBitmask;
+            info.mIndex = provider->mIndex;
+
+            // digested in the same form as the listening side decoded the request
+            auto foundEvents = mSetRemoteProviderEvents.find(provider->mProviderName);
+            if (foundEvents != mSetRemoteProviderEvents.end()) {
+              decodeEventIDBitmap(encodeEventIDSet((*foundEvents).second), info.mEnabledEvents);
+            }
+          }
+          for (auto iter = mRemoteSubsystems.begin(); iter != mRemoteSubsystems.end(); ++iter) {
+            resume->mSubsystems.insert((*iter).first);
+          }
+
+          mSessionToken.clear();
+          mSessionEpoch = 0;
+        }
+
+        // a session presented on a connection that never reached the welcome remains usable
+        if (!resume) return;
+
+        ResumeInfoCache &cache = getResumeInfoCache();
+        AutoLock lock(cache.mLock);
+        cache.mResumes[getResumeKey()] = resume;
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::restoreResumeInfo()
+      {
+        ZS_LOG_DEBUG(log("restoring resumed session") + ZS_PARAM("providers", mResume->mProviders.size()) + ZS_PARAM("subsystems", mResume->mSubsystems.size()));
+
+        for (auto iter = mResume->mSubsystems.begin(); iter != mResume->mSubsystems.end(); ++iter) {
+          registerRemoteSubsystem(*iter);
+        }
+        for (auto iter = mResume->mProviders.begin(); iter != mResume->mProviders.end(); ++iter) {
+          auto &info = (*iter).second;
+          registerRemoteProvider((*iter).first, info.mProviderID, info.mProviderName, info.mProviderHash, info.mIndex);
+          if (0 != info.mBitmask) noteRemoteProviderKeywords((*iter).first, info.mBitmask);
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      RemoteEventing::EventRing *RemoteEventing::getThreadEventRing()
+      {
+        auto &cache = getEventRingThreadCache();
+        if (mID == cache.mLastOwnerID) return cache.mLastRing;
+
+        cache.mLastOwnerID = 0;
+        cache.mLastRing = NULL;
+
+        for (auto iter_doNotUse = cache.mRings.begin(); iter_doNotUse != cache.mRings.end(); ) {
+          auto current = iter_doNotUse;
+          ++iter_doNotUse;
+
+          auto &checkRing = (*current).second;
+          if (!checkRing->mOwnerGone) continue;
+          cache.mRings.erase(current);
+        }
+
+        EventRingPtr ring;
+
+        auto found = cache.mRings.find(mID);
+        if (found != cache.mRings.end()) {
+          ring = (*found).second;
+        } else {
+          ring = make_shared<EventRing>(mID, mEventRingSize);
+          cache.mRings[mID] = ring;
+
+          AutoLock lock(mEventRingsLock);
+          EventRingListPtr replacement(make_shared<EventRingList>(*mEventRings));
+          replacement->push_back(ring);
+          mEventRings = replacement;
+        }
+
+        cache.mLastOwnerID = mID;
+        cache.mLastRing = ring.get();
+        return cache.mLastRing;
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::drainEventRings()
+      {
+        EventRingListPtr rings;
+
+        {
+          AutoLock lock(mEventRingsLock);
+          rings = mEventRings;
+        }
+
+        bool listener = isListener();
+        bool authorized = isAuthorized();
+        bool pruneRings = false;
+
+        RemoteEventingListPtr clients;
+        if (listener) {
+          AutoRecursiveLock lock(mLock);
+          clients = mClients;
+        }
+
+        for (auto iter = rings->begin(); iter != rings->end(); ++iter) {
+          auto &ring = (*iter);
+
+          bool threadGone = ring->mThreadGone;
+
+          size_t capacity = ring->mBuffer.SizeInBytes();
+          const BYTE *buffer = ring->mBuffer.BytePtr();
+
+          size_t tail = ring->mTail.load(std::memory_order_relaxed);
+          size_t head = ring->mHead.load();
+
+          while (tail != head) {
+            size_t offset = tail % capacity;
+            size_t contiguous = capacity - offset;
+
+            if (contiguous < sizeof(CryptoPP::word32)) {
+              tail += contiguous;
+              continue;
+            }
+
+            CryptoPP::word32 messageSize = IHelper::getBE32(buffer + offset);
+            if (ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_RING_WRAP_MARKER == messageSize) {
+              tail += contiguous;
+              continue;
+            }
+
+            size_t totalSize = sizeof(messageSize) + static_cast<size_t>(messageSize);
+            tail += totalSize;
+
+            if (listener) {
+              if (!forwardListenerEvent(*clients, buffer + offset, totalSize)) ring->mDrainDroppedEvents.fetch_add(1, std::memory_order_relaxed);
+              continue;
+            }
+
+            if (isSpoolOnlyEvent(buffer + offset)) continue;
+
+            if (shouldSpoolEvent(totalSize)) {
+              if (spoolEvent(buffer + offset, totalSize)) continue;
+            }
+
+            if (!authorized) {
+              ring->mDrainDroppedEvents.fetch_add(1, std::memory_order_relaxed);
+              ++(mDroppedEventsByReason[DropReason_NotAuthorized]);
+              ZS_LOG_WARNING(Insane, log("ignoring event as not in authorized connection state (event dropped)"));
+              continue;
+            }
+
+            if (!admitOutgoingEvent(buffer + offset, totalSize)) {
+              ring->mDrainDroppedEvents.fetch_add(1, std::memory_order_relaxed);
+              continue;
+            }
+
+            queueOutgoingEvent(buffer + offset, totalSize);
+          }
+
+          ring->mTail.store(tail, std::memory_order_release);
+
+          if (threadGone) pruneRings = true;
+        }
+
+        if (pruneRings) {
+          AutoLock lock(mEventRingsLock);
+          EventRingListPtr replacement(make_shared<EventRingList>());
+          for (auto iter = mEventRings->begin(); iter != mEventRings->end(); ++iter) {
+            auto &ring = (*iter);
+            if ((ring->mThreadGone) &&
+                (ring->mHead == ring->mTail)) {
+              mRetiredEventRingDroppedEvents += ring->mDroppedEvents + ring->mDrainDroppedEvents.load();
+              continue;
+            }
+            replacement->push_back(ring);
+          }
+          mEventRings = replacement;
+        }
+
+        if (listener) {
+          for (auto iter = clients->begin(); iter != clients->end(); ++iter) {
+            auto &client = (*iter);
+            client->completeForwardedEvents(true);
+          }
+          return;
+        }
+
+        flushEventBatch();
+
+        if (mWriteReady) {
+          sendOutgoingData();
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::discardEventRings()
+      {
+        EventRingListPtr rings;
+
+        {
+          AutoLock lock(mEventRingsLock);
+          rings = mEventRings;
+        }
+
+        size_t totalDropped = mRetiredEventRingDroppedEvents;
+        for (auto iter = rings->begin(); iter != rings->end(); ++iter) {
+          auto &ring = (*iter);
+          ring->mTail.store(ring->mHead.load(), std::memory_order_release);
+          totalDropped += ring->mDroppedEvents + ring->mDrainDroppedEvents.load();
+        }
+
+        mEventRingDroppedEventsBaseline = totalDropped;
+      }
+
+      //-----------------------------------------------------------------------
+      size_t RemoteEventing::getTotalDroppedEvents() const
+      {
+        EventRingListPtr rings;
+
+        {
+          AutoLock lock(mEventRingsLock);
+          rings = mEventRings;
+        }
+
+        size_t totalDropped = mRetiredEventRingDroppedEvents;
+        for (auto iter = rings->begin(); iter != rings->end(); ++iter) {
+          auto &ring = (*iter);
+          totalDropped += ring->mDroppedEvents.load(std::memory_order_relaxed) + ring->mDrainDroppedEvents.load(std::memory_order_relaxed);
+        }
+
+        size_t result = mTotalDroppedEvents + (totalDropped - mEventRingDroppedEventsBaseline);
+
+        if (mIsClient) {
+          // events dropped before reaching the listener were never offered to any client
+          auto parent = mParentWeak.lock();
+          if (parent) {
+            size_t parentDropped = parent->getListenerDroppedEvents();
+            if (parentDropped > mParentDroppedEventsBaseline) result += (parentDropped - mParentDroppedEventsBaseline);
+          }
+        }
+
+        return result;
+      }
+
+      //-----------------------------------------------------------------------
+      size_t RemoteEventing::getListenerDroppedEvents() const
+      {
+        // events dropped while no client was authorized concern no client so
+        // they are only counted by the listener itself
+        size_t total = getTotalDroppedEvents();
+        size_t notAuthorized = static_cast<size_t>(mDroppedEventsByReason[DropReason_NotAuthorized].load());
+        return (total > notAuthorized ? total - notAuthorized : 0);
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::noteDroppedEvent(EventRing *ring)
+      {
+        if (!ring) {
+          ++mTotalDroppedEvents;
+          return;
+        }
+
+        // only the owning thread ever writes the counter so no atomic increment is required
+        ring->mDroppedEvents.store(ring->mDroppedEvents.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::noteDroppedEvent(
+                                            ProviderInfo *provider,
+                                            Log::Severity severity
+                                            )
+      {
+        if (severity > Log::Severity_Last) return;
+        ++(provider->mDroppedEvents[severity]);
+      }
+
+      //-----------------------------------------------------------------------
+      bool RemoteEventing::admitOutgoingEvent(
+                                              const BYTE *message,
+                                              size_t messageSize
+                                              )
+      {
+        // message is [size][type][origin][provider handle][event header][data]
+        const BYTE *handlePos = message + (sizeof(CryptoPP::word32)*2) + ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_ORIGIN_SIZE;
+        ProviderHandle handle = static_cast<ProviderHandle>(IHelper::getBE64(handlePos));
+        Log::Severity severity = static_cast<Log::Severity>(IHelper::getBE16(handlePos + sizeof(uint64_t)));
+        Log::Level level = static_cast<Log::Level>(IHelper::getBE16(handlePos + sizeof(uint64_t) + sizeof(CryptoPP::word16)));
+
+        size_t queued = mEventDataInOutgoingQueue + mEventBatchSize;
+        size_t budget = mMaxQueuedOutgoingDataBeforeEventsDropped;
+        if (mUseLoadShedding) budget = getLoadSheddingBudget(budget, severity, level);
+
+        // a provider gone while its events were still in flight is not tracked again
+        ProviderLoadShedding untracked;
+        ProviderLoadShedding *shedding = &untracked;
+        if (mLocalAnnouncedProviderIndexes.end() != mLocalAnnouncedProviderIndexes.find(handle)) shedding = &(mProviderLoadShedding[handle]);
+
+        if (shedding->mEpoch != mLoadSheddingEpoch) {
+          shedding->mEpoch = mLoadSheddingEpoch;
+          shedding->mAdmittedData = 0;
+        }
+
+        // only the arriving event is ever shed; data already queued is wire
+        // encoded (and possibly part of a batch or compact stream whose later
+        // records depend on it) so it is never evicted in favour of it
+        if (queued + messageSize > budget) {
+          if (severity <= Log::Severity_Last) ++(shedding->mDroppedEvents[severity]);
+          ++(mDroppedEventsByReason[DropReason_OutgoingQueueFull]);
+          ZS_LOG_WARNING(Trace, log("too much data in outgoing queue (event dropped)") + ZS_PARAM("queued", queued) + ZS_PARAM("budget", budget));
+          return false;
+        }
+
+        if ((mUseLoadShedding) &&
+            (0 != mMaxProviderSharePercent) &&
+            (!isCriticalSeverity(severity)) &&
+            (queued > getPercentOf(mMaxQueuedOutgoingDataBeforeEventsDropped, ZSLIB_EVENTING_REMOTE_EVENTING_LOAD_SHEDDING_PRESSURE_PERCENT))) {
+          size_t share = getPercentOf(mMaxQueuedOutgoingDataBeforeEventsDropped, mMaxProviderSharePercent);
+          if (shedding->mAdmittedData + messageSize > share) {
+            if (severity <= Log::Severity_Last) ++(shedding->mDroppedEvents[severity]);
+            ++(mDroppedEventsByReason[DropReason_ProviderShareExceeded]);
+            ZS_LOG_WARNING(Trace, log("provider exceeded its share of the outgoing queue (event dropped)") + ZS_PARAM("provider handle", string(handle)) + ZS_PARAM("admitted", shedding->mAdmittedData));
+            return false;
+          }
+        }
+
+        shedding->mAdmittedData += messageSize;
+        return true;
+      }
+
+      //-----------------------------------------------------------------------
+      ElementPtr RemoteEventing::getDroppedEventsByProvider() const
+      {
+        ElementPtr providersEl;
+
+        for (auto iter = mLocalAnnouncedProviders.begin(); iter != mLocalAnnouncedProviders.end(); ++iter) {
+          auto info = (*iter).second;
+          if (info->mSelfRegistered) continue;
+
+          auto found = mProviderLoadShedding.find(info->mHandle);
+
+          ElementPtr providerEl;
+          for (size_t index = Log::Severity_First; index <= Log::Severity_Last; ++index) {
+            size_t dropped = info->mDroppedEvents[index];
+            if (found != mProviderLoadShedding.end()) dropped += (*found).second.mDroppedEvents[index];
+            if (0 == dropped) continue;
+
+            if (!providerEl) {
+              providerEl = Element::create("provider");
+              providerEl->adoptAsLastChild(IHelper::createElementWithTextAndJSONEncode("name", info->mProviderName));
+            }
+            providerEl->adoptAsLastChild(IHelper::createElementWithNumber(Log::toString(static_cast<Log::Severity>(index)), string(dropped)));
+          }
+          if (!providerEl) continue;
+
+          if (!providersEl) providersEl = Element::create("providers");
+          providersEl->adoptAsLastChild(providerEl);
+        }
+
+        return providersEl;
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::openSpool()
+      {
+        if (mSpoolPath.isEmpty()) {
+          mSpoolKeywords = 0;
+          return;
+        }
+
+        mSpool = EventSpool::open(mSpoolPath, mSpoolSize);
+        if (!mSpool) {
+          ZS_LOG_WARNING(Basic, log("unable to open event spool (events generated while disconnected are dropped)") + ZS_PARAM("path", mSpoolPath));
+          mSpoolKeywords = 0;
+          return;
+        }
+
+        // spooled events may later be replayed to a party receiving their origins
+        ++mEventOriginParties;
+
+        ZS_LOG_DEBUG(log("event spool opened") + ZS_PARAM("path", mSpoolPath) + ZS_PARAM("size", mSpoolSize) + ZS_PARAM("keywords", mSpoolKeywords));
+
+        // events are spooled from the start rather than from the first authorized party
+        if (0 != mSpoolKeywords) {
+          IRemoteEventingAsyncDelegateProxy::create(mThisWeak.lock())->onRemoteEventingSubscribeLogger();
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      bool RemoteEventing::isSpoolOnlyEvent(const BYTE *message) const
+      {
+        if (0 == mSpoolKeywords) return false;
+        if (!isAuthorized()) return false;
+
+        // message is [size][type][origin][provider handle][event header][data]
+        const BYTE *handlePos = message + (sizeof(CryptoPP::word32)*2) + ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_ORIGIN_SIZE;
+        ProviderHandle handle = static_cast<ProviderHandle>(IHelper::getBE64(handlePos));
+        return mRequestedRemoteProviderKeywords.end() == mRequestedRemoteProviderKeywords.find(handle);
+      }
+
+      //-----------------------------------------------------------------------
+      bool RemoteEventing::shouldSpoolEvent(size_t messageSize) const
+      {
+        if (!mSpool) return false;
+        if (!isAuthorized()) return true;
+
+        // once spooling starts every later event follows into the spool to keep the order
+        if (!mSpool->isEmpty()) return true;
+        return mEventDataInOutgoingQueue + mEventBatchSize + messageSize > mMaxQueuedOutgoingDataBeforeEventsDropped;
+      }
+
+      //-----------------------------------------------------------------------
+      bool RemoteEventing::spoolEvent(
+                                      const BYTE *message,
+                                      size_t messageSize
+                                      )
+      {
+        if (!mSpool) return false;
+
+        size_t overwritten {};
+        if (!mSpool->append(message, messageSize, overwritten)) return false;
+
+        ++mSpooledEvents;
+        if (0 != overwritten) {
+          mTotalDroppedEvents += overwritten;
+          mDroppedEventsByReason[DropReason_SpoolFull] += overwritten;
+          ZS_LOG_WARNING(Insane, log("spool is full (oldest events dropped)") + ZS_PARAM("dropped", overwritten));
+        }
+        return true;
+      }
+
+      //-----------------------------------------------------------------------
+      bool RemoteEventing::replaySpool()
+      {
+        if (!mSpool) return false;
+        if (mSpool->isEmpty()) return false;
+
+        // a listener replays with replayListenerSpool()
+        if (isListener()) return false;
+        if (!isAuthorized()) return false;
+
+        bool replayed = false;
+        size_t messageSize {};
+        const BYTE *message {};
+
+        // refilled as the connection drains so the backlog never crowds out the live events
+        size_t budget = mMaxQueuedOutgoingDataBeforeEventsDropped / 2;
+        while (NULL != (message = mSpool->peek(messageSize))) {
+          size_t queued = mEventDataInOutgoingQueue + mEventBatchSize;
+          if ((0 != queued) &&
+              (queued + messageSize > budget)) break;
+
+          queueOutgoingEvent(message, messageSize, true);
+          mSpool->consume(messageSize);
+          ++mReplayedEvents;
+          replayed = true;
+        }
+
+        if (mSpool->isEmpty()) {
+          ZS_LOG_DEBUG(log("spool replayed") + ZS_PARAM("replayed", mReplayedEvents));
+        }
+        return replayed;
+      }
+
+      //-----------------------------------------------------------------------
+      bool RemoteEventing::replayListenerSpool()
+      {
+        // replayed once to the authorized parties which have subscribed to
+        // a provider, each taking only what its subscriptions want and
+        // shedding against its own outgoing queue; until such a party
+        // exists the backlog waits (with the live events following it into
+        // the spool) and a party subscribing after the replay only receives
+        // live events
+        //
+        // called without the listener lock held; each event is copied out of
+        // the spool so the clients are never called with the lock held, and
+        // as the spool is only appended to from this object's queue the
+        // event is still at its head when it is consumed
+        RemoteEventingListPtr clients;
+        SecureByteBlock event;
+        size_t eventSize {};
+        bool replayed = false;
+
+        while (true) {
+          {
+            AutoRecursiveLock lock(mLock);
+            if ((replayed) && (mSpool)) {
+              mSpool->consume(eventSize);
+              ++mReplayedEvents;
+            }
+
+            if (!clients) clients = mClients;
+
+            const BYTE *message = (mSpool ? mSpool->peek(eventSize) : NULL);
+            if (NULL == message) {
+              if (replayed) {
+                ZS_LOG_DEBUG(log("spool replayed") + ZS_PARAM("replayed", mReplayedEvents));
+              }
+              break;
+            }
+
+            if (event.SizeInBytes() < eventSize) event.New(eventSize);
+            memcpy(event.BytePtr(), message, eventSize);
+          }
+
+          if (!fanOutEvent(*clients, event.BytePtr(), eventSize, true)) break;
+          replayed = true;
+        }
+
+        for (auto iter = clients->begin(); iter != clients->end(); ++iter) {
+          auto &client = (*iter);
+          client->completeForwardedEvents(false);
+        }
+        return replayed;
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::beginRecordedConnection()
+      {
+        endRecordedConnection();
+
+        if (!mRecorder) return;
+        if (!mRecorder->isOpen()) return;
+
+        mConnectionRecorder = mRecorder;
+        mRecordConnectionID = mRecorder->beginConnection();
+
+        ZS_LOG_DEBUG(log("recording connection") + ZS_PARAM("path", mRecorder->mPath) + ZS_PARAM("connection", mRecordConnectionID));
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::noteRecordedConnectionState()
+      {
+        if (!mConnectionRecorder) return;
+
+        // everything needed to decode the connection's frames from here on
+        BYTE flags {};
+        if (mEventOriginNegotiated) flags |= ZSLIB_EVENTING_REMOTE_EVENTING_TRACE_STATE_EVENT_ORIGIN;
+        if (mRemoteSupportsDenseProviders) flags |= ZSLIB_EVENTING_REMOTE_EVENTING_TRACE_STATE_DENSE_PROVIDERS;
+        if (mSwapIncomingIntegers) flags |= ZSLIB_EVENTING_REMOTE_EVENTING_TRACE_STATE_SWAP_INTEGERS;
+        if (mSwapIncomingFloats) flags |= ZSLIB_EVENTING_REMOTE_EVENTING_TRACE_STATE_SWAP_FLOATS;
+
+        std::string state;
+        state.append(1, static_cast<char>(flags));
+        appendSessionVarint(state, mRemoteRegisteredProvidersByRemoteHandle.size());
+        for (auto iter = mRemoteRegisteredProvidersByRemoteHandle.begin(); iter != mRemoteRegisteredProvidersByRemoteHandle.end(); ++iter) {
+          auto provider = (*iter).second;
+          appendSessionVarint(state, static_cast<uint64_t>(provider->mRemoteHandle));
+          appendSessionVarint(state, provider->mIndex);
+          appendSessionString(state, string(provider->mProviderID));
+          appendSessionString(state, provider->mProviderName);
+          appendSessionString(state, provider->mProviderHash);
+        }
+
+        mConnectionRecorder->setConnectionState(mRecordConnectionID, state);
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::endRecordedConnection()
+      {
+        if (!mConnectionRecorder) return;
+
+        mConnectionRecorder->endConnection(mRecordConnectionID);
+        mConnectionRecorder.reset();
+        mRecordConnectionID = 0;
+      }
+
+      //-----------------------------------------------------------------------
+      bool RemoteEventing::decodeTraceConnection(
+                                                 const BYTE *state,
+                                                 size_t stateSize,
+                                                 bool swapByteOrder,
+                                                 TraceConnection &outConnection
+                                                 )
+      {
+        outConnection = TraceConnection();
+
+        // a connection still in its handshake has no state yet
+        if (stateSize < sizeof(BYTE)) return false;
+
+        BYTE flags = state[0];
+        outConnection.mEventOrigin = (0 != (flags & ZSLIB_EVENTING_REMOTE_EVENTING_TRACE_STATE_EVENT_ORIGIN));
+        outConnection.mDenseProviders = (0 != (flags & ZSLIB_EVENTING_REMOTE_EVENTING_TRACE_STATE_DENSE_PROVIDERS));
+        outConnection.mSwapIntegers = ((0 != (flags & ZSLIB_EVENTING_REMOTE_EVENTING_TRACE_STATE_SWAP_INTEGERS)) != swapByteOrder);
+        outConnection.mSwapFloats = ((0 != (flags & ZSLIB_EVENTING_REMOTE_EVENTING_TRACE_STATE_SWAP_FLOATS)) != swapByteOrder);
+
+        // only read although the varint helpers take a mutable position
+        BYTE *pos = const_cast<BYTE *>(state) + sizeof(BYTE);
+        size_t remaining = stateSize - sizeof(BYTE);
+
+        uint64_t count {};
+        if (!getVarint(pos, remaining, count)) return false;
+
+        for (uint64_t loop = 0; loop < count; ++loop) {
+          uint64_t remoteHandle {};
+          uint64_t index {};
+          String providerIDStr;
+          String providerName;
+          String providerHash;
+
+          if (!getVarint(pos, remaining, remoteHandle)) return false;
+          if (!getVarint(pos, remaining, index)) return false;
+          if (!getSessionString(pos, remaining, providerIDStr)) return false;
+          if (!getSessionString(pos, remaining, providerName)) return false;
+          if (!getSessionString(pos, remaining, providerHash)) return false;
+
+          UUID providerID {};
+          try {
+            providerID = Numeric<UUID>(providerIDStr);
+          } catch (const Numeric<UUID>::ValueOutOfRange &) {
+            continue;
+          }
+
+          if (index > ZSLIB_EVENTING_REMOTE_EVENTING_MAX_DENSE_PROVIDERS) {
+            // providers beyond the dense table are found by the value carried on the wire
+            auto &provider = outConnection.mOverflowProviders[outConnection.mDenseProviders ? index : remoteHandle];
+            provider.mProviderID = providerID;
+            provider.mProviderName = providerName;
+            provider.mProviderUniqueHash = providerHash;
+            continue;
+          }
+
+          size_t providerIndex = static_cast<size_t>(index);
+          if (providerIndex >= outConnection.mProviders.size()) {
+            outConnection.mProviders.resize(providerIndex + 1);
+            outConnection.mDefined.resize(providerIndex + 1);
+          }
+
+          auto &provider = outConnection.mProviders[providerIndex];
+          provider.mProviderID = providerID;
+          provider.mProviderName = providerName;
+          provider.mProviderUniqueHash = providerHash;
+          outConnection.mDefined[providerIndex] = true;
+          outConnection.mIndexesByRemoteHandle[remoteHandle] = providerIndex;
+        }
+        return true;
+      }
+
+      //-----------------------------------------------------------------------
+      size_t RemoteEventing::decodeTraceFrame(
+                                              TraceConnection &connection,
+                                              const BYTE *frame,
+                                              size_t frameSize,
+                                              uint64_t receiveTime,
+                                              SecureByteBlock &ioScratch,
+                                              IRemoteEventingTraceDelegate &delegate
+                                              )
+      {
+        // frame is [size][type][message]
+        if (frameSize < sizeof(CryptoPP::word32)*2) return 0;
+
+        CryptoPP::word32 messageType = IHelper::getBE32(frame + sizeof(CryptoPP::word32));
+
+        bool backlog {};
+        switch (messageType) {
+          case MessageType_TraceEvent:        break;
+          case MessageType_TraceEventBatch:   break;
+          case MessageType_TraceEventBacklog: backlog = true; break;
+          default:                            return 0;   // announcements are captured in the connection state
+        }
+
+        // decoding swaps scalars in place so the (read only) trace is decoded from a copy
+        size_t remaining = frameSize - (sizeof(CryptoPP::word32)*2);
+        if (ioScratch.SizeInBytes() < remaining) ioScratch.New(remaining);
+        if (0 != remaining) memcpy(ioScratch.BytePtr(), frame + (sizeof(CryptoPP::word32)*2), remaining);
+
+        BYTE *pos = ioScratch.BytePtr();
+
+        auto findProvider = [&connection](uint64_t remoteProvider) -> const TraceProvider * {
+          size_t index {};
+          bool inTable {};
+          if (connection.mDenseProviders) {
+            index = static_cast<size_t>(remoteProvider);
+            inTable = (remoteProvider < connection.mProviders.size());
+          } else {
+            auto found = connection.mIndexesByRemoteHandle.find(remoteProvider);
+            if (found != connection.mIndexesByRemoteHandle.end()) {
+              index = (*found).second;
+              inTable = true;
+            }
+          }
+          if ((inTable) &&
+              (connection.mDefined[index])) return &(connection.mProviders[index]);
+
+          auto foundOverflow = connection.mOverflowProviders.find(remoteProvider);
+          if (foundOverflow == connection.mOverflowProviders.end()) return NULL;
+          return &((*foundOverflow).second);
+        };
+
+        EventHeader header;
+        USE_EVENT_DATA_DESCRIPTOR dataDescriptors[ZSLIB_EVENTING_REMOTE_EVENTING_MAX_DATA_DESCRIPTORS];
+        EventOrigin origin;
+
+        if (MessageType_TraceEventBatch != messageType) {
+          if (connection.mEventOrigin) {
+            if (!decodeEventOrigin(pos, remaining, origin)) return 0;
+          }
+          origin.mBacklog = backlog;
+
+          if (remaining < sizeof(uint64_t)) return 0;
+          uint64_t remoteProvider = IHelper::getBE64(pos);
+          pos += sizeof(remoteProvider);
+          remaining -= sizeof(remoteProvider);
+
+          auto provider = findProvider(remoteProvider);
+          if (!provider) return 0;
+
+          if (!decodeEventHeader(pos, remaining, header)) return 0;
+          if (!decodeEventData(pos, remaining, header, connection.mSwapIntegers, connection.mSwapFloats, &(dataDescriptors[0]))) return 0;
+
+          delegate.onRemoteEventingTraceEvent(*provider, ((connection.mEventOrigin) || (backlog)) ? &origin : NULL, receiveTime, header.mSeverity, header.mLevel, &(header.mDescriptor), &(header.mParamDescriptors[0]), &(dataDescriptors[0]), header.mDescriptorCount);
+          return 1;
+        }
+
+        const TraceProvider *provider {};
+        bool hasProvider {};
+        bool hasHeader {};
+        size_t total {};
+
+        while (remaining > 0) {
+          BYTE flags = *pos;
+          pos += sizeof(flags);
+          remaining -= sizeof(flags);
+
+          if (connection.mEventOrigin) {
+            if (!decodeEventOrigin(pos, remaining, origin)) break;
+          }
+
+          if (0 != (flags & ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_BATCH_FLAG_PROVIDER)) {
+            if (remaining < sizeof(uint64_t)) break;
+
+            uint64_t remoteProvider = IHelper::getBE64(pos);
+            pos += sizeof(remoteProvider);
+            remaining -= sizeof(remoteProvider);
+
+            // unknown providers still have their events parsed so the batch can continue
+            provider = findProvider(remoteProvider);
+            hasProvider = true;
+          }
+
+          if (0 != (flags & ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_BATCH_FLAG_HEADER)) {
+            if (!decodeEventHeader(pos, remaining, header)) break;
+            hasHeader = true;
+          }
+
+          if ((!hasProvider) ||
+              (!hasHeader)) break;
+
+          if (!decodeEventData(pos, remaining, header, connection.mSwapIntegers, connection.mSwapFloats, &(dataDescriptors[0]))) break;
+
+          if (!provider) continue;
+
+          delegate.onRemoteEventingTraceEvent(*provider, connection.mEventOrigin ? &origin : NULL, receiveTime, header.mSeverity, header.mLevel, &(header.mDescriptor), &(header.mParamDescriptors[0]), &(dataDescriptors[0]), header.mDescriptorCount);
+          ++total;
+        }
+
+        return total;
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::queueOutgoingEvent(
+                                              const BYTE *message,
+                                              size_t messageSize,
+                                              bool backlog
+                                              )
+      {
+        const BYTE *handlePos = message + (sizeof(CryptoPP::word32)*2) + ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_ORIGIN_SIZE;
+        ProviderHandle handle = static_cast<ProviderHandle>(IHelper::getBE64(handlePos));
+
+        size_t queuedBefore = mEventDataInOutgoingQueue + mEventBatchSize;
+        uint64_t start = getMonotonicTimestamp();
+
+        encodeOutgoingEvent(message, messageSize, backlog);
+
+        recordTime(mEncodeTime, getMonotonicTimestamp() - start);
+
+        auto found = mSentCounters.find(handle);
+        if (found == mSentCounters.end()) {
+          ProviderCounters counters;
+          for (auto iter = mLocalAnnouncedProviders.begin(); iter != mLocalAnnouncedProviders.end(); ++iter) {
+            auto info = (*iter).second;
+            if (info->mHandle != handle) continue;
+            counters.mName = info->mProviderName;
+            break;
+          }
+          found = mSentCounters.insert(ProviderCountersMap::value_type(handle, counters)).first;
+        }
+
+        auto &statistics = (*found).second.mStatistics;
+        ++(statistics.mEventsSent);
+
+        // includes the records defining compact stream state and any batch frame header started by this event
+        size_t queuedAfter = mEventDataInOutgoingQueue + mEventBatchSize;
+        if (queuedAfter > queuedBefore) statistics.mBytesSent += (queuedAfter - queuedBefore);
+
+        noteQueueHighWater();
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::noteQueueHighWater()
+      {
+        size_t queued = mEventDataInOutgoingQueue + mEventBatchSize;
+        if (queued > mOutgoingQueueBytesHighWater) mOutgoingQueueBytesHighWater = queued;
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::encodeOutgoingEvent(
+                                               const BYTE *message,
+                                               size_t messageSize,
+                                               bool backlog
+                                               )
+      {
+        // message is [size][type][origin][provider handle][event header][data]
+        const BYTE *originPos = message + (sizeof(CryptoPP::word32)*2);
+        const BYTE *handlePos = originPos + ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_ORIGIN_SIZE;
+
+        EventOrigin origin;
+        getOutgoingEventOrigin(originPos, origin);
+
+        // a backlog event is always framed on its own so it can carry its own
+        // message type; the frame leaves the batch and compact state untouched
+        if (backlog) flushEventBatch();
+
+        if ((backlog) ||
+            ((!mRemoteSupportsEventBatches) &&
+             (!mRemoteSupportsCompactEvents))) {
+          size_t wireSize = messageSize - (mEventOriginNegotiated ? 0 : ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_ORIGIN_SIZE);
+          MessageTypes messageType = (((backlog) && (mRemoteSupportsEventBacklog)) ? MessageType_TraceEventBacklog : MessageType_TraceEvent);
+
+          putOutgoingWord32(mOutgoingSegments, static_cast<CryptoPP::word32>(wireSize - sizeof(CryptoPP::word32)));
+          putOutgoingWord32(mOutgoingSegments, static_cast<CryptoPP::word32>(messageType));
+          if (mEventOriginNegotiated) {
+            putOutgoingEventOrigin(mOutgoingSegments, origin);
+          }
+          BYTE provider[sizeof(uint64_t)] {};
+          BYTE *providerPos = &(provider[0]);
+          putBE64(providerPos, getOutgoingProvider(IHelper::getBE64(handlePos)));
+          putOutgoing(mOutgoingSegments, &(provider[0]), sizeof(provider));
+
+          const BYTE *headerPos = handlePos + sizeof(uint64_t);
+          if (mSwapOutgoingScalars) {
+            size_t descriptorCount = IHelper::getBE16(headerPos + ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_HEADER_SIZE - sizeof(CryptoPP::word16));
+            size_t headerSize = ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_HEADER_SIZE + (sizeof(CryptoPP::word16)*descriptorCount);
+            const BYTE *dataPos = headerPos + headerSize;
+            size_t dataSize = messageSize - static_cast<size_t>(dataPos - message);
+
+            putOutgoing(mOutgoingSegments, headerPos, headerSize);
+            putOutgoing(mOutgoingSegments, getBigEndianEventData(dataPos, dataSize, descriptorCount), dataSize);
+          } else {
+            putOutgoing(mOutgoingSegments, headerPos, messageSize - static_cast<size_t>(headerPos - message));
+          }
+
+          mEventDataInOutgoingQueue += wireSize;
+          return;
+        }
+
+        // the batch record only repeats the provider handle and event header
+        // when they differ from the previous record in the same batch
+        const BYTE *headerPos = handlePos + sizeof(uint64_t);
+        size_t descriptorCount = IHelper::getBE16(headerPos + ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_HEADER_SIZE - sizeof(CryptoPP::word16));
+        size_t headerSize = ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_HEADER_SIZE + (sizeof(CryptoPP::word16)*descriptorCount);
+        const BYTE *dataPos = headerPos + headerSize;
+        size_t dataSize = messageSize - static_cast<size_t>(dataPos - message);
+
+        if (mRemoteSupportsCompactEvents) {
+          queueOutgoingCompactEvent(origin, handlePos, headerPos, headerSize, descriptorCount, dataPos, dataSize);
+          return;
+        }
+
+        if (mEventBatchSize + sizeof(BYTE) + ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_ORIGIN_SIZE + sizeof(uint64_t) + headerSize + dataSize > mMaxEventBatchSize) {
+          flushEventBatch();
+        }
+
+        uint64_t handle = IHelper::getBE64(handlePos);
+
+        bool newProvider = ((0 == mEventBatchSize) || (handle != mEventBatchProviderHandle));
+        bool newHeader = ((0 == mEventBatchSize) ||
+                          (headerSize != mEventBatchHeader.SizeInBytes()) ||
+                          (0 != memcmp(mEventBatchHeader.BytePtr(), headerPos, headerSize)));
+
+        BYTE flags = (newProvider ? ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_BATCH_FLAG_PROVIDER : 0) |
+                     (newHeader ? ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_BATCH_FLAG_HEADER : 0);
+
+        putOutgoing(mEventBatchSegments, &flags, sizeof(flags));
+        mEventBatchSize += sizeof(flags);
+
+        if (mEventOriginNegotiated) {
+          putOutgoingEventOrigin(mEventBatchSegments, origin);
+          mEventBatchSize += ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_ORIGIN_SIZE;
+        }
+
+        if (newProvider) {
+          BYTE provider[sizeof(uint64_t)] {};
+          BYTE *providerPos = &(provider[0]);
+          putBE64(providerPos, getOutgoingProvider(handle));
+          putOutgoing(mEventBatchSegments, &(provider[0]), sizeof(provider));
+          mEventBatchSize += sizeof(uint64_t);
+          mEventBatchProviderHandle = handle;
+        }
+        if (newHeader) {
+          putOutgoing(mEventBatchSegments, headerPos, headerSize);
+          mEventBatchSize += headerSize;
+          mEventBatchHeader.Assign(headerPos, headerSize);
+        }
+
+        putOutgoing(mEventBatchSegments, mSwapOutgoingScalars ? getBigEndianEventData(dataPos, dataSize, descriptorCount) : dataPos, dataSize);
+        mEventBatchSize += dataSize;
+      }
+
+      //-----------------------------------------------------------------------
+      const BYTE *RemoteEventing::getBigEndianEventData(
+                                                         const BYTE *dataPos,
+                                                         size_t dataSize,
+                                                         size_t descriptorCount
+                                                         )
+      {
+        // the packed message may be shared with other parties so it is converted in a copy
+        if (mBigEndianScratch.SizeInBytes() < dataSize) {
+          mBigEndianScratch.CleanNew(dataSize);
+        }
+
+        BYTE *start = mBigEndianScratch.BytePtr();
+        memcpy(start, dataPos, dataSize);
+
+        BYTE *pos = start;
+        for (size_t index = 0; index < descriptorCount; ++index) {
+          uint32_t dataTypeSize = IHelper::getBE32(pos);
+          pos += sizeof(CryptoPP::word32);
+
+          bool scalar = (0 != (dataTypeSize & ZSLIB_EVENTING_REMOTE_EVENTING_SCALAR_FLAG));
+          dataTypeSize = dataTypeSize & (~ZSLIB_EVENTING_REMOTE_EVENTING_SCALAR_FLAG);
+
+          if (scalar) swapScalarBytes(pos, dataTypeSize);
+          pos += dataTypeSize;
+        }
+        return start;
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::flushEventBatch()
+      {
+        if (0 == mEventBatchSize) return;
+
+        CryptoPP::word32 type = static_cast<CryptoPP::word32>(mRemoteSupportsCompactEvents ? MessageType_TraceEventCompact : MessageType_TraceEventBatch);
+        CryptoPP::word32 size = static_cast<CryptoPP::word32>(sizeof(type) + mEventBatchSize);
+
+        putOutgoingWord32(mOutgoingSegments, size);
+        putOutgoingWord32(mOutgoingSegments, type);
+
+        // the batch was built in pooled segments so it is spliced rather than copied
+        mOutgoingSegments.splice(mOutgoingSegments.end(), mEventBatchSegments);
+
+        mEventDataInOutgoingQueue += static_cast<size_t>((sizeof(uint32_t)*2) + mEventBatchSize);
+
+        mEventBatchSize = 0;
+        mEventBatchProviderHandle = 0;
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::getOutgoingEventOrigin(
+                                                  const BYTE *originPos,
+                                                  EventOrigin &outOrigin
+                                                  ) const
+      {
+        outOrigin.mTimestamp = IHelper::getBE64(originPos);
+        outOrigin.mThreadID = IHelper::getBE64(originPos + sizeof(uint64_t));
+        outOrigin.mCPU = IHelper::getBE32(originPos + (sizeof(uint64_t)*2));
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::putOutgoingEventOrigin(
+                                                  OutgoingSegmentList &segments,
+                                                  const EventOrigin &origin
+                                                  )
+      {
+        BYTE buffer[ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_ORIGIN_SIZE] {};
+        BYTE *pos = &(buffer[0]);
+        putBE64(pos, origin.mTimestamp);
+        putBE64(pos, origin.mThreadID);
+        putBE32(pos, origin.mCPU);
+        putOutgoing(segments, &(buffer[0]), sizeof(buffer));
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::queueOutgoingCompactEvent(
+                                                     const EventOrigin &origin,
+                                                     const BYTE *handlePos,
+                                                     const BYTE *headerPos,
+                                                     size_t headerSize,
+                                                     size_t descriptorCount,
+                                                     const BYTE *dataPos,
+                                                     size_t dataSize
+                                                     )
+      {
+        // provider definition, descriptor definition and event record headers
+        // plus a size varint and a possibly widened integer per parameter
+        size_t worstSize = (sizeof(BYTE)*5) + sizeof(uint64_t) + (ZSLIB_EVENTING_REMOTE_EVENTING_MAX_VARINT_SIZE*5) +
+                           headerSize + dataSize + (descriptorCount*ZSLIB_EVENTING_REMOTE_EVENTING_MAX_VARINT_SIZE*2) +
+                           (ZSLIB_EVENTING_REMOTE_EVENTING_COMPACT_INTERNED_PARAMETERS*((sizeof(BYTE)) + (ZSLIB_EVENTING_REMOTE_EVENTING_MAX_VARINT_SIZE*2)));
+
+        if (mEventBatchSize + worstSize > mMaxEventBatchSize) {
+          flushEventBatch();
+        }
+
+        if (mCompactScratch.SizeInBytes() < worstSize) {
+          mCompactScratch.CleanNew(worstSize);
+        }
+
+        BYTE *start = mCompactScratch.BytePtr();
+        BYTE *pos = start;
+
+        uint64_t handle = IHelper::getBE64(handlePos);
+
+        size_t providerIndex {};
+        auto foundProvider = mCompactOutgoingProviders.find(handle);
+        if (foundProvider == mCompactOutgoingProviders.end()) {
+          providerIndex = mCompactOutgoingProviders.size();
+          mCompactOutgoingProviders[handle] = providerIndex;
+
+          *pos = ZSLIB_EVENTING_REMOTE_EVENTING_COMPACT_RECORD_PROVIDER;
+          ++pos;
+          putVarint(pos, providerIndex);
+          putBE64(pos, getOutgoingProvider(handle));
+        } else {
+          providerIndex = (*foundProvider).second;
+        }
+
+        uint64_t hash = hashBytes(headerPos, headerSize);
+
+        CompactOutgoingDescriptor *descriptor {};
+        size_t descriptorIndex {};
+
+        auto foundDescriptor = mCompactOutgoingDescriptorsByHash.find(hash);
+        if (foundDescriptor != mCompactOutgoingDescriptorsByHash.end()) {
+          descriptorIndex = (*foundDescriptor).second;
+          descriptor = &(mCompactOutgoingDescriptors[descriptorIndex]);
+          if ((descriptor->mHeader.SizeInBytes() != headerSize) ||
+              (0 != memcmp(descriptor->mHeader.BytePtr(), headerPos, headerSize))) {
+            descriptor = NULL;
+          }
+        }
+
+        if (!descriptor) {
+          // table entries are recycled round robin; redefining an entry resets its delta state
+          descriptorIndex = mCompactNextOutgoingDescriptor;
+          mCompactNextOutgoingDescriptor = (mCompactNextOutgoingDescriptor + 1) % ZSLIB_EVENTING_REMOTE_EVENTING_COMPACT_MAX_DESCRIPTORS;
+
+          descriptor = &(mCompactOutgoingDescriptors[descriptorIndex]);
+          if (descriptor->mHeader.SizeInBytes() > 0) {
+            auto foundOld = mCompactOutgoingDescriptorsByHash.find(descriptor->mHash);
+            if ((foundOld != mCompactOutgoingDescriptorsByHash.end()) &&
+                ((*foundOld).second == descriptorIndex)) {
+              mCompactOutgoingDescriptorsByHash.erase(foundOld);
+            }
+          }
+
+          descriptor->mHeader.Assign(headerPos, headerSize);
+          descriptor->mHash = hash;
+          descriptor->mLastValues.assign(descriptorCount, 0);
+          mCompactOutgoingDescriptorsByHash[hash] = descriptorIndex;
+
+          *pos = ZSLIB_EVENTING_REMOTE_EVENTING_COMPACT_RECORD_DESCRIPTOR;
+          ++pos;
+          *pos = static_cast<BYTE>(descriptorIndex);
+          ++pos;
+          memcpy(pos, headerPos, headerSize);
+          pos += headerSize;
+        }
+
+        const BYTE *typesPos = headerPos + ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_HEADER_SIZE;
+
+        // string definitions must precede the event record referencing them
+        size_t stringIDs[ZSLIB_EVENTING_REMOTE_EVENTING_COMPACT_INTERNED_PARAMETERS] {};
+        {
+          const BYTE *stringPos = dataPos;
+          for (size_t index = 0; (index < descriptorCount) && (index < ZSLIB_EVENTING_REMOTE_EVENTING_COMPACT_INTERNED_PARAMETERS); ++index) {
+            auto type = static_cast<EventParameterTypes>(IHelper::getBE16(typesPos + (sizeof(CryptoPP::word16)*index)));
+
+            size_t dataTypeSize = static_cast<size_t>(IHelper::getBE32(stringPos) & (0x7FFFFFFF));
+            stringPos += sizeof(CryptoPP::word32);
+
+            if (EventParameterType_AString == type) {
+              stringIDs[index] = internCompactString(pos, stringPos, dataTypeSize);
+            }
+            stringPos += dataTypeSize;
+          }
+        }
+
+        *pos = ZSLIB_EVENTING_REMOTE_EVENTING_COMPACT_RECORD_EVENT;
+        ++pos;
+        putVarint(pos, providerIndex);
+        *pos = static_cast<BYTE>(descriptorIndex);
+        ++pos;
+
+        if (mEventOriginNegotiated) {
+          // events from different threads interleave so the delta may be negative
+          putVarint(pos, zigzagEncode(origin.mTimestamp - mCompactOutgoingLastTimestamp));
+          mCompactOutgoingLastTimestamp = origin.mTimestamp;
+          putVarint(pos, origin.mThreadID);
+          putVarint(pos, static_cast<uint32_t>(origin.mCPU + 1));  // unknown cpu becomes 0
+        }
+
+        for (size_t index = 0; index < descriptorCount; ++index) {
+          auto type = static_cast<EventParameterTypes>(IHelper::getBE16(typesPos + (sizeof(CryptoPP::word16)*index)));
+
+          size_t dataTypeSize = static_cast<size_t>(IHelper::getBE32(dataPos) & (0x7FFFFFFF));
+          dataPos += sizeof(CryptoPP::word32);
+
+          if ((index < ZSLIB_EVENTING_REMOTE_EVENTING_COMPACT_INTERNED_PARAMETERS) &&
+              (EventParameterType_AString == type)) {
+            putVarint(pos, stringIDs[index]);
+            if (ZSLIB_EVENTING_REMOTE_EVENTING_COMPACT_INLINE_STRING != stringIDs[index]) {
+              dataPos += dataTypeSize;
+              continue;
+            }
+          }
+
+          putVarint(pos, dataTypeSize);
+
+          if (!isCompactInteger(type, dataTypeSize)) {
+            memcpy(pos, dataPos, dataTypeSize);
+            if ((EventParameterType_FloatingPoint == type) &&
+                (mSwapOutgoingScalars)) {
+              swapScalarBytes(pos, dataTypeSize);
+            }
+            pos += dataTypeSize;
+            dataPos += dataTypeSize;
+            continue;
+          }
+
+          uint64_t value = getPackedInteger(dataPos, dataTypeSize, EventParameterType_SignedInteger == type);
+          dataPos += dataTypeSize;
+
+          switch (type) {
+            case EventParameterType_UnsignedInteger:
+            case EventParameterType_SignedInteger:    {
+              uint64_t delta = value - descriptor->mLastValues[index];
+              descriptor->mLastValues[index] = value;
+              putVarint(pos, zigzagEncode(delta));
+              break;
+            }
+            default:                                  {
+              putVarint(pos, value);
+              break;
+            }
+          }
+        }
+
+        size_t recordSize = static_cast<size_t>(pos - start);
+        putOutgoing(mEventBatchSegments, start, recordSize);
+        mEventBatchSize += recordSize;
+      }
+
+      //-----------------------------------------------------------------------
+      size_t RemoteEventing::internCompactString(
+                                                 BYTE * &ioPos,
+                                                 const BYTE *value,
+                                                 size_t size
+                                                 )
+      {
+        if ((0 == size) ||
+            (size > ZSLIB_EVENTING_REMOTE_EVENTING_COMPACT_MAX_INTERNED_STRING_SIZE)) return ZSLIB_EVENTING_REMOTE_EVENTING_COMPACT_INLINE_STRING;
+
+        // the original string pointers are gone once an event is packed so
+        // strings are keyed by content hash and confirmed by comparison
+        uint64_t hash = hashBytes(value, size);
+
+        auto found = mCompactOutgoingStringsByHash.find(hash);
+        if (found != mCompactOutgoingStringsByHash.end()) {
+          auto &existing = mCompactOutgoingStrings[(*found).second];
+          if ((existing.mValue.size() == size) &&
+              (0 == memcmp(existing.mValue.data(), value, size))) return (*found).second;
+        }
+
+        // ids start at 1 as 0 marks an inline string; recycled round robin
+        size_t stringID = mCompactNextOutgoingString + 1;
+        mCompactNextOutgoingString = (mCompactNextOutgoingString + 1) % ZSLIB_EVENTING_REMOTE_EVENTING_COMPACT_MAX_INTERNED_STRINGS;
+
+        auto &entry = mCompactOutgoingStrings[stringID];
+        if (entry.mValue.size() > 0) {
+          auto foundOld = mCompactOutgoingStringsByHash.find(entry.mHash);
+          if ((foundOld != mCompactOutgoingStringsByHash.end()) &&
+              ((*foundOld).second == stringID)) {
+            mCompactOutgoingStringsByHash.erase(foundOld);
+          }
+        }
+
+        entry.mHash = hash;
+        entry.mValue.assign(reinterpret_cast<const char *>(value), size);
+        mCompactOutgoingStringsByHash[hash] = stringID;
+
+        *ioPos = ZSLIB_EVENTING_REMOTE_EVENTING_COMPACT_RECORD_STRING;
+        ++ioPos;
+        putVarint(ioPos, stringID);
+        putVarint(ioPos, size);
+        memcpy(ioPos, value, size);
+        ioPos += size;
+
+        return stringID;
+      }
+
+      //-----------------------------------------------------------------------
+      uint64_t RemoteEventing::getOutgoingProvider(uint64_t handle)
+      {
+        if (!mRemoteSupportsDenseProviders) return handle;
+
+        // consecutive events mostly come from the same provider
+        if ((0 != mLastOutgoingProviderHandle) &&
+            (handle == mLastOutgoingProviderHandle)) return mLastOutgoingProviderIndex;
+
+        auto found = mLocalAnnouncedProviderIndexes.find(static_cast<ProviderHandle>(handle));
+        if (found == mLocalAnnouncedProviderIndexes.end()) return ZSLIB_EVENTING_REMOTE_EVENTING_UNKNOWN_PROVIDER_INDEX;
+
+        mLastOutgoingProviderHandle = handle;
+        mLastOutgoingProviderIndex = (*found).second;
+        return mLastOutgoingProviderIndex;
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::setEventOriginNegotiated(bool negotiated)
+      {
+        if (negotiated == mEventOriginNegotiated) return;
+        mEventOriginNegotiated = negotiated;
+
+        // origins are captured by whichever object receives the written events
+        RemoteEventingPtr capturing = (mIsClient ? mParentWeak.lock() : mThisWeak.lock());
+        RemoteEventing *target = (capturing ? capturing.get() : this);
+        if (negotiated) {
+          ++(target->mEventOriginParties);
+        } else {
+          --(target->mEventOriginParties);
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::resetCompactEvents(bool active)
+      {
+        mRemoteSupportsCompactEvents = active;
+
+        mCompactOutgoingProviders.clear();
+        mCompactOutgoingDescriptorsByHash.clear();
+        mCompactOutgoingDescriptors.clear();
+        mCompactNextOutgoingDescriptor = 0;
+        mCompactOutgoingStringsByHash.clear();
+        mCompactOutgoingStrings.clear();
+        mCompactNextOutgoingString = 0;
+        mCompactOutgoingLastTimestamp = 0;
+        mCompactIncomingLastTimestamp = 0;
+        mCompactIncomingProviders.clear();
+        mCompactIncomingDescriptors.clear();
+        mCompactIncomingStrings.clear();
+
+        if (!active) return;
+
+        mCompactOutgoingDescriptors.resize(ZSLIB_EVENTING_REMOTE_EVENTING_COMPACT_MAX_DESCRIPTORS);
+        mCompactIncomingDescriptors.resize(ZSLIB_EVENTING_REMOTE_EVENTING_COMPACT_MAX_DESCRIPTORS);
+        mCompactOutgoingStrings.resize(ZSLIB_EVENTING_REMOTE_EVENTING_COMPACT_MAX_INTERNED_STRINGS + 1);
+        mCompactIncomingStrings.resize(ZSLIB_EVENTING_REMOTE_EVENTING_COMPACT_MAX_INTERNED_STRINGS + 1);
+      }
+
+      //-----------------------------------------------------------------------
+      RemoteEventing::OutgoingSegmentPtr RemoteEventing::acquireOutgoingSegment()
+      {
+        if (mOutgoingSegmentPool.size() > 0) {
+          auto segment = mOutgoingSegmentPool.front();
+          mOutgoingSegmentPool.pop_front();
+          segment->mFilled = 0;
+          segment->mSent = 0;
+          return segment;
+        }
+        return make_shared<OutgoingSegment>(mOutgoingSegmentSize);
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::releaseOutgoingSegments(OutgoingSegmentList &segments)
+      {
+        while (segments.size() > 0) {
+          auto segment = segments.front();
+          segments.pop_front();
+
+          if (mOutgoingSegmentPool.size() >= mMaxPooledOutgoingSegments) continue;
+          mOutgoingSegmentPool.push_back(segment);
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::putOutgoing(
+                                       OutgoingSegmentList &segments,
+                                       const BYTE *data,
+                                       size_t size
+                                       )
+      {
+        while (size > 0) {
+          if ((segments.size() < 1) ||
+              (segments.back()->mFilled >= segments.back()->mBuffer.SizeInBytes())) {
+            segments.push_back(acquireOutgoingSegment());
+          }
+
+          auto &segment = segments.back();
+          size_t available = segment->mBuffer.SizeInBytes() - segment->mFilled;
+          size_t copySize = (size > available ? available : size);
+
+          memcpy(segment->mBuffer.BytePtr() + segment->mFilled, data, copySize);
+          segment->mFilled += copySize;
+
+          data += copySize;
+          size -= copySize;
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::putOutgoingWord32(
+                                             OutgoingSegmentList &segments,
+                                             CryptoPP::word32 value
+                                             )
+      {
+        BYTE buffer[sizeof(value)] {};
+        BYTE *pos = &(buffer[0]);
+        putBE32(pos, value);
+        putOutgoing(segments, &(buffer[0]), sizeof(buffer));
+      }
+
+      //-----------------------------------------------------------------------
+      size_t RemoteEventing::writeOutgoing(
+                                           SocketPtr socket,
+                                           bool &outWouldBlock
+                                           )
+      {
+#ifdef _WIN32
+        WSABUF buffers[ZSLIB_EVENTING_REMOTE_EVENTING_MAX_SEND_SEGMENTS];
+#else
+        struct iovec buffers[ZSLIB_EVENTING_REMOTE_EVENTING_MAX_SEND_SEGMENTS];
+#endif //_WIN32
+
+        const BYTE *firstPos {};
+        size_t firstSize {};
+        size_t count {};
+
+        for (auto iter = mOutgoingSegments.begin(); iter != mOutgoingSegments.end(); ++iter) {
+          if (count >= ZSLIB_EVENTING_REMOTE_EVENTING_MAX_SEND_SEGMENTS) break;
+
+          auto &segment = (*iter);
+          size_t available = segment->mFilled - segment->mSent;
+          if (0 == available) continue;
+
+          BYTE *pos = segment->mBuffer.BytePtr() + segment->mSent;
+          if (0 == count) {
+            firstPos = pos;
+            firstSize = available;
+          }
+
+#ifdef _WIN32
+          buffers[count].buf = reinterpret_cast<CHAR *>(pos);
+          buffers[count].len = static_cast<ULONG>(available);
+#else
+          buffers[count].iov_base = pos;
+          buffers[count].iov_len = available;
+#endif //_WIN32
+          ++count;
+        }
+
+        if (0 == count) return 0;
+
+#ifdef _WIN32
+        DWORD written {};
+        ++mSendCalls;
+        int result = WSASend(socket->getSocket(), &(buffers[0]), static_cast<DWORD>(count), &written, 0, NULL, NULL);
+        if (SOCKET_ERROR != result) return static_cast<size_t>(written);
+#else
+        struct msghdr message {};
+        message.msg_iov = &(buffers[0]);
+        message.msg_iovlen = count;
+
+        ++mSendCalls;
+        auto written = ::sendmsg(socket->getSocket(), &message, ZSLIB_EVENTING_REMOTE_EVENTING_SEND_FLAGS);
+        if (written >= 0) return static_cast<size_t>(written);
+#endif //_WIN32
+
+        // would block or failure; sending through the socket object rearms
+        // write ready notification or throws a socket exception as appropriate
+        ++mSendCalls;
+        auto sent = socket->send(firstPos, firstSize, &outWouldBlock);
+        if (outWouldBlock) ++mSendWouldBlockCalls;
+        return sent;
+      }
+
+      //-----------------------------------------------------------------------
+      size_t RemoteEventing::writeOutgoingLocal(bool &outWouldBlock)
+      {
+        size_t total {};
+
+        for (auto iter = mOutgoingSegments.begin(); iter != mOutgoingSegments.end(); ++iter) {
+          auto &segment = (*iter);
+          size_t available = segment->mFilled - segment->mSent;
+          if (0 == available) continue;
+
+          ++mSendCalls;
+          size_t written = mLocalChannel->send(segment->mBuffer.BytePtr() + segment->mSent, available);
+          total += written;
+          if (mLocalChannel->mFailed) {
+            outWouldBlock = true;
+            break;
+          }
+          if (written == available) continue;
+
+          // the ring is full; space freed while arming is used on the next pass
+          ++mSendWouldBlockCalls;
+          if (mLocalChannel->armWrite()) outWouldBlock = true;
+          break;
+        }
+
+        return total;
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::consumeOutgoing(size_t written)
+      {
+        mEventDataInOutgoingQueue -= written;
+
+        if (mEventDataInOutgoingQueue <= getPercentOf(mMaxQueuedOutgoingDataBeforeEventsDropped, ZSLIB_EVENTING_REMOTE_EVENTING_LOAD_SHEDDING_PRESSURE_PERCENT)) {
+          // pressure relieved, provider shares start over
+          ++mLoadSheddingEpoch;
+        }
+
+        while (mOutgoingSegments.size() > 0) {
+          auto &segment = mOutgoingSegments.front();
+
+          if (segment->mSent == segment->mFilled) {
+            OutgoingSegmentList sentSegments;
+            sentSegments.splice(sentSegments.end(), mOutgoingSegments, mOutgoingSegments.begin());
+            releaseOutgoingSegments(sentSegments);
+            continue;
+          }
+
+          if (0 == written) break;
+
+          size_t available = segment->mFilled - segment->mSent;
+          size_t consumed = (written > available ? available : written);
+          segment->mSent += consumed;
+          written -= consumed;
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::sendData(
+                                    MessageTypes messageType,
+                                    const SecureByteBlock &buffer
+                                    )
+      {
+        if (sizeof(CryptoPP::word32) + buffer.SizeInBytes() > ZSLIB_EVENTING_REMOTE_EVENTING_MAX_MESSAGE_SIZE) {
+          ZS_LOG_WARNING(Detail, log("outgoing message exceeds maximum size (not sent)") + ZS_PARAM("type", string(messageType)) + ZS_PARAM("size", buffer.SizeInBytes()));
+          return;
+        }
+
+        flushEventBatch();
+
+        CryptoPP::word32 type = static_cast<CryptoPP::word32>(messageType);
+        CryptoPP::word32 size = static_cast<CryptoPP::word32>(sizeof(type) + buffer.SizeInBytes());
+        
+        putOutgoingWord32(mOutgoingSegments, size);
+        putOutgoingWord32(mOutgoingSegments, type);
+        putOutgoing(mOutgoingSegments, buffer, buffer.SizeInBytes());
+        
+        mEventDataInOutgoingQueue += static_cast<size_t>((sizeof(uint32_t)*2) + buffer.SizeInBytes());
+        
+        if (mWriteReady) {
+          sendOutgoingData();
+        }
+      }
+      
+      //-----------------------------------------------------------------------
+      void RemoteEventing::sendData(
+                                    MessageTypes messageType,
+                                    const ElementPtr &rootEl
+                                    )
+      {
+        auto message = IHelper::toString(rootEl);
+        sendData(messageType, message);
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::sendData(
+                                    MessageTypes messageType,
+                                    const std::string &message
+                                    )
+      {
+        if (sizeof(CryptoPP::word32) + message.length() > ZSLIB_EVENTING_REMOTE_EVENTING_MAX_MESSAGE_SIZE) {
+          ZS_LOG_WARNING(Detail, log("outgoing message exceeds maximum size (not sent)") + ZS_PARAM("type", string(messageType)) + ZS_PARAM("size", message.length()));
+          return;
+        }
+
+        flushEventBatch();
+
+        CryptoPP::word32 type = static_cast<CryptoPP::word32>(messageType);
+        CryptoPP::word32 size = static_cast<CryptoPP::word32>(sizeof(type) + message.length());
+        
+        putOutgoingWord32(mOutgoingSegments, size);
+        putOutgoingWord32(mOutgoingSegments, type);
+        putOutgoing(mOutgoingSegments, reinterpret_cast<const BYTE *>(message.c_str()), message.length());
+
+        mEventDataInOutgoingQueue += static_cast<size_t>((sizeof(uint32_t)*2) + message.length());
+
+        if (mWriteReady) {
+          sendOutgoingData();
+        }
+      }
+      
+      //-----------------------------------------------------------------------
+      void RemoteEventing::sendAck(
+                                   const String &requestID,
+                                   int errorNumber,
+                                   const char *reason
+                                   )
+      {
+        auto rootEl = Element::create("ack");
+        
+        rootEl->adoptAsLastChild(IHelper::createElementWithText("id", requestID));
+        if (0 != errorNumber) {
+          rootEl->adoptAsLastChild(IHelper::createElementWithNumber("error", string(errorNumber)));
+          String reasonStr(reason);
+          if (reasonStr.hasData()) {
+            rootEl->adoptAsLastChild(IHelper::createElementWithText("reason", reasonStr));
+          }
+        }
+
+        sendData(MessageType_RequestAck, rootEl);
+      }
+      
+      //-----------------------------------------------------------------------
+      void RemoteEventing::handleHandshakeMessage(
+                                                  MessageTypes messageType,
+                                                  BYTE *buffer,
+                                                  size_t bufferSize
+                                                  )
+      {
+        if (MessageType_Goodbye == messageType) {
+          ZS_LOG_DEBUG(log("received goodbye during handshake"));
+          disconnect();
+          return;
+        }
+        
+        if (bufferSize < 1) {
+          ZS_LOG_WARNING(Detail, log("message size not legal (shutting down)") + ZS_PARAM("type", string(messageType)));
+          disconnect();
+          return;
+        }
+
+        // parsed in place so copy out to obtain a null terminated message
+        String message(std::string(reinterpret_cast<const char *>(buffer), bufferSize));
+        ElementPtr rootEl = IHelper::toJSON(message.c_str());
+        if (!rootEl) {
+          ZS_LOG_WARNING(Detail, log("message not legal (disconnecting)") + ZS_PARAM("type", string(messageType)));
+          disconnect();
+          return;
+        }
+
+        switch (messageType) {
+          case MessageType_Hello:           handleHello(rootEl); break;
+          case MessageType_Challenge:       handleChallenge(rootEl); break;
+          case MessageType_ChallengeReply:  handleChallengeReply(rootEl); break;
+          case MessageType_Welcome:         handleWelcome(rootEl); break;
+          default: {
+            ZS_LOG_WARNING(Detail, log("message type not understood (disconnecting)") + ZS_PARAM("type", string(messageType)));
+            disconnect();
+            break;
+          }
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::handleAuthorizedMessage(
+                                                   MessageTypes messageType,
+                                                   BYTE *buffer,
+                                                   size_t bufferSize
+                                                   )
+      {
+        switch (messageType) {
+          case MessageType_TraceEvent: {
+            handleEvent(buffer, bufferSize);
+            return;
+          }
+          case MessageType_TraceEventBatch: {
+            handleEventBatch(buffer, bufferSize);
+            return;
+          }
+          case MessageType_TraceEventCompact: {
+            handleEventCompact(buffer, bufferSize);
+            return;
+          }
+          case MessageType_TraceEventBacklog: {
+            handleEvent(buffer, bufferSize, true);
+            return;
+          }
+          case MessageType_SessionDelta: {
+            handleSessionDelta(buffer, bufferSize);
+            return;
+          }
+          case MessageType_Goodbye: {
+            ZS_LOG_DEBUG(log("received goodbye"));
+            disconnect();
+            return;
+          }
+          default: {
+            break;
+          }
+        }
+        
+        if (bufferSize < 1) {
+          ZS_LOG_WARNING(Detail, log("message size not legal (disconnecting)") + ZS_PARAM("type", string(messageType)));
+          disconnect();
+          return;
+        }
+        
+        // parsed in place so copy out to obtain a null terminated message
+        String message(std::string(reinterpret_cast<const char *>(buffer), bufferSize));
+        ElementPtr rootEl = IHelper::toJSON(message.c_str());
+        if (!rootEl) {
+          ZS_LOG_WARNING(Detail, log("message not legal (disconnecting)") + ZS_PARAM("type", string(messageType)));
+          disconnect();
+          return;
+        }
+
+        switch (messageType) {
+          case MessageType_Notify:      handleNotify(rootEl); break;
+          case MessageType_Request:     handleRequest(rootEl); break;
+          case MessageType_RequestAck:  handleRequestAck(rootEl); break;
+          default: {
+            ZS_LOG_WARNING(Detail, log("message type not understood (disconnecting)") + ZS_PARAM("type", string(messageType)));
+            disconnect();
+            break;
+          }
+        }
+      }
+      
+      //-----------------------------------------------------------------------
+      void RemoteEventing::handleHello(const ElementPtr &rootEl)
+      {
+        if ((MessageType_Hello != mHandshakeState) ||
+            (isConnectingMode())) {
+          ZS_LOG_WARNING(Detail, log("received hello but not waiting for hello"));
+          disconnect();
+          return;
+        }
+
+        mHelloSalt = IHelper::getElementText(rootEl->findFirstChildElement("salt"));
+        if (mHelloSalt.isEmpty()) {
+          ZS_LOG_WARNING(Detail, log("received hello but missing salt"));
+          disconnect();
+          return;
+        }
+        
+        String helloProof = IHelper::getElementText(rootEl->findFirstChildElement("proof"));
+        String expectingHelloProof = IHasher::hashAsString("hello:proof:" + mSharedSecret + ":" + mHelloSalt, IHasher::sha256());
+        
+        if (helloProof != expectingHelloProof) {
+          ZS_LOG_WARNING(Detail, log("hello proof does not match expected value") + ZS_PARAMIZE(helloProof) + ZS_PARAMIZE(expectingHelloProof));
+          disconnect();
+          return;
+        }
+
+        mHandshakeState = MessageType_Challenge;
+
+        // only a party which proved the shared secret is recorded
+        beginRecordedConnection();
+
+        // remember the connecting side can accept batches (confirmed again in its welcome)
+        String eventBatchStr = IHelper::getElementText(rootEl->findFirstChildElement("eventBatch"));
+        mRemoteSupportsEventBatches = (mUseEventBatches) && (String(ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_BATCH_VERSION) == eventBatchStr);
+
+        String compactEventsStr = IHelper::getElementText(rootEl->findFirstChildElement("compactEvents"));
+        resetCompactEvents((useCompactEvents()) && (String(ZSLIB_EVENTING_REMOTE_EVENTING_COMPACT_EVENTS_VERSION) == compactEventsStr));
+
+        String eventOriginStr = IHelper::getElementText(rootEl->findFirstChildElement("eventOrigin"));
+        setEventOriginNegotiated(String(ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_ORIGIN_VERSION) == eventOriginStr);
+
+        String denseProvidersStr = IHelper::getElementText(rootEl->findFirstChildElement("denseProviders"));
+        mRemoteSupportsDenseProviders = (String(ZSLIB_EVENTING_REMOTE_EVENTING_DENSE_PROVIDERS_VERSION) == denseProvidersStr);
+        mLastOutgoingProviderHandle = 0;
+
+        // a party not sending scalars in its own byte order expects them big endian
+        String nativeByteOrderStr = IHelper::getElementText(rootEl->findFirstChildElement("nativeByteOrder"));
+        mRemoteUsesNativeByteOrder = (String(ZSLIB_EVENTING_REMOTE_EVENTING_NATIVE_BYTE_ORDER_VERSION) == nativeByteOrderStr);
+        mSwapOutgoingScalars = (!mRemoteUsesNativeByteOrder) && (isLittleEndianHost());
+
+        String eventBacklogStr = IHelper::getElementText(rootEl->findFirstChildElement("eventBacklog"));
+        mRemoteSupportsEventBacklog = (String(ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_BACKLOG_VERSION) == eventBacklogStr);
+
+        mPresentedSessionToken = IHelper::getElementText(rootEl->findFirstChildElement("session"));
+        mPresentedSessionEpoch = getElementNumber<uint32_t>(rootEl, "sessionEpoch");
+        mPresentedSessionDigest = getElementNumber<uint64_t>(rootEl, "sessionDigest");
+        
+        mExpectingHelloProofInChallenge = IHasher::hashAsString("hello:expecting:" + mSharedSecret + ":" + mHelloSalt, IHasher::sha256());
+
+        ElementPtr challengeEl = Element::create("challenge");
+
+        mChallengeSalt = IHelper::randomString(IHasher::sha256DigestSize() * 8 / 5);
+        challengeEl->adoptAsFirstChild(IHelper::createElementWithNumber("version", "1"));
+        challengeEl->adoptAsFirstChild(IHelper::createElementWithText("salt", mChallengeSalt));
+        challengeEl->adoptAsFirstChild(IHelper::createElementWithText("proof", mExpectingHelloProofInChallenge));
+
+        mExpectingChallengeProofInReply = IHasher::hashAsString("challenge:expecting:" + mSharedSecret + ":" + mHelloSalt + ":" + mChallengeSalt, IHasher::sha256());
+        sendData(MessageType_Challenge, challengeEl);
       }
       
       //-----------------------------------------------------------------------
-      bool RemoteEventing::stepNotifyTimer()
+      void RemoteEventing::handleChallenge(const ElementPtr &rootEl)
       {
-        if (mNotifyTimer) {
-          ZS_LOG_TRACE(log("step - already have notify timer"));
-          return true;
+        if ((MessageType_Challenge != mHandshakeState) ||
+            (mChallengeSalt.hasData())) {
+          ZS_LOG_WARNING(Detail, log("received challenge but not waiting for challenge"));
+          disconnect();
+          return;
         }
+
+        mChallengeSalt = IHelper::getElementText(rootEl->findFirstChildElement("salt"));
+        String proof = IHelper::getElementText(rootEl->findFirstChildElement("proof"));
         
-        Seconds notifyTimeout(ISettings::getUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_NOTIFY_TIMER));
-        if (notifyTimeout < Seconds(1)) {
-          notifyTimeout = Seconds(1);
+        if (proof != mExpectingHelloProofInChallenge) {
+          ZS_LOG_WARNING(Detail, log("received challenge but proof does not match") + ZS_PARAMIZE(proof) + ZS_PARAMIZE(mExpectingHelloProofInChallenge));
+          disconnect();
+          return;
         }
 
-        mNotifyTimer = ITimer::create(mThisWeak.lock(), notifyTimeout);
-        return true;
+        ElementPtr challengeReplyEl = Element::create("challengeReply");
+
+        mExpectingChallengeProofInReply = IHasher::hashAsString("challenge:expecting:" + mSharedSecret + ":" + mHelloSalt + ":" + mChallengeSalt, IHasher::sha256());
+        challengeReplyEl->adoptAsFirstChild(IHelper::createElementWithText("proof", mExpectingChallengeProofInReply));
+
+        sendData(MessageType_ChallengeReply, challengeReplyEl);
+        mHandshakeState = MessageType_ChallengeReply;
       }
 
       //-----------------------------------------------------------------------
-      bool RemoteEventing::stepAuthorized()
+      void RemoteEventing::handleChallengeReply(const ElementPtr &rootEl)
       {
-        if (!isAuthorized()) {
-          ZS_LOG_TRACE(log("step - not authorized"));
-          return false;
+        if ((MessageType_Challenge != mHandshakeState) ||
+            (!mChallengeSalt.hasData())) {
+          ZS_LOG_WARNING(Detail, log("received challenge reply but not waiting for challenge reply"));
+          disconnect();
+          return;
+        }
+        
+        String proof = IHelper::getElementText(rootEl->findFirstChildElement("proof"));
+        if (proof != mExpectingChallengeProofInReply) {
+          ZS_LOG_WARNING(Detail, log("received challenge reply but proof does not match") + ZS_PARAMIZE(proof) + ZS_PARAMIZE(mExpectingChallengeProofInReply));
+          disconnect();
+          return;
+        }
+
+        mHandshakeState = MessageType_ChallengeReply;
+        sendWelcome();
+      }
+      
+      //-----------------------------------------------------------------------
+      void RemoteEventing::handleWelcome(const ElementPtr &rootEl)
+      {
+        if (MessageType_ChallengeReply != mHandshakeState) {
+          ZS_LOG_WARNING(Detail, log("received welcome but not waiting for welcome"));
+          disconnect();
+          return;
+        }
+
+        String eventBatchStr = IHelper::getElementText(rootEl->findFirstChildElement("eventBatch"));
+        mRemoteSupportsEventBatches = (mUseEventBatches) && (String(ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_BATCH_VERSION) == eventBatchStr);
+
+        String compactEventsStr = IHelper::getElementText(rootEl->findFirstChildElement("compactEvents"));
+        resetCompactEvents((useCompactEvents()) && (String(ZSLIB_EVENTING_REMOTE_EVENTING_COMPACT_EVENTS_VERSION) == compactEventsStr));
+
+        String eventOriginStr = IHelper::getElementText(rootEl->findFirstChildElement("eventOrigin"));
+        setEventOriginNegotiated(String(ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_ORIGIN_VERSION) == eventOriginStr);
+
+        String denseProvidersStr = IHelper::getElementText(rootEl->findFirstChildElement("denseProviders"));
+        mRemoteSupportsDenseProviders = (String(ZSLIB_EVENTING_REMOTE_EVENTING_DENSE_PROVIDERS_VERSION) == denseProvidersStr);
+        mLastOutgoingProviderHandle = 0;
+
+        // a party not sending scalars in its own byte order expects them big endian
+        String nativeByteOrderStr = IHelper::getElementText(rootEl->findFirstChildElement("nativeByteOrder"));
+        mRemoteUsesNativeByteOrder = (String(ZSLIB_EVENTING_REMOTE_EVENTING_NATIVE_BYTE_ORDER_VERSION) == nativeByteOrderStr);
+        mSwapOutgoingScalars = (!mRemoteUsesNativeByteOrder) && (isLittleEndianHost());
+
+        String eventBacklogStr = IHelper::getElementText(rootEl->findFirstChildElement("eventBacklog"));
+        mRemoteSupportsEventBacklog = (String(ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_BACKLOG_VERSION) == eventBacklogStr);
+
+        mHandshakeState = MessageType_Welcome;
+        if (isConnectingMode()) {
+          sendWelcome();
+        }
+        
+        String valueStr = IHelper::getElementText(rootEl->findFirstChildElement("value32"));
+        String valueBytesStr = IHelper::getElementText(rootEl->findFirstChildElement("value32Bytes"));
+        
+        try {
+          uint32_t value32 = Numeric<uint32_t>(valueStr);
+          
+          auto valueBuffer = IHelper::convertFromHex(valueBytesStr);
+          if ((!valueBuffer) ||
+              (valueBuffer->SizeInBytes() < sizeof(value32))) {
+            ZS_LOG_WARNING(Detail, log("value byes does not match size of value32"));
+            disconnect();
+            return;
+          }
+          
+          if (0 != memcmp(valueBuffer->BytePtr(), &value32, sizeof(value32))) mFlipEndianInt = true;
+        } catch (const Numeric<uint32_t>::ValueOutOfRange &) {
+          ZS_LOG_WARNING(Detail, log("received welcome but missing value32"));
+          disconnect();
+          return;
+        }
+
+        String valueFloatStr = IHelper::getElementText(rootEl->findFirstChildElement("valueFloat"));
+        String valueFloatBytesStr = IHelper::getElementText(rootEl->findFirstChildElement("valueFloatBytes"));
+
+        try {
+          float valueFloat = Numeric<float>(valueFloatStr);
+          
+          auto valueBuffer = IHelper::convertFromHex(valueFloatBytesStr);
+          if ((!valueBuffer) ||
+              (valueBuffer->SizeInBytes() < sizeof(valueFloat))) {
+            ZS_LOG_WARNING(Detail, log("value byes does not match size of value float"));
+            disconnect();
+            return;
+          }
+
+          if (0 != memcmp(valueBuffer->BytePtr(), &valueFloat, sizeof(valueFloat))) mFlipEndianFloat = true;
+        } catch (const Numeric<float>::ValueOutOfRange &) {
+          ZS_LOG_WARNING(Detail, log("received welcome but missing value32"));
+          disconnect();
+          return;
+        }
+
+        if (mRemoteUsesNativeByteOrder) {
+          mSwapIncomingIntegers = mFlipEndianInt;
+          mSwapIncomingFloats = mFlipEndianFloat;
+        }
+        ZS_LOG_DEBUG(log("scalar byte order") + ZS_PARAM("native", mRemoteUsesNativeByteOrder) + ZS_PARAM("swap integers", mSwapIncomingIntegers) + ZS_PARAM("swap floats", mSwapIncomingFloats) + ZS_PARAM("swap outgoing", mSwapOutgoingScalars));
+
+        if (isConnectingMode()) {
+          mSessionToken = IHelper::getElementText(rootEl->findFirstChildElement("session"));
+          mSessionEpoch = getElementNumber<uint32_t>(rootEl, "sessionEpoch");
+
+          String resumedStr = IHelper::getElementText(rootEl->findFirstChildElement("sessionResumed"));
+          if ((mResume) &&
+              (mResume->mToken == mSessionToken) &&
+              ("true" == resumedStr)) {
+            restoreResumeInfo();
+          }
+          mResume.reset();
+        }
+
+        noteRecordedConnectionState();
+
+        // events spooled before the connection was authorized follow the announcements
+        if (replaySpool()) sendOutgoingData();
+
+        IWakeDelegateProxy::create(mThisWeak.lock())->onWake();
+        IRemoteEventingAsyncDelegateProxy::create(mThisWeak.lock())->onRemoteEventingSubscribeLogger();
+      }
+      
+      
+      //-----------------------------------------------------------------------
+      void RemoteEventing::handleNotify(const ElementPtr &rootEl)
+      {
+        String typeStr = IHelper::getElementText(rootEl->findFirstChildElement("type"));
+        if (ZSLIB_EVENTING_REMOTE_EVENTING_NOTIFY_GENERAL_INFO == typeStr) {
+          handleNotifyGeneralInfo(rootEl);
+          return;
+        }
+        if (ZSLIB_EVENTING_REMOTE_EVENTING_NOTIFY_SUBSYSTEM == typeStr) {
+          handleNotifyRemoteSubsystem(rootEl);
+          return;
+        }
+        if (ZSLIB_EVENTING_REMOTE_EVENTING_NOTIFY_PROVIDER == typeStr) {
+          handleNotifyRemoteProvider(rootEl);
+          return;
+        }
+        if (ZSLIB_EVENTING_REMOTE_EVENTING_NOTIFY_PROVIDER_KEYWORD_LOGGING == typeStr) {
+          handleNotifyRemoteProviderKeywordLogging(rootEl);
+          return;
         }
-
-        ZS_LOG_TRACE(log("step - authorized"));
-        return true;
+        ZS_LOG_WARNING(Detail, log("remote notify is not understood (ignored)") + ZS_PARAMIZE(typeStr));
       }
 
       //-----------------------------------------------------------------------
-      void RemoteEventing::setState(States state)
+      void RemoteEventing::handleNotifyGeneralInfo(const ElementPtr &rootEl)
       {
-        if (state == mState) return;
-        
-        ZS_LOG_DEBUG(log("state changed") + ZS_PARAM("old state", IRemoteEventingTypes::toString(mState)) + ZS_PARAM("new state", state));
+        String subsystemStr = IHelper::getElementText(rootEl->findFirstChildElement("subsystem"));
+        String droppedStr = IHelper::getElementText(rootEl->findFirstChildElement("dropped"));
         
-        mState = state;
+        size_t totalDropped = 0;
+        try {
+          totalDropped = Numeric<decltype(totalDropped)>(droppedStr);
+        } catch (const Numeric<decltype(totalDropped)>::ValueOutOfRange &) {
+          ZS_LOG_WARNING(Detail, log("dropped value is not valid") + ZS_PARAMIZE(droppedStr));
+          return;
+        }
 
-        auto pThis = mThisWeak.lock();
-        if (pThis) {
+        ElementPtr statisticsEl = rootEl->findFirstChildElement("statistics");
+        if (statisticsEl) {
+          mRemoteStatistics = Statistics(statisticsEl);
+          mHasRemoteStatistics = true;
+        }
+
+        if (mAnnouncedRemoteDropped != totalDropped) {
+          mAnnouncedRemoteDropped = totalDropped;
+
+          ElementPtr providersEl = rootEl->findFirstChildElement("providers");
+          if (providersEl) {
+            ZS_LOG_WARNING(Detail, log("remote events dropped") + ZS_PARAM("dropped", totalDropped) + ZS_PARAM("by provider", IHelper::toString(providersEl)));
+          }
           if (mDelegate) {
             try {
-              mDelegate->onRemoteEventingStateChanged(pThis, mState);
+              mDelegate->onRemoteEventingRemoteDroppedEvents(getPublicConnection(), totalDropped);
             } catch (const IRemoteEventingDelegateProxy::Exceptions::DelegateGone &) {
               ZS_LOG_WARNING(Detail, log("delegate gone (probably okay)"));
               mDelegate.reset();
@@ -1254,524 +7375,780 @@ namespace zsLib
       }
 
       //-----------------------------------------------------------------------
-      void RemoteEventing::resetConnection()
-      {
-        if (mNotifyTimer) {
-          mNotifyTimer->cancel();
-          mNotifyTimer.reset();
-        }
-        for (auto iter = mRequestedRemoteProviderKeywordLevel.begin(); iter != mRequestedRemoteProviderKeywordLevel.end(); ++iter)
-        {
-          auto provider = (*iter).second;
-          Log::setEventingLogging(provider->mHandle, mID, false);
-        }
-        mRequestedRemoteProviderKeywordLevel.clear();
-        mRequestRemoteProviderKeywordLevel.clear();
-
-        mAnnouncedLocalDropped = 0;
-        mAnnouncedRemoteDropped = 0;
-        mTotalDroppedEvents = 0;
-        mIncomingQueue.Clear();
-        mOutgoingQueue.Clear();
-        mEventDataInOutgoingQueue = 0;
-
-        mHelloSalt.clear();
-        mExpectingHelloProofInChallenge.clear();
-        mChallengeSalt.clear();
-        mExpectingChallengeProofInReply.clear();
-        
-        mFlipEndianInt = false;
-        mFlipEndianFloat = false;
-        
-        mRemoteSubsystems.clear();
-        for (auto iter = mRemoteRegisteredProvidersByUUID.begin(); iter != mRemoteRegisteredProvidersByUUID.end(); ++iter) {
-          auto provider = (*iter).second;
-          Log::setEventingLogging(provider->mHandle, mID, false);
-          Log::unregisterEventingWriter(provider->mHandle);
-        }
-        mRemoteRegisteredProvidersByUUID.clear();
-        mRemoteRegisteredProvidersByRemoteHandle.clear();
-      }
-      
-      //-----------------------------------------------------------------------
-      void RemoteEventing::prepareNewConnection()
+      void RemoteEventing::handleNotifyRemoteSubsystem(const ElementPtr &rootEl)
       {
-        resetConnection();
-        mHandshakeState = MessageType_First;
-        setState(State_Listening);
+        String subsystemStr = IHelper::getElementText(rootEl->findFirstChildElement("name"));
+        registerRemoteSubsystem(subsystemStr);
       }
 
       //-----------------------------------------------------------------------
-      void RemoteEventing::readIncomingMessage()
-      {
-        while ((mIncomingQueue.AnyRetrievable()) &&
-               (MessageType_Goodbye != mHandshakeState))
-        {
-          auto available = mIncomingQueue.CurrentSize();
-
-          CryptoPP::word32 messageSize{};
-          if (available < sizeof(messageSize)) {
-            ZS_LOG_INSANE(log("insufficient read size for next message") + ZS_PARAM("size", available));
-            break;
-          }
-
-          // message size does include the size of the message type
-          mIncomingQueue.PeekWord32(messageSize);
-          if (available < sizeof(messageSize) + messageSize) {
-            ZS_LOG_INSANE(log("insufficient read size for next message") + ZS_PARAM("available", available) + ZS_PARAM("size", messageSize));
-            break;
-          }
-
-          mIncomingQueue.Skip(sizeof(messageSize));
-
-          CryptoPP::word32 messageType {};
-          if (messageSize < sizeof(messageType)) {
-            ZS_LOG_WARNING(Detail, log("illegal message size (disconnecting)"));
-            disconnect();
-            return;
-          }
-
-          mIncomingQueue.GetWord32(messageType);
-          messageSize -= sizeof(messageType);
-
-          SecureByteBlock buffer(messageSize);
-          mIncomingQueue.Get(buffer, messageSize);
-
-          if (MessageType_Welcome == mHandshakeState) {
-            handleAuthorizedMessage(static_cast<MessageTypes>(messageType), buffer);
-          } else {
-            handleHandshakeMessage(static_cast<MessageTypes>(messageType), buffer);
-          }
-        }
-      }
-      
-      //-----------------------------------------------------------------------
-      void RemoteEventing::sendOutgoingData()
+      void RemoteEventing::handleNotifyRemoteProvider(const ElementPtr &rootEl)
       {
-        if (!mWriteReady) {
-          ZS_LOG_INSANE(log("waiting for write ready to be able to send"));
-          return;
-        }
+        String remoteHandleStr = IHelper::getElementText(rootEl->findLastChildElement("handle"));
+        String goneStr = IHelper::getElementText(rootEl->findLastChildElement("gone"));
         
-        if (!mOutgoingQueue.AnyRetrievable()) {
-          ZS_LOG_INSANE(log("no data available to send"));
+        ProviderHandle remoteHandle = 0;
+        try {
+          remoteHandle = Numeric<ProviderHandle>(remoteHandleStr);
+        } catch (const Numeric<ProviderHandle>::ValueOutOfRange &) {
+          ZS_LOG_WARNING(Detail, log("remote handle is not valid") + ZS_PARAMIZE(remoteHandleStr));
           return;
         }
         
-        auto activeSocket = getActiveSocket();
-        if (!activeSocket) {
-          ZS_LOG_INSANE(log("no socket available to send"));
-          return;
+        if (goneStr.hasData()) {
+          try {
+            bool gone = Numeric<bool>(goneStr);
+            if (gone) {
+              unregisterRemoteProvider(remoteHandle);
+              return;
+            }
+            
+            // provider is not gone...
+          } catch (const Numeric<bool>::ValueOutOfRange &) {
+            ZS_LOG_WARNING(Detail, log("gone text was not understood") + ZS_PARAMIZE(goneStr));
+            return;
+          }
         }
         
+        String providerIDStr = IHelper::getElementText(rootEl->findLastChildElement("id"));
+        String providerNameStr = IHelper::getElementText(rootEl->findLastChildElement("name"));
+        String providerHashStr = IHelper::getElementText(rootEl->findLastChildElement("hash"));
+        
+        UUID providerID {};
         try {
-          while (mWriteReady) {
-            BYTE buffer[4096];
-
-            size_t availeable = mEventDataInOutgoingQueue;
-            if (availeable < 1) break;
-#ifdef _DEBUG
-            ZS_THROW_BAD_STATE_IF(availeable != mOutgoingQueue.CurrentSize())
-#endif //_DEBUG
-            if (availeable > sizeof(buffer)) {
-              availeable = sizeof(buffer);
-            }
-
-            mOutgoingQueue.Peek(&(buffer[0]), availeable);
-
-            bool wouldBlock = false;
-            auto written = activeSocket->send(&(buffer[0]), availeable, &wouldBlock);
-
-            mOutgoingQueue.Skip(written);
-            mEventDataInOutgoingQueue -= static_cast<size_t>(written);
-            if (wouldBlock) mWriteReady = false;
-          }
-        } catch (const Socket::Exceptions::Unspecified &) {
-          ZS_LOG_WARNING(Debug, log("could not write to active socket"));
+          providerID = Numeric<UUID>(providerIDStr);
+        } catch (const Numeric<UUID>::ValueOutOfRange &) {
+          ZS_LOG_WARNING(Debug, log("remote provider announced by provider ID is not recognized") + ZS_PARAMIZE(providerIDStr));
+          return;
         }
 
-        if (isShuttingDown()) {
-          ZS_LOG_TRACE(log("step after write ready"));
-          cancel();
-        }
+        registerRemoteProvider(remoteHandle, providerID, providerNameStr, providerHashStr, getElementNumber<uint32_t>(rootEl, "index"));
       }
 
       //-----------------------------------------------------------------------
-      void RemoteEventing::sendData(
-                                    MessageTypes messageType,
-                                    const SecureByteBlock &buffer
-                                    )
+      void RemoteEventing::handleNotifyRemoteProviderKeywordLogging(const ElementPtr &rootEl)
       {
-        CryptoPP::word32 type = static_cast<CryptoPP::word32>(messageType);
-        CryptoPP::word32 size = static_cast<CryptoPP::word32>(sizeof(type) + buffer.SizeInBytes());
-        
-        mOutgoingQueue.PutWord32(size);
-        mOutgoingQueue.PutWord32(type);
-        mOutgoingQueue.Put(buffer, buffer.SizeInBytes());
+        String remoteHandleStr = IHelper::getElementText(rootEl->findLastChildElement("handle"));
+        String bitmaskStr = IHelper::getElementText(rootEl->findLastChildElement("bitmask"));
         
-        mEventDataInOutgoingQueue += static_cast<size_t>((sizeof(uint32_t)*2) + buffer.SizeInBytes());
+        ProviderHandle remoteHandle = 0;
+        try {
+          remoteHandle = Numeric<ProviderHandle>(remoteHandleStr);
+        } catch (const Numeric<ProviderHandle>::ValueOutOfRange &) {
+          ZS_LOG_WARNING(Detail, log("remote handle is not valid") + ZS_PARAMIZE(remoteHandleStr));
+          return;
+        }
         
-        if (mWriteReady) {
-          sendOutgoingData();
+        KeywordBitmaskType bitmask = 0;
+        try {
+          bitmask = Numeric<KeywordBitmaskType>(bitmaskStr);
+        } catch (const Numeric<KeywordBitmaskType>::ValueOutOfRange &) {
+          ZS_LOG_WARNING(Debug, log("remote bitmask is not valid"));
+          return;
         }
+
+        noteRemoteProviderKeywords(remoteHandle, bitmask);
       }
-      
+
       //-----------------------------------------------------------------------
-      void RemoteEventing::sendData(
-                                    MessageTypes messageType,
-                                    const ElementPtr &rootEl
-                                    )
+      void RemoteEventing::handleSessionDelta(
+                                              BYTE *buffer,
+                                              size_t bufferSize
+                                              )
       {
-        auto message = IHelper::toString(rootEl);
-        sendData(messageType, message);
+        BYTE *pos = buffer;
+        size_t remaining = bufferSize;
+
+        while (remaining > 0) {
+          BYTE record = *pos;
+          ++pos;
+          --remaining;
+
+          uint64_t remoteHandle {};
+
+          switch (record) {
+            case ZSLIB_EVENTING_REMOTE_EVENTING_SESSION_RECORD_SUBSYSTEM: {
+              String subsystemName;
+              if (!getSessionString(pos, remaining, subsystemName)) goto invalid_delta;
+              registerRemoteSubsystem(subsystemName);
+              break;
+            }
+            case ZSLIB_EVENTING_REMOTE_EVENTING_SESSION_RECORD_PROVIDER: {
+              String providerIDStr;
+              String providerName;
+              String providerHash;
+              uint64_t index {};
+              uint64_t bitmask {};
+              if (!getVarint(pos, remaining, remoteHandle)) goto invalid_delta;
+              if (!getVarint(pos, remaining, index)) goto invalid_delta;
+              if (!getSessionString(pos, remaining, providerIDStr)) goto invalid_delta;
+              if (!getSessionString(pos, remaining, providerName)) goto invalid_delta;
+              if (!getSessionString(pos, remaining, providerHash)) goto invalid_delta;
+              if (!getVarint(pos, remaining, bitmask)) goto invalid_delta;
+
+              UUID providerID {};
+              try {
+                providerID = Numeric<UUID>(providerIDStr);
+              } catch (const Numeric<UUID>::ValueOutOfRange &) {
+                goto invalid_delta;
+              }
+
+              registerRemoteProvider(static_cast<ProviderHandle>(remoteHandle), providerID, providerName, providerHash, static_cast<uint32_t>(index));
+              if (0 != bitmask) noteRemoteProviderKeywords(static_cast<ProviderHandle>(remoteHandle), static_cast<KeywordBitmaskType>(bitmask));
+              break;
+            }
+            case ZSLIB_EVENTING_REMOTE_EVENTING_SESSION_RECORD_PROVIDER_GONE: {
+              if (!getVarint(pos, remaining, remoteHandle)) goto invalid_delta;
+              unregisterRemoteProvider(static_cast<ProviderHandle>(remoteHandle));
+              break;
+            }
+            case ZSLIB_EVENTING_REMOTE_EVENTING_SESSION_RECORD_PROVIDER_KEYWORDS: {
+              uint64_t bitmask {};
+              if (!getVarint(pos, remaining, remoteHandle)) goto invalid_delta;
+              if (!getVarint(pos, remaining, bitmask)) goto invalid_delta;
+              noteRemoteProviderKeywords(static_cast<ProviderHandle>(remoteHandle), static_cast<KeywordBitmaskType>(bitmask));
+              break;
+            }
+            default: goto invalid_delta;
+          }
+        }
+        return;
+
+      invalid_delta:
+        {
+          ZS_LOG_WARNING(Detail, log("session delta is not valid (disconnecting)") + ZS_PARAM("offset", bufferSize - remaining));
+          disconnect();
+        }
       }
 
       //-----------------------------------------------------------------------
-      void RemoteEventing::sendData(
-                                    MessageTypes messageType,
-                                    const std::string &message
-                                    )
+      void RemoteEventing::handleRequest(const ElementPtr &rootEl)
       {
-        CryptoPP::word32 type = static_cast<CryptoPP::word32>(messageType);
-        CryptoPP::word32 size = static_cast<CryptoPP::word32>(sizeof(type) + message.length());
-        
-        mOutgoingQueue.PutWord32(size);
-        mOutgoingQueue.PutWord32(type);
-        mOutgoingQueue.Put(reinterpret_cast<const BYTE *>(message.c_str()), message.length());
+        int error = 0;
+        String reason;
+        String requestID = IHelper::getElementText(rootEl->findFirstChildElement("id"));
+        String typeStr = IHelper::getElementText(rootEl->findFirstChildElement("type"));
+        if (ZSLIB_EVENTING_REMOTE_EVENTING_REQUEST_SET_SUBSYSTEM_LEVEL == typeStr) {
+          String subsystemStr = IHelper::getElementText(rootEl->findFirstChildElement("subsystem"));
+          String levelStr = IHelper::getElementText(rootEl->findFirstChildElement("level"));
 
-        mEventDataInOutgoingQueue += static_cast<size_t>((sizeof(uint32_t)*2) + message.length());
+          try {
+            auto level = Log::toLevel(levelStr);
+            if (mIsClient) {
+              // the subsystem level is shared so it becomes the highest level any party requested
+              mRequestedSubsystemLevels[hashBytes(reinterpret_cast<const BYTE *>(subsystemStr.c_str()), subsystemStr.length())] = level;
+              auto parent = mParentWeak.lock();
+              if (parent) level = parent->setClientSubsystemLevel(mID, subsystemStr, level);
+            }
+            Log::setEventingLevelByName(subsystemStr, level);
+          } catch (const InvalidArgument &) {
+            ZS_LOG_WARNING(Detail, log("remote set subsystem request is not understood (ignored)") + ZS_PARAMIZE(subsystemStr) + ZS_PARAMIZE(subsystemStr));
+            error = -1;
+            reason = "Level was not understood: " + levelStr;
+          }
+          sendAck(requestID, error, reason);
+          return;
+        }
+        if (ZSLIB_EVENTING_REMOTE_EVENTING_REQUEST_SET_EVENT_PROVIDER_LOGGING == typeStr) {
+          String providerStr = IHelper::getElementText(rootEl->findFirstChildElement("provider"));
+          String keywordStr = IHelper::getElementText(rootEl->findFirstChildElement("keywords"));
+          KeywordBitmaskType bitmask = 0;
+          try {
+            bitmask = Numeric<KeywordBitmaskType>(keywordStr);
+            for (auto iter = mLocalAnnouncedProviders.begin(); iter != mLocalAnnouncedProviders.end(); ++iter) {
+              auto providerInfo = (*iter).second;
+              if (providerInfo->mProviderName == providerStr) {
+                if (0 == bitmask) {
+                  auto found = mRequestedRemoteProviderKeywordLevel.find(providerInfo->mHandle);
+                  if (found != mRequestedRemoteProviderKeywordLevel.end()) mRequestedRemoteProviderKeywordLevel.erase(found);
+                  auto foundKeywords = mRequestedRemoteProviderKeywords.find(providerInfo->mHandle);
+                  if (foundKeywords != mRequestedRemoteProviderKeywords.end()) mRequestedRemoteProviderKeywords.erase(foundKeywords);
+                } else {
+                  mRequestedRemoteProviderKeywordLevel[providerInfo->mHandle] = providerInfo;
+                  mRequestedRemoteProviderKeywords[providerInfo->mHandle] = bitmask;
+                }
+                if (mIsClient) updateProviderEventFilter(providerInfo);
+                Log::setEventingLogging(providerInfo->mHandle, mID, 0 != bitmask, bitmask);
+              }
+            }
 
-        if (mWriteReady) {
-          sendOutgoingData();
+            // a subscribed party may be what a waiting backlog is replayed to
+            if ((mIsClient) &&
+                (0 != bitmask)) {
+              auto parent = mParentWeak.lock();
+              if (parent) IRemoteEventingAsyncDelegateProxy::create(parent)->onRemoteEventingClientStateChanged();
+            }
+          } catch (const Numeric<KeywordBitmaskType>::ValueOutOfRange &) {
+            ZS_LOG_WARNING(Detail, log("remote set event provider logging request is not understood (ignored)") + ZS_PARAMIZE(providerStr) + ZS_PARAMIZE(keywordStr));
+            error = -1;
+            reason = "Keywords value was not understood: " + keywordStr;
+          }
+          sendAck(requestID, error, reason);
+          return;
+        }
+        if (ZSLIB_EVENTING_REMOTE_EVENTING_REQUEST_SET_EVENT_PROVIDER_EVENTS == typeStr) {
+          String providerStr = IHelper::getElementText(rootEl->findFirstChildElement("provider"));
+          String eventsStr = IHelper::getElementText(rootEl->findFirstChildElement("events"));
+          EventIDBitmapPtr enabledEvents;
+          if (decodeEventIDBitmap(eventsStr, enabledEvents)) {
+            for (auto iter = mLocalAnnouncedProviders.begin(); iter != mLocalAnnouncedProviders.end(); ++iter) {
+              auto providerInfo = (*iter).second;
+              if (providerInfo->mProviderName == providerStr) {
+                if (enabledEvents) {
+                  mRequestedRemoteProviderEvents[providerInfo->mHandle] = enabledEvents;
+                } else {
+                  auto found = mRequestedRemoteProviderEvents.find(providerInfo->mHandle);
+                  if (found != mRequestedRemoteProviderEvents.end()) mRequestedRemoteProviderEvents.erase(found);
+                }
+                updateProviderEventFilter(providerInfo);
+              }
+            }
+          } else {
+            ZS_LOG_WARNING(Detail, log("remote set event provider events request is not understood (ignored)") + ZS_PARAMIZE(providerStr) + ZS_PARAMIZE(eventsStr));
+            error = -1;
+            reason = "Events bitmap was not understood: " + eventsStr;
+          }
+          sendAck(requestID, error, reason);
+          return;
         }
+        
+        ZS_LOG_WARNING(Detail, log("remote request is not understood (ignored)") + ZS_PARAMIZE(typeStr));
       }
       
       //-----------------------------------------------------------------------
-      void RemoteEventing::sendAck(
-                                   const String &requestID,
-                                   int errorNumber,
-                                   const char *reason
-                                   )
+      void RemoteEventing::handleRequestAck(const ElementPtr &rootEl)
       {
-        auto rootEl = Element::create("ack");
-        
-        rootEl->adoptAsLastChild(IHelper::createElementWithText("id", requestID));
-        if (0 != errorNumber) {
-          rootEl->adoptAsLastChild(IHelper::createElementWithNumber("error", string(errorNumber)));
-          String reasonStr(reason);
-          if (reasonStr.hasData()) {
-            rootEl->adoptAsLastChild(IHelper::createElementWithText("reason", reasonStr));
-          }
-        }
-
-        sendData(MessageType_RequestAck, rootEl);
+        // ignored for now...
       }
-      
+
       //-----------------------------------------------------------------------
-      void RemoteEventing::handleHandshakeMessage(
-                                                  MessageTypes messageType,
-                                                  SecureByteBlock &buffer
-                                                  )
+      void RemoteEventing::handleEvent(
+                                       BYTE *buffer,
+                                       size_t bufferSize,
+                                       bool backlog
+                                       )
       {
-        if (MessageType_Goodbye == messageType) {
-          ZS_LOG_DEBUG(log("received goodbye during handshake"));
-          disconnect();
-          return;
-        }
-        
-        if (buffer.SizeInBytes() < 1) {
-          ZS_LOG_WARNING(Detail, log("message size not legal (shutting down)") + ZS_PARAM("type", string(messageType)));
-          disconnect();
-          return;
+        uint64_t decodeStartTime = getMonotonicTimestamp();
+
+        BYTE *pos = buffer;
+        size_t remaining = bufferSize;
+
+        EventOrigin origin;
+        if (mEventOriginNegotiated) {
+          if (!decodeEventOrigin(pos, remaining, origin)) return;
         }
+        origin.mBacklog = backlog;
 
-        const char *message = reinterpret_cast<const char *>(buffer.BytePtr());
-        ElementPtr rootEl = IHelper::toJSON(message);
-        if (!rootEl) {
-          ZS_LOG_WARNING(Detail, log("message not legal (disconnecting)") + ZS_PARAM("type", string(messageType)));
-          disconnect();
+        if (remaining < sizeof(uint64_t)) {
+          ZS_LOG_WARNING(Debug, log("event message did not contain enough header data") + ZS_PARAM("actual size", bufferSize));
           return;
         }
 
-        switch (messageType) {
-          case MessageType_Hello:           handleHello(rootEl); break;
-          case MessageType_Challenge:       handleChallenge(rootEl); break;
-          case MessageType_ChallengeReply:  handleChallengeReply(rootEl); break;
-          case MessageType_Welcome:         handleWelcome(rootEl); break;
-          default: {
-            ZS_LOG_WARNING(Detail, log("message type not understood (disconnecting)") + ZS_PARAM("type", string(messageType)));
-            disconnect();
-            break;
-          }
-        }
+        uint64_t remoteProvider = IHelper::getBE64(pos);
+        pos += sizeof(remoteProvider);
+        remaining -= sizeof(remoteProvider);
+
+        auto entry = findRemoteEventProvider(remoteProvider);
+        if (!entry) return;
+
+        EventHeader scratchHeader;
+        const EventHeader *header = decodeCachedEventHeader(entry, pos, remaining, scratchHeader);
+        if (!header) return;
+
+        USE_EVENT_DATA_DESCRIPTOR dataDescriptors[ZSLIB_EVENTING_REMOTE_EVENTING_MAX_DATA_DESCRIPTORS];
+        if (!decodeEventData(pos, remaining, *header, mSwapIncomingIntegers, mSwapIncomingFloats, &(dataDescriptors[0]))) return;
+
+        deliverRemoteEvent(entry, *header, &(dataDescriptors[0]), ((mEventOriginNegotiated) || (backlog)) ? &origin : NULL, bufferSize + (sizeof(CryptoPP::word32)*2), decodeStartTime);
       }
 
       //-----------------------------------------------------------------------
-      void RemoteEventing::handleAuthorizedMessage(
-                                                   MessageTypes messageType,
-                                                   SecureByteBlock &buffer
-                                                   )
+      void RemoteEventing::handleEventBatch(
+                                            BYTE *buffer,
+                                            size_t bufferSize
+                                            )
       {
-        switch (messageType) {
-          case MessageType_TraceEvent: {
-            handleEvent(buffer);
-            return;
+        BYTE *pos = buffer;
+        size_t remaining = bufferSize;
+
+        RemoteProviderEntry *entry {};
+        bool hasProvider {false};
+
+        // points into the provider's header cache (or the scratch header for
+        // unknown providers) and stays valid until the next header is decoded
+        EventHeader scratchHeader;
+        const EventHeader *header {};
+
+        USE_EVENT_DATA_DESCRIPTOR dataDescriptors[ZSLIB_EVENTING_REMOTE_EVENTING_MAX_DATA_DESCRIPTORS];
+
+        EventOrigin origin;
+
+        while (remaining > 0) {
+          uint64_t decodeStartTime = getMonotonicTimestamp();
+          const BYTE *recordPos = pos;
+
+          BYTE flags = *pos;
+          pos += sizeof(flags);
+          remaining -= sizeof(flags);
+
+          if (mEventOriginNegotiated) {
+            if (!decodeEventOrigin(pos, remaining, origin)) return;
           }
-          case MessageType_Goodbye: {
-            ZS_LOG_DEBUG(log("received goodbye"));
-            disconnect();
-            return;
+
+          if (0 != (flags & ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_BATCH_FLAG_PROVIDER)) {
+            if (remaining < sizeof(uint64_t)) {
+              ZS_LOG_WARNING(Debug, log("event batch did not contain enough provider data") + ZS_PARAMIZE(remaining) + ZS_PARAM("actual size", bufferSize));
+              return;
+            }
+
+            uint64_t remoteProvider = IHelper::getBE64(pos);
+            pos += sizeof(remoteProvider);
+            remaining -= sizeof(remoteProvider);
+
+            // unknown providers still have their events parsed so the batch can continue
+            entry = findRemoteEventProvider(remoteProvider);
+            hasProvider = true;
           }
-          default: {
-            break;
+
+          if (0 != (flags & ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_BATCH_FLAG_HEADER)) {
+            header = decodeCachedEventHeader(entry, pos, remaining, scratchHeader);
+            if (!header) return;
           }
-        }
-        
-        if (buffer.SizeInBytes() < 1) {
-          ZS_LOG_WARNING(Detail, log("message size not legal (disconnecting)") + ZS_PARAM("type", string(messageType)));
-          disconnect();
-          return;
-        }
-        
-        const char *message = reinterpret_cast<const char *>(buffer.BytePtr());
-        ElementPtr rootEl = IHelper::toJSON(message);
-        if (!rootEl) {
-          ZS_LOG_WARNING(Detail, log("message not legal (disconnecting)") + ZS_PARAM("type", string(messageType)));
-          disconnect();
-          return;
-        }
 
-        switch (messageType) {
-          case MessageType_Notify:      handleNotify(rootEl); break;
-          case MessageType_Request:     handleRequest(rootEl); break;
-          case MessageType_RequestAck:  handleRequestAck(rootEl); break;
-          default: {
-            ZS_LOG_WARNING(Detail, log("message type not understood (disconnecting)") + ZS_PARAM("type", string(messageType)));
-            disconnect();
-            break;
+          bool hasHeader = (NULL != header);
+          if ((!hasProvider) ||
+              (!hasHeader)) {
+            ZS_LOG_WARNING(Debug, log("event batch record is missing provider or header context") + ZS_PARAMIZE(hasProvider) + ZS_PARAMIZE(hasHeader));
+            return;
           }
+
+          if (!decodeEventData(pos, remaining, *header, mSwapIncomingIntegers, mSwapIncomingFloats, &(dataDescriptors[0]))) return;
+
+          if (!entry) continue;
+
+          deliverRemoteEvent(entry, *header, &(dataDescriptors[0]), mEventOriginNegotiated ? &origin : NULL, static_cast<size_t>(pos - recordPos), decodeStartTime);
         }
       }
-      
+
       //-----------------------------------------------------------------------
-      void RemoteEventing::handleHello(const ElementPtr &rootEl)
+      void RemoteEventing::handleEventCompact(
+                                              BYTE *buffer,
+                                              size_t bufferSize
+                                              )
       {
-        if ((MessageType_Hello != mHandshakeState) ||
-            (isConnectingMode())) {
-          ZS_LOG_WARNING(Detail, log("received hello but not waiting for hello"));
+        if (!mRemoteSupportsCompactEvents) {
+          ZS_LOG_WARNING(Detail, log("compact events were not negotiated (disconnecting)"));
           disconnect();
           return;
         }
 
-        mHelloSalt = IHelper::getElementText(rootEl->findFirstChildElement("salt"));
-        if (mHelloSalt.isEmpty()) {
-          ZS_LOG_WARNING(Detail, log("received hello but missing salt"));
-          disconnect();
-          return;
-        }
-        
-        String helloProof = IHelper::getElementText(rootEl->findFirstChildElement("proof"));
-        String expectingHelloProof = IHasher::hashAsString("hello:proof:" + mSharedSecret + ":" + mHelloSalt, IHasher::sha256());
-        
-        if (helloProof != expectingHelloProof) {
-          ZS_LOG_WARNING(Detail, log("hello proof does not match expected value") + ZS_PARAMIZE(helloProof) + ZS_PARAMIZE(expectingHelloProof));
-          disconnect();
-          return;
-        }
+        BYTE *pos = buffer;
+        size_t remaining = bufferSize;
 
-        mHandshakeState = MessageType_Challenge;
-        
-        mExpectingHelloProofInChallenge = IHasher::hashAsString("hello:expecting:" + mSharedSecret + ":" + mHelloSalt, IHasher::sha256());
+        USE_EVENT_DATA_DESCRIPTOR dataDescriptors[ZSLIB_EVENTING_REMOTE_EVENTING_MAX_DATA_DESCRIPTORS];
+        uint64_t integerValues[ZSLIB_EVENTING_REMOTE_EVENTING_MAX_DATA_DESCRIPTORS];
+        EventOrigin origin;
+
+        while (remaining > 0) {
+          uint64_t decodeStartTime = getMonotonicTimestamp();
+          const BYTE *recordPos = pos;
+
+          BYTE recordType = *pos;
+          ++pos;
+          --remaining;
+
+          switch (recordType) {
+            case ZSLIB_EVENTING_REMOTE_EVENTING_COMPACT_RECORD_PROVIDER: {
+              uint64_t providerIndex {};
+              if (!getVarint(pos, remaining, providerIndex)) goto illegal_record;
+              if (remaining < sizeof(uint64_t)) goto illegal_record;
+              if (providerIndex > mCompactIncomingProviders.size()) goto illegal_record;
+
+              uint64_t remoteHandle = IHelper::getBE64(pos);
+              pos += sizeof(remoteHandle);
+              remaining -= sizeof(remoteHandle);
+
+              if (providerIndex == mCompactIncomingProviders.size()) {
+                mCompactIncomingProviders.push_back(remoteHandle);
+              } else {
+                mCompactIncomingProviders[static_cast<size_t>(providerIndex)] = remoteHandle;
+              }
+              continue;
+            }
+            case ZSLIB_EVENTING_REMOTE_EVENTING_COMPACT_RECORD_DESCRIPTOR: {
+              if (remaining < sizeof(BYTE)) goto illegal_record;
+              auto &descriptor = mCompactIncomingDescriptors[*pos];
+              ++pos;
+              --remaining;
+
+              descriptor.mDefined = false;
+              if (!decodeEventHeader(pos, remaining, descriptor.mHeader)) goto illegal_record;
+              descriptor.mLastValues.assign(descriptor.mHeader.mDescriptorCount, 0);
+              descriptor.mDefined = true;
+              continue;
+            }
+            case ZSLIB_EVENTING_REMOTE_EVENTING_COMPACT_RECORD_STRING: {
+              uint64_t stringID {};
+              uint64_t size {};
+              if (!getVarint(pos, remaining, stringID)) goto illegal_record;
+              if (!getVarint(pos, remaining, size)) goto illegal_record;
+              if ((ZSLIB_EVENTING_REMOTE_EVENTING_COMPACT_INLINE_STRING == stringID) ||
+                  (stringID > ZSLIB_EVENTING_REMOTE_EVENTING_COMPACT_MAX_INTERNED_STRINGS)) goto illegal_record;
+              if (remaining < size) goto illegal_record;
+
+              auto &entry = mCompactIncomingStrings[static_cast<size_t>(stringID)];
+              entry.mValue.assign(reinterpret_cast<const char *>(pos), static_cast<size_t>(size));
+              entry.mDefined = true;
+
+              pos += size;
+              remaining -= static_cast<size_t>(size);
+              continue;
+            }
+            case ZSLIB_EVENTING_REMOTE_EVENTING_COMPACT_RECORD_EVENT: {
+              uint64_t providerIndex {};
+              if (!getVarint(pos, remaining, providerIndex)) goto illegal_record;
+              if (providerIndex >= mCompactIncomingProviders.size()) goto illegal_record;
+              if (remaining < sizeof(BYTE)) goto illegal_record;
+
+              auto &descriptor = mCompactIncomingDescriptors[*pos];
+              ++pos;
+              --remaining;
+
+              if (!descriptor.mDefined) goto illegal_record;
+
+              if (mEventOriginNegotiated) {
+                uint64_t timestampDelta {};
+                uint64_t threadID {};
+                uint64_t cpu {};
+                if (!getVarint(pos, remaining, timestampDelta)) goto illegal_record;
+                if (!getVarint(pos, remaining, threadID)) goto illegal_record;
+                if (!getVarint(pos, remaining, cpu)) goto illegal_record;
+
+                mCompactIncomingLastTimestamp += zigzagDecode(timestampDelta);
+                origin.mTimestamp = mCompactIncomingLastTimestamp;
+                origin.mThreadID = threadID;
+                origin.mCPU = static_cast<uint32_t>(cpu - 1);
+              }
 
-        ElementPtr challengeEl = Element::create("challenge");
+              auto &header = descriptor.mHeader;
 
-        mChallengeSalt = IHelper::randomString(IHasher::sha256DigestSize() * 8 / 5);
-        challengeEl->adoptAsFirstChild(IHelper::createElementWithNumber("version", "1"));
-        challengeEl->adoptAsFirstChild(IHelper::createElementWithText("salt", mChallengeSalt));
-        challengeEl->adoptAsFirstChild(IHelper::createElementWithText("proof", mExpectingHelloProofInChallenge));
+              for (size_t index = 0; index < header.mDescriptorCount; ++index) {
+                auto type = header.mParamDescriptors[index].Type;
 
-        mExpectingChallengeProofInReply = IHasher::hashAsString("challenge:expecting:" + mSharedSecret + ":" + mHelloSalt + ":" + mChallengeSalt, IHasher::sha256());
-        sendData(MessageType_Challenge, challengeEl);
-      }
-      
-      //-----------------------------------------------------------------------
-      void RemoteEventing::handleChallenge(const ElementPtr &rootEl)
-      {
-        if ((MessageType_Challenge != mHandshakeState) ||
-            (mChallengeSalt.hasData())) {
-          ZS_LOG_WARNING(Detail, log("received challenge but not waiting for challenge"));
-          disconnect();
-          return;
-        }
+                if ((index < ZSLIB_EVENTING_REMOTE_EVENTING_COMPACT_INTERNED_PARAMETERS) &&
+                    (EventParameterType_AString == type)) {
+                  uint64_t stringID {};
+                  if (!getVarint(pos, remaining, stringID)) goto illegal_record;
 
-        mChallengeSalt = IHelper::getElementText(rootEl->findFirstChildElement("salt"));
-        String proof = IHelper::getElementText(rootEl->findFirstChildElement("proof"));
-        
-        if (proof != mExpectingHelloProofInChallenge) {
-          ZS_LOG_WARNING(Detail, log("received challenge but proof does not match") + ZS_PARAMIZE(proof) + ZS_PARAMIZE(mExpectingHelloProofInChallenge));
-          disconnect();
-          return;
-        }
+                  if (ZSLIB_EVENTING_REMOTE_EVENTING_COMPACT_INLINE_STRING != stringID) {
+                    if (stringID > ZSLIB_EVENTING_REMOTE_EVENTING_COMPACT_MAX_INTERNED_STRINGS) goto illegal_record;
 
-        ElementPtr challengeReplyEl = Element::create("challengeReply");
+                    auto &entry = mCompactIncomingStrings[static_cast<size_t>(stringID)];
+                    if (!entry.mDefined) goto illegal_record;
 
-        mExpectingChallengeProofInReply = IHasher::hashAsString("challenge:expecting:" + mSharedSecret + ":" + mHelloSalt + ":" + mChallengeSalt, IHasher::sha256());
-        challengeReplyEl->adoptAsFirstChild(IHelper::createElementWithText("proof", mExpectingChallengeProofInReply));
+                    dataDescriptors[index].Ptr = reinterpret_cast<uintptr_t>(entry.mValue.data());
+                    dataDescriptors[index].Size = entry.mValue.size();
+                    continue;
+                  }
+                }
 
-        sendData(MessageType_ChallengeReply, challengeReplyEl);
-        mHandshakeState = MessageType_ChallengeReply;
+                uint64_t dataTypeSize {};
+                if (!getVarint(pos, remaining, dataTypeSize)) goto illegal_record;
+
+                dataDescriptors[index].Ptr = 0;
+                dataDescriptors[index].Size = static_cast<size_t>(dataTypeSize);
+
+                if (isCompactInteger(type, static_cast<size_t>(dataTypeSize))) {
+                  uint64_t value {};
+                  if (!getVarint(pos, remaining, value)) goto illegal_record;
+
+                  switch (type) {
+                    case EventParameterType_UnsignedInteger:
+                    case EventParameterType_SignedInteger:    {
+                      value = descriptor.mLastValues[index] + zigzagDecode(value);
+                      descriptor.mLastValues[index] = value;
+                      break;
+                    }
+                    default:                                  break;
+                  }
+
+                  BYTE *dest = reinterpret_cast<BYTE *>(&(integerValues[index]));
+                  setHostInteger(dest, value, static_cast<size_t>(dataTypeSize));
+                  dataDescriptors[index].Ptr = reinterpret_cast<uintptr_t>(dest);
+                  continue;
+                }
+
+                if (remaining < dataTypeSize) goto illegal_record;
+
+                if (0 != dataTypeSize) {
+                  dataDescriptors[index].Ptr = reinterpret_cast<uintptr_t>(pos);
+                }
+
+                if ((EventParameterType_FloatingPoint == type) &&
+                    (mSwapIncomingFloats)) {
+                  swapScalarBytes(pos, static_cast<size_t>(dataTypeSize));
+                }
+
+                pos += dataTypeSize;
+                remaining -= static_cast<size_t>(dataTypeSize);
+              }
+
+              auto entry = findRemoteEventProvider(mCompactIncomingProviders[static_cast<size_t>(providerIndex)]);
+              if (!entry) continue;
+
+              deliverRemoteEvent(entry, header, &(dataDescriptors[0]), mEventOriginNegotiated ? &origin : NULL, static_cast<size_t>(pos - recordPos), decodeStartTime);
+              continue;
+            }
+            default: break;
+          }
+
+        illegal_record:
+          {
+            // the compact stream is stateful so nothing after a bad record can be trusted
+            ZS_LOG_WARNING(Detail, log("compact event record is not legal (disconnecting)") + ZS_PARAMIZE(recordType) + ZS_PARAMIZE(remaining));
+            disconnect();
+            return;
+          }
+        }
       }
 
       //-----------------------------------------------------------------------
-      void RemoteEventing::handleChallengeReply(const ElementPtr &rootEl)
+      bool RemoteEventing::decodeEventOrigin(
+                                             BYTE * &ioPos,
+                                             size_t &ioRemaining,
+                                             EventOrigin &outOrigin
+                                             )
       {
-        if ((MessageType_Challenge != mHandshakeState) ||
-            (!mChallengeSalt.hasData())) {
-          ZS_LOG_WARNING(Detail, log("received challenge reply but not waiting for challenge reply"));
-          disconnect();
-          return;
-        }
-        
-        String proof = IHelper::getElementText(rootEl->findFirstChildElement("proof"));
-        if (proof != mExpectingChallengeProofInReply) {
-          ZS_LOG_WARNING(Detail, log("received challenge reply but proof does not match") + ZS_PARAMIZE(proof) + ZS_PARAMIZE(mExpectingChallengeProofInReply));
-          disconnect();
-          return;
+        if (ioRemaining < ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_ORIGIN_SIZE) {
+          ZS_LOG_WARNING(Debug, slog("event message did not contain enough origin data") + ZS_PARAM("remaining", ioRemaining));
+          return false;
         }
 
-        mHandshakeState = MessageType_ChallengeReply;
-        sendWelcome();
+        outOrigin.mTimestamp = IHelper::getBE64(ioPos);
+        outOrigin.mThreadID = IHelper::getBE64(ioPos + sizeof(uint64_t));
+        outOrigin.mCPU = IHelper::getBE32(ioPos + (sizeof(uint64_t)*2));
+
+        ioPos += ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_ORIGIN_SIZE;
+        ioRemaining -= ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_ORIGIN_SIZE;
+        return true;
       }
-      
+
       //-----------------------------------------------------------------------
-      void RemoteEventing::handleWelcome(const ElementPtr &rootEl)
+      void RemoteEventing::deliverRemoteEvent(
+                                              RemoteProviderEntry *entry,
+                                              const EventHeader &header,
+                                              const USE_EVENT_DATA_DESCRIPTOR *dataDescriptors,
+                                              const EventOrigin *origin,
+                                              size_t recordSize,
+                                              uint64_t decodeStartTime
+                                              )
       {
-        if (MessageType_ChallengeReply != mHandshakeState) {
-          ZS_LOG_WARNING(Detail, log("received welcome but not waiting for welcome"));
-          disconnect();
+        recordTime(mDecodeTime, getMonotonicTimestamp() - decodeStartTime);
+
+        auto provider = entry->mProvider;
+        auto &statistics = entry->mReceivedCounters->mStatistics;
+        ++(statistics.mEventsReceived);
+        statistics.mBytesReceived += recordSize;
+
+        if (0 != mReceiveWorkerThreads) {
+          dispatchRemoteEvent(provider, header, dataDescriptors, origin);
           return;
         }
 
-        mHandshakeState = MessageType_Welcome;
-        if (isConnectingMode()) {
-          sendWelcome();
-        }
-        
-        String valueStr = IHelper::getElementText(rootEl->findFirstChildElement("value32"));
-        String valueBytesStr = IHelper::getElementText(rootEl->findFirstChildElement("value32Bytes"));
-        
-        try {
-          uint32_t value32 = Numeric<uint32_t>(valueStr);
-          
-          auto valueBuffer = IHelper::convertFromHex(valueBytesStr);
-          if ((!valueBuffer) ||
-              (valueBuffer->SizeInBytes() < sizeof(value32))) {
-            ZS_LOG_WARNING(Detail, log("value byes does not match size of value32"));
-            disconnect();
-            return;
+        writeRemoteEvent(provider->mHandle, header, dataDescriptors, origin);
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::dispatchRemoteEvent(
+                                               ProviderInfo *provider,
+                                               const EventHeader &header,
+                                               const USE_EVENT_DATA_DESCRIPTOR *dataDescriptors,
+                                               const EventOrigin *origin
+                                               )
+      {
+        if (mReceiveWorkers.empty()) {
+          ZS_LOG_DEBUG(log("starting receive workers") + ZS_PARAM("threads", mReceiveWorkerThreads));
+          for (size_t index = 0; index < mReceiveWorkerThreads; ++index) {
+            mReceiveWorkers.push_back(make_shared<ReceiveWorker>(mAsyncNotify, mMaxReceiveWorkerQueuedEvents, mReceiveBarrier));
           }
-          
-          if (0 != memcmp(valueBuffer->BytePtr(), &value32, sizeof(value32))) mFlipEndianInt = true;
-        } catch (const Numeric<uint32_t>::ValueOutOfRange &) {
-          ZS_LOG_WARNING(Detail, log("received welcome but missing value32"));
-          disconnect();
-          return;
         }
 
-        String valueFloatStr = IHelper::getElementText(rootEl->findFirstChildElement("valueFloat"));
-        String valueFloatBytesStr = IHelper::getElementText(rootEl->findFirstChildElement("valueFloatBytes"));
-
-        try {
-          float valueFloat = Numeric<float>(valueFloatStr);
-          
-          auto valueBuffer = IHelper::convertFromHex(valueFloatBytesStr);
-          if ((!valueBuffer) ||
-              (valueBuffer->SizeInBytes() < sizeof(valueFloat))) {
-            ZS_LOG_WARNING(Detail, log("value byes does not match size of value float"));
-            disconnect();
-            return;
+        // events of the same emitting thread (or of the same provider when the
+        // origin is not known) always go to the same worker to keep their order
+        uint64_t key = (origin ? origin->mThreadID : static_cast<uint64_t>(provider->mHandle));
+        key = (key * 0x9E3779B97F4A7C15ULL) >> 32;
+        auto &worker = mReceiveWorkers[static_cast<size_t>(key % mReceiveWorkers.size())];
+
+        auto event = worker->acquire();
+        event->mHandle = provider->mHandle;
+        event->mHeader.mSeverity = header.mSeverity;
+        event->mHeader.mLevel = header.mLevel;
+        event->mHeader.mDescriptor = header.mDescriptor;
+        event->mHeader.mDescriptorCount = header.mDescriptorCount;
+
+        // the data points into the incoming buffer (or compact decoding state)
+        // which is reused as soon as this returns
+        size_t totalSize {};
+        for (size_t index = 0; index < header.mDescriptorCount; ++index) {
+          event->mHeader.mParamDescriptors[index] = header.mParamDescriptors[index];
+          totalSize += dataDescriptors[index].Size;
+        }
+
+        event->mData.resize(totalSize);
+        BYTE *pos = event->mData.data();
+        for (size_t index = 0; index < header.mDescriptorCount; ++index) {
+          auto &dataDescriptor = event->mDataDescriptors[index];
+          dataDescriptor = dataDescriptors[index];
+          if (0 == dataDescriptor.Size) continue;
+
+          memcpy(pos, reinterpret_cast<const void *>(dataDescriptors[index].Ptr), dataDescriptor.Size);
+          dataDescriptor.Ptr = reinterpret_cast<uintptr_t>(pos);
+          pos += dataDescriptor.Size;
+        }
+
+        event->mHasOrigin = (NULL != origin);
+        if (origin) event->mOrigin = *origin;
+
+        // the rest of the current frame is still decoded but no further
+        // frames are read until the worker reports it has drained; that
+        // includes control frames so announcements, logging requests and a
+        // goodbye from the remote party wait behind the queued events
+        if (!worker->queue(event)) {
+          if (!mReceivePaused) {
+            ZS_LOG_TRACE(log("receive worker full (pausing reads)"));
           }
+          mReceivePaused = true;
+        }
+      }
 
-          if (0 != memcmp(valueBuffer->BytePtr(), &valueFloat, sizeof(valueFloat))) mFlipEndianFloat = true;
-        } catch (const Numeric<float>::ValueOutOfRange &) {
-          ZS_LOG_WARNING(Detail, log("received welcome but missing value32"));
-          disconnect();
+      //-----------------------------------------------------------------------
+      void RemoteEventing::retireRemoteProvider(ProviderInfo *provider)
+      {
+        if ((mReceiveWorkers.empty()) &&
+            (mStoppingReceiveWorkers.empty())) {
+          Log::unregisterEventingWriter(provider->mHandle);
+          noteRemoteProviderWithListener(provider->mProviderID, false);
           return;
         }
 
-        IWakeDelegateProxy::create(mThisWeak.lock())->onWake();
-        IRemoteEventingAsyncDelegateProxy::create(mThisWeak.lock())->onRemoteEventingSubscribeLogger();
+        // the writer goes away once every event queued before this barrier
+        // has been written (stopping workers already have a final barrier)
+        if (!mReceiveWorkers.empty()) {
+          ++mReceiveBarrier;
+          for (auto iter = mReceiveWorkers.begin(); iter != mReceiveWorkers.end(); ++iter) {
+            (*iter)->queueBarrier(mReceiveBarrier);
+          }
+        }
+        mRetiredRemoteProviders.push_back(RetiredProviderPair(mReceiveBarrier, provider));
       }
-      
-      
+
       //-----------------------------------------------------------------------
-      void RemoteEventing::handleNotify(const ElementPtr &rootEl)
+      void RemoteEventing::releaseRetiredRemoteProviders()
       {
-        String typeStr = IHelper::getElementText(rootEl->findFirstChildElement("type"));
-        if (ZSLIB_EVENTING_REMOTE_EVENTING_NOTIFY_GENERAL_INFO == typeStr) {
-          handleNotifyGeneralInfo(rootEl);
-          return;
-        }
-        if (ZSLIB_EVENTING_REMOTE_EVENTING_NOTIFY_SUBSYSTEM == typeStr) {
-          handleNotifyRemoteSubsystem(rootEl);
-          return;
+        if (mRetiredRemoteProviders.empty()) return;
+
+        size_t passed = mReceiveBarrier;
+        for (auto iter = mReceiveWorkers.begin(); iter != mReceiveWorkers.end(); ++iter) {
+          auto workerPassed = (*iter)->getPassedBarrier();
+          if (workerPassed < passed) passed = workerPassed;
         }
-        if (ZSLIB_EVENTING_REMOTE_EVENTING_NOTIFY_PROVIDER == typeStr) {
-          handleNotifyRemoteProvider(rootEl);
-          return;
+        for (auto iter = mStoppingReceiveWorkers.begin(); iter != mStoppingReceiveWorkers.end(); ++iter) {
+          auto workerPassed = (*iter)->getPassedBarrier();
+          if (workerPassed < passed) passed = workerPassed;
         }
-        if (ZSLIB_EVENTING_REMOTE_EVENTING_NOTIFY_PROVIDER_KEYWORD_LOGGING == typeStr) {
-          handleNotifyRemoteProviderKeywordLogging(rootEl);
-          return;
+
+        while (!mRetiredRemoteProviders.empty()) {
+          auto &retired = mRetiredRemoteProviders.front();
+          if (retired.first > passed) break;
+
+          auto provider = retired.second;
+          Log::unregisterEventingWriter(provider->mHandle);
+          noteRemoteProviderWithListener(provider->mProviderID, false);
+          mRetiredRemoteProviders.pop_front();
         }
-        ZS_LOG_WARNING(Detail, log("remote notify is not understood (ignored)") + ZS_PARAMIZE(typeStr));
       }
 
       //-----------------------------------------------------------------------
-      void RemoteEventing::handleNotifyGeneralInfo(const ElementPtr &rootEl)
+      void RemoteEventing::resumeReceiving()
       {
-        String subsystemStr = IHelper::getElementText(rootEl->findFirstChildElement("subsystem"));
-        String droppedStr = IHelper::getElementText(rootEl->findFirstChildElement("dropped"));
-        
-        size_t totalDropped = 0;
-        try {
-          totalDropped = Numeric<decltype(totalDropped)>(droppedStr);
-        } catch (const Numeric<decltype(totalDropped)>::ValueOutOfRange &) {
-          ZS_LOG_WARNING(Detail, log("dropped value is not valid") + ZS_PARAMIZE(droppedStr));
+        if (!mReceivePaused) return;
+
+        for (auto iter = mReceiveWorkers.begin(); iter != mReceiveWorkers.end(); ++iter) {
+          if ((*iter)->isPaused()) return;
+        }
+
+        ZS_LOG_TRACE(log("receive workers drained (resuming reads)"));
+        mReceivePaused = false;
+
+        if ((isShuttingDown()) ||
+            (isShutdown())) return;
+
+        if (mLocalChannel) {
+          if (mLocalChannel->mReady) readLocalChannel();
           return;
         }
 
-        if (mAnnouncedRemoteDropped != totalDropped) {
-          mAnnouncedRemoteDropped = totalDropped;
-          if (mDelegate) {
-            try {
-              mDelegate->onRemoteEventingRemoteDroppedEvents(mThisWeak.lock(), totalDropped);
-            } catch (const IRemoteEventingDelegateProxy::Exceptions::DelegateGone &) {
-              ZS_LOG_WARNING(Detail, log("delegate gone (probably okay)"));
-              mDelegate.reset();
-            }
+        // frames left in the buffer when paused are handled before reading more
+        readIncomingMessage();
+        readActiveSocket();
+      }
+
+      //-----------------------------------------------------------------------
+      bool RemoteEventing::stopReceiveWorkers()
+      {
+        if (!mReceiveWorkers.empty()) {
+          ZS_LOG_DEBUG(log("stopping receive workers"));
+
+          // every queued event is written before the final barrier and exit
+          ++mReceiveBarrier;
+          for (auto iter = mReceiveWorkers.begin(); iter != mReceiveWorkers.end(); ++iter) {
+            auto &worker = (*iter);
+            worker->queueBarrier(mReceiveBarrier);
+            worker->stop();
+            mStoppingReceiveWorkers.push_back(worker);
           }
+          mReceiveWorkers.clear();
+        }
+
+        if (mStoppingReceiveWorkers.empty()) {
+          releaseRetiredRemoteProviders();
+          return false;
+        }
+
+        bool drained = true;
+        for (auto iter = mStoppingReceiveWorkers.begin(); iter != mStoppingReceiveWorkers.end(); ++iter) {
+          if ((*iter)->getPassedBarrier() < mReceiveBarrier) drained = false;
         }
+
+        // joined from onRemoteEventingReceiveWorkerProgress without any lock
+        // held unless nothing can be notified any more (being destroyed)
+        if ((!drained) &&
+            (mThisWeak.lock())) return true;
+
+        for (auto iter = mStoppingReceiveWorkers.begin(); iter != mStoppingReceiveWorkers.end(); ++iter) {
+          (*iter)->join();
+        }
+        mStoppingReceiveWorkers.clear();
+
+        releaseRetiredRemoteProviders();
+        return false;
       }
 
       //-----------------------------------------------------------------------
-      void RemoteEventing::handleNotifyRemoteSubsystem(const ElementPtr &rootEl)
+      void RemoteEventing::registerRemoteSubsystem(const String &subsystemName)
       {
-        String subsystemStr = IHelper::getElementText(rootEl->findFirstChildElement("name"));
-        
-        auto found = mRemoteSubsystems.find(subsystemStr);
+        auto found = mRemoteSubsystems.find(subsystemName);
         if (found != mRemoteSubsystems.end()) {
-          ZS_LOG_WARNING(Debug, log("already notified about subsystem") + ZS_PARAMIZE(subsystemStr));
+          ZS_LOG_WARNING(Debug, log("already notified about subsystem") + ZS_PARAM("subsystem", subsystemName));
           return;
         }
         
         auto info = make_shared<SubsystemInfo>();
-        info->mName = subsystemStr;
-        mRemoteSubsystems[subsystemStr] = info;
+        info->mName = subsystemName;
+        mRemoteSubsystems[subsystemName] = info;
         
         if (mDelegate) {
           try {
-            mDelegate->onRemoteEventingRemoteSubsystem(mThisWeak.lock(), info->mName);
+            mDelegate->onRemoteEventingRemoteSubsystem(getPublicConnection(), info->mName);
           } catch (const IRemoteEventingDelegateProxy::Exceptions::DelegateGone &) {
             ZS_LOG_WARNING(Detail, log("delegate gone (probably okay)"));
             mDelegate.reset();
@@ -1780,93 +8157,66 @@ namespace zsLib
       }
 
       //-----------------------------------------------------------------------
-      void RemoteEventing::handleNotifyRemoteProvider(const ElementPtr &rootEl)
+      void RemoteEventing::registerRemoteProvider(
+                                                  ProviderHandle remoteHandle,
+                                                  const UUID &providerID,
+                                                  const String &providerName,
+                                                  const String &providerHash,
+                                                  uint32_t index
+                                                  )
       {
-        String remoteHandleStr = IHelper::getElementText(rootEl->findLastChildElement("handle"));
-        String goneStr = IHelper::getElementText(rootEl->findLastChildElement("gone"));
-        
-        ProviderHandle remoteHandle = 0;
-        try {
-          remoteHandle = Numeric<ProviderHandle>(remoteHandleStr);
-        } catch (const Numeric<ProviderHandle>::ValueOutOfRange &) {
-          ZS_LOG_WARNING(Detail, log("remote handle is not valid") + ZS_PARAMIZE(remoteHandleStr));
+        auto found = mRemoteRegisteredProvidersByUUID.find(providerID);
+        if (found != mRemoteRegisteredProvidersByUUID.end()) {
+          ZS_LOG_WARNING(Debug, log("remote provider announced but alrady know about provider ID") + ZS_PARAM("provider id", string(providerID)));
           return;
         }
-        
-        if (goneStr.hasData()) {
-          try {
-            bool gone = Numeric<bool>(goneStr);
-            if (gone) {
-              auto found = mRemoteRegisteredProvidersByRemoteHandle.find(remoteHandle);
-              if (found == mRemoteRegisteredProvidersByRemoteHandle.end()) {
-                ZS_LOG_WARNING(Trace, log("notified remote provider is gone but provider was never announced"));
-                return;
-              }
-              
-              auto provider = (*found).second;
 
-              {
-                auto foundUUDI = mRemoteRegisteredProvidersByUUID.find(provider->mProviderID);
-                if (foundUUDI != mRemoteRegisteredProvidersByUUID.end()) {
-                  mRemoteRegisteredProvidersByUUID.erase(foundUUDI);
-                } else {
-                  ZS_LOG_WARNING(Trace, log("notified remote provider is gone but provider UUID was not found"));
-                }
-              }
+        ProviderInfo *provider = new ProviderInfo;
+        mCleanUpProviderInfos.insert(provider);
 
-              Log::unregisterEventingWriter(provider->mHandle);
-              
-              if (mDelegate) {
-                try {
-                  mDelegate->onRemoteEventingRemoteProviderGone(provider->mProviderName);
-                } catch (const IRemoteEventingDelegateProxy::Exceptions::DelegateGone &) {
-                  ZS_LOG_WARNING(Debug, log("delegate gone (probably okay)"));
-                  mDelegate.reset();
-                }
-              }
-              return;
-            }
-            
-            // provider is not gone...
-          } catch (const Numeric<bool>::ValueOutOfRange &) {
-            ZS_LOG_WARNING(Detail, log("gone text was not understood") + ZS_PARAMIZE(goneStr));
-            return;
+        provider->mRelatedToRemoteEventingObjectID = mID;
+        provider->mProviderID = providerID;
+        provider->mRemoteHandle = remoteHandle;
+        provider->mProviderName = providerName;
+        provider->mProviderHash = providerHash;
+        provider->mSelfRegistered = true;
+
+        mRemoteRegisteredProvidersByUUID[provider->mProviderID] = provider;
+        mRemoteRegisteredProvidersByRemoteHandle[provider->mRemoteHandle] = provider;
+
+        noteRemoteProviderWithListener(provider->mProviderID, true);
+        provider->mHandle = Log::registerEventingWriter(provider->mProviderID, provider->mProviderName, provider->mProviderHash);
+
+        // without dense indexes on the wire the table is still used after the handle lookup
+        if (!mRemoteSupportsDenseProviders) {
+          if (mFreeRemoteProviderIndexes.size() > 0) {
+            index = mFreeRemoteProviderIndexes.back();
+            mFreeRemoteProviderIndexes.pop_back();
+          } else {
+            index = static_cast<uint32_t>(mRemoteProviders.size());
           }
         }
-        
-        String providerIDStr = IHelper::getElementText(rootEl->findLastChildElement("id"));
-        String providerNameStr = IHelper::getElementText(rootEl->findLastChildElement("name"));
-        String providerHashStr = IHelper::getElementText(rootEl->findLastChildElement("hash"));
-        
-        ProviderInfo *provider {};
-        
-        try {
-          UUID providerID = Numeric<UUID>(providerIDStr);
-          
-          auto found = mRemoteRegisteredProvidersByUUID.find(providerID);
-          if (found != mRemoteRegisteredProvidersByUUID.end()) {
-            ZS_LOG_WARNING(Debug, log("remote provider announced but alrady know about provider ID") + ZS_PARAMIZE(providerIDStr));
-            return;
-          }
 
-          provider = new ProviderInfo;
-          mCleanUpProviderInfos.insert(provider);
+        auto &counters = mReceivedCounters[provider->mHandle];
+        if (counters.mName.isEmpty()) counters.mName = provider->mProviderName;
 
-          provider->mRelatedToRemoteEventingObjectID = mID;
-          provider->mProviderID = providerID;
-          provider->mRemoteHandle = remoteHandle;
-          provider->mProviderName = providerNameStr;
-          provider->mProviderHash = providerHashStr;
-          provider->mSelfRegistered = true;
-        } catch (const Numeric<UUID>::ValueOutOfRange &) {
-          ZS_LOG_WARNING(Debug, log("remote provider announced by provider ID is not recognized") + ZS_PARAMIZE(providerIDStr));
-          return;
+        RemoteProviderEntry *entry {};
+        if (index <= ZSLIB_EVENTING_REMOTE_EVENTING_MAX_DENSE_PROVIDERS) {
+          if (index >= mRemoteProviders.size()) mRemoteProviders.resize(index + 1);
+          entry = &(mRemoteProviders[index]);
+          provider->mIndex = index;
+        } else {
+          // beyond the table the provider is found by the value carried on the wire
+          ZS_LOG_DEBUG(log("remote provider index is beyond the dense table") + ZS_PARAMIZE(index) + ZS_PARAM("provider name", provider->mProviderName));
+          provider->mIndex = (mRemoteSupportsDenseProviders ? index : ZSLIB_EVENTING_REMOTE_EVENTING_UNKNOWN_PROVIDER_INDEX);
+          entry = &(mOverflowRemoteProviders[getRemoteProviderWireValue(provider)]);
         }
 
-        mRemoteRegisteredProvidersByUUID[provider->mProviderID] = provider;
-        mRemoteRegisteredProvidersByRemoteHandle[provider->mRemoteHandle] = provider;
+        entry->mProvider = provider;
+        entry->mReceivedCounters = &counters;
+        entry->mHeaders.clear();
 
-        provider->mHandle = Log::registerEventingWriter(provider->mProviderID, provider->mProviderName, provider->mProviderHash);
+        noteRecordedConnectionState();
 
         EventingAtomDataArray atomArray {};
         if (!Log::getEventingWriterInfo(provider->mHandle, provider->mProviderID, provider->mProviderName, provider->mProviderHash, &atomArray)) {
@@ -1876,7 +8226,8 @@ namespace zsLib
 
         ProviderInfo *existingProvider = reinterpret_cast<ProviderInfo *>(atomArray[mEventingAtomIndex]);
         if (existingProvider) {
-          if (mID != existingProvider->mRelatedToRemoteEventingObjectID) {
+          if ((mID != existingProvider->mRelatedToRemoteEventingObjectID) &&
+              (mParentID != existingProvider->mRelatedToRemoteEventingObjectID)) {
             ZS_LOG_WARNING(Detail, log("existing provider belongs to unrelated remote eventing") + ZS_PARAM("id", existingProvider->mRelatedToRemoteEventingObjectID));
             return;
           }
@@ -1894,6 +8245,12 @@ namespace zsLib
           }
         }
 
+        // the event filter is in place before any logging request enables the provider
+        auto foundEvents = mSetRemoteProviderEvents.find(providerName);
+        if (foundEvents != mSetRemoteProviderEvents.end()) {
+          requestSetRemoteEventProviderEvents(providerName, (*foundEvents).second);
+        }
+
         for (auto iter_doNotUse = mRequestRemoteProviderKeywordLevel.begin(); iter_doNotUse != mRequestRemoteProviderKeywordLevel.end(); )
         {
           auto current = iter_doNotUse;
@@ -1902,7 +8259,7 @@ namespace zsLib
           auto checkProviderName = (*current).first;
           auto bitmask = (*current).second;
 
-          if (checkProviderName == providerNameStr) {
+          if (checkProviderName == providerName) {
             requestSetRemoteEventProviderLogging(checkProviderName, bitmask);
             mRequestRemoteProviderKeywordLevel.erase(current);
           }
@@ -1910,19 +8267,63 @@ namespace zsLib
       }
 
       //-----------------------------------------------------------------------
-      void RemoteEventing::handleNotifyRemoteProviderKeywordLogging(const ElementPtr &rootEl)
+      void RemoteEventing::unregisterRemoteProvider(ProviderHandle remoteHandle)
       {
-        String remoteHandleStr = IHelper::getElementText(rootEl->findLastChildElement("handle"));
-        String bitmaskStr = IHelper::getElementText(rootEl->findLastChildElement("bitmask"));
-        
-        ProviderHandle remoteHandle = 0;
-        try {
-          remoteHandle = Numeric<ProviderHandle>(remoteHandleStr);
-        } catch (const Numeric<ProviderHandle>::ValueOutOfRange &) {
-          ZS_LOG_WARNING(Detail, log("remote handle is not valid") + ZS_PARAMIZE(remoteHandleStr));
+        auto found = mRemoteRegisteredProvidersByRemoteHandle.find(remoteHandle);
+        if (found == mRemoteRegisteredProvidersByRemoteHandle.end()) {
+          ZS_LOG_WARNING(Trace, log("notified remote provider is gone but provider was never announced"));
           return;
         }
         
+        auto provider = (*found).second;
+        mRemoteRegisteredProvidersByRemoteHandle.erase(found);
+
+        if (provider->mIndex <= ZSLIB_EVENTING_REMOTE_EVENTING_MAX_DENSE_PROVIDERS) {
+          if (provider->mIndex < mRemoteProviders.size()) {
+            auto &entry = mRemoteProviders[provider->mIndex];
+            if (entry.mProvider == provider) {
+              entry.mProvider = NULL;
+              entry.mHeaders.clear();
+              if (!mRemoteSupportsDenseProviders) mFreeRemoteProviderIndexes.push_back(provider->mIndex);
+            }
+          }
+        } else {
+          auto foundOverflow = mOverflowRemoteProviders.find(getRemoteProviderWireValue(provider));
+          if ((foundOverflow != mOverflowRemoteProviders.end()) &&
+              ((*foundOverflow).second.mProvider == provider)) {
+            mOverflowRemoteProviders.erase(foundOverflow);
+          }
+        }
+
+        {
+          auto foundUUDI = mRemoteRegisteredProvidersByUUID.find(provider->mProviderID);
+          if (foundUUDI != mRemoteRegisteredProvidersByUUID.end()) {
+            mRemoteRegisteredProvidersByUUID.erase(foundUUDI);
+          } else {
+            ZS_LOG_WARNING(Trace, log("notified remote provider is gone but provider UUID was not found"));
+          }
+        }
+
+        noteRecordedConnectionState();
+
+        retireRemoteProvider(provider);
+        
+        if (mDelegate) {
+          try {
+            mDelegate->onRemoteEventingRemoteProviderGone(provider->mProviderName);
+          } catch (const IRemoteEventingDelegateProxy::Exceptions::DelegateGone &) {
+            ZS_LOG_WARNING(Debug, log("delegate gone (probably okay)"));
+            mDelegate.reset();
+          }
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventing::noteRemoteProviderKeywords(
+                                                      ProviderHandle remoteHandle,
+                                                      KeywordBitmaskType bitmask
+                                                      )
+      {
         auto found = mRemoteRegisteredProvidersByRemoteHandle.find(remoteHandle);
         if (found == mRemoteRegisteredProvidersByRemoteHandle.end()) {
           ZS_LOG_WARNING(Debug, log("told keyword logging information about unknown provider") + ZS_PARAMIZE(remoteHandle));
@@ -1930,124 +8331,134 @@ namespace zsLib
         }
         
         auto provider = (*found).second;
+        provider->mBitmask = bitmask;
 
-        try {
-          KeywordBitmaskType bitmask = Numeric<KeywordBitmaskType>(bitmaskStr);
-          if (mDelegate) {
+        if (mDelegate) {
+          try {
             mDelegate->onRemoteEventingRemoteProviderStateChange(provider->mProviderName, bitmask);
+          } catch (const IRemoteEventingDelegateProxy::Exceptions::DelegateGone &) {
+            ZS_LOG_WARNING(Debug, log("delegate gone (probably okay)"));
+            mDelegate.reset();
           }
-        } catch (const Numeric<KeywordBitmaskType>::ValueOutOfRange &) {
-          ZS_LOG_WARNING(Debug, log("remote bitmask is not valid"));
-        } catch (const IRemoteEventingDelegateProxy::Exceptions::DelegateGone &) {
-          ZS_LOG_WARNING(Debug, log("delegate gone (probably okay)"));
-          mDelegate.reset();
         }
       }
-      
+
       //-----------------------------------------------------------------------
-      void RemoteEventing::handleRequest(const ElementPtr &rootEl)
+      RemoteEventing::RemoteProviderEntry *RemoteEventing::findRemoteEventProvider(uint64_t remoteProvider)
       {
-        int error = 0;
-        String reason;
-        String requestID = IHelper::getElementText(rootEl->findFirstChildElement("id"));
-        String typeStr = IHelper::getElementText(rootEl->findFirstChildElement("type"));
-        if (ZSLIB_EVENTING_REMOTE_EVENTING_REQUEST_SET_SUBSYSTEM_LEVEL == typeStr) {
-          String subsystemStr = IHelper::getElementText(rootEl->findFirstChildElement("subsystem"));
-          String levelStr = IHelper::getElementText(rootEl->findFirstChildElement("level"));
-
-          try {
-            auto level = Log::toLevel(levelStr);
-            Log::setEventingLevelByName(subsystemStr, level);
-          } catch (const InvalidArgument &) {
-            ZS_LOG_WARNING(Detail, log("remote set subsystem request is not understood (ignored)") + ZS_PARAMIZE(subsystemStr) + ZS_PARAMIZE(subsystemStr));
-            error = -1;
-            reason = "Level was not understood: " + levelStr;
+        if (mRemoteSupportsDenseProviders) {
+          if ((remoteProvider < mRemoteProviders.size()) &&
+              (mRemoteProviders[static_cast<size_t>(remoteProvider)].mProvider)) {
+            return &(mRemoteProviders[static_cast<size_t>(remoteProvider)]);
           }
-          sendAck(requestID, error, reason);
-          return;
-        }
-        if (ZSLIB_EVENTING_REMOTE_EVENTING_REQUEST_SET_EVENT_PROVIDER_LOGGING == typeStr) {
-          String providerStr = IHelper::getElementText(rootEl->findFirstChildElement("provider"));
-          String keywordStr = IHelper::getElementText(rootEl->findFirstChildElement("keywords"));
-          KeywordBitmaskType bitmask = 0;
-          try {
-            bitmask = Numeric<KeywordBitmaskType>(keywordStr);
-            for (auto iter = mLocalAnnouncedProviders.begin(); iter != mLocalAnnouncedProviders.end(); ++iter) {
-              auto providerInfo = (*iter).second;
-              if (providerInfo->mProviderName == providerStr) {
-                if (0 == bitmask) {
-                  auto found = mRequestedRemoteProviderKeywordLevel.find(providerInfo->mHandle);
-                  if (found != mRequestedRemoteProviderKeywordLevel.end()) mRequestedRemoteProviderKeywordLevel.erase(found);
-                } else {
-                  mRequestedRemoteProviderKeywordLevel[providerInfo->mHandle] = providerInfo;
-                }
-                Log::setEventingLogging(providerInfo->mHandle, mID, 0 != bitmask, bitmask);
-              }
-            }
-          } catch (const Numeric<KeywordBitmaskType>::ValueOutOfRange &) {
-            ZS_LOG_WARNING(Detail, log("remote set event provider logging request is not understood (ignored)") + ZS_PARAMIZE(providerStr) + ZS_PARAMIZE(keywordStr));
-            error = -1;
-            reason = "Keywords value was not understood: " + keywordStr;
+          if (remoteProvider > ZSLIB_EVENTING_REMOTE_EVENTING_MAX_DENSE_PROVIDERS) {
+            auto foundOverflow = mOverflowRemoteProviders.find(remoteProvider);
+            if (foundOverflow != mOverflowRemoteProviders.end()) return &((*foundOverflow).second);
           }
-          sendAck(requestID, error, reason);
-          return;
+          ZS_LOG_WARNING(Trace, log("event about provider index that was never announced") + ZS_PARAMIZE(remoteProvider));
+          return NULL;
         }
-        
-        ZS_LOG_WARNING(Detail, log("remote request is not understood (ignored)") + ZS_PARAMIZE(typeStr));
+
+        auto found = mRemoteRegisteredProvidersByRemoteHandle.find(remoteProvider);
+        if (found == mRemoteRegisteredProvidersByRemoteHandle.end()) {
+          ZS_LOG_WARNING(Trace, log("event about provider that was never announced") + ZS_PARAM("remote handle", remoteProvider));
+          return NULL;
+        }
+
+        auto provider = (*found).second;
+        if (!provider->mSelfRegistered) {
+          ZS_LOG_ERROR(Debug, log("event about provider that was not registered from remote party") + ZS_PARAM("remote handle", remoteProvider));
+          return NULL;
+        }
+        if (provider->mIndex < mRemoteProviders.size()) return &(mRemoteProviders[provider->mIndex]);
+
+        auto foundOverflow = mOverflowRemoteProviders.find(remoteProvider);
+        if (foundOverflow == mOverflowRemoteProviders.end()) return NULL;
+        return &((*foundOverflow).second);
       }
-      
+
       //-----------------------------------------------------------------------
-      void RemoteEventing::handleRequestAck(const ElementPtr &rootEl)
+      uint64_t RemoteEventing::getRemoteProviderWireValue(const ProviderInfo *provider) const
       {
-        // ignored for now...
+        if (mRemoteSupportsDenseProviders) return provider->mIndex;
+        return static_cast<uint64_t>(provider->mRemoteHandle);
+      }
+
+      //-----------------------------------------------------------------------
+      const RemoteEventing::EventHeader *RemoteEventing::decodeCachedEventHeader(
+                                                                                 RemoteProviderEntry *entry,
+                                                                                 BYTE * &ioPos,
+                                                                                 size_t &ioRemaining,
+                                                                                 EventHeader &scratchHeader
+                                                                                 )
+      {
+        if ((!entry) ||
+            (ioRemaining < ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_HEADER_SIZE)) {
+          if (!decodeEventHeader(ioPos, ioRemaining, scratchHeader)) return NULL;
+          return &scratchHeader;
+        }
+
+        size_t descriptorCount = IHelper::getBE16(ioPos + ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_HEADER_SIZE - sizeof(CryptoPP::word16));
+        size_t headerSize = ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_HEADER_SIZE + (sizeof(CryptoPP::word16)*descriptorCount);
+
+        if (entry->mHeaders.empty()) entry->mHeaders.resize(ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_HEADER_CACHE_SIZE);
+
+        // the event ID follows the severity and level
+        uint16_t eventID = IHelper::getBE16(ioPos + (sizeof(CryptoPP::word16)*2));
+        auto &cached = entry->mHeaders[eventID % ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_HEADER_CACHE_SIZE];
+
+        if ((cached.mDefined) &&
+            (ioRemaining >= headerSize) &&
+            (cached.mRaw.SizeInBytes() == headerSize) &&
+            (0 == memcmp(cached.mRaw.BytePtr(), ioPos, headerSize))) {
+          ioPos += headerSize;
+          ioRemaining -= headerSize;
+          return &(cached.mHeader);
+        }
+
+        const BYTE *headerPos = ioPos;
+
+        cached.mDefined = false;
+        if (!decodeEventHeader(ioPos, ioRemaining, cached.mHeader)) return NULL;
+
+        cached.mRaw.Assign(headerPos, headerSize);
+        cached.mDefined = true;
+        return &(cached.mHeader);
       }
 
       //-----------------------------------------------------------------------
-      void RemoteEventing::handleEvent(SecureByteBlock &buffer)
+      bool RemoteEventing::decodeEventHeader(
+                                             BYTE * &ioPos,
+                                             size_t &ioRemaining,
+                                             EventHeader &outHeader
+                                             )
       {
-        size_t expectingBasicSize = (sizeof(CryptoPP::word16)*5) +
-                                    (sizeof(uint8_t)*4) +
-                                    (sizeof(uint64_t)*2);
-        
-        if (buffer.SizeInBytes() < expectingBasicSize) {
-          ZS_LOG_WARNING(Debug, log("event message did not contain enough header data") + ZS_PARAMIZE(expectingBasicSize) + ZS_PARAM("actual size", buffer.SizeInBytes()));
-          return;
-        }
-        
-        const BYTE *pos = buffer.BytePtr();
-        
-        uint64_t remoteHandle = IHelper::getBE64(pos);
-        pos += sizeof(remoteHandle);
-        
-        auto found = mRemoteRegisteredProvidersByRemoteHandle.find(remoteHandle);
-        if (found == mRemoteRegisteredProvidersByRemoteHandle.end()) {
-          ZS_LOG_WARNING(Trace, log("event about provider that was never announced") + ZS_PARAMIZE(remoteHandle));
-          return;
-        }
-        
-        auto provider = (*found).second;
-        if (!provider->mSelfRegistered) {
-          ZS_LOG_ERROR(Debug, log("event about provider that was not registered from remote party") + ZS_PARAMIZE(remoteHandle));
-          return;
+        size_t expectingBasicSize = ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_HEADER_SIZE;
+
+        if (ioRemaining < expectingBasicSize) {
+          ZS_LOG_WARNING(Debug, slog("event message did not contain enough header data") + ZS_PARAMIZE(expectingBasicSize) + ZS_PARAM("remaining", ioRemaining));
+          return false;
         }
-        
-        Log::Severity severity = static_cast<Log::Severity>(IHelper::getBE16(pos));
+
+        const BYTE *pos = ioPos;
+
+        outHeader.mSeverity = static_cast<Log::Severity>(IHelper::getBE16(pos));
         pos += sizeof(uint16_t);
-        Log::Level level = static_cast<Log::Level>(IHelper::getBE16(pos));
+        outHeader.mLevel = static_cast<Log::Level>(IHelper::getBE16(pos));
         pos += sizeof(uint16_t);
-        
-        if ((severity < Log::Severity_First) ||
-            (severity > Log::Severity_Last)) {
-          ZS_LOG_WARNING(Debug, log("illegal severity") + ZS_PARAMIZE(severity));
-          return;
+
+        if ((outHeader.mSeverity < Log::Severity_First) ||
+            (outHeader.mSeverity > Log::Severity_Last)) {
+          ZS_LOG_WARNING(Debug, slog("illegal severity") + ZS_PARAM("severity", outHeader.mSeverity));
+          return false;
         }
-        if ((level < Log::Level_First) ||
-            (level > Log::Level_Last)) {
-          ZS_LOG_WARNING(Debug, log("illegal level") + ZS_PARAMIZE(level));
-          return;
+        if ((outHeader.mLevel < Log::Level_First) ||
+            (outHeader.mLevel > Log::Level_Last)) {
+          ZS_LOG_WARNING(Debug, slog("illegal level") + ZS_PARAM("level", outHeader.mLevel));
+          return false;
         }
-        
-        USE_EVENT_DESCRIPTOR descriptor {};
+
+        auto &descriptor = outHeader.mDescriptor;
         descriptor.Id = IHelper::getBE16(pos);
         pos += sizeof(uint16_t);
         descriptor.Version = *pos;
@@ -2065,30 +8476,48 @@ namespace zsLib
 
         size_t descriptorCount = IHelper::getBE16(pos);
         pos += sizeof(uint16_t);
-        
+
         if (descriptorCount > ZSLIB_EVENTING_REMOTE_EVENTING_MAX_DATA_DESCRIPTORS) {
-          ZS_LOG_WARNING(Debug, log("remote event contains too many data descriptors") + ZS_PARAMIZE(descriptorCount));
-          return;
+          ZS_LOG_WARNING(Debug, slog("remote event contains too many data descriptors") + ZS_PARAMIZE(descriptorCount));
+          return false;
         }
 
-        USE_EVENT_DATA_DESCRIPTOR dataDescriptors[ZSLIB_EVENTING_REMOTE_EVENTING_MAX_DATA_DESCRIPTORS];
-        USE_EVENT_PARAMETER_DESCRIPTOR paramDescriptors[ZSLIB_EVENTING_REMOTE_EVENTING_MAX_DATA_DESCRIPTORS];
+        size_t remaining = ioRemaining - expectingBasicSize;
 
-        size_t remaining = buffer.SizeInBytes() - expectingBasicSize;
-        
         size_t expecting = (sizeof(uint16_t)*descriptorCount);
         if (remaining < expecting) {
-          ZS_LOG_WARNING(Debug, log("event message did not contain enough data") + ZS_PARAMIZE(expecting) + ZS_PARAMIZE(remaining) + ZS_PARAM("actual size", buffer.SizeInBytes()));
-          return;
+          ZS_LOG_WARNING(Debug, slog("event message did not contain enough data") + ZS_PARAMIZE(expecting) + ZS_PARAMIZE(remaining));
+          return false;
         }
 
         for (size_t index = 0; index < descriptorCount; ++index) {
-          paramDescriptors[index].Type = static_cast<EventParameterTypes>(IHelper::getBE16(pos));
+          outHeader.mParamDescriptors[index].Type = static_cast<EventParameterTypes>(IHelper::getBE16(pos));
           pos += sizeof(uint16_t);
           remaining -= sizeof(uint16_t);
         }
 
-        for (size_t index = 0; index < descriptorCount; ++index) {
+        outHeader.mDescriptorCount = descriptorCount;
+
+        ioPos += (ioRemaining - remaining);
+        ioRemaining = remaining;
+        return true;
+      }
+
+      //-----------------------------------------------------------------------
+      bool RemoteEventing::decodeEventData(
+                                           BYTE * &ioPos,
+                                           size_t &ioRemaining,
+                                           const EventHeader &header,
+                                           bool swapIntegers,
+                                           bool swapFloats,
+                                           USE_EVENT_DATA_DESCRIPTOR *outDataDescriptors
+                                           )
+      {
+        BYTE *pos = ioPos;
+        size_t remaining = ioRemaining;
+        size_t expecting {};
+
+        for (size_t index = 0; index < header.mDescriptorCount; ++index) {
           
           {
             expecting = sizeof(uint32_t);
@@ -2098,42 +8527,24 @@ namespace zsLib
             pos += sizeof(dataTypeSize);
             remaining -= sizeof(dataTypeSize);
             
-            bool endianFlip {false};
-            if (0 != (dataTypeSize & (1 << 31))) {
-              endianFlip = true;
-              dataTypeSize = dataTypeSize & (0x7FFFFFFF);
+            bool scalar {false};
+            if (0 != (dataTypeSize & ZSLIB_EVENTING_REMOTE_EVENTING_SCALAR_FLAG)) {
+              scalar = true;
+              dataTypeSize = dataTypeSize & (~ZSLIB_EVENTING_REMOTE_EVENTING_SCALAR_FLAG);
             }
             
             expecting = dataTypeSize;
             if (remaining < expecting) goto not_enough_data;
             
-            dataDescriptors[index].Size = dataTypeSize;
-            if (0 != dataDescriptors[index].Size) {
-              dataDescriptors[index].Ptr = reinterpret_cast<uintptr_t>(pos);
+            outDataDescriptors[index].Ptr = 0;
+            outDataDescriptors[index].Size = dataTypeSize;
+            if (0 != outDataDescriptors[index].Size) {
+              outDataDescriptors[index].Ptr = reinterpret_cast<uintptr_t>(pos);
             }
 
-            if (endianFlip) {
-              switch (dataTypeSize) {
-                case 2: {
-                  uint16_t value = IHelper::getBE16(pos);
-                  memcpy(const_cast<BYTE *>(pos), &value, sizeof(value));
-                  break;
-                }
-                case 4: {
-                  uint32_t value = IHelper::getBE32(pos);
-                  memcpy(const_cast<BYTE *>(pos), &value, sizeof(value));
-                  break;
-                }
-                case 8: {
-                  uint64_t value = IHelper::getBE64(pos);
-                  memcpy(const_cast<BYTE *>(pos), &value, sizeof(value));
-                  break;
-                }
-                default:  {
-                  // just leave in original format
-                  break;
-                }
-              }
+            if (scalar) {
+              bool swap = (EventParameterType_FloatingPoint == header.mParamDescriptors[index].Type ? swapFloats : swapIntegers);
+              if (swap) swapScalarBytes(pos, dataTypeSize);
             }
 
             pos += dataTypeSize;
@@ -2144,21 +8555,14 @@ namespace zsLib
           
         not_enough_data:
           {
-            ZS_LOG_WARNING(Debug, log("event message did not contain enough data") + ZS_PARAMIZE(index) + ZS_PARAMIZE(expecting) + ZS_PARAMIZE(remaining) + ZS_PARAM("actual size", buffer.SizeInBytes()));
-            return;
+            ZS_LOG_WARNING(Debug, slog("event message did not contain enough data") + ZS_PARAMIZE(index) + ZS_PARAMIZE(expecting) + ZS_PARAMIZE(remaining));
+            return false;
           }
         }
 
-        // write the remote event as if it was generated locally
-        Log::writeEvent(
-                        provider->mHandle,
-                        severity,
-                        level,
-                        (&descriptor),
-                        (&(paramDescriptors[0])),
-                        (&(dataDescriptors[0])),
-                        descriptorCount
-                        );
+        ioPos = pos;
+        ioRemaining = remaining;
+        return true;
       }
 
       //-----------------------------------------------------------------------
@@ -2178,17 +8582,47 @@ namespace zsLib
         welcomeEl->adoptAsFirstChild(IHelper::createElementWithText("value32Bytes", IHelper::convertToHex(&(endian32Bytes[0]), sizeof(endian32Bytes))));
         welcomeEl->adoptAsFirstChild(IHelper::createElementWithNumber("valueFloat", string(endianFloat)));
         welcomeEl->adoptAsFirstChild(IHelper::createElementWithText("valueFloatBytes", IHelper::convertToHex(&(endianFloatBytes[0]), sizeof(endianFloatBytes))));
-        
-        sendData(MessageType_Welcome, welcomeEl);
-        
-        for (auto iter = mLocalSubsystems.begin(); iter != mLocalSubsystems.end(); ++iter) {
-          auto &info = (*iter).second;
-          announceSubsystemToRemote(info);
+        if (mUseEventBatches) {
+          welcomeEl->adoptAsFirstChild(IHelper::createElementWithNumber("eventBatch", ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_BATCH_VERSION));
+        }
+        if (useCompactEvents()) {
+          welcomeEl->adoptAsFirstChild(IHelper::createElementWithNumber("compactEvents", ZSLIB_EVENTING_REMOTE_EVENTING_COMPACT_EVENTS_VERSION));
+        }
+        welcomeEl->adoptAsFirstChild(IHelper::createElementWithNumber("eventOrigin", ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_ORIGIN_VERSION));
+        welcomeEl->adoptAsFirstChild(IHelper::createElementWithNumber("denseProviders", ZSLIB_EVENTING_REMOTE_EVENTING_DENSE_PROVIDERS_VERSION));
+        welcomeEl->adoptAsFirstChild(IHelper::createElementWithNumber("nativeByteOrder", ZSLIB_EVENTING_REMOTE_EVENTING_NATIVE_BYTE_ORDER_VERSION));
+        welcomeEl->adoptAsFirstChild(IHelper::createElementWithNumber("eventBacklog", ZSLIB_EVENTING_REMOTE_EVENTING_EVENT_BACKLOG_VERSION));
+
+        bool resumed = false;
+        if ((isListeningMode()) &&
+            (0 != mMaxResumableSessions)) {
+          // the session is kept by whoever outlives the connection
+          RemoteEventingPtr owner = (mIsClient ? mParentWeak.lock() : mThisWeak.lock());
+          if (owner) mSession = owner->claimSession(mPresentedSessionToken, mPresentedSessionEpoch, mPresentedSessionDigest, resumed);
+          if (mSession) {
+            welcomeEl->adoptAsFirstChild(IHelper::createElementWithText("session", mSession->mToken));
+            welcomeEl->adoptAsFirstChild(IHelper::createElementWithNumber("sessionEpoch", string(mSession->mEpoch)));
+            if (resumed) {
+              welcomeEl->adoptAsFirstChild(IHelper::createElementWithNumber("sessionResumed", "true"));
+            }
+          }
         }
+
+        sendData(MessageType_Welcome, welcomeEl);
         
-        for (auto iter = mLocalAnnouncedProviders.begin(); iter != mLocalAnnouncedProviders.end(); ++iter) {
-          auto &info = (*iter).second;
-          announceProviderToRemote(info);
+        if (resumed) {
+          ZS_LOG_DEBUG(log("resuming session") + ZS_PARAM("epoch", mSession->mEpoch));
+          sendSessionDelta();
+        } else {
+          for (auto iter = mLocalSubsystems.begin(); iter != mLocalSubsystems.end(); ++iter) {
+            auto &info = (*iter).second;
+            announceSubsystemToRemote(info);
+          }
+
+          for (auto iter = mLocalAnnouncedProviders.begin(); iter != mLocalAnnouncedProviders.end(); ++iter) {
+            auto &info = (*iter).second;
+            announceProviderToRemote(info);
+          }
         }
         
         for (auto iter = mSetRemoteSubsystemsLevels.begin(); iter != mSetRemoteSubsystemsLevels.end(); ++iter) {
@@ -2197,6 +8631,67 @@ namespace zsLib
         }
       }
 
+      //-----------------------------------------------------------------------
+      void RemoteEventing::sendSessionDelta()
+      {
+        ProviderInfoHandleMap current;
+        for (auto iter = mLocalAnnouncedProviders.begin(); iter != mLocalAnnouncedProviders.end(); ++iter) {
+          auto provider = (*iter).second;
+          current[provider->mHandle] = provider;
+        }
+
+        std::string delta;
+        size_t totalRecords {};
+
+        // gone providers first so a reused handle is announced afresh
+        for (auto iter = mSession->mProviders.begin(); iter != mSession->mProviders.end(); ++iter) {
+          auto found = current.find((*iter).first);
+          if ((found != current.end()) &&
+              ((*found).second->mProviderID == (*iter).second.mProviderID)) continue;
+
+          delta.append(1, static_cast<char>(ZSLIB_EVENTING_REMOTE_EVENTING_SESSION_RECORD_PROVIDER_GONE));
+          appendSessionVarint(delta, static_cast<uint64_t>((*iter).first));
+          ++totalRecords;
+        }
+
+        for (auto iter = mLocalSubsystems.begin(); iter != mLocalSubsystems.end(); ++iter) {
+          if (mSession->mSubsystems.end() != mSession->mSubsystems.find((*iter).first)) continue;
+
+          delta.append(1, static_cast<char>(ZSLIB_EVENTING_REMOTE_EVENTING_SESSION_RECORD_SUBSYSTEM));
+          appendSessionString(delta, (*iter).first);
+          ++totalRecords;
+        }
+
+        for (auto iter = current.begin(); iter != current.end(); ++iter) {
+          auto provider = (*iter).second;
+          auto found = mSession->mProviders.find((*iter).first);
+          if ((found != mSession->mProviders.end()) &&
+              ((*found).second.mProviderID == provider->mProviderID)) {
+            if ((*found).second.mBitmask == provider->mBitmask) continue;
+
+            delta.append(1, static_cast<char>(ZSLIB_EVENTING_REMOTE_EVENTING_SESSION_RECORD_PROVIDER_KEYWORDS));
+            appendSessionVarint(delta, static_cast<uint64_t>(provider->mHandle));
+            appendSessionVarint(delta, static_cast<uint64_t>(provider->mBitmask));
+            ++totalRecords;
+            continue;
+          }
+
+          delta.append(1, static_cast<char>(ZSLIB_EVENTING_REMOTE_EVENTING_SESSION_RECORD_PROVIDER));
+          appendSessionVarint(delta, static_cast<uint64_t>(provider->mHandle));
+          appendSessionVarint(delta, static_cast<uint64_t>(provider->mIndex));
+          appendSessionString(delta, string(provider->mProviderID));
+          appendSessionString(delta, provider->mProviderName);
+          appendSessionString(delta, provider->mProviderHash);
+          appendSessionVarint(delta, static_cast<uint64_t>(provider->mBitmask));
+          ++totalRecords;
+        }
+
+        ZS_LOG_TRACE(log("session delta") + ZS_PARAM("records", totalRecords) + ZS_PARAM("size", delta.length()));
+
+        if (delta.empty()) return;
+        sendData(MessageType_SessionDelta, delta);
+      }
+
       //-----------------------------------------------------------------------
       void RemoteEventing::sendNotify()
       {
@@ -2205,16 +8700,36 @@ namespace zsLib
           return;
         }
 
-        if (mAnnouncedLocalDropped != mTotalDroppedEvents) {
-          mAnnouncedLocalDropped = mTotalDroppedEvents;
-          ElementPtr rootEl = Element::create("notify");
-          rootEl->adoptAsLastChild(IHelper::createElementWithText("type", ZSLIB_EVENTING_REMOTE_EVENTING_NOTIFY_GENERAL_INFO));
-          rootEl->adoptAsLastChild(IHelper::createElementWithNumber("dropped", string(mTotalDroppedEvents)));
-          sendData(MessageType_Notify, rootEl);
+        size_t totalDropped = getTotalDroppedEvents();
+        bool droppedChanged = (mAnnouncedLocalDropped != totalDropped);
+
+        if ((!droppedChanged) &&
+            (!mNotifyStatistics)) return;
+
+        ElementPtr rootEl = Element::create("notify");
+        rootEl->adoptAsLastChild(IHelper::createElementWithText("type", ZSLIB_EVENTING_REMOTE_EVENTING_NOTIFY_GENERAL_INFO));
+        rootEl->adoptAsLastChild(IHelper::createElementWithNumber("dropped", string(totalDropped)));
+
+        if (droppedChanged) {
+          auto providersEl = getDroppedEventsByProvider();
+          if (providersEl) {
+            ZS_LOG_WARNING(Detail, log("events dropped") + ZS_PARAM("dropped", totalDropped) + ZS_PARAM("by provider", IHelper::toString(providersEl)));
+            rootEl->adoptAsLastChild(providersEl);
+          }
+        }
+        if (mNotifyStatistics) {
+          // opt-in as the snapshot takes the connection lock (and a listener
+          // walks every client) on each notify timer tick
+          rootEl->adoptAsLastChild(getStatistics().createElement());
+        }
+        sendData(MessageType_Notify, rootEl);
+
+        if (droppedChanged) {
+          mAnnouncedLocalDropped = totalDropped;
 
           if (mDelegate) {
             try {
-              mDelegate->onRemoteEventingLocalDroppedEvents(mThisWeak.lock(), mAnnouncedLocalDropped);
+              mDelegate->onRemoteEventingLocalDroppedEvents(getPublicConnection(), mAnnouncedLocalDropped);
             } catch (const IRemoteEventingDelegateProxy::Exceptions::DelegateGone &) {
               ZS_LOG_WARNING(Detail, log("delegate gone (probably okay)"));
               mDelegate.reset();
@@ -2250,6 +8765,31 @@ namespace zsLib
         sendData(MessageType_Request, rootEl);
       }
       
+      //-----------------------------------------------------------------------
+      void RemoteEventing::requestSetRemoteEventProviderEvents(
+                                                               const String &providerName,
+                                                               const EventIDSet &enabledEventIDs
+                                                               )
+      {
+        ElementPtr rootEl = Element::create("request");
+
+        rootEl->adoptAsLastChild(IHelper::createElementWithText("type", ZSLIB_EVENTING_REMOTE_EVENTING_REQUEST_SET_EVENT_PROVIDER_EVENTS));
+        rootEl->adoptAsLastChild(IHelper::createElementWithText("provider", providerName));
+        rootEl->adoptAsLastChild(IHelper::createElementWithText("events", encodeEventIDSet(enabledEventIDs)));
+
+        sendData(MessageType_Request, rootEl);
+      }
+
+      //-----------------------------------------------------------------------
+      bool RemoteEventing::isRemoteProviderRegistered(const String &providerName) const
+      {
+        for (auto iter = mRemoteRegisteredProvidersByUUID.begin(); iter != mRemoteRegisteredProvidersByUUID.end(); ++iter) {
+          auto provider = (*iter).second;
+          if (provider->mProviderName == providerName) return true;
+        }
+        return false;
+      }
+
       //-----------------------------------------------------------------------
       void RemoteEventing::announceProviderToRemote(
                                                     ProviderInfo *provider,
@@ -2264,6 +8804,7 @@ namespace zsLib
           rootEl->adoptAsLastChild(IHelper::createElementWithText("id", string(provider->mProviderID)));
           rootEl->adoptAsLastChild(IHelper::createElementWithText("name", provider->mProviderName));
           rootEl->adoptAsLastChild(IHelper::createElementWithText("hash", provider->mProviderHash));
+          rootEl->adoptAsLastChild(IHelper::createElementWithNumber("index", string(provider->mIndex)));
         } else {
           rootEl->adoptAsLastChild(IHelper::createElementWithNumber("gone", (!announceNew) ? "true" : "false"));
         }
@@ -2339,7 +8880,255 @@ namespace zsLib
       ZS_THROW_INVALID_ARGUMENT(String("Not a state: ") + str);
       return State_First;
     }
-    
+
+    //-------------------------------------------------------------------------
+    const char *IRemoteEventingTypes::toString(DropReasons reason)
+    {
+      switch (reason)
+      {
+        case DropReason_NotAuthorized:          return "notAuthorized";
+        case DropReason_InvalidEvent:           return "invalidEvent";
+        case DropReason_EventRingFull:          return "eventRingFull";
+        case DropReason_AsyncQueueFull:         return "asyncQueueFull";
+        case DropReason_OutgoingQueueFull:      return "outgoingQueueFull";
+        case DropReason_ProviderShareExceeded:  return "providerShareExceeded";
+        case DropReason_SpoolFull:              return "spoolFull";
+      }
+
+      return "unknown";
+    }
+
+    //-------------------------------------------------------------------------
+    IRemoteEventingTypes::DropReasons IRemoteEventingTypes::toDropReason(const char *reason) throw (InvalidArgument)
+    {
+      String str(reason);
+      for (IRemoteEventingTypes::DropReasons index = IRemoteEventingTypes::DropReason_First; index <= IRemoteEventingTypes::DropReason_Last; index = static_cast<IRemoteEventingTypes::DropReasons>(static_cast<std::underlying_type<IRemoteEventingTypes::DropReasons>::type>(index) + 1)) {
+        if (0 == str.compareNoCase(IRemoteEventingTypes::toString(index))) return index;
+      }
+
+      ZS_THROW_INVALID_ARGUMENT(String("Not a drop reason: ") + str);
+      return DropReason_First;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IRemoteEventingTypes::TimeHistogram
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    IRemoteEventingTypes::TimeHistogram::TimeHistogram(const ElementPtr &rootEl)
+    {
+      if (!rootEl) return;
+
+      mCount = internal::getElementNumber<decltype(mCount)>(rootEl, "count");
+      mTotalNanoseconds = internal::getElementNumber<decltype(mTotalNanoseconds)>(rootEl, "totalNanoseconds");
+
+      ElementPtr bucketsEl = rootEl->findFirstChildElement("buckets");
+      if (!bucketsEl) return;
+
+      size_t index = 0;
+      ElementPtr bucketEl = bucketsEl->findFirstChildElement("bucket");
+      while ((bucketEl) && (index < Buckets_Total)) {
+        String value = IHelper::getElementText(bucketEl);
+        try {
+          mBuckets[index] = Numeric<uint64_t>(value);
+        } catch (const Numeric<uint64_t>::ValueOutOfRange &) {
+        }
+        ++index;
+        bucketEl = bucketEl->findNextSiblingElement("bucket");
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    ElementPtr IRemoteEventingTypes::TimeHistogram::createElement(const char *objectName) const
+    {
+      if (NULL == objectName) objectName = "timeHistogram";
+
+      ElementPtr rootEl = Element::create(objectName);
+      rootEl->adoptAsLastChild(IHelper::createElementWithNumber("count", string(mCount)));
+      rootEl->adoptAsLastChild(IHelper::createElementWithNumber("totalNanoseconds", string(mTotalNanoseconds)));
+
+      // trailing empty buckets are omitted
+      size_t total = Buckets_Total;
+      while ((total > 0) && (0 == mBuckets[total - 1])) --total;
+
+      if (total > 0) {
+        ElementPtr bucketsEl = Element::create("buckets");
+        for (size_t index = 0; index < total; ++index) {
+          bucketsEl->adoptAsLastChild(IHelper::createElementWithNumber("bucket", string(mBuckets[index])));
+        }
+        rootEl->adoptAsLastChild(bucketsEl);
+      }
+
+      return rootEl;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IRemoteEventingTypes::ProviderStatistics
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    IRemoteEventingTypes::ProviderStatistics::ProviderStatistics(const ElementPtr &rootEl)
+    {
+      mEventsSent = internal::getElementNumber<decltype(mEventsSent)>(rootEl, "eventsSent");
+      mBytesSent = internal::getElementNumber<decltype(mBytesSent)>(rootEl, "bytesSent");
+      mEventsReceived = internal::getElementNumber<decltype(mEventsReceived)>(rootEl, "eventsReceived");
+      mBytesReceived = internal::getElementNumber<decltype(mBytesReceived)>(rootEl, "bytesReceived");
+    }
+
+    //-------------------------------------------------------------------------
+    ElementPtr IRemoteEventingTypes::ProviderStatistics::createElement(const char *objectName) const
+    {
+      if (NULL == objectName) objectName = "provider";
+
+      ElementPtr rootEl = Element::create(objectName);
+      rootEl->adoptAsLastChild(IHelper::createElementWithNumber("eventsSent", string(mEventsSent)));
+      rootEl->adoptAsLastChild(IHelper::createElementWithNumber("bytesSent", string(mBytesSent)));
+      rootEl->adoptAsLastChild(IHelper::createElementWithNumber("eventsReceived", string(mEventsReceived)));
+      rootEl->adoptAsLastChild(IHelper::createElementWithNumber("bytesReceived", string(mBytesReceived)));
+      return rootEl;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IRemoteEventingTypes::Statistics
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    IRemoteEventingTypes::Statistics::Statistics(const ElementPtr &rootEl)
+    {
+      if (!rootEl) return;
+
+      ElementPtr providersEl = rootEl->findFirstChildElement("providers");
+      if (providersEl) {
+        ElementPtr providerEl = providersEl->findFirstChildElement("provider");
+        while (providerEl) {
+          String name = IHelper::getElementTextAndDecode(providerEl->findFirstChildElement("name"));
+          mProviders[name] = ProviderStatistics(providerEl);
+          providerEl = providerEl->findNextSiblingElement("provider");
+        }
+      }
+
+      mAsyncQueueBytes = internal::getElementNumber<decltype(mAsyncQueueBytes)>(rootEl, "asyncQueueBytes");
+      mAsyncQueueBytesHighWater = internal::getElementNumber<decltype(mAsyncQueueBytesHighWater)>(rootEl, "asyncQueueBytesHighWater");
+      mOutgoingQueueBytes = internal::getElementNumber<decltype(mOutgoingQueueBytes)>(rootEl, "outgoingQueueBytes");
+      mOutgoingQueueBytesHighWater = internal::getElementNumber<decltype(mOutgoingQueueBytesHighWater)>(rootEl, "outgoingQueueBytesHighWater");
+
+      ElementPtr segmentPoolEl = rootEl->findFirstChildElement("outgoingSegmentPool");
+      mOutgoingSegmentPoolSegments = internal::getElementNumber<decltype(mOutgoingSegmentPoolSegments)>(segmentPoolEl, "segments");
+      mOutgoingSegmentPoolBytes = internal::getElementNumber<decltype(mOutgoingSegmentPoolBytes)>(segmentPoolEl, "bytes");
+
+      ElementPtr spoolEl = rootEl->findFirstChildElement("spool");
+      mSpoolBytes = internal::getElementNumber<decltype(mSpoolBytes)>(spoolEl, "bytes");
+      mSpooledEvents = internal::getElementNumber<decltype(mSpooledEvents)>(spoolEl, "spooled");
+      mReplayedEvents = internal::getElementNumber<decltype(mReplayedEvents)>(spoolEl, "replayed");
+
+      ElementPtr droppedEl = rootEl->findFirstChildElement("dropped");
+      for (DropReasons index = DropReason_First; index <= DropReason_Last; index = static_cast<DropReasons>(static_cast<std::underlying_type<DropReasons>::type>(index) + 1)) {
+        mDroppedEvents[index] = internal::getElementNumber<uint64_t>(droppedEl, toString(index));
+      }
+
+      mSendCalls = internal::getElementNumber<decltype(mSendCalls)>(rootEl, "sendCalls");
+      mSendWouldBlockCalls = internal::getElementNumber<decltype(mSendWouldBlockCalls)>(rootEl, "sendWouldBlockCalls");
+      mReceiveCalls = internal::getElementNumber<decltype(mReceiveCalls)>(rootEl, "receiveCalls");
+
+      mEncodeTime = TimeHistogram(rootEl->findFirstChildElement("encodeTime"));
+      mDecodeTime = TimeHistogram(rootEl->findFirstChildElement("decodeTime"));
+    }
+
+    //-------------------------------------------------------------------------
+    ElementPtr IRemoteEventingTypes::Statistics::createElement(const char *objectName) const
+    {
+      if (NULL == objectName) objectName = "statistics";
+
+      ElementPtr rootEl = Element::create(objectName);
+
+      if (mProviders.size() > 0) {
+        ElementPtr providersEl = Element::create("providers");
+        for (auto iter = mProviders.begin(); iter != mProviders.end(); ++iter) {
+          auto &name = (*iter).first;
+          auto &statistics = (*iter).second;
+          ElementPtr providerEl = statistics.createElement();
+          providerEl->adoptAsFirstChild(IHelper::createElementWithTextAndJSONEncode("name", name));
+          providersEl->adoptAsLastChild(providerEl);
+        }
+        rootEl->adoptAsLastChild(providersEl);
+      }
+
+      rootEl->adoptAsLastChild(IHelper::createElementWithNumber("asyncQueueBytes", string(mAsyncQueueBytes)));
+      rootEl->adoptAsLastChild(IHelper::createElementWithNumber("asyncQueueBytesHighWater", string(mAsyncQueueBytesHighWater)));
+      rootEl->adoptAsLastChild(IHelper::createElementWithNumber("outgoingQueueBytes", string(mOutgoingQueueBytes)));
+      rootEl->adoptAsLastChild(IHelper::createElementWithNumber("outgoingQueueBytesHighWater", string(mOutgoingQueueBytesHighWater)));
+
+      ElementPtr segmentPoolEl = Element::create("outgoingSegmentPool");
+      segmentPoolEl->adoptAsLastChild(IHelper::createElementWithNumber("segments", string(mOutgoingSegmentPoolSegments)));
+      segmentPoolEl->adoptAsLastChild(IHelper::createElementWithNumber("bytes", string(mOutgoingSegmentPoolBytes)));
+      rootEl->adoptAsLastChild(segmentPoolEl);
+
+      ElementPtr spoolEl = Element::create("spool");
+      spoolEl->adoptAsLastChild(IHelper::createElementWithNumber("bytes", string(mSpoolBytes)));
+      spoolEl->adoptAsLastChild(IHelper::createElementWithNumber("spooled", string(mSpooledEvents)));
+      spoolEl->adoptAsLastChild(IHelper::createElementWithNumber("replayed", string(mReplayedEvents)));
+      rootEl->adoptAsLastChild(spoolEl);
+
+      ElementPtr droppedEl = Element::create("dropped");
+      for (DropReasons index = DropReason_First; index <= DropReason_Last; index = static_cast<DropReasons>(static_cast<std::underlying_type<DropReasons>::type>(index) + 1)) {
+        droppedEl->adoptAsLastChild(IHelper::createElementWithNumber(toString(index), string(mDroppedEvents[index])));
+      }
+      rootEl->adoptAsLastChild(droppedEl);
+
+      rootEl->adoptAsLastChild(IHelper::createElementWithNumber("sendCalls", string(mSendCalls)));
+      rootEl->adoptAsLastChild(IHelper::createElementWithNumber("sendWouldBlockCalls", string(mSendWouldBlockCalls)));
+      rootEl->adoptAsLastChild(IHelper::createElementWithNumber("receiveCalls", string(mReceiveCalls)));
+
+      rootEl->adoptAsLastChild(mEncodeTime.createElement("encodeTime"));
+      rootEl->adoptAsLastChild(mDecodeTime.createElement("decodeTime"));
+
+      return rootEl;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IRemoteEventingTypes::FramePoolStatistics
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    IRemoteEventingTypes::FramePoolStatistics::FramePoolStatistics(const ElementPtr &rootEl)
+    {
+      if (!rootEl) return;
+
+      mFrames = internal::getElementNumber<decltype(mFrames)>(rootEl, "frames");
+      mFramesInUse = internal::getElementNumber<decltype(mFramesInUse)>(rootEl, "framesInUse");
+      mBytes = internal::getElementNumber<decltype(mBytes)>(rootEl, "bytes");
+      mBytesInUse = internal::getElementNumber<decltype(mBytesInUse)>(rootEl, "bytesInUse");
+    }
+
+    //-------------------------------------------------------------------------
+    ElementPtr IRemoteEventingTypes::FramePoolStatistics::createElement(const char *objectName) const
+    {
+      if (NULL == objectName) objectName = "framePool";
+
+      ElementPtr rootEl = Element::create(objectName);
+      rootEl->adoptAsLastChild(IHelper::createElementWithNumber("frames", string(mFrames)));
+      rootEl->adoptAsLastChild(IHelper::createElementWithNumber("framesInUse", string(mFramesInUse)));
+      rootEl->adoptAsLastChild(IHelper::createElementWithNumber("bytes", string(mBytes)));
+      rootEl->adoptAsLastChild(IHelper::createElementWithNumber("bytesInUse", string(mBytesInUse)));
+      return rootEl;
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -2359,6 +9148,41 @@ namespace zsLib
       return internal::RemoteEventing::connectToRemote(connectionDelegate, serverIP, connectionSharedSecret);
     }
 
+    //-------------------------------------------------------------------------
+    bool IRemoteEventing::getCurrentEventOrigin(EventOrigin &outOrigin)
+    {
+      return internal::RemoteEventing::getCurrentEventOrigin(outOrigin);
+    }
+
+    //-------------------------------------------------------------------------
+    IRemoteEventingTypes::FramePoolStatistics IRemoteEventing::getFramePoolStatistics()
+    {
+      return internal::RemoteEventing::getFramePoolStatistics();
+    }
+
+    //-------------------------------------------------------------------------
+    bool IRemoteEventing::readTraceIndex(
+                                         const BYTE *trace,
+                                         size_t traceSize,
+                                         ElementPtr &outHeaderEl,
+                                         TraceIndex &outIndex
+                                         )
+    {
+      return internal::RemoteEventing::readTraceIndex(trace, traceSize, outHeaderEl, outIndex);
+    }
+
+    //-------------------------------------------------------------------------
+    size_t IRemoteEventing::decodeTrace(
+                                        const BYTE *trace,
+                                        size_t traceSize,
+                                        uint64_t startOffset,
+                                        uint64_t endOffset,
+                                        IRemoteEventingTraceDelegate &delegate
+                                        )
+    {
+      return internal::RemoteEventing::decodeTrace(trace, traceSize, startOffset, endOffset, delegate);
+    }
+
     //-------------------------------------------------------------------------
     IRemoteEventingPtr IRemoteEventing::listenForRemote(
                                                         IRemoteEventingDelegatePtr connectionDelegate,
@@ -2370,5 +9194,27 @@ namespace zsLib
       return internal::RemoteEventing::listenForRemote(connectionDelegate, localPort, connectionSharedSecret, maxWaitToBindTimeInSeconds);
     }
 
+    //-------------------------------------------------------------------------
+    IRemoteEventingPtr IRemoteEventing::connectToLocal(
+                                                       IRemoteEventingDelegatePtr connectionDelegate,
+                                                       const char *localName,
+                                                       const char *connectionSharedSecret
+                                                       )
+    {
+      ZS_THROW_INVALID_ARGUMENT_IF((!localName) || ('\0' == *localName));
+      return internal::RemoteEventing::connectToLocal(connectionDelegate, localName, connectionSharedSecret);
+    }
+
+    //-------------------------------------------------------------------------
+    IRemoteEventingPtr IRemoteEventing::listenForLocal(
+                                                       IRemoteEventingDelegatePtr connectionDelegate,
+                                                       const char *localName,
+                                                       const char *connectionSharedSecret
+                                                       )
+    {
+      ZS_THROW_INVALID_ARGUMENT_IF((!localName) || ('\0' == *localName));
+      return internal::RemoteEventing::listenForLocal(connectionDelegate, localName, connectionSharedSecret);
+    }
+
   } // namespace eventing
 } // namespace zsLib
@@ -43,6 +43,10 @@ either expressed or implied, of the FreeBSD Project.
 
 #include <cryptopp/queue.h>
 
+#include <condition_variable>
+#include <cstdio>
+#include <thread>
+
 #define ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_MAX_DATA_SIZE                                    "zsLib/eventing/remote-eventing/max-data-size-in-bytes"
 #define ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_MAX_PACKED_SIZE                                  "zsLib/eventing/remote-eventing/max-packed-data-size-in-bytes"
 #define ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_MAX_OUTSTANDING_EVENTS                           "zsLib/eventing/remote-eventing/max-outstanding-events-in-bytes"
@@ -50,6 +54,31 @@ either expressed or implied, of the FreeBSD Project.
 #define ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_MAX_QUEUED_OUTGOING_DATA_BEFORED_EVENTS_DROPPED  "zsLib/eventing/remote-eventing/max-queued-outgoing-data-before-events-dropped"
 #define ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_NOTIFY_TIMER                                     "zsLib/eventing/remote-eventing/notify-timer-in-seconds"
 #define ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_USE_IPV6                                         "zsLib/eventing/remote-eventing/use-ipv6"
+#define ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_USE_EVENT_RINGS                                  "zsLib/eventing/remote-eventing/use-per-thread-event-rings"
+#define ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_EVENT_RING_SIZE                                  "zsLib/eventing/remote-eventing/event-ring-size-in-bytes"
+#define ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_USE_EVENT_BATCHES                                "zsLib/eventing/remote-eventing/use-trace-event-batches"
+#define ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_MAX_EVENT_BATCH_SIZE                             "zsLib/eventing/remote-eventing/max-trace-event-batch-size-in-bytes"
+#define ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_OUTGOING_SEGMENT_SIZE                            "zsLib/eventing/remote-eventing/outgoing-segment-size-in-bytes"
+#define ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_MAX_POOLED_OUTGOING_SEGMENTS                     "zsLib/eventing/remote-eventing/max-pooled-outgoing-segments"
+#define ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_INCOMING_BUFFER_SIZE                             "zsLib/eventing/remote-eventing/incoming-buffer-size-in-bytes"
+#define ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_USE_COMPACT_EVENTS                               "zsLib/eventing/remote-eventing/use-compact-trace-events"
+#define ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_USE_TSC_CLOCK                                    "zsLib/eventing/remote-eventing/use-tsc-clock"
+#define ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_USE_SEVERITY_LOAD_SHEDDING                       "zsLib/eventing/remote-eventing/use-severity-load-shedding"
+#define ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_MAX_PROVIDER_SHARE_PERCENT                       "zsLib/eventing/remote-eventing/max-provider-share-of-queued-data-percent"
+#define ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_NOTIFY_STATISTICS                                "zsLib/eventing/remote-eventing/notify-statistics"
+#define ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_MAX_LISTEN_CLIENTS                               "zsLib/eventing/remote-eventing/max-listen-clients"
+#define ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_LOCAL_CHANNEL_RING_SIZE                          "zsLib/eventing/remote-eventing/local-channel-ring-size-in-bytes"
+#define ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_MAX_RESUMABLE_SESSIONS                           "zsLib/eventing/remote-eventing/max-resumable-sessions"
+#define ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_RECEIVE_WORKER_THREADS                           "zsLib/eventing/remote-eventing/receive-worker-threads"
+#define ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_MAX_RECEIVE_WORKER_QUEUED_EVENTS                 "zsLib/eventing/remote-eventing/max-receive-worker-queued-events"
+#define ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_SPOOL_PATH                                       "zsLib/eventing/remote-eventing/spool-path"
+#define ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_SPOOL_SIZE                                       "zsLib/eventing/remote-eventing/spool-size-in-bytes"
+#define ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_SPOOL_KEYWORDS                                   "zsLib/eventing/remote-eventing/spool-keywords"
+#define ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_RECORD_BUFFER_SIZE                               "zsLib/eventing/remote-eventing/record-buffer-size-in-bytes"
+#define ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_RECORD_INDEX_INTERVAL_SIZE                       "zsLib/eventing/remote-eventing/record-index-interval-in-bytes"
+#define ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_RECORD_INDEX_INTERVAL_TIME                       "zsLib/eventing/remote-eventing/record-index-interval-in-milliseconds"
+
+#define ZSLIB_EVENTING_REMOTE_EVENTING_MAX_DATA_DESCRIPTORS (80)
 
 namespace zsLib
 {
@@ -72,6 +101,8 @@ namespace zsLib
         
         struct ProviderInfo
         {
+          ~ProviderInfo() { delete [] mEnabledEventIDs; }
+
           ProviderHandle mHandle {};
           ProviderHandle mRemoteHandle {};
           bool mSelfRegistered {};
@@ -80,6 +111,15 @@ namespace zsLib
           String mProviderName;
           String mProviderHash;
           KeywordBitmaskType mBitmask {};
+          uint32_t mIndex {};   // dense index announced with the provider (remote party's index for remote providers)
+          bool mLocalIndex {};  // mIndex was handed out by this engine and returns to its free list
+
+          std::atomic<size_t> mDroppedEvents[zsLib::Log::Severity_Last + 1] {};  // dropped before reaching the socket thread
+
+          // event ID bitmap tested by producers; allocated on the first
+          // filter and never replaced until the provider info is deleted
+          std::atomic<bool> mFilterEventIDs {};
+          std::atomic<uint64_t> *mEnabledEventIDs {};
         };
       };
 
@@ -93,7 +133,6 @@ namespace zsLib
       
       interaction IRemoteEventingAsyncDelegate : public IRemoteEventingInternalTypes
       {
-        ZS_DECLARE_TYPEDEF_PTR(CryptoPP::ByteQueue, ByteQueue);
         typedef zsLib::Log::KeywordBitmaskType KeywordBitmaskType;
         
         virtual void onRemoteEventingSubscribeLogger() = 0;
@@ -109,9 +148,21 @@ namespace zsLib
                                                                  ) = 0;
 
         virtual void onRemoteEventingWriteEvent(
-                                                ByteQueuePtr message,
-                                                size_t currentSize
+                                                SecureByteBlockPtr message,
+                                                size_t currentSize,
+                                                size_t subscribeEpoch
                                                 ) = 0;
+        virtual void onRemoteEventingDrainEventRings() = 0;
+        virtual void onRemoteEventingFlushEventBatch() = 0;
+
+        virtual void onRemoteEventingClientStateChanged() = 0;
+        virtual void onRemoteEventingListenerShutdown() = 0;
+
+        virtual void onRemoteEventingLocalChannelReadReady(PUID channelID) = 0;
+        virtual void onRemoteEventingLocalChannelWriteReady(PUID channelID) = 0;
+        virtual void onRemoteEventingLocalChannelClosed(PUID channelID) = 0;
+
+        virtual void onRemoteEventingReceiveWorkerProgress() = 0;
       };
       
       //-----------------------------------------------------------------------
@@ -138,6 +189,15 @@ namespace zsLib
         friend interaction IRemoteEventing;
         ZS_DECLARE_TYPEDEF_PTR(CryptoPP::ByteQueue, ByteQueue);
         ZS_DECLARE_STRUCT_PTR(SubsystemInfo);
+        ZS_DECLARE_STRUCT_PTR(EventRing);
+        ZS_DECLARE_STRUCT_PTR(OutgoingSegment);
+        ZS_DECLARE_STRUCT_PTR(LocalChannel);
+        ZS_DECLARE_STRUCT_PTR(EventSpool);
+        ZS_DECLARE_STRUCT_PTR(TraceRecorder);
+        ZS_DECLARE_STRUCT_PTR(SessionInfo);
+        ZS_DECLARE_STRUCT_PTR(ResumeInfo);
+        ZS_DECLARE_STRUCT_PTR(ReceivedEvent);
+        ZS_DECLARE_STRUCT_PTR(ReceiveWorker);
         typedef zsLib::Log::Level Level;
 
         typedef zsLib::Log::ProviderHandle ProviderHandle;
@@ -157,12 +217,16 @@ namespace zsLib
           MessageType_Goodbye         = 5,
           
           MessageType_Notify          = 8,
+          MessageType_SessionDelta    = 9,
           MessageType_Request         = 16,
           MessageType_RequestAck      = 17,
           
           MessageType_TraceEvent      = 32,
+          MessageType_TraceEventBatch = 33,
+          MessageType_TraceEventCompact = 34,
+          MessageType_TraceEventBacklog = 35,
           
-          MessageType_Last            = MessageType_TraceEvent
+          MessageType_Last            = MessageType_TraceEventBacklog
         };
         
         static const char *toString(MessageTypes messageType);
@@ -179,7 +243,487 @@ namespace zsLib
         typedef std::map<ProviderHandle, ProviderInfo *> ProviderInfoHandleMap;
         typedef std::map<String, SubsystemInfoPtr> SubsystemMap;
         typedef std::map<String, KeywordBitmaskType> KeywordLogLevelMap;
-        
+        typedef std::map<ProviderHandle, KeywordBitmaskType> ProviderKeywordMap;
+        typedef std::map<uint64_t, Level> SubsystemHashLevelMap;
+        typedef std::map<PUID, Level> ClientLevelMap;
+        typedef std::map<String, ClientLevelMap> ClientSubsystemLevelMap;
+        typedef std::map<UUID, size_t> ClientRemoteProviderMap;
+
+        ZS_DECLARE_TYPEDEF_PTR(std::vector<uint64_t>, EventIDBitmap);
+        typedef std::map<ProviderHandle, EventIDBitmapPtr> ProviderEventIDBitmapMap;
+        typedef std::map<String, EventIDSet> ProviderEventIDSetMap;
+
+        struct ClientProviderEvents
+        {
+          bool mSubscribed {};
+          EventIDBitmapPtr mEnabledEvents;  // every event is wanted when null
+        };
+
+        typedef std::map<PUID, ClientProviderEvents> ClientProviderEventsMap;
+
+        struct ProviderEventFilter
+        {
+          ProviderInfo *mProvider {};
+          ClientProviderEventsMap mClients;
+        };
+
+        typedef std::map<ProviderHandle, ProviderEventFilter> ProviderEventFilterMap;
+
+        //---------------------------------------------------------------------
+        // What the listening side had announced to a party when its
+        // connection closed. A party presenting the session token with the
+        // matching epoch and digest in its hello is only sent the
+        // announcements that changed since.
+        struct SessionProvider
+        {
+          UUID mProviderID {};
+          KeywordBitmaskType mBitmask {};
+          EventIDBitmapPtr mEnabledEvents;  // as requested by the party; every event when null
+        };
+
+        typedef std::map<ProviderHandle, SessionProvider> SessionProviderMap;
+        typedef std::set<String> SessionSubsystemSet;
+
+        struct SessionInfo
+        {
+          String mToken;
+          uint32_t mEpoch {};
+          bool mActive {};
+          Time mLastUsed {};
+          SessionProviderMap mProviders;
+          SessionSubsystemSet mSubsystems;
+        };
+
+        typedef std::map<String, SessionInfoPtr> SessionMap;
+
+        //---------------------------------------------------------------------
+        // The connecting side's copy of what the listening side announced,
+        // kept after the connection closes so the next connection to the
+        // same party can resume the session.
+        struct ResumeProvider
+        {
+          UUID mProviderID {};
+          String mProviderName;
+          String mProviderHash;
+          KeywordBitmaskType mBitmask {};
+          uint32_t mIndex {};
+          EventIDBitmapPtr mEnabledEvents;  // as requested from the party; every event when null
+        };
+
+        typedef std::map<ProviderHandle, ResumeProvider> ResumeProviderMap;
+
+        struct ResumeInfo
+        {
+          String mToken;
+          uint32_t mEpoch {};
+          ResumeProviderMap mProviders;   // by remote handle
+          SessionSubsystemSet mSubsystems;
+        };
+
+        typedef std::list<RemoteEventingPtr> RemoteEventingList;
+        ZS_DECLARE_PTR(RemoteEventingList);
+
+        struct EventHeader
+        {
+          Log::Severity mSeverity {Log::Severity_First};
+          Log::Level mLevel {Log::Level_First};
+          USE_EVENT_DESCRIPTOR mDescriptor {};
+          size_t mDescriptorCount {};
+          USE_EVENT_PARAMETER_DESCRIPTOR mParamDescriptors[ZSLIB_EVENTING_REMOTE_EVENTING_MAX_DATA_DESCRIPTORS];
+        };
+
+        // descriptor table entry for the compact encoding; integer parameters
+        // are delta encoded against the previous value in the same entry
+        struct CompactOutgoingDescriptor
+        {
+          SecureByteBlock mHeader;
+          uint64_t mHash {};
+          std::vector<uint64_t> mLastValues;
+        };
+
+        struct CompactIncomingDescriptor
+        {
+          bool mDefined {};
+          EventHeader mHeader;
+          std::vector<uint64_t> mLastValues;
+        };
+
+        struct CompactOutgoingString
+        {
+          uint64_t mHash {};
+          std::string mValue;
+        };
+
+        struct CompactIncomingString
+        {
+          bool mDefined {};
+          std::string mValue;
+        };
+
+        typedef std::map<uint64_t, size_t> CompactProviderIndexMap;
+        typedef std::vector<uint64_t> CompactProviderHandleList;
+        typedef std::map<uint64_t, size_t> CompactDescriptorHashMap;
+        typedef std::vector<CompactOutgoingDescriptor> CompactOutgoingDescriptorList;
+        typedef std::vector<CompactIncomingDescriptor> CompactIncomingDescriptorList;
+        typedef std::map<uint64_t, size_t> CompactStringHashMap;
+        typedef std::vector<CompactOutgoingString> CompactOutgoingStringList;
+        typedef std::vector<CompactIncomingString> CompactIncomingStringList;
+
+        //---------------------------------------------------------------------
+        // Single producer / single consumer ring of packed trace event
+        // messages. Only the owning emitting thread moves mHead and only the
+        // holder of mLock moves mTail. A message never wraps; when it does not
+        // fit at the end of the buffer the producer skips to the start
+        // (leaving a wrap marker if there is room for one).
+        struct EventRing
+        {
+          EventRing(
+                    PUID ownerID,
+                    size_t size
+                    );
+
+          BYTE *reserve(
+                        size_t messageSize,
+                        size_t &outHead
+                        );
+          void commit(size_t head);
+
+          PUID mOwnerID {};
+          SecureByteBlock mBuffer;
+
+          std::atomic<size_t> mHead {};
+          std::atomic<size_t> mTail {};
+
+          std::atomic<size_t> mDroppedEvents {};        // modified by producer only
+          std::atomic<size_t> mDrainDroppedEvents {};   // modified by consumer only, read by any thread
+
+          std::atomic<bool> mOwnerGone {};
+          std::atomic<bool> mThreadGone {};
+        };
+
+        typedef std::list<EventRingPtr> EventRingList;
+        ZS_DECLARE_PTR(EventRingList);
+
+        //---------------------------------------------------------------------
+        // Pooled chunk of outgoing wire data. Data is appended at mFilled and
+        // handed to the socket from mSent so partial writes never require
+        // the data to be copied or re-peeked. A segment only ever belongs to
+        // the outgoing queue of a single connection.
+        struct OutgoingSegment
+        {
+          OutgoingSegment(size_t size) : mBuffer(size) {}
+
+          SecureByteBlock mBuffer;
+          size_t mFilled {};
+          size_t mSent {};
+        };
+
+        typedef std::list<OutgoingSegmentPtr> OutgoingSegmentList;
+
+        //---------------------------------------------------------------------
+        // Bounded ring of packed event messages in a memory mapped file which
+        // holds the events generated while no party is authorized to receive
+        // them (or while the outgoing queue is over budget) until they can be
+        // replayed. Only touched by the socket thread; appending never waits
+        // and overwrites the oldest events once the ring is full.
+        struct EventSpool
+        {
+          ~EventSpool();
+
+          static EventSpoolPtr open(
+                                    const String &path,
+                                    size_t size
+                                    );
+
+          bool append(
+                      const BYTE *message,
+                      size_t messageSize,
+                      size_t &outOverwrittenEvents
+                      );
+          const BYTE *peek(size_t &outMessageSize);
+          void consume(size_t messageSize);
+
+          bool isEmpty() const;
+          size_t getUsedBytes() const;
+
+          String mPath;
+          BYTE *mData {};
+          size_t mCapacity {};
+
+          void *mMapping {};
+          size_t mMappingSize {};
+          void *mFileHandle {};
+          void *mMappingHandle {};
+          int mDescriptor {-1};
+        };
+
+        //---------------------------------------------------------------------
+        // Binary trace file (.zstrace) receiving the messages of every
+        // recorded connection exactly as they arrived. Data is only ever
+        // appended from a large buffer. An index record is written
+        // periodically with the receive time, the frame count and the
+        // provider table of every recorded connection so decoding can start
+        // at any index record; closing appends the table of index records
+        // and a fixed size trailer locating it.
+        struct TraceRecorder
+        {
+          struct IndexEntry
+          {
+            uint64_t mOffset {};
+            uint64_t mTime {};
+            uint64_t mFrames {};
+          };
+
+          typedef std::vector<IndexEntry> IndexEntryList;
+          typedef std::map<uint32_t, std::string> ConnectionStateMap;
+
+          ~TraceRecorder();
+
+          static TraceRecorderPtr open(
+                                       const String &path,
+                                       ElementPtr headerEl,
+                                       size_t bufferSize,
+                                       size_t indexIntervalSize,
+                                       Milliseconds indexIntervalTime
+                                       );
+
+          bool isOpen() const;
+
+          uint32_t beginConnection();
+          void setConnectionState(
+                                  uint32_t connectionID,
+                                  const std::string &state
+                                  );
+          void endConnection(uint32_t connectionID);
+
+          void recordFrame(
+                           uint32_t connectionID,
+                           const BYTE *frame,
+                           size_t frameSize
+                           );
+
+          void close();
+
+          void writeRecord(
+                           BYTE recordType,
+                           const BYTE *prefix,
+                           size_t prefixSize,
+                           const BYTE *data,
+                           size_t dataSize
+                           );
+          void writeIndex(uint64_t time);
+          void append(
+                      const BYTE *data,
+                      size_t size
+                      );
+          void flush();
+
+          mutable Lock mLock;
+          String mPath;
+          FILE *mFile {};
+
+          SecureByteBlock mBuffer;
+          size_t mBuffered {};
+          uint64_t mOffset {};              // file offset of the next appended byte
+
+          size_t mIndexIntervalSize {};
+          uint64_t mIndexIntervalTime {};   // nanoseconds
+          bool mIndexDue {};
+          uint64_t mStartTime {};
+          uint64_t mLastIndexTime {};
+          uint64_t mLastIndexOffset {};
+          uint64_t mFrames {};
+
+          uint32_t mNextConnectionID {};
+          ConnectionStateMap mConnections;
+          IndexEntryList mIndex;
+        };
+
+        // decoding state of a recorded connection while reading a trace
+        struct TraceConnection
+        {
+          bool mEventOrigin {};
+          bool mDenseProviders {};
+          bool mSwapIntegers {};
+          bool mSwapFloats {};
+
+          std::vector<TraceProvider> mProviders;          // by provider index
+          std::vector<bool> mDefined;
+          std::map<uint64_t, size_t> mIndexesByRemoteHandle;
+          std::map<uint64_t, TraceProvider> mOverflowProviders;   // by wire value when beyond the dense table
+        };
+
+        typedef std::map<uint32_t, TraceConnection> TraceConnectionMap;
+
+        //---------------------------------------------------------------------
+        // Same host transport carrying the connection byte stream through a
+        // shared memory segment holding one single producer / single consumer
+        // ring per direction. Data is moved without any system call; a side
+        // is only woken (by futex where available) after arming a read or
+        // write notification because it found its ring empty or full. The
+        // waiter thread turns wake ups into notifications posted to the
+        // connection's queue.
+        struct LocalChannel
+        {
+          ~LocalChannel();
+
+          static LocalChannelPtr create(
+                                        const String &name,
+                                        size_t ringSize
+                                        );
+          static LocalChannelPtr attach(const String &name);
+
+          void startWaiter(IRemoteEventingAsyncDelegatePtr delegate);
+          void close();
+          void unlink();
+
+          bool isPeerAttached() const;
+
+          size_t receive(
+                         BYTE *buffer,
+                         size_t size
+                         );
+          size_t send(
+                      const BYTE *data,
+                      size_t size
+                      );
+
+          bool armRead();   // false if data arrived while arming
+          bool armWrite();  // false if space was freed while arming
+
+          void waitLoop();
+
+          AutoPUID mID;
+          String mName;
+          size_t mSide {};
+          bool mLinked {};
+          bool mOpen {};
+          bool mReady {};   // the local party attached (socket thread only)
+          bool mFailed {};  // the peer corrupted the ring positions (socket thread only)
+          size_t mRingSize {};
+
+          void *mMapping {};
+          size_t mMappingSize {};
+          void *mMappingHandle {};
+          int mDescriptor {-1};
+
+          std::thread mWaiter;
+          std::atomic<bool> mStop {};
+          IRemoteEventingAsyncDelegatePtr mDelegate;
+        };
+
+        //---------------------------------------------------------------------
+        // Socket thread accounting of the outgoing data admitted for a
+        // provider while the outgoing queue is under pressure. The admitted
+        // data restarts whenever the pressure epoch changes.
+        struct ProviderLoadShedding
+        {
+          size_t mEpoch {};
+          size_t mAdmittedData {};
+          size_t mDroppedEvents[zsLib::Log::Severity_Last + 1] {};
+        };
+
+        typedef std::map<ProviderHandle, ProviderLoadShedding> ProviderLoadSheddingMap;
+
+        struct ProviderCounters
+        {
+          String mName;
+          ProviderStatistics mStatistics;
+        };
+
+        typedef std::map<ProviderHandle, ProviderCounters> ProviderCountersMap;
+
+        //---------------------------------------------------------------------
+        // A received event header kept with the bytes it was decoded from so
+        // an event repeating the same header bytes skips decoding and
+        // validating them again.
+        struct CachedEventHeader
+        {
+          bool mDefined {};
+          SecureByteBlock mRaw;
+          EventHeader mHeader;
+        };
+
+        typedef std::vector<CachedEventHeader> CachedEventHeaderList;
+
+        //---------------------------------------------------------------------
+        // Receiving side entry for a provider announced by the remote party,
+        // found by the provider's dense index without any map lookup.
+        struct RemoteProviderEntry
+        {
+          ProviderInfo *mProvider {};
+          ProviderCounters *mReceivedCounters {};
+          CachedEventHeaderList mHeaders;   // by event ID, allocated on the first event
+        };
+
+        typedef std::vector<RemoteProviderEntry> RemoteProviderEntryList;
+        typedef std::map<uint64_t, RemoteProviderEntry> RemoteProviderEntryMap;   // providers beyond the dense table
+        typedef std::vector<uint32_t> ProviderIndexList;
+
+        //---------------------------------------------------------------------
+        // A received event copied out of the incoming buffer so a receive
+        // worker can write it to the eventing listeners while the socket
+        // thread continues with the next frame.
+        struct ReceivedEvent
+        {
+          ProviderHandle mHandle {};
+          EventHeader mHeader;
+          USE_EVENT_DATA_DESCRIPTOR mDataDescriptors[ZSLIB_EVENTING_REMOTE_EVENTING_MAX_DATA_DESCRIPTORS];
+          bool mHasOrigin {};
+          EventOrigin mOrigin;
+          std::vector<BYTE> mData;
+          size_t mBarrier {};               // non zero marks a barrier instead of an event
+        };
+
+        typedef std::list<ReceivedEventPtr> ReceivedEventList;
+
+        //---------------------------------------------------------------------
+        // Writes received events to the eventing listeners on its own thread
+        // in the order they were queued. Queuing never blocks; once the
+        // maximum number of events is queued the reader pauses until the
+        // worker reports it has drained to half. While paused no frame of any
+        // type is read, so a listener slower than the remote party delays its
+        // control frames (provider announcements, logging requests, goodbye)
+        // just like its events. Barriers tell the owner when everything
+        // queued before them has been written.
+        struct ReceiveWorker
+        {
+          ReceiveWorker(
+                        IRemoteEventingAsyncDelegatePtr delegate,
+                        size_t maxQueued,
+                        size_t passedBarrier
+                        );
+          ~ReceiveWorker();
+
+          ReceivedEventPtr acquire();
+          bool queue(ReceivedEventPtr event);
+          void queueBarrier(size_t barrier);
+          size_t getPassedBarrier() const;
+          bool isPaused() const;
+          void stop();
+          void join();
+
+          void run();
+
+          IRemoteEventingAsyncDelegatePtr mDelegate;  // weak
+          size_t mMaxQueued {};
+
+          mutable Lock mLock;
+          std::condition_variable mCondition;
+          ReceivedEventList mPending;
+          ReceivedEventList mFree;          // recycled events keep their data capacity
+          size_t mPassedBarrier {};
+          bool mPaused {};
+          bool mStop {};
+
+          std::thread mThread;
+        };
+
+        typedef std::vector<ReceiveWorkerPtr> ReceiveWorkerList;
+        typedef std::pair<size_t, ProviderInfo *> RetiredProviderPair;
+        typedef std::list<RetiredProviderPair> RetiredProviderList;
+        typedef std::map<ProviderHandle, uint32_t> ProviderIndexMap;
+
       public:
         RemoteEventing(
                        const make_private &,
@@ -214,6 +758,36 @@ namespace zsLib
                                                  Seconds maxWaitToBindTimeInSeconds
                                                  );
 
+        static RemoteEventingPtr connectToLocal(
+                                                IRemoteEventingDelegatePtr connectionDelegate,
+                                                const char *localName,
+                                                const char *connectionSharedSecret
+                                                );
+
+        static RemoteEventingPtr listenForLocal(
+                                                IRemoteEventingDelegatePtr connectionDelegate,
+                                                const char *localName,
+                                                const char *connectionSharedSecret
+                                                );
+
+        static bool getCurrentEventOrigin(EventOrigin &outOrigin);
+        static FramePoolStatistics getFramePoolStatistics();
+
+        static bool readTraceIndex(
+                                   const BYTE *trace,
+                                   size_t traceSize,
+                                   ElementPtr &outHeaderEl,
+                                   TraceIndex &outIndex
+                                   );
+
+        static size_t decodeTrace(
+                                  const BYTE *trace,
+                                  size_t traceSize,
+                                  uint64_t startOffset,
+                                  uint64_t endOffset,
+                                  IRemoteEventingTraceDelegate &delegate
+                                  );
+
         virtual PUID getID() const override { return mID; }
 
         virtual void shutdown() override;
@@ -225,6 +799,20 @@ namespace zsLib
                                     Level level
                                     ) override;
 
+        virtual void setRemoteProviderEvents(
+                                             const char *remoteProviderName,
+                                             const EventIDSet &enabledEventIDs
+                                             ) override;
+
+        virtual Statistics getStatistics() const override;
+        virtual bool getRemoteStatistics(Statistics &outStatistics) const override;
+
+        virtual bool startRecording(
+                                    const char *path,
+                                    ElementPtr headerEl
+                                    ) override;
+        virtual void stopRecording() override;
+
         //---------------------------------------------------------------------
         #pragma mark
         #pragma mark RemoteEventing => IWakeDelegate
@@ -305,9 +893,21 @@ namespace zsLib
                                                                  ) override;
 
         virtual void onRemoteEventingWriteEvent(
-                                                ByteQueuePtr message,
-                                                size_t currentSize
+                                                SecureByteBlockPtr message,
+                                                size_t currentSize,
+                                                size_t subscribeEpoch
                                                 ) override;
+        virtual void onRemoteEventingDrainEventRings() override;
+        virtual void onRemoteEventingFlushEventBatch() override;
+
+        virtual void onRemoteEventingClientStateChanged() override;
+        virtual void onRemoteEventingListenerShutdown() override;
+
+        virtual void onRemoteEventingLocalChannelReadReady(PUID channelID) override;
+        virtual void onRemoteEventingLocalChannelWriteReady(PUID channelID) override;
+        virtual void onRemoteEventingLocalChannelClosed(PUID channelID) override;
+
+        virtual void onRemoteEventingReceiveWorkerProgress() override;
         
       protected:
         //---------------------------------------------------------------------
@@ -320,10 +920,14 @@ namespace zsLib
         
         bool isShuttingDown() const       { return State_ShuttingDown == mState; }
         bool isShutdown() const           { return State_Shutdown == mState; }
-        bool isListeningMode() const      { return 0 != mListenPort; }
-        bool isConnectingMode() const     { return 0 == mListenPort; }
+        bool isListeningMode() const      { return (0 != mListenPort) || (mLocalListen); }
+        bool isConnectingMode() const     { return !isListeningMode(); }
+        bool isLocalMode() const          { return mLocalName.hasData(); }
         SocketPtr getActiveSocket() const { if (isListeningMode()) return mAcceptedSocket; return mConnectSocket; }
         bool isAuthorized() const         { return MessageType_Welcome == mHandshakeState; }
+        bool isListener() const           { return (0 != mListenPort) && (!mIsClient); }
+        bool hasSentWelcome() const       { return (isAuthorized()) || ((isListeningMode()) && (MessageType_ChallengeReply == mHandshakeState)); }
+        IRemoteEventingPtr getPublicConnection() const;
 
         void disconnect();
         void cancel();
@@ -335,6 +939,8 @@ namespace zsLib
         bool stepSocketConnect();
         bool stepWaitConnected();
         bool stepHello();
+
+        bool stepLocalChannel();
         
         bool stepNotifyTimer();
         bool stepAuthorized();
@@ -343,7 +949,188 @@ namespace zsLib
         void resetConnection();
         void prepareNewConnection();
         void readIncomingMessage();
+        void readActiveSocket();
+        size_t getMaxIncomingMessageSize() const;
         void sendOutgoingData();
+        void readLocalChannel();
+        void closeLocalChannel();
+
+        RemoteEventingPtr createClient(
+                                       SocketPtr socket,
+                                       const IPAddress &remoteIP
+                                       );
+        size_t pruneClients();
+        bool forwardListenerEvent(
+                                  const RemoteEventingList &clients,
+                                  const BYTE *message,
+                                  size_t messageSize
+                                  );
+        bool fanOutEvent(
+                         const RemoteEventingList &clients,
+                         const BYTE *message,
+                         size_t messageSize,
+                         bool backlog = false
+                         );
+        bool isSubscribedProvider(ProviderHandle handle) const;
+        bool isReplayTarget() const;
+        bool forwardOutgoingEvent(
+                                  const BYTE *message,
+                                  size_t messageSize,
+                                  bool anySubscribed,
+                                  bool backlog
+                                  );
+        bool isForwardedEventWanted(
+                                    const BYTE *message,
+                                    size_t messageSize,
+                                    bool anySubscribed
+                                    ) const;
+        void completeForwardedEvents(bool batchNow);
+        void noteClientRemoteProvider(
+                                      const UUID &providerID,
+                                      bool registered
+                                      );
+        bool isClientRemoteProvider(const UUID &providerID) const;
+        void noteRemoteProviderWithListener(
+                                            const UUID &providerID,
+                                            bool registered
+                                            );
+        Level setClientSubsystemLevel(
+                                      PUID clientID,
+                                      const String &subsystemName,
+                                      Level level
+                                      );
+        void removeClientSubsystemLevels(PUID clientID);
+        void updateProviderEventFilter(ProviderInfo *provider);
+        void resetProviderEventFilters();
+        void setClientProviderEvents(
+                                     PUID clientID,
+                                     ProviderInfo *provider,
+                                     bool subscribed,
+                                     EventIDBitmapPtr enabledEvents
+                                     );
+        void removeClientProviderEvents(PUID clientID);
+        SessionInfoPtr claimSession(
+                                    const String &token,
+                                    uint32_t epoch,
+                                    uint64_t digest,
+                                    bool &outResumed
+                                    );
+        void releaseSession(
+                            SessionInfoPtr session,
+                            SessionProviderMap &ioProviders,
+                            SessionSubsystemSet &ioSubsystems
+                            );
+        void closeSession();
+        String getResumeKey() const;
+        void saveResumeInfo();
+        void restoreResumeInfo();
+
+        EventRing *getThreadEventRing();
+        void drainEventRings();
+        void discardEventRings();
+        size_t getTotalDroppedEvents() const;
+        size_t getListenerDroppedEvents() const;
+        void noteDroppedEvent(EventRing *ring);
+        void noteDroppedEvent(
+                              ProviderInfo *provider,
+                              Log::Severity severity
+                              );
+        bool admitOutgoingEvent(
+                                const BYTE *message,
+                                size_t messageSize
+                                );
+        ElementPtr getDroppedEventsByProvider() const;
+
+        void openSpool();
+        bool isSpoolOnlyEvent(const BYTE *message) const;
+        bool shouldSpoolEvent(size_t messageSize) const;
+        bool spoolEvent(
+                        const BYTE *message,
+                        size_t messageSize
+                        );
+        bool replaySpool();
+        bool replayListenerSpool();
+
+        static bool decodeTraceConnection(
+                                          const BYTE *state,
+                                          size_t stateSize,
+                                          bool swapByteOrder,
+                                          TraceConnection &outConnection
+                                          );
+        static size_t decodeTraceFrame(
+                                       TraceConnection &connection,
+                                       const BYTE *frame,
+                                       size_t frameSize,
+                                       uint64_t receiveTime,
+                                       SecureByteBlock &ioScratch,
+                                       IRemoteEventingTraceDelegate &delegate
+                                       );
+
+        bool useCompactEvents() const     { return (mUseCompactEvents) && (!mConnectionRecorder); }
+        void beginRecordedConnection();
+        void noteRecordedConnectionState();
+        void endRecordedConnection();
+
+        void queueOutgoingEvent(
+                                const BYTE *message,
+                                size_t messageSize,
+                                bool backlog = false
+                                );
+        void encodeOutgoingEvent(
+                                 const BYTE *message,
+                                 size_t messageSize,
+                                 bool backlog
+                                 );
+        void noteQueueHighWater();
+        void flushEventBatch();
+        void getOutgoingEventOrigin(
+                                    const BYTE *originPos,
+                                    EventOrigin &outOrigin
+                                    ) const;
+        void putOutgoingEventOrigin(
+                                    OutgoingSegmentList &segments,
+                                    const EventOrigin &origin
+                                    );
+        void queueOutgoingCompactEvent(
+                                       const EventOrigin &origin,
+                                       const BYTE *handlePos,
+                                       const BYTE *headerPos,
+                                       size_t headerSize,
+                                       size_t descriptorCount,
+                                       const BYTE *dataPos,
+                                       size_t dataSize
+                                       );
+        size_t internCompactString(
+                                   BYTE * &ioPos,
+                                   const BYTE *value,
+                                   size_t size
+                                   );
+        void setEventOriginNegotiated(bool negotiated);
+        void resetCompactEvents(bool active);
+        uint64_t getOutgoingProvider(uint64_t handle);
+        const BYTE *getBigEndianEventData(
+                                          const BYTE *dataPos,
+                                          size_t dataSize,
+                                          size_t descriptorCount
+                                          );
+
+        OutgoingSegmentPtr acquireOutgoingSegment();
+        void releaseOutgoingSegments(OutgoingSegmentList &segments);
+        void putOutgoing(
+                         OutgoingSegmentList &segments,
+                         const BYTE *data,
+                         size_t size
+                         );
+        void putOutgoingWord32(
+                               OutgoingSegmentList &segments,
+                               CryptoPP::word32 value
+                               );
+        size_t writeOutgoing(
+                             SocketPtr socket,
+                             bool &outWouldBlock
+                             );
+        size_t writeOutgoingLocal(bool &outWouldBlock);
+        void consumeOutgoing(size_t written);
 
         void sendData(
                       MessageTypes messageType,
@@ -365,11 +1152,13 @@ namespace zsLib
 
         void handleHandshakeMessage(
                                     MessageTypes messageType,
-                                    SecureByteBlock &buffer
+                                    BYTE *buffer,
+                                    size_t bufferSize
                                     );
         void handleAuthorizedMessage(
                                      MessageTypes messageType,
-                                     SecureByteBlock &buffer
+                                     BYTE *buffer,
+                                     size_t bufferSize
                                      );
         
         void handleHello(const ElementPtr &rootEl);
@@ -382,14 +1171,95 @@ namespace zsLib
         void handleNotifyRemoteSubsystem(const ElementPtr &rootEl);
         void handleNotifyRemoteProvider(const ElementPtr &rootEl);
         void handleNotifyRemoteProviderKeywordLogging(const ElementPtr &rootEl);
+        void handleSessionDelta(
+                                BYTE *buffer,
+                                size_t bufferSize
+                                );
         void handleRequest(const ElementPtr &rootEl);
         void handleRequestAck(const ElementPtr &rootEl);
         
-        void handleEvent(SecureByteBlock &buffer);
+        void handleEvent(
+                         BYTE *buffer,
+                         size_t bufferSize,
+                         bool backlog = false
+                         );
+        void handleEventBatch(
+                              BYTE *buffer,
+                              size_t bufferSize
+                              );
+        void handleEventCompact(
+                                BYTE *buffer,
+                                size_t bufferSize
+                                );
+
+        void registerRemoteSubsystem(const String &subsystemName);
+        void registerRemoteProvider(
+                                    ProviderHandle remoteHandle,
+                                    const UUID &providerID,
+                                    const String &providerName,
+                                    const String &providerHash,
+                                    uint32_t index
+                                    );
+        void unregisterRemoteProvider(ProviderHandle remoteHandle);
+        void noteRemoteProviderKeywords(
+                                        ProviderHandle remoteHandle,
+                                        KeywordBitmaskType bitmask
+                                        );
+
+        RemoteProviderEntry *findRemoteEventProvider(uint64_t remoteProvider);
+        uint64_t getRemoteProviderWireValue(const ProviderInfo *provider) const;
+        static bool decodeEventHeader(
+                                      BYTE * &ioPos,
+                                      size_t &ioRemaining,
+                                      EventHeader &outHeader
+                                      );
+        const EventHeader *decodeCachedEventHeader(
+                                                   RemoteProviderEntry *entry,
+                                                   BYTE * &ioPos,
+                                                   size_t &ioRemaining,
+                                                   EventHeader &scratchHeader
+                                                   );
+        static bool decodeEventData(
+                                    BYTE * &ioPos,
+                                    size_t &ioRemaining,
+                                    const EventHeader &header,
+                                    bool swapIntegers,
+                                    bool swapFloats,
+                                    USE_EVENT_DATA_DESCRIPTOR *outDataDescriptors
+                                    );
+        static bool decodeEventOrigin(
+                                      BYTE * &ioPos,
+                                      size_t &ioRemaining,
+                                      EventOrigin &outOrigin
+                                      );
+        void deliverRemoteEvent(
+                                RemoteProviderEntry *entry,
+                                const EventHeader &header,
+                                const USE_EVENT_DATA_DESCRIPTOR *dataDescriptors,
+                                const EventOrigin *origin,
+                                size_t recordSize,
+                                uint64_t decodeStartTime
+                                );
+        void dispatchRemoteEvent(
+                                 ProviderInfo *provider,
+                                 const EventHeader &header,
+                                 const USE_EVENT_DATA_DESCRIPTOR *dataDescriptors,
+                                 const EventOrigin *origin
+                                 );
+        void retireRemoteProvider(ProviderInfo *provider);
+        void releaseRetiredRemoteProviders();
+        void resumeReceiving();
+        bool stopReceiveWorkers();
         
         void sendWelcome();
+        void sendSessionDelta();
         void sendNotify();
         void requestSetRemoteSubsystemLevel(SubsystemInfoPtr info);
+        void requestSetRemoteEventProviderEvents(
+                                                 const String &providerName,
+                                                 const EventIDSet &enabledEventIDs
+                                                 );
+        bool isRemoteProviderRegistered(const String &providerName) const;
         void requestSetRemoteEventProviderLogging(
                                                   const String &providerName,
                                                   KeywordBitmaskType bitmask
@@ -424,6 +1294,29 @@ namespace zsLib
         size_t mMaxQueuedAsyncDataBeforeEventsDropped {};
         size_t mMaxQueuedOutgoingDataBeforeEventsDropped {};
         bool mUseIPv6 {};
+        bool mUseEventRings {};
+        size_t mEventRingSize {};
+        bool mUseEventBatches {};
+        size_t mMaxEventBatchSize {};
+        size_t mOutgoingSegmentSize {};
+        size_t mMaxPooledOutgoingSegments {};
+        size_t mIncomingBufferSize {};
+        bool mUseCompactEvents {};
+        std::atomic<bool> mUseTSCClock {};
+        bool mUseLoadShedding {};
+        size_t mMaxProviderSharePercent {};
+        bool mNotifyStatistics {};
+        size_t mMaxListenClients {};
+        size_t mLocalChannelRingSize {};
+        size_t mMaxResumableSessions {};
+        size_t mReceiveWorkerThreads {};
+        size_t mMaxReceiveWorkerQueuedEvents {};
+        String mSpoolPath;
+        size_t mSpoolSize {};
+        KeywordBitmaskType mSpoolKeywords {};
+        size_t mRecordBufferSize {};
+        size_t mRecordIndexIntervalSize {};
+        Milliseconds mRecordIndexIntervalTime {};
         
         EventingAtomIndex mEventingAtomIndex {};
 
@@ -442,13 +1335,28 @@ namespace zsLib
 
         SocketPtr mConnectSocket;
         bool mConnected {false};
+
+        String mLocalName;
+        bool mLocalListen {};
+        LocalChannelPtr mLocalChannel;
+
+        EventSpoolPtr mSpool;             // owned by the listener (or the connecting side)
+        AutoPUID mSpoolSubscriptionID;    // enables the providers at the spool keywords
+        uint64_t mSpooledEvents {};
+        uint64_t mReplayedEvents {};
+
+        TraceRecorderPtr mRecorder;           // owned by the listener (or the connecting side)
+        TraceRecorderPtr mConnectionRecorder; // recording the current connection
+        uint32_t mRecordConnectionID {};
         
         ITimerPtr mNotifyTimer;
         size_t mAnnouncedLocalDropped {};
         size_t mAnnouncedRemoteDropped {};
 
-        ByteQueue mIncomingQueue;
-        ByteQueue mOutgoingQueue;
+        SecureByteBlock mIncomingBuffer;
+        size_t mIncomingFilled {};
+        OutgoingSegmentList mOutgoingSegments;
+        OutgoingSegmentList mOutgoingSegmentPool;
         bool mWriteReady {false};
         
         MessageTypes mHandshakeState {MessageType_First};
@@ -460,10 +1368,66 @@ namespace zsLib
         
         bool mFlipEndianInt {false};
         bool mFlipEndianFloat {false};
+
+        bool mRemoteUsesNativeByteOrder {false};
+        bool mSwapOutgoingScalars {false};
+        bool mSwapIncomingIntegers {false};
+        bool mSwapIncomingFloats {false};
+        SecureByteBlock mBigEndianScratch;
+
+        bool mRemoteSupportsEventBatches {false};
+        OutgoingSegmentList mEventBatchSegments;
+        size_t mEventBatchSize {};
+        uint64_t mEventBatchProviderHandle {};
+        SecureByteBlock mEventBatchHeader;
+        bool mEventBatchFlushPending {false};
+
+        bool mEventOriginNegotiated {false};
+        std::atomic<size_t> mEventOriginParties {};     // connections (and the spool) receiving origins from events written here
+        bool mRemoteSupportsEventBacklog {false};
+
+        bool mRemoteSupportsDenseProviders {false};
+        uint32_t mNextProviderIndex {};
+        ProviderIndexList mFreeProviderIndexes;         // released by unregistered providers
+        ProviderIndexMap mLocalAnnouncedProviderIndexes;
+        uint64_t mLastOutgoingProviderHandle {};
+        uint32_t mLastOutgoingProviderIndex {};
+        RemoteProviderEntryList mRemoteProviders;
+        ProviderIndexList mFreeRemoteProviderIndexes;   // table slots to reuse when the wire carries handles
+        RemoteProviderEntryMap mOverflowRemoteProviders;
+        ReceiveWorkerList mReceiveWorkers;  // started with the first received event
+        ReceiveWorkerList mStoppingReceiveWorkers;
+        bool mReceivePaused {};
+        size_t mReceiveBarrier {};
+        RetiredProviderList mRetiredRemoteProviders;  // writers unregistered once their barrier passed
+
+        String mPresentedSessionToken;
+        uint32_t mPresentedSessionEpoch {};
+        uint64_t mPresentedSessionDigest {};
+        SessionInfoPtr mSession;          // listening side session of the connected party
+        ResumeInfoPtr mResume;            // connecting side session being presented
+        String mSessionToken;             // connecting side session issued in the welcome
+        uint32_t mSessionEpoch {};
+
+        bool mRemoteSupportsCompactEvents {false};
+        uint64_t mCompactOutgoingLastTimestamp {};
+        uint64_t mCompactIncomingLastTimestamp {};
+        SecureByteBlock mCompactScratch;
+        CompactProviderIndexMap mCompactOutgoingProviders;
+        CompactDescriptorHashMap mCompactOutgoingDescriptorsByHash;
+        CompactOutgoingDescriptorList mCompactOutgoingDescriptors;
+        size_t mCompactNextOutgoingDescriptor {};
+        CompactStringHashMap mCompactOutgoingStringsByHash;
+        CompactOutgoingStringList mCompactOutgoingStrings;
+        size_t mCompactNextOutgoingString {};
+        CompactProviderHandleList mCompactIncomingProviders;
+        CompactIncomingDescriptorList mCompactIncomingDescriptors;
+        CompactIncomingStringList mCompactIncomingStrings;
         
         SubsystemMap mLocalSubsystems;
         SubsystemMap mRemoteSubsystems;
         SubsystemMap mSetRemoteSubsystemsLevels;
+        ProviderEventIDSetMap mSetRemoteProviderEvents;
 
         ProviderInfoUUIDMap mLocalAnnouncedProviders;
         ProviderInfoUUIDMap mRemoteRegisteredProvidersByUUID;
@@ -473,13 +1437,57 @@ namespace zsLib
 
         ProviderInfoSet mCleanUpProviderInfos;
 
-        mutable RecursiveLock mAsyncSelfLock;
-        IRemoteEventingAsyncDelegatePtr mAsyncSelf;
+        bool mIsClient {};
+        RemoteEventingWeakPtr mParentWeak;
+        PUID mParentID {};
+        size_t mParentDroppedEventsBaseline {};
+        RemoteEventingListPtr mClients;   // contents are non-mutable
+        ProviderKeywordMap mRequestedRemoteProviderKeywords;
+        ProviderEventIDBitmapMap mRequestedRemoteProviderEvents;
+        SubsystemHashLevelMap mRequestedSubsystemLevels;
+
+        mutable Lock mClientSharedLock;
+        ClientRemoteProviderMap mClientRemoteProviders;
+        ClientSubsystemLevelMap mClientSubsystemLevels;
+        ProviderEventFilterMap mClientProviderEvents;
+        SessionMap mSessions;
+
+        // producers never lock; they post through the weak proxy while the
+        // subscribe epoch is non-zero and the epoch travels with every event
+        // so events still in flight after unsubscribing are discarded
+        IRemoteEventingAsyncDelegatePtr mAsyncSelf;   // holds the subscription (queue thread only)
+        IRemoteEventingAsyncDelegatePtr mAsyncNotify; // weak and never changes after init
+        std::atomic<size_t> mSubscribeEpoch {};
+        size_t mLastSubscribeEpoch {};
 
         std::atomic<size_t> mTotalDroppedEvents {};
         std::atomic<size_t> mOutstandingEvents {};
         std::atomic<size_t> mEventDataInAsyncQueue {};
         std::atomic<size_t> mEventDataInOutgoingQueue {};
+
+        ProviderLoadSheddingMap mProviderLoadShedding;
+        size_t mLoadSheddingEpoch {};
+
+        std::atomic<uint64_t> mDroppedEventsByReason[DropReason_Last + 1] {};
+        ProviderCountersMap mSentCounters;
+        ProviderCountersMap mReceivedCounters;
+        size_t mAsyncQueueBytesHighWater {};
+        size_t mOutgoingQueueBytesHighWater {};
+        uint64_t mSendCalls {};
+        uint64_t mSendWouldBlockCalls {};
+        uint64_t mReceiveCalls {};
+        TimeHistogram mEncodeTime;
+        TimeHistogram mDecodeTime;
+
+        bool mHasRemoteStatistics {};
+        Statistics mRemoteStatistics;
+
+        mutable Lock mEventRingsLock;
+        EventRingListPtr mEventRings;     // contents are non-mutable
+        std::atomic<bool> mEventRingsActive {};
+        std::atomic<bool> mEventRingDrainPending {};
+        size_t mRetiredEventRingDroppedEvents {};
+        size_t mEventRingDroppedEventsBaseline {};
       };
     }
   }
@@ -488,13 +1496,22 @@ namespace zsLib
 ZS_DECLARE_PROXY_BEGIN(zsLib::eventing::internal::IRemoteEventingAsyncDelegate)
 ZS_DECLARE_PROXY_TYPEDEF(zsLib::eventing::internal::IRemoteEventingInternalTypes::ProviderInfo, ProviderInfo)
 ZS_DECLARE_PROXY_TYPEDEF(zsLib::eventing::internal::IRemoteEventingAsyncDelegate::KeywordBitmaskType, KeywordBitmaskType)
-ZS_DECLARE_PROXY_TYPEDEF(zsLib::eventing::internal::IRemoteEventingAsyncDelegate::ByteQueuePtr, ByteQueuePtr)
+ZS_DECLARE_PROXY_TYPEDEF(zsLib::eventing::SecureByteBlockPtr, SecureByteBlockPtr)
 ZS_DECLARE_PROXY_TYPEDEF(std::size_t, size_t)
+ZS_DECLARE_PROXY_TYPEDEF(zsLib::PUID, PUID)
 ZS_DECLARE_PROXY_METHOD_0(onRemoteEventingSubscribeLogger)
 ZS_DECLARE_PROXY_METHOD_0(onRemoteEventingUnsubscribeLogger)
 ZS_DECLARE_PROXY_METHOD_1(onRemoteEventingNewSubsystem, const char *)
 ZS_DECLARE_PROXY_METHOD_1(onRemoteEventingProviderRegistered, ProviderInfo *)
 ZS_DECLARE_PROXY_METHOD_1(onRemoteEventingProviderUnregistered, ProviderInfo *)
 ZS_DECLARE_PROXY_METHOD_2(onRemoteEventingProviderLoggingStateChanged, ProviderInfo *, KeywordBitmaskType)
-ZS_DECLARE_PROXY_METHOD_2(onRemoteEventingWriteEvent, ByteQueuePtr, size_t)
+ZS_DECLARE_PROXY_METHOD_3(onRemoteEventingWriteEvent, SecureByteBlockPtr, size_t, size_t)
+ZS_DECLARE_PROXY_METHOD_0(onRemoteEventingDrainEventRings)
+ZS_DECLARE_PROXY_METHOD_0(onRemoteEventingFlushEventBatch)
+ZS_DECLARE_PROXY_METHOD_0(onRemoteEventingClientStateChanged)
+ZS_DECLARE_PROXY_METHOD_0(onRemoteEventingListenerShutdown)
+ZS_DECLARE_PROXY_METHOD_1(onRemoteEventingLocalChannelReadReady, PUID)
+ZS_DECLARE_PROXY_METHOD_1(onRemoteEventingLocalChannelWriteReady, PUID)
+ZS_DECLARE_PROXY_METHOD_1(onRemoteEventingLocalChannelClosed, PUID)
+ZS_DECLARE_PROXY_METHOD_0(onRemoteEventingReceiveWorkerProgress)
 ZS_DECLARE_PROXY_END()
@@ -0,0 +1,999 @@
+/*
+
+Copyright (c) 2016, Robin Raymond
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+*/
+
+#include "RemoteEventingTester.h"
+#include "testing.h"
+
+#include <zsLib/eventing/IHelper.h>
+
+#include <zsLib/IMessageQueueManager.h>
+#include <zsLib/Numeric.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <cwchar>
+
+#define ZSLIB_EVENTING_TEST_PROVIDER_NAME_PREFIX "zsLib-eventing-test-provider-"
+
+// never bound; a listener is only told apart by having a listen port
+#define ZSLIB_EVENTING_TEST_LISTEN_PORT (0xFFFF)
+
+namespace zsLib
+{
+  namespace eventing
+  {
+    namespace test
+    {
+      //-----------------------------------------------------------------------
+      static bool isLittleEndianHost()
+      {
+        uint16_t value = 1;
+        return 1 == *reinterpret_cast<const BYTE *>(&value);
+      }
+
+      //-----------------------------------------------------------------------
+      static bool isScalarType(EventParameterTypes type)
+      {
+        switch (type) {
+          case EventParameterType_Boolean:
+          case EventParameterType_UnsignedInteger:
+          case EventParameterType_SignedInteger:
+          case EventParameterType_Pointer:
+          case EventParameterType_FloatingPoint:  return true;
+          default:                                break;
+        }
+        return false;
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark TestProvider
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      TestProvider TestProvider::create(uint32_t index)
+      {
+        // every provider registered with the eventing writers must be unique within the process
+        static std::atomic<uint64_t> counter {};
+        uint64_t unique = ++counter;
+
+        char uuid[64] {};
+        snprintf(uuid, sizeof(uuid), "c8d54f0a-1e6b-4b8e-9a41-%012llx", static_cast<unsigned long long>(unique));
+
+        TestProvider result;
+        result.mHandle = static_cast<zsLib::Log::ProviderHandle>(0x10000 + unique);
+        result.mIndex = index;
+        result.mProviderID = Numeric<UUID>(String(uuid));
+        result.mProviderName = String(ZSLIB_EVENTING_TEST_PROVIDER_NAME_PREFIX) + string(unique);
+        result.mProviderHash = "hash-" + string(unique);
+        return result;
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark TestEvent
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      TestEvent TestEvent::create(
+                                  const TestProvider &provider,
+                                  uint16_t eventID,
+                                  uint64_t timestamp
+                                  )
+      {
+        TestEvent result;
+        result.mHandle = provider.mHandle;
+        result.mProviderName = provider.mProviderName;
+        result.mDescriptor.Id = eventID;
+        result.mDescriptor.Version = 1;
+        result.mDescriptor.Channel = 0x10;
+        result.mDescriptor.Level = 4;
+        result.mDescriptor.Opcode = 0;
+        result.mDescriptor.Task = 7;
+        result.mDescriptor.Keyword = 1;
+
+        result.mHasOrigin = true;
+        result.mOrigin.mTimestamp = timestamp;
+        result.mOrigin.mThreadID = 0x1234;
+        result.mOrigin.mCPU = 3;
+        return result;
+      }
+
+      //-----------------------------------------------------------------------
+      TestEvent TestEvent::capture(
+                                   zsLib::Log::Severity severity,
+                                   zsLib::Log::Level level,
+                                   EVENT_DESCRIPTOR_HANDLE descriptor,
+                                   EVENT_PARAMETER_DESCRIPTOR_HANDLE paramDescriptor,
+                                   EVENT_DATA_DESCRIPTOR_HANDLE dataDescriptor,
+                                   size_t dataDescriptorCount
+                                   )
+      {
+        TestEvent result;
+        result.mSeverity = severity;
+        result.mLevel = level;
+        result.mDescriptor = *descriptor;
+
+        for (size_t index = 0; index < dataDescriptorCount; ++index) {
+          TestParameter param;
+          param.mType = static_cast<EventParameterTypes>(paramDescriptor[index].Type);
+          param.mNull = ((0 == dataDescriptor[index].Ptr) || (0 == dataDescriptor[index].Size));
+          if (!param.mNull) {
+            param.mValue.assign(reinterpret_cast<const char *>(dataDescriptor[index].Ptr), static_cast<size_t>(dataDescriptor[index].Size));
+          }
+          result.mParameters.push_back(param);
+        }
+        return result;
+      }
+
+      //-----------------------------------------------------------------------
+      void TestEvent::addInteger(
+                                 EventParameterTypes type,
+                                 uint64_t value,
+                                 size_t size
+                                 )
+      {
+        TestParameter param;
+        param.mType = type;
+
+        switch (size) {
+          case sizeof(uint8_t):   { uint8_t sized = static_cast<uint8_t>(value); param.mValue.assign(reinterpret_cast<const char *>(&sized), sizeof(sized)); break; }
+          case sizeof(uint16_t):  { uint16_t sized = static_cast<uint16_t>(value); param.mValue.assign(reinterpret_cast<const char *>(&sized), sizeof(sized)); break; }
+          case sizeof(uint32_t):  { uint32_t sized = static_cast<uint32_t>(value); param.mValue.assign(reinterpret_cast<const char *>(&sized), sizeof(sized)); break; }
+          default:                { param.mValue.assign(reinterpret_cast<const char *>(&value), sizeof(value)); break; }
+        }
+        mParameters.push_back(param);
+      }
+
+      //-----------------------------------------------------------------------
+      void TestEvent::addFloat(double value)
+      {
+        TestParameter param;
+        param.mType = EventParameterType_FloatingPoint;
+        param.mValue.assign(reinterpret_cast<const char *>(&value), sizeof(value));
+        mParameters.push_back(param);
+      }
+
+      //-----------------------------------------------------------------------
+      void TestEvent::addString(const char *value)
+      {
+        TestParameter param;
+        param.mType = EventParameterType_AString;
+        param.mValue.assign(value, strlen(value) + 1);
+        mParameters.push_back(param);
+      }
+
+      //-----------------------------------------------------------------------
+      void TestEvent::addWideString(const wchar_t *value)
+      {
+        TestParameter param;
+        param.mType = EventParameterType_WString;
+        param.mValue.assign(reinterpret_cast<const char *>(value), (wcslen(value) + 1) * sizeof(wchar_t));
+        mParameters.push_back(param);
+      }
+
+      //-----------------------------------------------------------------------
+      void TestEvent::addBinary(
+                                const void *value,
+                                size_t size
+                                )
+      {
+        TestParameter param;
+        param.mType = EventParameterType_Binary;
+        param.mValue.assign(reinterpret_cast<const char *>(value), size);
+        mParameters.push_back(param);
+      }
+
+      //-----------------------------------------------------------------------
+      void TestEvent::addNull(EventParameterTypes type)
+      {
+        TestParameter param;
+        param.mType = type;
+        param.mNull = true;
+        mParameters.push_back(param);
+      }
+
+      //-----------------------------------------------------------------------
+      std::string TestEvent::pack() const
+      {
+        // same layout as the events packed by the writing thread
+        std::string result;
+        appendBE32(result, 0);
+        appendBE32(result, static_cast<uint32_t>(internal::RemoteEventing::MessageType_TraceEvent));
+
+        appendBE64(result, mOrigin.mTimestamp);
+        appendBE64(result, mOrigin.mThreadID);
+        appendBE32(result, mOrigin.mCPU);
+
+        appendBE64(result, static_cast<uint64_t>(mHandle));
+
+        appendBE16(result, static_cast<uint16_t>(mSeverity));
+        appendBE16(result, static_cast<uint16_t>(mLevel));
+        appendBE16(result, mDescriptor.Id);
+        result.append(1, static_cast<char>(mDescriptor.Version));
+        result.append(1, static_cast<char>(mDescriptor.Channel));
+        result.append(1, static_cast<char>(mDescriptor.Level));
+        result.append(1, static_cast<char>(mDescriptor.Opcode));
+        appendBE16(result, mDescriptor.Task);
+        appendBE64(result, mDescriptor.Keyword);
+
+        appendBE16(result, static_cast<uint16_t>(mParameters.size()));
+        for (auto iter = mParameters.begin(); iter != mParameters.end(); ++iter) {
+          appendBE16(result, static_cast<uint16_t>((*iter).mType));
+        }
+
+        for (auto iter = mParameters.begin(); iter != mParameters.end(); ++iter) {
+          auto &param = (*iter);
+          if (param.mNull) {
+            appendBE32(result, 0);
+            continue;
+          }
+          uint32_t size = static_cast<uint32_t>(param.mValue.length());
+          appendBE32(result, isScalarType(param.mType) ? (size | ZSLIB_EVENTING_TEST_SCALAR_FLAG) : size);
+          result.append(param.mValue);
+        }
+
+        std::string sizeWord;
+        appendBE32(sizeWord, static_cast<uint32_t>(result.length() - sizeof(uint32_t)));
+        result.replace(0, sizeWord.length(), sizeWord);
+        return result;
+      }
+
+      //-----------------------------------------------------------------------
+      void checkEvent(
+                      const TestEvent &expected,
+                      const TestEvent &received,
+                      bool expectOrigin
+                      )
+      {
+        TESTING_EQUAL(expected.mProviderName, received.mProviderName);
+        TESTING_EQUAL(expected.mSeverity, received.mSeverity);
+        TESTING_EQUAL(expected.mLevel, received.mLevel);
+        TESTING_EQUAL(expected.mDescriptor.Id, received.mDescriptor.Id);
+        TESTING_EQUAL(expected.mDescriptor.Version, received.mDescriptor.Version);
+        TESTING_EQUAL(expected.mDescriptor.Channel, received.mDescriptor.Channel);
+        TESTING_EQUAL(expected.mDescriptor.Level, received.mDescriptor.Level);
+        TESTING_EQUAL(expected.mDescriptor.Opcode, received.mDescriptor.Opcode);
+        TESTING_EQUAL(expected.mDescriptor.Task, received.mDescriptor.Task);
+        TESTING_EQUAL(expected.mDescriptor.Keyword, received.mDescriptor.Keyword);
+
+        TESTING_EQUAL(expected.mParameters.size(), received.mParameters.size());
+        if (expected.mParameters.size() == received.mParameters.size()) {
+          for (size_t index = 0; index < expected.mParameters.size(); ++index) {
+            auto &expectedParam = expected.mParameters[index];
+            auto &receivedParam = received.mParameters[index];
+            TESTING_EQUAL(expectedParam.mType, receivedParam.mType);
+            TESTING_EQUAL(expectedParam.mNull, receivedParam.mNull);
+            TESTING_CHECK(expectedParam.mValue == receivedParam.mValue);
+          }
+        }
+
+        TESTING_EQUAL(expectOrigin, received.mHasOrigin);
+        if ((expectOrigin) &&
+            (received.mHasOrigin)) {
+          TESTING_EQUAL(expected.mOrigin.mTimestamp, received.mOrigin.mTimestamp);
+          TESTING_EQUAL(expected.mOrigin.mThreadID, received.mOrigin.mThreadID);
+          TESTING_EQUAL(expected.mOrigin.mCPU, received.mOrigin.mCPU);
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      void checkEvents(
+                       const TestEventList &expected,
+                       const TestEventList &received,
+                       bool expectOrigin
+                       )
+      {
+        TESTING_EQUAL(expected.size(), received.size());
+        if (expected.size() != received.size()) return;
+
+        auto receivedIter = received.begin();
+        for (auto iter = expected.begin(); iter != expected.end(); ++iter, ++receivedIter) {
+          checkEvent(*iter, *receivedIter, expectOrigin);
+        }
+      }
+
+      //-----------------------------------------------------------------------
+      TestEventList createSampleEvents(
+                                       const TestProvider &provider1,
+                                       const TestProvider &provider2
+                                       )
+      {
+        static const BYTE binary[] = {0x00, 0x01, 0x7F, 0x80, 0xFF};
+
+        TestEventList result;
+
+        for (int loop = 0; loop < 2; ++loop) {
+          TestEvent event = TestEvent::create(provider1, 1, 1000000 - (loop * 1000));
+          event.addString("hello");
+          event.addInteger(zsLib::eventing::EventParameterType_UnsignedInteger, 42 + loop, sizeof(uint32_t));
+          event.addFloat(3.25);
+          event.addWideString(L"wide");
+          event.addBinary(&(binary[0]), sizeof(binary));
+          event.addNull(zsLib::eventing::EventParameterType_AString);
+          event.addInteger(zsLib::eventing::EventParameterType_SignedInteger, static_cast<uint64_t>(-5 - loop), sizeof(int64_t));
+          event.addInteger(zsLib::eventing::EventParameterType_Boolean, 1, sizeof(bool));
+          result.push_back(event);
+        }
+
+        {
+          TestEvent event = TestEvent::create(provider2, 2, 2000000);
+          event.mSeverity = zsLib::Log::Warning;
+          event.mLevel = zsLib::Log::Debug;
+          event.addString("other");
+          event.addString("");
+          event.addInteger(zsLib::eventing::EventParameterType_Pointer, 0xDEADBEEF, sizeof(void *));
+          event.addInteger(zsLib::eventing::EventParameterType_SignedInteger, 0x8000, sizeof(int16_t));
+          result.push_back(event);
+        }
+
+        {
+          TestEvent event = TestEvent::create(provider1, 3, 1500000);
+          event.addInteger(zsLib::eventing::EventParameterType_UnsignedInteger, 0xFFFFFFFFFFFFFFFFULL, sizeof(uint64_t));
+          event.addFloat(-0.0078125);
+          result.push_back(event);
+        }
+
+        return result;
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark EventCapture
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      EventCapturePtr EventCapture::create()
+      {
+        EventCapturePtr pThis(make_shared<EventCapture>());
+        pThis->mThisWeak = pThis;
+        Log::addEventingProviderListener(pThis);
+        Log::addEventingListener(pThis);
+        return pThis;
+      }
+
+      //-----------------------------------------------------------------------
+      void EventCapture::shutdown()
+      {
+        auto pThis = mThisWeak.lock();
+        if (!pThis) return;
+
+        Log::removeEventingListener(pThis);
+        Log::removeEventingProviderListener(pThis);
+      }
+
+      //-----------------------------------------------------------------------
+      TestEventList EventCapture::takeEvents()
+      {
+        AutoLock lock(mLock);
+        TestEventList result;
+        result.swap(mEvents);
+        return result;
+      }
+
+      //-----------------------------------------------------------------------
+      size_t EventCapture::getTotalEvents() const
+      {
+        AutoLock lock(mLock);
+        return mTotalEvents;
+      }
+
+      //-----------------------------------------------------------------------
+      void EventCapture::setKeepEvents(bool keep)
+      {
+        AutoLock lock(mLock);
+        mKeepEvents = keep;
+      }
+
+      //-----------------------------------------------------------------------
+      void EventCapture::holdWrites()
+      {
+        AutoLock lock(mLock);
+        mHoldWrites = true;
+        mReleasedWrites = 0;
+      }
+
+      //-----------------------------------------------------------------------
+      void EventCapture::releaseWrites(size_t count)
+      {
+        {
+          AutoLock lock(mLock);
+          mReleasedWrites += count;
+        }
+        mWriteCondition.notify_all();
+      }
+
+      //-----------------------------------------------------------------------
+      void EventCapture::releaseAllWrites()
+      {
+        {
+          AutoLock lock(mLock);
+          mHoldWrites = false;
+          mReleasedWrites = 0;
+        }
+        mWriteCondition.notify_all();
+      }
+
+      //-----------------------------------------------------------------------
+      size_t EventCapture::getWaitingWrites() const
+      {
+        AutoLock lock(mLock);
+        return mWaitingWrites;
+      }
+
+      //-----------------------------------------------------------------------
+      void EventCapture::notifyEventingProviderRegistered(
+                                                         ProviderHandle handle,
+                                                         EventingAtomDataArray eventingAtomDataArray
+                                                         )
+      {
+        UUID providerID;
+        String providerName;
+        String providerHash;
+        if (!Log::getEventingWriterInfo(handle, providerID, providerName, providerHash)) return;
+
+        if (0 != strncmp(providerName.c_str(), ZSLIB_EVENTING_TEST_PROVIDER_NAME_PREFIX, strlen(ZSLIB_EVENTING_TEST_PROVIDER_NAME_PREFIX))) return;
+
+        {
+          AutoLock lock(mLock);
+          mProviders[handle] = providerName;
+        }
+
+        // the eventing lock may be held while enabling so never hold our own
+        Log::setEventingLogging(handle, mID, true);
+      }
+
+      //-----------------------------------------------------------------------
+      void EventCapture::notifyEventingProviderUnregistered(
+                                                           ProviderHandle handle,
+                                                           EventingAtomDataArray eventingAtomDataArray
+                                                           )
+      {
+        {
+          AutoLock lock(mLock);
+          auto found = mProviders.find(handle);
+          if (found == mProviders.end()) return;
+          mProviders.erase(found);
+        }
+
+        Log::setEventingLogging(handle, mID, false);
+      }
+
+      //-----------------------------------------------------------------------
+      void EventCapture::notifyWriteEvent(
+                                         ProviderHandle handle,
+                                         EventingAtomDataArray eventingAtomDataArray,
+                                         Severity severity,
+                                         Level level,
+                                         EVENT_DESCRIPTOR_HANDLE descriptor,
+                                         EVENT_PARAMETER_DESCRIPTOR_HANDLE paramDescriptor,
+                                         EVENT_DATA_DESCRIPTOR_HANDLE dataDescriptor,
+                                         size_t dataDescriptorCount
+                                         )
+      {
+        std::unique_lock<Lock> lock(mLock);
+
+        auto found = mProviders.find(handle);
+        if (found == mProviders.end()) return;
+
+        if (mHoldWrites) {
+          ++mWaitingWrites;
+          mWriteCondition.wait(lock, [this]() { return (!mHoldWrites) || (mReleasedWrites > 0); });
+          --mWaitingWrites;
+          if (mHoldWrites) --mReleasedWrites;
+
+          found = mProviders.find(handle);
+          if (found == mProviders.end()) return;
+        }
+
+        ++mTotalEvents;
+        if (!mKeepEvents) return;
+
+        TestEvent event = TestEvent::capture(severity, level, descriptor, paramDescriptor, dataDescriptor, dataDescriptorCount);
+        event.mHandle = handle;
+        event.mProviderName = (*found).second;
+        event.mHasOrigin = IRemoteEventing::getCurrentEventOrigin(event.mOrigin);
+        mEvents.push_back(event);
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RemoteEventingTester
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      RemoteEventingTester::RemoteEventingTester(IMessageQueuePtr queue) :
+        RemoteEventing(make_private {}, queue, IRemoteEventingDelegatePtr(), "", IPAddress(), 0, Seconds())
+      {
+      }
+
+      //-----------------------------------------------------------------------
+      RemoteEventingTester::~RemoteEventingTester()
+      {
+        // the base destructor still walks the announced providers owned here
+        AutoRecursiveLock lock(mLock);
+        mLocalAnnouncedProviders.clear();
+        mLocalAnnouncedProviderIndexes.clear();
+        mSession.reset();
+      }
+
+      //-----------------------------------------------------------------------
+      RemoteEventingTesterPtr RemoteEventingTester::create(const Options &options)
+      {
+        RemoteEventingTesterPtr pThis(make_shared<RemoteEventingTester>(IMessageQueueManager::getMessageQueue("org.zsLib.eventing.test")));
+        pThis->mThisWeak = pThis;
+
+        // authorized without a handshake; init() is never called as it would start connecting
+        AutoRecursiveLock lock(pThis->mLock);
+        pThis->mEventingAtomIndex = zsLib::Log::registerEventingAtom("org.zsLib.eventing.RemoteEventing");
+        pThis->mAsyncNotify = internal::IRemoteEventingAsyncDelegateProxy::createWeak(pThis);
+
+        pThis->mHandshakeState = MessageType_Welcome;
+        pThis->setState(State_Connected);
+
+        pThis->mRemoteSupportsEventBatches = options.mBatches;
+        pThis->resetCompactEvents(options.mCompact);
+        pThis->mRemoteSupportsDenseProviders = options.mDenseProviders;
+        pThis->setEventOriginNegotiated(options.mEventOrigin);
+        pThis->mRemoteSupportsEventBacklog = options.mBacklog;
+
+        bool swap = ((options.mBigEndianWire) && (isLittleEndianHost()));
+        pThis->mSwapOutgoingScalars = swap;
+        pThis->mSwapIncomingIntegers = swap;
+        pThis->mSwapIncomingFloats = swap;
+
+        pThis->mIncomingBuffer.CleanNew(pThis->mIncomingBufferSize);
+        return pThis;
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventingTester::announce(
+                                          const TestProvider &provider,
+                                          RemoteEventingTester &receiver
+                                          )
+      {
+        {
+          AutoRecursiveLock lock(mLock);
+          if (mLocalAnnouncedProviders.end() == mLocalAnnouncedProviders.find(provider.mProviderID)) {
+            addLocalProvider(provider, 0);
+          }
+        }
+
+        AutoRecursiveLock lock(receiver.mLock);
+        receiver.registerRemoteProvider(provider.mHandle, provider.mProviderID, provider.mProviderName, provider.mProviderHash, provider.mIndex);
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventingTester::addLocalProvider(
+                                                  const TestProvider &provider,
+                                                  KeywordBitmaskType bitmask
+                                                  )
+      {
+        AutoRecursiveLock lock(mLock);
+
+        std::unique_ptr<ProviderInfo> info(new ProviderInfo);
+        info->mHandle = provider.mHandle;
+        info->mProviderID = provider.mProviderID;
+        info->mProviderName = provider.mProviderName;
+        info->mProviderHash = provider.mProviderHash;
+        info->mBitmask = bitmask;
+        info->mIndex = provider.mIndex;
+
+        mLocalAnnouncedProviders[provider.mProviderID] = info.get();
+        mLocalAnnouncedProviderIndexes[provider.mHandle] = provider.mIndex;
+        mOwnedProviders.push_back(std::move(info));
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventingTester::unannounce(
+                                            const TestProvider &provider,
+                                            RemoteEventingTester &receiver
+                                            )
+      {
+        removeLocalProvider(provider);
+
+        AutoRecursiveLock lock(receiver.mLock);
+        receiver.unregisterRemoteProvider(provider.mHandle);
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventingTester::removeLocalProvider(const TestProvider &provider)
+      {
+        AutoRecursiveLock lock(mLock);
+        mLocalAnnouncedProviders.erase(provider.mProviderID);
+        mLocalAnnouncedProviderIndexes.erase(provider.mHandle);
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventingTester::setLocalProviderKeywords(
+                                                          const TestProvider &provider,
+                                                          KeywordBitmaskType bitmask
+                                                          )
+      {
+        AutoRecursiveLock lock(mLock);
+        auto found = mLocalAnnouncedProviders.find(provider.mProviderID);
+        if (found == mLocalAnnouncedProviders.end()) return;
+        (*found).second->mBitmask = bitmask;
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventingTester::addLocalSubsystem(const char *subsystemName)
+      {
+        AutoRecursiveLock lock(mLock);
+        auto info = make_shared<SubsystemInfo>();
+        info->mName = subsystemName;
+        mLocalSubsystems[info->mName] = info;
+      }
+
+      //-----------------------------------------------------------------------
+      RemoteEventingTester::ProviderHandle RemoteEventingTester::registerLocalWriter(
+                                                                                    const TestProvider &provider,
+                                                                                    uint32_t &outIndex
+                                                                                    )
+      {
+        outIndex = 0xFFFFFFFF;
+
+        ProviderHandle handle = Log::registerEventingWriter(provider.mProviderID, provider.mProviderName, provider.mProviderHash);
+
+        // the tester is not installed as an eventing listener so it is told directly
+        UUID providerID;
+        String providerName;
+        String providerHash;
+        EventingAtomDataArray atomArray {};
+        if (!Log::getEventingWriterInfo(handle, providerID, providerName, providerHash, &atomArray)) return handle;
+
+        notifyEventingProviderRegistered(handle, atomArray);
+
+        ProviderInfo *info = reinterpret_cast<ProviderInfo *>(atomArray[mEventingAtomIndex]);
+        if (info) outIndex = info->mIndex;
+        return handle;
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventingTester::unregisterLocalWriter(ProviderHandle handle)
+      {
+        UUID providerID;
+        String providerName;
+        String providerHash;
+        EventingAtomDataArray atomArray {};
+        if (Log::getEventingWriterInfo(handle, providerID, providerName, providerHash, &atomArray)) {
+          notifyEventingProviderUnregistered(handle, atomArray);
+        }
+
+        Log::unregisterEventingWriter(handle);
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventingTester::send(
+                                      const TestEvent &event,
+                                      bool backlog
+                                      )
+      {
+        std::string message = event.pack();
+
+        AutoRecursiveLock lock(mLock);
+        queueOutgoingEvent(reinterpret_cast<const BYTE *>(message.c_str()), message.length(), backlog);
+      }
+
+      //-----------------------------------------------------------------------
+      std::string RemoteEventingTester::takeWire()
+      {
+        AutoRecursiveLock lock(mLock);
+
+        flushEventBatch();
+
+        std::string result;
+        for (auto iter = mOutgoingSegments.begin(); iter != mOutgoingSegments.end(); ++iter) {
+          auto &segment = (*iter);
+          result.append(reinterpret_cast<const char *>(segment->mBuffer.BytePtr() + segment->mSent), segment->mFilled - segment->mSent);
+        }
+        releaseOutgoingSegments(mOutgoingSegments);
+        mEventDataInOutgoingQueue = 0;
+        return result;
+      }
+
+      //-----------------------------------------------------------------------
+      std::string RemoteEventingTester::takeSessionDelta()
+      {
+        AutoRecursiveLock lock(mLock);
+
+        if (!mSession) mSession = make_shared<SessionInfo>();
+
+        sendSessionDelta();
+        std::string result = takeWire();
+
+        // what the remote party now knows about
+        mSession->mProviders.clear();
+        for (auto iter = mLocalAnnouncedProviders.begin(); iter != mLocalAnnouncedProviders.end(); ++iter) {
+          auto provider = (*iter).second;
+          auto &sessionProvider = mSession->mProviders[provider->mHandle];
+          sessionProvider.mProviderID = provider->mProviderID;
+          sessionProvider.mBitmask = provider->mBitmask;
+        }
+        mSession->mSubsystems.clear();
+        for (auto iter = mLocalSubsystems.begin(); iter != mLocalSubsystems.end(); ++iter) {
+          mSession->mSubsystems.insert((*iter).first);
+        }
+        return result;
+      }
+
+      //-----------------------------------------------------------------------
+      bool RemoteEventingTester::attachSpool(
+                                             const String &path,
+                                             size_t size
+                                             )
+      {
+        AutoRecursiveLock lock(mLock);
+        mSpool = EventSpool::open(path, size);
+        if (!mSpool) return false;
+
+        ++mEventOriginParties;
+        return true;
+      }
+
+      //-----------------------------------------------------------------------
+      bool RemoteEventingTester::spool(const TestEvent &event)
+      {
+        std::string message = event.pack();
+
+        AutoRecursiveLock lock(mLock);
+        return spoolEvent(reinterpret_cast<const BYTE *>(message.c_str()), message.length());
+      }
+
+      //-----------------------------------------------------------------------
+      bool RemoteEventingTester::replay()
+      {
+        // a listener replays to its clients without its lock held
+        if (isListener()) return replayListenerSpool();
+
+        AutoRecursiveLock lock(mLock);
+        return replaySpool();
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventingTester::attachClient(RemoteEventingTesterPtr client)
+      {
+        AutoRecursiveLock lock(mLock);
+
+        mListenPort = ZSLIB_EVENTING_TEST_LISTEN_PORT;
+
+        {
+          AutoRecursiveLock clientLock(client->mLock);
+          client->mIsClient = true;
+          client->mListenPort = mListenPort;
+          client->mParentWeak = mThisWeak;
+          client->mParentID = mID;
+          client->mSpoolKeywords = mSpoolKeywords;
+        }
+
+        RemoteEventingListPtr replacement(make_shared<RemoteEventingList>(*mClients));
+        replacement->push_back(client);
+        mClients = replacement;
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventingTester::subscribeClient(
+                                                 const TestProvider &provider,
+                                                 KeywordBitmaskType bitmask
+                                                 )
+      {
+        AutoRecursiveLock lock(mLock);
+        if (0 == bitmask) {
+          mRequestedRemoteProviderKeywords.erase(provider.mHandle);
+          return;
+        }
+        mRequestedRemoteProviderKeywords[provider.mHandle] = bitmask;
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventingTester::receive(const std::string &wire)
+      {
+        AutoRecursiveLock lock(mLock);
+
+        if (mIncomingFilled + wire.length() + 1 > mIncomingBuffer.SizeInBytes()) {
+          mIncomingBuffer.resize(mIncomingFilled + wire.length() + 1);
+        }
+        memcpy(mIncomingBuffer.BytePtr() + mIncomingFilled, wire.c_str(), wire.length());
+        mIncomingFilled += wire.length();
+
+        readIncomingMessage();
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventingTester::receiveFrame(
+                                              MessageTypes messageType,
+                                              const std::string &payload
+                                              )
+      {
+        receive(frame(messageType, payload));
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventingTester::startRecording(TraceRecorderPtr recorder)
+      {
+        AutoRecursiveLock lock(mLock);
+        mRecorder = recorder;
+        beginRecordedConnection();
+        noteRecordedConnectionState();
+      }
+
+      //-----------------------------------------------------------------------
+      void RemoteEventingTester::stopRecording()
+      {
+        AutoRecursiveLock lock(mLock);
+        endRecordedConnection();
+        if (mRecorder) mRecorder->close();
+        mRecorder.reset();
+      }
+
+      //-----------------------------------------------------------------------
+      bool RemoteEventingTester::isReceivePaused() const
+      {
+        AutoRecursiveLock lock(mLock);
+        return mReceivePaused;
+      }
+
+      //-----------------------------------------------------------------------
+      bool RemoteEventingTester::hasRemoteSubsystem(const char *subsystemName) const
+      {
+        AutoRecursiveLock lock(mLock);
+        return mRemoteSubsystems.end() != mRemoteSubsystems.find(String(subsystemName));
+      }
+
+      //-----------------------------------------------------------------------
+      bool RemoteEventingTester::hasRemoteProvider(const TestProvider &provider) const
+      {
+        AutoRecursiveLock lock(mLock);
+        return mRemoteRegisteredProvidersByUUID.end() != mRemoteRegisteredProvidersByUUID.find(provider.mProviderID);
+      }
+
+      //-----------------------------------------------------------------------
+      RemoteEventingTester::KeywordBitmaskType RemoteEventingTester::getRemoteProviderKeywords(const TestProvider &provider) const
+      {
+        AutoRecursiveLock lock(mLock);
+        auto found = mRemoteRegisteredProvidersByUUID.find(provider.mProviderID);
+        if (found == mRemoteRegisteredProvidersByUUID.end()) return 0;
+        return (*found).second->mBitmask;
+      }
+
+      //-----------------------------------------------------------------------
+      size_t RemoteEventingTester::getRemoteProviderTableSize() const
+      {
+        AutoRecursiveLock lock(mLock);
+        return mRemoteProviders.size();
+      }
+
+      //-----------------------------------------------------------------------
+      RemoteEventingTester::CachedEventHeader *RemoteEventingTester::getCachedEventHeader(
+                                                                                        const TestProvider &provider,
+                                                                                        uint16_t eventID
+                                                                                        )
+      {
+        AutoRecursiveLock lock(mLock);
+
+        auto found = mRemoteRegisteredProvidersByUUID.find(provider.mProviderID);
+        if (found == mRemoteRegisteredProvidersByUUID.end()) return NULL;
+
+        auto index = (*found).second->mIndex;
+        if (index >= mRemoteProviders.size()) return NULL;
+
+        auto &headers = mRemoteProviders[index].mHeaders;
+        if (headers.empty()) return NULL;
+        return &(headers[eventID % headers.size()]);
+      }
+
+      //-----------------------------------------------------------------------
+      std::string RemoteEventingTester::frame(
+                                              MessageTypes messageType,
+                                              const std::string &payload
+                                              )
+      {
+        std::string result;
+        appendBE32(result, static_cast<uint32_t>(sizeof(uint32_t) + payload.length()));
+        appendBE32(result, static_cast<uint32_t>(messageType));
+        result.append(payload);
+        return result;
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark (wire helpers)
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      void appendBE16(std::string &ioBuffer, uint16_t value)
+      {
+        ioBuffer.append(1, static_cast<char>((value >> 8) & 0xFF));
+        ioBuffer.append(1, static_cast<char>(value & 0xFF));
+      }
+
+      //-----------------------------------------------------------------------
+      void appendBE32(std::string &ioBuffer, uint32_t value)
+      {
+        appendBE16(ioBuffer, static_cast<uint16_t>(value >> 16));
+        appendBE16(ioBuffer, static_cast<uint16_t>(value & 0xFFFF));
+      }
+
+      //-----------------------------------------------------------------------
+      void appendBE64(std::string &ioBuffer, uint64_t value)
+      {
+        appendBE32(ioBuffer, static_cast<uint32_t>(value >> 32));
+        appendBE32(ioBuffer, static_cast<uint32_t>(value & 0xFFFFFFFF));
+      }
+
+      //-----------------------------------------------------------------------
+      void appendVarint(std::string &ioBuffer, uint64_t value)
+      {
+        while (value >= 0x80) {
+          ioBuffer.append(1, static_cast<char>((value & 0x7F) | 0x80));
+          value >>= 7;
+        }
+        ioBuffer.append(1, static_cast<char>(value));
+      }
+
+      //-----------------------------------------------------------------------
+      void appendString(std::string &ioBuffer, const char *value)
+      {
+        size_t length = strlen(value);
+        appendVarint(ioBuffer, length);
+        ioBuffer.append(value, length);
+      }
+
+      //-----------------------------------------------------------------------
+      std::string loadFile(const char *path)
+      {
+        try {
+          auto buffer = IHelper::loadFile(path);
+          if (!buffer) return std::string();
+          return std::string(reinterpret_cast<const char *>(buffer->BytePtr()), buffer->SizeInBytes());
+        } catch (const StdError &) {
+        }
+        return std::string();
+      }
+    }
+  }
+}
@@ -0,0 +1,392 @@
+/*
+
+Copyright (c) 2016, Robin Raymond
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+*/
+
+#pragma once
+
+#include <zsLib/eventing/internal/zsLib_eventing_RemoteEventing.h>
+
+#include <zsLib/eventing/Log.h>
+
+#include <condition_variable>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+// wire constants private to the remote eventing implementation
+#define ZSLIB_EVENTING_TEST_EVENT_ORIGIN_SIZE                 (20)
+#define ZSLIB_EVENTING_TEST_SCALAR_FLAG                       (0x80000000)
+#define ZSLIB_EVENTING_TEST_BATCH_FLAG_PROVIDER               (0x01)
+#define ZSLIB_EVENTING_TEST_BATCH_FLAG_HEADER                 (0x02)
+#define ZSLIB_EVENTING_TEST_COMPACT_RECORD_PROVIDER           (1)
+#define ZSLIB_EVENTING_TEST_COMPACT_RECORD_DESCRIPTOR         (2)
+#define ZSLIB_EVENTING_TEST_COMPACT_RECORD_EVENT              (3)
+#define ZSLIB_EVENTING_TEST_COMPACT_RECORD_STRING             (4)
+#define ZSLIB_EVENTING_TEST_COMPACT_MAX_INTERNED_STRINGS      (4096)
+#define ZSLIB_EVENTING_TEST_SESSION_RECORD_SUBSYSTEM          (1)
+#define ZSLIB_EVENTING_TEST_SESSION_RECORD_PROVIDER           (2)
+#define ZSLIB_EVENTING_TEST_SESSION_RECORD_PROVIDER_GONE      (3)
+#define ZSLIB_EVENTING_TEST_SESSION_RECORD_PROVIDER_KEYWORDS  (4)
+#define ZSLIB_EVENTING_TEST_TRACE_MAGIC                       (0x7A735452)
+#define ZSLIB_EVENTING_TEST_TRACE_RECORD_FRAME                (1)
+#define ZSLIB_EVENTING_TEST_TRACE_RECORD_CONNECTION           (2)
+#define ZSLIB_EVENTING_TEST_TRACE_RECORD_INDEX_TABLE          (5)
+#define ZSLIB_EVENTING_TEST_MAX_MESSAGE_SIZE                  (16*1024*1024)
+
+namespace zsLib
+{
+  namespace eventing
+  {
+    namespace test
+    {
+      ZS_DECLARE_CLASS_PTR(RemoteEventingTester);
+      ZS_DECLARE_CLASS_PTR(EventCapture);
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark TestProvider
+      #pragma mark
+
+      // provider as announced by the sending party
+      struct TestProvider
+      {
+        zsLib::Log::ProviderHandle mHandle {};
+        uint32_t mIndex {};
+        UUID mProviderID {};
+        String mProviderName;
+        String mProviderHash;
+
+        static TestProvider create(uint32_t index);
+      };
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark TestEvent
+      #pragma mark
+
+      struct TestParameter
+      {
+        EventParameterTypes mType {};
+        bool mNull {};
+        std::string mValue;   // host byte order for scalars
+      };
+
+      typedef std::vector<TestParameter> TestParameterList;
+
+      // event as written on the sending party (or as captured on the receiving party)
+      struct TestEvent
+      {
+        zsLib::Log::ProviderHandle mHandle {};
+        String mProviderName;
+        zsLib::Log::Severity mSeverity {zsLib::Log::Informational};
+        zsLib::Log::Level mLevel {zsLib::Log::Basic};
+        USE_EVENT_DESCRIPTOR mDescriptor {};
+        TestParameterList mParameters;
+
+        bool mHasOrigin {};
+        IRemoteEventingTypes::EventOrigin mOrigin;
+
+        static TestEvent create(
+                                const TestProvider &provider,
+                                uint16_t eventID,
+                                uint64_t timestamp = 0
+                                );
+
+        // copies an event out of the descriptors handed to a listener
+        static TestEvent capture(
+                                 zsLib::Log::Severity severity,
+                                 zsLib::Log::Level level,
+                                 EVENT_DESCRIPTOR_HANDLE descriptor,
+                                 EVENT_PARAMETER_DESCRIPTOR_HANDLE paramDescriptor,
+                                 EVENT_DATA_DESCRIPTOR_HANDLE dataDescriptor,
+                                 size_t dataDescriptorCount
+                                 );
+
+        void addInteger(
+                        EventParameterTypes type,
+                        uint64_t value,
+                        size_t size
+                        );
+        void addFloat(double value);
+        void addString(const char *value);
+        void addWideString(const wchar_t *value);
+        void addBinary(
+                       const void *value,
+                       size_t size
+                       );
+        void addNull(EventParameterTypes type);
+
+        std::string pack() const;
+      };
+
+      typedef std::list<TestEvent> TestEventList;
+
+      void checkEvent(
+                      const TestEvent &expected,
+                      const TestEvent &received,
+                      bool expectOrigin
+                      );
+      void checkEvents(
+                       const TestEventList &expected,
+                       const TestEventList &received,
+                       bool expectOrigin
+                       );
+
+      // the first events share a header and repeat their strings so batches and
+      // compact streams exercise their reuse paths
+      TestEventList createSampleEvents(
+                                       const TestProvider &provider1,
+                                       const TestProvider &provider2
+                                       );
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark EventCapture
+      #pragma mark
+
+      // collects the events written by the receiving party to the eventing
+      // listeners for providers created through TestProvider
+      class EventCapture : public ILogEventingProviderDelegate,
+                           public ILogEventingDelegate
+      {
+      public:
+        typedef zsLib::Log::Severity Severity;
+        typedef zsLib::Log::Level Level;
+        typedef zsLib::Log::ProviderHandle ProviderHandle;
+        typedef zsLib::Log::EventingAtomDataArray EventingAtomDataArray;
+        typedef zsLib::Log::KeywordBitmaskType KeywordBitmaskType;
+        typedef std::map<ProviderHandle, String> ProviderNameMap;
+
+        static EventCapturePtr create();
+        void shutdown();
+
+        TestEventList takeEvents();
+        size_t getTotalEvents() const;
+
+        void setKeepEvents(bool keep);
+
+        // while held every write waits inside the listener until released,
+        // which holds up the receive worker writing it
+        void holdWrites();
+        void releaseWrites(size_t count);
+        void releaseAllWrites();
+        size_t getWaitingWrites() const;
+
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark EventCapture => ILogEventingProviderDelegate
+        #pragma mark
+
+        virtual void notifyEventingProviderRegistered(
+                                                      ProviderHandle handle,
+                                                      EventingAtomDataArray eventingAtomDataArray
+                                                      ) override;
+        virtual void notifyEventingProviderUnregistered(
+                                                        ProviderHandle handle,
+                                                        EventingAtomDataArray eventingAtomDataArray
+                                                        ) override;
+
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark EventCapture => ILogEventingDelegate
+        #pragma mark
+
+        virtual void notifyWriteEvent(
+                                      ProviderHandle handle,
+                                      EventingAtomDataArray eventingAtomDataArray,
+                                      Severity severity,
+                                      Level level,
+                                      EVENT_DESCRIPTOR_HANDLE descriptor,
+                                      EVENT_PARAMETER_DESCRIPTOR_HANDLE paramDescriptor,
+                                      EVENT_DATA_DESCRIPTOR_HANDLE dataDescriptor,
+                                      size_t dataDescriptorCount
+                                      ) override;
+
+      protected:
+        EventCaptureWeakPtr mThisWeak;
+        AutoPUID mID;
+
+        mutable Lock mLock;
+        ProviderNameMap mProviders;
+        TestEventList mEvents;
+        size_t mTotalEvents {};
+        bool mKeepEvents {true};    // benchmarks only count
+
+        std::condition_variable mWriteCondition;
+        bool mHoldWrites {};
+        size_t mReleasedWrites {};
+        size_t mWaitingWrites {};
+      };
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RemoteEventingTester
+      #pragma mark
+
+      // Drives one side of an authorized connection without any socket;
+      // frames are taken from the outgoing queue of the sending party and
+      // handed to the incoming buffer of the receiving party.
+      class RemoteEventingTester : public internal::RemoteEventing
+      {
+      public:
+        typedef zsLib::Log::ProviderHandle ProviderHandle;
+        typedef zsLib::Log::KeywordBitmaskType KeywordBitmaskType;
+
+        // anything not negotiated here (clock, receive workers, queue sizes)
+        // comes from the settings in effect when the tester is created
+        struct Options
+        {
+          bool mBatches {};
+          bool mCompact {};
+          bool mDenseProviders {};
+          bool mEventOrigin {};
+          bool mBacklog {};
+          bool mBigEndianWire {};     // scalars are swapped on the wire (a no-op on big endian hosts)
+        };
+
+        typedef std::list<std::unique_ptr<ProviderInfo> > OwnedProviderList;
+
+      public:
+        RemoteEventingTester(IMessageQueuePtr queue);
+        ~RemoteEventingTester();
+
+        static RemoteEventingTesterPtr create(const Options &options);
+
+        // sending party
+        void announce(
+                      const TestProvider &provider,
+                      RemoteEventingTester &receiver
+                      );
+        void addLocalProvider(
+                              const TestProvider &provider,
+                              KeywordBitmaskType bitmask
+                              );
+        void unannounce(
+                        const TestProvider &provider,
+                        RemoteEventingTester &receiver
+                        );
+        void removeLocalProvider(const TestProvider &provider);
+        void setLocalProviderKeywords(
+                                      const TestProvider &provider,
+                                      KeywordBitmaskType bitmask
+                                      );
+        void addLocalSubsystem(const char *subsystemName);
+
+        // registers an eventing writer as an application would (outIndex is the index handed out)
+        ProviderHandle registerLocalWriter(
+                                           const TestProvider &provider,
+                                           uint32_t &outIndex
+                                           );
+        void unregisterLocalWriter(ProviderHandle handle);
+
+        void send(
+                  const TestEvent &event,
+                  bool backlog = false
+                  );
+        std::string takeWire();
+        std::string takeSessionDelta();
+
+        bool attachSpool(
+                         const String &path,
+                         size_t size
+                         );
+        bool spool(const TestEvent &event);
+        bool replay();
+
+        // listening party; the client stands in for an accepted party and
+        // is told directly what its remote party subscribed to
+        void attachClient(RemoteEventingTesterPtr client);
+        void subscribeClient(
+                             const TestProvider &provider,
+                             KeywordBitmaskType bitmask
+                             );
+
+        // receiving party
+        void receive(const std::string &wire);
+        void receiveFrame(
+                          MessageTypes messageType,
+                          const std::string &payload
+                          );
+
+        void startRecording(TraceRecorderPtr recorder);
+        void stopRecording();
+
+        bool isReceivePaused() const;
+        bool hasRemoteSubsystem(const char *subsystemName) const;
+        bool hasRemoteProvider(const TestProvider &provider) const;
+        KeywordBitmaskType getRemoteProviderKeywords(const TestProvider &provider) const;
+        size_t getRemoteProviderTableSize() const;
+
+        // the receive side header cache slot the event ID maps to (NULL if not allocated yet)
+        CachedEventHeader *getCachedEventHeader(
+                                                const TestProvider &provider,
+                                                uint16_t eventID
+                                                );
+
+        static std::string frame(
+                                 MessageTypes messageType,
+                                 const std::string &payload
+                                 );
+
+      protected:
+        OwnedProviderList mOwnedProviders;
+      };
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark (wire helpers)
+      #pragma mark
+
+      void appendBE16(std::string &ioBuffer, uint16_t value);
+      void appendBE32(std::string &ioBuffer, uint32_t value);
+      void appendBE64(std::string &ioBuffer, uint64_t value);
+      void appendVarint(std::string &ioBuffer, uint64_t value);
+      void appendString(std::string &ioBuffer, const char *value);
+
+      std::string loadFile(const char *path);
+    }
+  }
+}
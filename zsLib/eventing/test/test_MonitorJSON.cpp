@@ -0,0 +1,604 @@
+/*
+
+Copyright (c) 2016, Robin Raymond
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+*/
+
+#include "testing.h"
+
+#include <zsLib/eventing/tool/internal/zsLib_eventing_tool_Monitor.h>
+
+#include <zsLib/eventing/IHelper.h>
+
+#include <chrono>
+#include <cstring>
+#include <cwchar>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <vector>
+
+using zsLib::String;
+using zsLib::eventing::IEventingTypes;
+using zsLib::eventing::IRemoteEventing;
+using zsLib::eventing::tool::internal::Monitor;
+
+#define ZSLIB_EVENTING_TEST_JSON_BENCHMARK_EVENTS (100000)
+
+namespace
+{
+  typedef std::map<size_t, IEventingTypes::EventPtr> ReferenceEventMap;
+
+  //---------------------------------------------------------------------------
+  // reaches the plan compiler the monitor uses for every jman provider
+  class MonitorTester : public Monitor
+  {
+  public:
+    using Monitor::compileEventPlans;
+  };
+
+  //---------------------------------------------------------------------------
+  // an event as handed to the eventing listeners
+  struct JSONTestEvent
+  {
+    zsLib::Log::Severity mSeverity {zsLib::Log::Informational};
+    zsLib::Log::Level mLevel {zsLib::Log::Basic};
+    USE_EVENT_DESCRIPTOR mDescriptor {};
+    std::vector<USE_EVENT_PARAMETER_DESCRIPTOR> mParams;
+    std::vector<USE_EVENT_DATA_DESCRIPTOR> mData;
+
+    void add(
+             zsLib::eventing::EventParameterTypes type,
+             const void *value,
+             size_t size
+             )
+    {
+      USE_EVENT_PARAMETER_DESCRIPTOR param {};
+      param.Type = type;
+      USE_EVENT_DATA_DESCRIPTOR data {};
+      data.Ptr = reinterpret_cast<uintptr_t>(value);
+      data.Size = size;
+      mParams.push_back(param);
+      mData.push_back(data);
+    }
+    void addString(const char *value)     {add(zsLib::eventing::EventParameterType_AString, value, value ? strlen(value) + 1 : 0);}
+    void addWideString(const wchar_t *value) {add(zsLib::eventing::EventParameterType_WString, value, value ? (wcslen(value) + 1) * sizeof(wchar_t) : 0);}
+  };
+
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  #pragma mark
+  #pragma mark (reference element output)
+  #pragma mark
+
+  // the monitor output as it was produced through an element tree before the
+  // JSON was written directly; kept as the reference the writer must match
+
+  //---------------------------------------------------------------------------
+  uint64_t referenceUnsigned(const USE_EVENT_DATA_DESCRIPTOR &data)
+  {
+    if (!data.Ptr) return 0;
+    uint64_t value = 0;
+    memcpy(&value, reinterpret_cast<const void *>(data.Ptr), sizeof(value) > data.Size ? data.Size : sizeof(value));
+    return value;
+  }
+
+  //---------------------------------------------------------------------------
+  int64_t referenceSigned(const USE_EVENT_DATA_DESCRIPTOR &data)
+  {
+    if (!data.Ptr) return 0;
+    switch (data.Size) {
+      case 1: { int8_t value {}; memcpy(&value, reinterpret_cast<const void *>(data.Ptr), sizeof(value)); return value; }
+      case 2: { int16_t value {}; memcpy(&value, reinterpret_cast<const void *>(data.Ptr), sizeof(value)); return value; }
+      case 4: { int32_t value {}; memcpy(&value, reinterpret_cast<const void *>(data.Ptr), sizeof(value)); return value; }
+      default: break;
+    }
+    int64_t value = 0;
+    memcpy(&value, reinterpret_cast<const void *>(data.Ptr), sizeof(value) > data.Size ? data.Size : sizeof(value));
+    return value;
+  }
+
+  //---------------------------------------------------------------------------
+  double referenceFloat(const USE_EVENT_DATA_DESCRIPTOR &data)
+  {
+    if (!data.Ptr) return 0.0;
+    if (sizeof(float) == data.Size) {
+      float value {};
+      memcpy(&value, reinterpret_cast<const void *>(data.Ptr), sizeof(value));
+      return value;
+    }
+    double value = 0;
+    memcpy(&value, reinterpret_cast<const void *>(data.Ptr), sizeof(double) > data.Size ? data.Size : sizeof(double));
+    return value;
+  }
+
+  //---------------------------------------------------------------------------
+  String referenceValue(
+                        const USE_EVENT_PARAMETER_DESCRIPTOR &param,
+                        const USE_EVENT_DATA_DESCRIPTOR &data,
+                        bool &outIsNumber
+                        )
+  {
+    outIsNumber = true;
+
+    switch (param.Type) {
+      case zsLib::eventing::EventParameterType_Boolean:          {
+        outIsNumber = false;
+        if (0 != referenceUnsigned(data)) return "true";
+        return "false";
+      }
+      case zsLib::eventing::EventParameterType_UnsignedInteger:  return zsLib::string(referenceUnsigned(data));
+      case zsLib::eventing::EventParameterType_SignedInteger:    return zsLib::string(referenceSigned(data));
+      case zsLib::eventing::EventParameterType_FloatingPoint:    return zsLib::string(referenceFloat(data));
+      case zsLib::eventing::EventParameterType_Pointer:          return zsLib::string(referenceUnsigned(data));
+      case zsLib::eventing::EventParameterType_AString:          {
+        outIsNumber = false;
+        if (!data.Ptr) return String();
+        if (0 == data.Size) return String();
+        auto temp = zsLib::eventing::IHelper::convertToBuffer(reinterpret_cast<const BYTE *>(data.Ptr), data.Size);
+        return String(reinterpret_cast<const char *>(temp->BytePtr()));
+      }
+      case zsLib::eventing::EventParameterType_WString:          {
+        outIsNumber = false;
+        if (!data.Ptr) return String();
+        if (0 == data.Size) return String();
+        size_t total = data.Size / sizeof(wchar_t);
+        if (0 == total) return String();
+
+        std::vector<wchar_t> temp(total + 1);
+        memcpy(&(temp[0]), reinterpret_cast<const void *>(data.Ptr), data.Size);
+        return String(&(temp[0]));
+      }
+      default: break;
+    }
+
+    outIsNumber = false;
+    if (!data.Ptr) return String();
+    if (0 == data.Size) return String();
+    return zsLib::eventing::IHelper::convertToHex(reinterpret_cast<const BYTE *>(data.Ptr), data.Size);
+  }
+
+  //---------------------------------------------------------------------------
+  void referenceAddValue(
+                         zsLib::eventing::ElementPtr valuesEl,
+                         const String &valueName,
+                         const USE_EVENT_PARAMETER_DESCRIPTOR &param,
+                         const USE_EVENT_DATA_DESCRIPTOR &data
+                         )
+  {
+    bool isNumber = false;
+    String value = referenceValue(param, data, isNumber);
+    if (isNumber) {
+      valuesEl->adoptAsLastChild(zsLib::eventing::IHelper::createElementWithNumber(valueName, value));
+    } else {
+      valuesEl->adoptAsLastChild(zsLib::eventing::IHelper::createElementWithTextAndJSONEncode(valueName, value));
+    }
+  }
+
+  //---------------------------------------------------------------------------
+  void referenceAddOrigin(
+                          zsLib::eventing::ElementPtr rootEl,
+                          const IRemoteEventing::EventOrigin *origin
+                          )
+  {
+    if (!origin) return;
+
+    rootEl->adoptAsLastChild(zsLib::eventing::IHelper::createElementWithNumber("timestamp", zsLib::string(origin->mTimestamp)));
+    rootEl->adoptAsLastChild(zsLib::eventing::IHelper::createElementWithNumber("thread", zsLib::string(origin->mThreadID)));
+    if (IRemoteEventing::CPU_Unknown != origin->mCPU) {
+      rootEl->adoptAsLastChild(zsLib::eventing::IHelper::createElementWithNumber("cpu", zsLib::string(origin->mCPU)));
+    }
+  }
+
+  //---------------------------------------------------------------------------
+  // without the {"event": ... } wrapper, or empty if the event is rejected
+  std::string referenceEventJSON(
+                                 const ReferenceEventMap &events,
+                                 const JSONTestEvent &test,
+                                 const IRemoteEventing::EventOrigin *origin,
+                                 bool quietMode
+                                 )
+  {
+    using zsLib::eventing::IHelper;
+    using zsLib::eventing::Element;
+    using zsLib::eventing::ElementPtr;
+
+    static const char *builtInNames[ZS_EVENTING_TOTAL_BUILT_IN_EVENT_DATA] = {"_subsystemName", "_function", "_line"};
+
+    const USE_EVENT_PARAMETER_DESCRIPTOR *paramDescriptor = &(test.mParams[0]);
+    const USE_EVENT_DATA_DESCRIPTOR *dataDescriptor = &(test.mData[0]);
+    size_t dataDescriptorCount = test.mData.size();
+
+    ElementPtr rootEl = Element::create("event");
+    rootEl->adoptAsLastChild(IHelper::createElementWithText("severity", zsLib::Log::toString(test.mSeverity)));
+    rootEl->adoptAsLastChild(IHelper::createElementWithText("level", zsLib::Log::toString(test.mLevel)));
+    referenceAddOrigin(rootEl, origin);
+
+    auto found = events.find(test.mDescriptor.Id);
+    if (found != events.end()) {
+      auto event = (*found).second;
+
+      rootEl->adoptAsLastChild(IHelper::createElementWithTextAndJSONEncode("name", event->mName));
+      if (event->mChannel) rootEl->adoptAsLastChild(IHelper::createElementWithTextAndJSONEncode("channel", event->mChannel->mID));
+      if (event->mTask) rootEl->adoptAsLastChild(IHelper::createElementWithTextAndJSONEncode("task", event->mTask->mName));
+      if (event->mOpCode) rootEl->adoptAsLastChild(IHelper::createElementWithTextAndJSONEncode("opCode", event->mOpCode->mName));
+
+      ElementPtr valuesEl = Element::create("values");
+      rootEl->adoptAsLastChild(valuesEl);
+
+      size_t totalDataParams = ZS_EVENTING_TOTAL_BUILT_IN_EVENT_DATA;
+      size_t totalSizes = 0;
+      if (event->mDataTemplate) {
+        totalDataParams += event->mDataTemplate->mDataTypes.size();
+        for (auto iter = event->mDataTemplate->mDataTypes.begin(); iter != event->mDataTemplate->mDataTypes.end(); ++iter) {
+          if ((*iter)->mType == IEventingTypes::PredefinedTypedef_size) ++totalSizes;
+        }
+      }
+      if ((totalDataParams != dataDescriptorCount) &&
+          (totalDataParams - totalSizes != dataDescriptorCount) &&
+          (!quietMode)) return std::string();
+
+      for (size_t index = 0; index < ZS_EVENTING_TOTAL_BUILT_IN_EVENT_DATA; ++index) {
+        referenceAddValue(valuesEl, builtInNames[index], paramDescriptor[index], dataDescriptor[index]);
+      }
+
+      if (event->mDataTemplate) {
+        auto iterDataType = event->mDataTemplate->mDataTypes.begin();
+        for (size_t index = ZS_EVENTING_TOTAL_BUILT_IN_EVENT_DATA; index < dataDescriptorCount; ++index, ++iterDataType) {
+          if (iterDataType == event->mDataTemplate->mDataTypes.end()) break;
+
+          auto &dataType = (*iterDataType);
+          size_t valueIndex = index;
+          if (dataType->mType == IEventingTypes::PredefinedTypedef_binary) {
+            if (index + 1 >= dataDescriptorCount) return std::string();
+            ++valueIndex;
+          } else if (dataType->mType == IEventingTypes::PredefinedTypedef_size) {
+            --valueIndex;
+          }
+          referenceAddValue(valuesEl, dataType->mValueName, paramDescriptor[valueIndex], dataDescriptor[valueIndex]);
+        }
+      }
+    } else {
+      rootEl->adoptAsLastChild(IHelper::createElementWithNumber("name", zsLib::string(test.mDescriptor.Id)));
+      rootEl->adoptAsLastChild(IHelper::createElementWithNumber("channel", zsLib::string(test.mDescriptor.Channel)));
+      rootEl->adoptAsLastChild(IHelper::createElementWithNumber("task", zsLib::string(test.mDescriptor.Task)));
+      rootEl->adoptAsLastChild(IHelper::createElementWithNumber("opCode", zsLib::string(test.mDescriptor.Opcode)));
+
+      ElementPtr valuesEl = Element::create("values");
+      rootEl->adoptAsLastChild(valuesEl);
+
+      for (size_t index = 0; index < ZS_EVENTING_TOTAL_BUILT_IN_EVENT_DATA; ++index) {
+        referenceAddValue(valuesEl, builtInNames[index], paramDescriptor[index], dataDescriptor[index]);
+      }
+      for (size_t index = ZS_EVENTING_TOTAL_BUILT_IN_EVENT_DATA; index < dataDescriptorCount; ++index) {
+        referenceAddValue(valuesEl, zsLib::string(index - ZS_EVENTING_TOTAL_BUILT_IN_EVENT_DATA), paramDescriptor[index], dataDescriptor[index]);
+      }
+    }
+
+    static const size_t skipStartLength = strlen("{\"event\":");
+    static const size_t skipEndLength = strlen("}");
+
+    String output = IHelper::toString(rootEl);
+    if (output.length() < skipStartLength + skipEndLength) return std::string();
+    return output.substr(skipStartLength, output.length() - skipStartLength - skipEndLength);
+  }
+
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  //---------------------------------------------------------------------------
+  #pragma mark
+  #pragma mark (test data)
+  #pragma mark
+
+  struct JSONTestData
+  {
+    IEventingTypes::ProviderPtr mProvider;
+    ReferenceEventMap mReferenceEvents;
+    Monitor::EventPlanArray mPlans;
+
+    // values the descriptors point at
+    const char *mSubsystem {"zsLib_eventing_test"};
+    const char *mFunction {"doTest\"Monitor\\JSON/</script>"};
+    uint32_t mLine {1234};
+    BYTE mBinary[6] {0x00, 0x01, 0x7F, 0x80, 0xAB, 0xFF};
+    size_t mBinarySize {sizeof(mBinary)};
+    bool mTrue {true};
+    bool mFalse {false};
+    uint64_t mMaxUnsigned {std::numeric_limits<uint64_t>::max()};
+    int64_t mMinSigned {std::numeric_limits<int64_t>::min()};
+    int16_t mNegativeShort {-12345};
+    uint8_t mSmallUnsigned {200};
+    double mFloats[6] {3.25, -0.0078125, 1e20, 0.0, 123456789.123456789, -1e-9};
+    float mSingleFloat {0.1f};
+    uintptr_t mPointer {0xDEADBEEF};
+  };
+
+  //---------------------------------------------------------------------------
+  IEventingTypes::DataTypePtr createDataType(
+                                              IEventingTypes::PredefinedTypedefs type,
+                                              const char *name
+                                              )
+  {
+    auto dataType = IEventingTypes::DataType::create();
+    dataType->mType = type;
+    dataType->mValueName = name;
+    return dataType;
+  }
+
+  //---------------------------------------------------------------------------
+  void createTestData(JSONTestData &data)
+  {
+    data.mProvider = IEventingTypes::Provider::create();
+
+    auto channel = IEventingTypes::Channel::create();
+    channel->mID = "channel/\"quoted\"";
+    auto task = IEventingTypes::Task::create();
+    task->mName = "task\\slash";
+    auto opCode = IEventingTypes::OpCode::create();
+    opCode->mName = "op\tcode\x01";
+
+    auto dataTemplate = IEventingTypes::DataTemplate::create();
+    dataTemplate->mDataTypes.push_back(createDataType(IEventingTypes::PredefinedTypedef_astring, "text"));
+    dataTemplate->mDataTypes.push_back(createDataType(IEventingTypes::PredefinedTypedef_astring, "escaped"));
+    dataTemplate->mDataTypes.push_back(createDataType(IEventingTypes::PredefinedTypedef_astring, "empty"));
+    dataTemplate->mDataTypes.push_back(createDataType(IEventingTypes::PredefinedTypedef_astring, "null"));
+    dataTemplate->mDataTypes.push_back(createDataType(IEventingTypes::PredefinedTypedef_wstring, "wide"));
+    dataTemplate->mDataTypes.push_back(createDataType(IEventingTypes::PredefinedTypedef_wstring, "wideEscaped"));
+    dataTemplate->mDataTypes.push_back(createDataType(IEventingTypes::PredefinedTypedef_wstring, "wideEmpty"));
+    dataTemplate->mDataTypes.push_back(createDataType(IEventingTypes::PredefinedTypedef_binary, "buffer"));
+    dataTemplate->mDataTypes.push_back(createDataType(IEventingTypes::PredefinedTypedef_size, "bufferSize"));
+    dataTemplate->mDataTypes.push_back(createDataType(IEventingTypes::PredefinedTypedef_bool, "yes"));
+    dataTemplate->mDataTypes.push_back(createDataType(IEventingTypes::PredefinedTypedef_bool, "no"));
+    dataTemplate->mDataTypes.push_back(createDataType(IEventingTypes::PredefinedTypedef_uint64, "maxUnsigned"));
+    dataTemplate->mDataTypes.push_back(createDataType(IEventingTypes::PredefinedTypedef_int64, "minSigned"));
+    dataTemplate->mDataTypes.push_back(createDataType(IEventingTypes::PredefinedTypedef_int16, "negativeShort"));
+    dataTemplate->mDataTypes.push_back(createDataType(IEventingTypes::PredefinedTypedef_uint8, "smallUnsigned"));
+    for (size_t index = 0; index < sizeof(data.mFloats) / sizeof(data.mFloats[0]); ++index) {
+      dataTemplate->mDataTypes.push_back(createDataType(IEventingTypes::PredefinedTypedef_double, (String("float") + zsLib::string(index)).c_str()));
+    }
+    dataTemplate->mDataTypes.push_back(createDataType(IEventingTypes::PredefinedTypedef_float, "singleFloat"));
+    dataTemplate->mDataTypes.push_back(createDataType(IEventingTypes::PredefinedTypedef_pointer, "pointer"));
+
+    auto event = IEventingTypes::Event::create();
+    event->mName = "Event\"Name\"/\\é";
+    event->mValue = 7;
+    event->mChannel = channel;
+    event->mTask = task;
+    event->mOpCode = opCode;
+    event->mDataTemplate = dataTemplate;
+
+    auto bare = IEventingTypes::Event::create();
+    bare->mName = "Bare";
+    bare->mValue = 9;
+
+    data.mProvider->mEvents[event->mName] = event;
+    data.mProvider->mEvents[bare->mName] = bare;
+    data.mReferenceEvents[event->mValue] = event;
+    data.mReferenceEvents[bare->mValue] = bare;
+
+    MonitorTester::compileEventPlans(data.mProvider, data.mPlans);
+  }
+
+  //---------------------------------------------------------------------------
+  void addBuiltIns(
+                   const JSONTestData &data,
+                   JSONTestEvent &event
+                   )
+  {
+    event.addString(data.mSubsystem);
+    event.addString(data.mFunction);
+    event.add(zsLib::eventing::EventParameterType_UnsignedInteger, &(data.mLine), sizeof(data.mLine));
+  }
+
+  //---------------------------------------------------------------------------
+  // the event described by the data template of event id 7
+  JSONTestEvent createFullEvent(const JSONTestData &data)
+  {
+    JSONTestEvent event;
+    event.mSeverity = zsLib::Log::Warning;
+    event.mLevel = zsLib::Log::Debug;
+    event.mDescriptor.Id = 7;
+    event.mDescriptor.Channel = 16;
+    event.mDescriptor.Task = 3;
+    event.mDescriptor.Opcode = 4;
+
+    addBuiltIns(data, event);
+    event.addString("plain text value");
+    event.addString("quote\" backslash\\ slash/ tab\t newline\n bell\x07 del\x7F utf8 \xC3\xA9");
+    event.addString("");
+    event.add(zsLib::eventing::EventParameterType_AString, NULL, 0);
+    event.addWideString(L"wide é中\U0001F600 value");
+    event.addWideString(L"wide \"quoted\" \\ / \t");
+    event.addWideString(L"");
+    event.add(zsLib::eventing::EventParameterType_UnsignedInteger, &(data.mBinarySize), sizeof(data.mBinarySize));
+    event.add(zsLib::eventing::EventParameterType_Binary, &(data.mBinary[0]), sizeof(data.mBinary));
+    event.add(zsLib::eventing::EventParameterType_Boolean, &(data.mTrue), sizeof(data.mTrue));
+    event.add(zsLib::eventing::EventParameterType_Boolean, &(data.mFalse), sizeof(data.mFalse));
+    event.add(zsLib::eventing::EventParameterType_UnsignedInteger, &(data.mMaxUnsigned), sizeof(data.mMaxUnsigned));
+    event.add(zsLib::eventing::EventParameterType_SignedInteger, &(data.mMinSigned), sizeof(data.mMinSigned));
+    event.add(zsLib::eventing::EventParameterType_SignedInteger, &(data.mNegativeShort), sizeof(data.mNegativeShort));
+    event.add(zsLib::eventing::EventParameterType_UnsignedInteger, &(data.mSmallUnsigned), sizeof(data.mSmallUnsigned));
+    for (size_t index = 0; index < sizeof(data.mFloats) / sizeof(data.mFloats[0]); ++index) {
+      event.add(zsLib::eventing::EventParameterType_FloatingPoint, &(data.mFloats[index]), sizeof(data.mFloats[index]));
+    }
+    event.add(zsLib::eventing::EventParameterType_FloatingPoint, &(data.mSingleFloat), sizeof(data.mSingleFloat));
+    event.add(zsLib::eventing::EventParameterType_Pointer, &(data.mPointer), sizeof(data.mPointer));
+    return event;
+  }
+
+  //---------------------------------------------------------------------------
+  std::string writerEventJSON(
+                              const JSONTestData &data,
+                              const JSONTestEvent &event,
+                              const IRemoteEventing::EventOrigin *origin,
+                              bool quietMode
+                              )
+  {
+    std::stringstream warnings;
+    std::string output;
+    bool written = Monitor::writeEventJSON(output, &(data.mPlans), event.mSeverity, event.mLevel, origin, &(event.mDescriptor), &(event.mParams[0]), &(event.mData[0]), event.mData.size(), quietMode, warnings);
+    TESTING_EQUAL(written, !output.empty());
+    return output;
+  }
+
+  //---------------------------------------------------------------------------
+  void checkGolden(
+                   const char *name,
+                   const JSONTestData &data,
+                   const JSONTestEvent &event,
+                   const IRemoteEventing::EventOrigin *origin,
+                   bool quietMode = false
+                   )
+  {
+    TESTING_STDOUT() << "  json: " << name << "\n";
+
+    std::string expected = referenceEventJSON(data.mReferenceEvents, event, origin, quietMode);
+    std::string actual = writerEventJSON(data, event, origin, quietMode);
+
+    TESTING_EQUAL(expected, actual);
+    if (expected != actual) {
+      TESTING_STDOUT() << "    expected: " << expected << "\n";
+      TESTING_STDOUT() << "    actual:   " << actual << "\n";
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+void doTestMonitorJSON()
+{
+  JSONTestData data;
+  createTestData(data);
+
+  TESTING_EQUAL(static_cast<size_t>(10), data.mPlans.size());
+
+  JSONTestEvent full = createFullEvent(data);
+
+  IRemoteEventing::EventOrigin origin;
+  origin.mTimestamp = 0xFFFFFFFFFFFFFFFFULL;
+  origin.mThreadID = 0x1234;
+  origin.mCPU = 7;
+
+  IRemoteEventing::EventOrigin unknownCPU = origin;
+  unknownCPU.mCPU = IRemoteEventing::CPU_Unknown;
+
+  checkGolden("jman event", data, full, NULL);
+  checkGolden("jman event with origin", data, full, &origin);
+  checkGolden("jman event with unknown cpu", data, full, &unknownCPU);
+
+  {
+    // the buffer size is optional on the wire
+    JSONTestEvent withoutSize = full;
+    size_t sizeIndex = ZS_EVENTING_TOTAL_BUILT_IN_EVENT_DATA + 7;
+    withoutSize.mParams.erase(withoutSize.mParams.begin() + sizeIndex);
+    withoutSize.mData.erase(withoutSize.mData.begin() + sizeIndex);
+    checkGolden("jman event without buffer size", data, withoutSize, NULL);
+  }
+  {
+    JSONTestEvent bare;
+    bare.mDescriptor.Id = 9;
+    addBuiltIns(data, bare);
+    checkGolden("jman event without values", data, bare, NULL);
+  }
+  {
+    JSONTestEvent mismatch = full;
+    mismatch.mParams.pop_back();
+    mismatch.mData.pop_back();
+    mismatch.mParams.pop_back();
+    mismatch.mData.pop_back();
+    checkGolden("jman event with missing values", data, mismatch, NULL);
+    TESTING_CHECK(writerEventJSON(data, mismatch, NULL, false).empty());
+    checkGolden("jman event with missing values (quiet)", data, mismatch, NULL, true);
+  }
+  {
+    JSONTestEvent unknown = full;
+    unknown.mDescriptor.Id = 1000;
+    checkGolden("undefined event", data, unknown, &origin);
+
+    // the plans have an empty entry for ids between defined events
+    unknown.mDescriptor.Id = 8;
+    checkGolden("undefined event inside the plans", data, unknown, &origin);
+  }
+  {
+    JSONTestEvent extreme;
+    extreme.mSeverity = zsLib::Log::Fatal;
+    extreme.mLevel = zsLib::Log::Insane;
+    extreme.mDescriptor.Id = 0xFFFF;
+    extreme.mDescriptor.Channel = 0xFF;
+    extreme.mDescriptor.Task = 0xFFFF;
+    extreme.mDescriptor.Opcode = 0xFF;
+    addBuiltIns(data, extreme);
+    extreme.add(zsLib::eventing::EventParameterType_Binary, NULL, 0);
+    extreme.add(zsLib::eventing::EventParameterType_WString, NULL, 0);
+    extreme.addString("\xE2\x80\xA8 line separator");
+    checkGolden("undefined event with empty values", data, extreme, NULL);
+  }
+}
+
+//-----------------------------------------------------------------------------
+void doBenchmarkMonitorJSON()
+{
+  JSONTestData data;
+  createTestData(data);
+
+  JSONTestEvent full = createFullEvent(data);
+
+  IRemoteEventing::EventOrigin origin;
+  origin.mTimestamp = 1000000;
+  origin.mThreadID = 0x1234;
+  origin.mCPU = 3;
+
+  std::stringstream warnings;
+  size_t totalBytes {};
+
+  auto start = std::chrono::steady_clock::now();
+  for (size_t index = 0; index < ZSLIB_EVENTING_TEST_JSON_BENCHMARK_EVENTS; ++index) {
+    totalBytes += referenceEventJSON(data.mReferenceEvents, full, &origin, false).length();
+  }
+  double referenceSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  // the monitor keeps one buffer per thread and only clears it between events
+  std::string output;
+  start = std::chrono::steady_clock::now();
+  for (size_t index = 0; index < ZSLIB_EVENTING_TEST_JSON_BENCHMARK_EVENTS; ++index) {
+    output.clear();
+    Monitor::writeEventJSON(output, &(data.mPlans), full.mSeverity, full.mLevel, &origin, &(full.mDescriptor), &(full.mParams[0]), &(full.mData[0]), full.mData.size(), false, warnings);
+    totalBytes -= output.length();
+  }
+  double writerSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  TESTING_CHECK(0 == totalBytes);
+
+  if (referenceSeconds <= 0) referenceSeconds = 1e-9;
+  if (writerSeconds <= 0) writerSeconds = 1e-9;
+
+  TESTING_STDOUT() << "  json: element tree: " << static_cast<uint64_t>(ZSLIB_EVENTING_TEST_JSON_BENCHMARK_EVENTS / referenceSeconds) << " events/s\n";
+  TESTING_STDOUT() << "  json: writer: " << static_cast<uint64_t>(ZSLIB_EVENTING_TEST_JSON_BENCHMARK_EVENTS / writerSeconds) << " events/s (" << (referenceSeconds / writerSeconds) << "x)\n";
+}
@@ -0,0 +1,462 @@
+/*
+
+Copyright (c) 2016, Robin Raymond
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+*/
+
+#include "RemoteEventingTester.h"
+#include "testing.h"
+
+using zsLib::eventing::IRemoteEventingTypes;
+using zsLib::eventing::internal::RemoteEventing;
+using zsLib::eventing::test::EventCapture;
+using zsLib::eventing::test::EventCapturePtr;
+using zsLib::eventing::test::RemoteEventingTester;
+using zsLib::eventing::test::RemoteEventingTesterPtr;
+using zsLib::eventing::test::TestEvent;
+using zsLib::eventing::test::TestEventList;
+using zsLib::eventing::test::TestProvider;
+
+namespace
+{
+  using zsLib::eventing::test::appendBE16;
+  using zsLib::eventing::test::appendBE32;
+  using zsLib::eventing::test::appendBE64;
+  using zsLib::eventing::test::appendVarint;
+  using zsLib::eventing::test::appendString;
+  using zsLib::eventing::test::checkEvents;
+  using zsLib::eventing::test::createSampleEvents;
+
+  //---------------------------------------------------------------------------
+  // the event header bytes (descriptor plus parameter types) of a packed event
+  std::string eventHeader(const TestEvent &event)
+  {
+    size_t offset = (sizeof(uint32_t)*2) + ZSLIB_EVENTING_TEST_EVENT_ORIGIN_SIZE + sizeof(uint64_t);
+    size_t size = (sizeof(uint16_t)*5) + (sizeof(uint8_t)*4) + sizeof(uint64_t) + (sizeof(uint16_t)*event.mParameters.size());
+    return event.pack().substr(offset, size);
+  }
+
+  //---------------------------------------------------------------------------
+  void testRoundTrip(
+                     const char *name,
+                     const RemoteEventingTester::Options &options,
+                     EventCapturePtr capture
+                     )
+  {
+    TESTING_STDOUT() << "  round trip: " << name << "\n";
+
+    auto sender = RemoteEventingTester::create(options);
+    auto receiver = RemoteEventingTester::create(options);
+
+    auto provider1 = TestProvider::create(0);
+    auto provider2 = TestProvider::create(1);
+    sender->announce(provider1, *receiver);
+    sender->announce(provider2, *receiver);
+
+    auto events = createSampleEvents(provider1, provider2);
+    for (auto iter = events.begin(); iter != events.end(); ++iter) {
+      sender->send(*iter);
+    }
+
+    // a frame split across reads is carried over to the next read
+    std::string wire = sender->takeWire();
+    TESTING_CHECK(wire.length() > 0);
+    receiver->receive(wire.substr(0, wire.length() / 2));
+    receiver->receive(wire.substr(wire.length() / 2));
+
+    checkEvents(events, capture->takeEvents(), options.mEventOrigin);
+    TESTING_EQUAL(IRemoteEventingTypes::State_Connected, receiver->getState());
+
+    // the stream state carries over to the next flush
+    for (auto iter = events.begin(); iter != events.end(); ++iter) {
+      sender->send(*iter);
+    }
+    receiver->receive(sender->takeWire());
+
+    checkEvents(events, capture->takeEvents(), options.mEventOrigin);
+    TESTING_EQUAL(IRemoteEventingTypes::State_Connected, receiver->getState());
+  }
+
+  //---------------------------------------------------------------------------
+  void testCompactInterning(EventCapturePtr capture)
+  {
+    TESTING_STDOUT() << "  compact interned strings\n";
+
+    RemoteEventingTester::Options options;
+    options.mCompact = true;
+
+    auto sender = RemoteEventingTester::create(options);
+    auto receiver = RemoteEventingTester::create(options);
+
+    auto provider = TestProvider::create(0);
+    sender->announce(provider, *receiver);
+
+    std::string longString(1024, 'x');
+
+    TestEvent event = TestEvent::create(provider, 10);
+    event.addString("interned string value");
+    event.addString(longString.c_str());   // too long to be interned so always inline
+
+    sender->send(event);
+    std::string first = sender->takeWire();
+    sender->send(event);
+    std::string second = sender->takeWire();
+
+    // the repeat only references the provider, descriptor and string already defined
+    TESTING_CHECK(second.length() < first.length());
+    TESTING_CHECK(std::string::npos != first.find("interned string value"));
+    TESTING_CHECK(std::string::npos == second.find("interned string value"));
+    TESTING_CHECK(std::string::npos != second.find(longString));
+
+    receiver->receive(first);
+    receiver->receive(second);
+
+    TestEventList expected;
+    expected.push_back(event);
+    expected.push_back(event);
+    checkEvents(expected, capture->takeEvents(), false);
+    TESTING_EQUAL(IRemoteEventingTypes::State_Connected, receiver->getState());
+  }
+
+  //---------------------------------------------------------------------------
+  void testSessionDelta()
+  {
+    TESTING_STDOUT() << "  session delta\n";
+
+    RemoteEventingTester::Options options;
+    options.mDenseProviders = true;
+
+    auto sender = RemoteEventingTester::create(options);
+    auto receiver = RemoteEventingTester::create(options);
+
+    auto provider1 = TestProvider::create(0);
+    auto provider2 = TestProvider::create(1);
+
+    sender->addLocalSubsystem("zsLib_eventing_test");
+    sender->addLocalProvider(provider1, 0x3);
+    sender->addLocalProvider(provider2, 0);
+
+    receiver->receive(sender->takeSessionDelta());
+    TESTING_CHECK(receiver->hasRemoteSubsystem("zsLib_eventing_test"));
+    TESTING_CHECK(receiver->hasRemoteProvider(provider1));
+    TESTING_CHECK(receiver->hasRemoteProvider(provider2));
+    TESTING_EQUAL(0x3, receiver->getRemoteProviderKeywords(provider1));
+    TESTING_EQUAL(0, receiver->getRemoteProviderKeywords(provider2));
+
+    // nothing changed so nothing is sent
+    TESTING_CHECK(sender->takeSessionDelta().empty());
+
+    sender->setLocalProviderKeywords(provider1, 0x5);
+    sender->removeLocalProvider(provider2);
+
+    receiver->receive(sender->takeSessionDelta());
+    TESTING_CHECK(receiver->hasRemoteProvider(provider1));
+    TESTING_CHECK(!receiver->hasRemoteProvider(provider2));
+    TESTING_EQUAL(0x5, receiver->getRemoteProviderKeywords(provider1));
+    TESTING_EQUAL(IRemoteEventingTypes::State_Connected, receiver->getState());
+  }
+
+  //---------------------------------------------------------------------------
+  void expectDisconnect(
+                        const char *name,
+                        const RemoteEventingTester::Options &options,
+                        RemoteEventing::MessageTypes messageType,
+                        const std::string &payload,
+                        bool expectDisconnected = true
+                        )
+  {
+    TESTING_STDOUT() << "  malformed: " << name << "\n";
+
+    auto sender = RemoteEventingTester::create(options);
+    auto receiver = RemoteEventingTester::create(options);
+
+    auto provider = TestProvider::create(0);
+    sender->announce(provider, *receiver);
+
+    receiver->receiveFrame(messageType, payload);
+    TESTING_EQUAL(expectDisconnected ? IRemoteEventingTypes::State_Shutdown : IRemoteEventingTypes::State_Connected, receiver->getState());
+  }
+
+  //---------------------------------------------------------------------------
+  void testMalformedCompact()
+  {
+    RemoteEventingTester::Options options;
+    options.mCompact = true;
+
+    auto provider = TestProvider::create(0);
+
+    TestEvent stringEvent = TestEvent::create(provider, 20);
+    stringEvent.addString("value");
+
+    std::string providerRecord;
+    providerRecord.append(1, static_cast<char>(ZSLIB_EVENTING_TEST_COMPACT_RECORD_PROVIDER));
+    appendVarint(providerRecord, 0);
+    appendBE64(providerRecord, 1);
+
+    std::string descriptorRecord;
+    descriptorRecord.append(1, static_cast<char>(ZSLIB_EVENTING_TEST_COMPACT_RECORD_DESCRIPTOR));
+    descriptorRecord.append(1, '\0');
+    descriptorRecord.append(eventHeader(stringEvent));
+
+    {
+      RemoteEventingTester::Options notNegotiated;
+      expectDisconnect("compact not negotiated", notNegotiated, RemoteEventing::MessageType_TraceEventCompact, providerRecord);
+    }
+    expectDisconnect("compact definitions only", options, RemoteEventing::MessageType_TraceEventCompact, providerRecord + descriptorRecord, false);
+    {
+      std::string payload;
+      payload.append(1, static_cast<char>(ZSLIB_EVENTING_TEST_COMPACT_RECORD_PROVIDER));
+      appendVarint(payload, 5);
+      appendBE64(payload, 1);
+      expectDisconnect("compact provider index skips ahead", options, RemoteEventing::MessageType_TraceEventCompact, payload);
+    }
+    {
+      std::string payload;
+      payload.append(1, static_cast<char>(ZSLIB_EVENTING_TEST_COMPACT_RECORD_PROVIDER));
+      appendVarint(payload, 0);
+      payload.append(3, '\0');
+      expectDisconnect("compact provider handle truncated", options, RemoteEventing::MessageType_TraceEventCompact, payload);
+    }
+    {
+      std::string payload(providerRecord);
+      payload.append(1, static_cast<char>(ZSLIB_EVENTING_TEST_COMPACT_RECORD_DESCRIPTOR));
+      payload.append(1, '\0');
+      payload.append(eventHeader(stringEvent).substr(0, 5));
+      expectDisconnect("compact descriptor truncated", options, RemoteEventing::MessageType_TraceEventCompact, payload);
+    }
+    {
+      std::string payload;
+      payload.append(1, static_cast<char>(ZSLIB_EVENTING_TEST_COMPACT_RECORD_STRING));
+      appendVarint(payload, 0);
+      appendString(payload, "x");
+      expectDisconnect("compact inline string id defined", options, RemoteEventing::MessageType_TraceEventCompact, payload);
+    }
+    {
+      std::string payload;
+      payload.append(1, static_cast<char>(ZSLIB_EVENTING_TEST_COMPACT_RECORD_STRING));
+      appendVarint(payload, ZSLIB_EVENTING_TEST_COMPACT_MAX_INTERNED_STRINGS + 1);
+      appendString(payload, "x");
+      expectDisconnect("compact string id out of range", options, RemoteEventing::MessageType_TraceEventCompact, payload);
+    }
+    {
+      std::string payload;
+      payload.append(1, static_cast<char>(ZSLIB_EVENTING_TEST_COMPACT_RECORD_STRING));
+      appendVarint(payload, 1);
+      appendVarint(payload, 10);
+      payload.append("abc");
+      expectDisconnect("compact string longer than record", options, RemoteEventing::MessageType_TraceEventCompact, payload);
+    }
+    {
+      std::string payload(providerRecord);
+      payload.append(1, static_cast<char>(ZSLIB_EVENTING_TEST_COMPACT_RECORD_EVENT));
+      appendVarint(payload, 0);
+      payload.append(1, static_cast<char>(5));
+      expectDisconnect("compact event with undefined descriptor", options, RemoteEventing::MessageType_TraceEventCompact, payload);
+    }
+    {
+      std::string payload(descriptorRecord);
+      payload.append(1, static_cast<char>(ZSLIB_EVENTING_TEST_COMPACT_RECORD_EVENT));
+      appendVarint(payload, 0);
+      payload.append(1, '\0');
+      appendVarint(payload, 0);
+      appendString(payload, "value");
+      expectDisconnect("compact event with undefined provider", options, RemoteEventing::MessageType_TraceEventCompact, payload);
+    }
+    {
+      std::string payload(providerRecord + descriptorRecord);
+      payload.append(1, static_cast<char>(ZSLIB_EVENTING_TEST_COMPACT_RECORD_EVENT));
+      appendVarint(payload, 0);
+      payload.append(1, '\0');
+      appendVarint(payload, 9);
+      expectDisconnect("compact event with undefined string", options, RemoteEventing::MessageType_TraceEventCompact, payload);
+    }
+    {
+      std::string payload(providerRecord + descriptorRecord);
+      payload.append(1, static_cast<char>(ZSLIB_EVENTING_TEST_COMPACT_RECORD_EVENT));
+      appendVarint(payload, 0);
+      payload.append(1, '\0');
+      appendVarint(payload, 0);
+      appendVarint(payload, 100);
+      payload.append("value");
+      expectDisconnect("compact event data longer than record", options, RemoteEventing::MessageType_TraceEventCompact, payload);
+    }
+    {
+      std::string payload(providerRecord);
+      payload.append(1, static_cast<char>(9));
+      expectDisconnect("compact unknown record", options, RemoteEventing::MessageType_TraceEventCompact, payload);
+    }
+    {
+      std::string payload;
+      payload.append(1, static_cast<char>(ZSLIB_EVENTING_TEST_COMPACT_RECORD_STRING));
+      payload.append(1, '\x80');
+      expectDisconnect("compact truncated varint", options, RemoteEventing::MessageType_TraceEventCompact, payload);
+    }
+  }
+
+  //---------------------------------------------------------------------------
+  void testMalformedSessionDelta()
+  {
+    RemoteEventingTester::Options options;
+
+    auto provider = TestProvider::create(0);
+
+    {
+      std::string payload;
+      payload.append(1, static_cast<char>(ZSLIB_EVENTING_TEST_SESSION_RECORD_SUBSYSTEM));
+      appendString(payload, "zsLib_eventing_test");
+      expectDisconnect("session delta subsystem", options, RemoteEventing::MessageType_SessionDelta, payload, false);
+    }
+    {
+      std::string payload;
+      payload.append(1, static_cast<char>(7));
+      expectDisconnect("session delta unknown record", options, RemoteEventing::MessageType_SessionDelta, payload);
+    }
+    {
+      std::string payload;
+      payload.append(1, static_cast<char>(ZSLIB_EVENTING_TEST_SESSION_RECORD_SUBSYSTEM));
+      appendVarint(payload, 10);
+      payload.append("abc");
+      expectDisconnect("session delta subsystem truncated", options, RemoteEventing::MessageType_SessionDelta, payload);
+    }
+    {
+      std::string payload;
+      payload.append(1, static_cast<char>(ZSLIB_EVENTING_TEST_SESSION_RECORD_PROVIDER));
+      appendVarint(payload, 0x20000);
+      appendVarint(payload, 0);
+      appendString(payload, "not-a-uuid");
+      appendString(payload, provider.mProviderName.c_str());
+      appendString(payload, provider.mProviderHash.c_str());
+      appendVarint(payload, 0);
+      expectDisconnect("session delta provider with bad uuid", options, RemoteEventing::MessageType_SessionDelta, payload);
+    }
+    {
+      std::string payload;
+      payload.append(1, static_cast<char>(ZSLIB_EVENTING_TEST_SESSION_RECORD_PROVIDER));
+      appendVarint(payload, 0x20000);
+      appendVarint(payload, 0);
+      appendString(payload, zsLib::string(provider.mProviderID).c_str());
+      expectDisconnect("session delta provider truncated", options, RemoteEventing::MessageType_SessionDelta, payload);
+    }
+    {
+      std::string payload;
+      payload.append(1, static_cast<char>(ZSLIB_EVENTING_TEST_SESSION_RECORD_PROVIDER_GONE));
+      expectDisconnect("session delta provider gone truncated", options, RemoteEventing::MessageType_SessionDelta, payload);
+    }
+    {
+      std::string payload;
+      payload.append(1, static_cast<char>(ZSLIB_EVENTING_TEST_SESSION_RECORD_PROVIDER_KEYWORDS));
+      appendVarint(payload, provider.mHandle);
+      expectDisconnect("session delta keywords truncated", options, RemoteEventing::MessageType_SessionDelta, payload);
+    }
+    {
+      std::string payload;
+      payload.append(1, static_cast<char>(ZSLIB_EVENTING_TEST_SESSION_RECORD_PROVIDER_KEYWORDS));
+      payload.append(1, '\xFF');
+      expectDisconnect("session delta truncated varint", options, RemoteEventing::MessageType_SessionDelta, payload);
+    }
+  }
+
+  //---------------------------------------------------------------------------
+  void testMessageSizeLimit()
+  {
+    RemoteEventingTester::Options options;
+
+    // a document far larger than the incoming buffer and the event limits of
+    // either party is still accepted once authorized
+    {
+      std::string payload = "{\"notify\":{\"type\":\"padding\",\"padding\":\"";
+      payload.append(4*1024*1024, 'x');
+      payload.append("\"}}");
+      expectDisconnect("large document", options, RemoteEventing::MessageType_Notify, payload, false);
+    }
+
+    // a frame beyond the protocol maximum is refused from its size alone
+    {
+      TESTING_STDOUT() << "  malformed: frame exceeds protocol maximum\n";
+
+      auto receiver = RemoteEventingTester::create(options);
+
+      std::string wire;
+      appendBE32(wire, ZSLIB_EVENTING_TEST_MAX_MESSAGE_SIZE + 1);
+      appendBE32(wire, RemoteEventing::MessageType_Notify);
+      receiver->receive(wire);
+      TESTING_EQUAL(IRemoteEventingTypes::State_Shutdown, receiver->getState());
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+void doTestRemoteEventingFormats()
+{
+  EventCapturePtr capture = EventCapture::create();
+
+  {
+    RemoteEventingTester::Options options;
+    testRoundTrip("single events", options, capture);
+
+    options.mEventOrigin = true;
+    testRoundTrip("single events with origin", options, capture);
+
+    options.mBigEndianWire = true;
+    testRoundTrip("single events with big endian scalars", options, capture);
+  }
+  {
+    RemoteEventingTester::Options options;
+    options.mBatches = true;
+    testRoundTrip("batch", options, capture);
+
+    options.mEventOrigin = true;
+    options.mDenseProviders = true;
+    testRoundTrip("batch with origin and dense providers", options, capture);
+
+    options.mBigEndianWire = true;
+    testRoundTrip("batch with big endian scalars", options, capture);
+  }
+  {
+    RemoteEventingTester::Options options;
+    options.mBatches = true;
+    options.mCompact = true;
+    testRoundTrip("compact", options, capture);
+
+    options.mEventOrigin = true;
+    options.mDenseProviders = true;
+    testRoundTrip("compact with origin and dense providers", options, capture);
+
+    options.mBigEndianWire = true;
+    testRoundTrip("compact with big endian scalars", options, capture);
+  }
+
+  testCompactInterning(capture);
+  testSessionDelta();
+  testMalformedCompact();
+  testMalformedSessionDelta();
+  testMessageSizeLimit();
+
+  TESTING_CHECK(capture->takeEvents().empty());
+  capture->shutdown();
+}
@@ -0,0 +1,551 @@
+/*
+
+Copyright (c) 2016, Robin Raymond
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+*/
+
+#include "RemoteEventingTester.h"
+#include "testing.h"
+
+#include <zsLib/ISettings.h>
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <thread>
+
+using zsLib::eventing::IRemoteEventingTypes;
+using zsLib::eventing::internal::RemoteEventing;
+using zsLib::eventing::test::EventCapture;
+using zsLib::eventing::test::EventCapturePtr;
+using zsLib::eventing::test::RemoteEventingTester;
+using zsLib::eventing::test::RemoteEventingTesterPtr;
+using zsLib::eventing::test::TestEvent;
+using zsLib::eventing::test::TestEventList;
+using zsLib::eventing::test::TestProvider;
+
+// a round stays well below the outgoing queue limit so no event is dropped
+#define ZSLIB_EVENTING_TEST_BENCHMARK_ROUNDS (250)
+#define ZSLIB_EVENTING_TEST_BENCHMARK_EVENTS_PER_ROUND (400)
+
+#define ZSLIB_EVENTING_TEST_MAX_DENSE_PROVIDERS (0xFFFF)
+
+#define ZSLIB_EVENTING_TEST_RECEIVE_WORKERS (2)
+#define ZSLIB_EVENTING_TEST_RECEIVE_WORKER_MAX_QUEUED (8)
+#define ZSLIB_EVENTING_TEST_RECEIVE_WORKER_WAIT_SECONDS (10)
+
+namespace
+{
+  using zsLib::eventing::test::appendBE64;
+  using zsLib::eventing::test::checkEvent;
+  using zsLib::eventing::test::checkEvents;
+
+  //---------------------------------------------------------------------------
+  TestEvent createEvent(
+                        const TestProvider &provider,
+                        uint16_t eventID,
+                        uint64_t value
+                        )
+  {
+    TestEvent event = TestEvent::create(provider, eventID, 1000000 + value);
+    event.addString("receive");
+    event.addInteger(zsLib::eventing::EventParameterType_UnsignedInteger, value, sizeof(uint32_t));
+    event.addInteger(zsLib::eventing::EventParameterType_SignedInteger, static_cast<uint64_t>(-static_cast<int64_t>(value)), sizeof(int64_t));
+    event.addFloat(static_cast<double>(value) / 4);
+    return event;
+  }
+
+  //---------------------------------------------------------------------------
+  // a single event payload (without origin) about the provider as given
+  std::string eventPayload(
+                           const TestEvent &event,
+                           uint64_t remoteProvider
+                           )
+  {
+    size_t headerOffset = (sizeof(uint32_t)*2) + ZSLIB_EVENTING_TEST_EVENT_ORIGIN_SIZE + sizeof(uint64_t);
+
+    std::string result;
+    appendBE64(result, remoteProvider);
+    result.append(event.pack().substr(headerOffset));
+    return result;
+  }
+
+  //---------------------------------------------------------------------------
+  void checkReceived(
+                     const TestEvent &expected,
+                     EventCapturePtr capture
+                     )
+  {
+    auto received = capture->takeEvents();
+    TESTING_CHECK(1 == received.size());
+    if (received.empty()) return;
+    checkEvent(expected, received.front(), false);
+  }
+
+  //---------------------------------------------------------------------------
+  void testDenseIndexDecode(EventCapturePtr capture)
+  {
+    TESTING_STDOUT() << "  decode: dense provider index\n";
+
+    RemoteEventingTester::Options options;
+    options.mDenseProviders = true;
+
+    auto sender = RemoteEventingTester::create(options);
+    auto receiver = RemoteEventingTester::create(options);
+
+    // index 1 and 2 are never announced so the table has a hole
+    auto provider0 = TestProvider::create(0);
+    auto provider3 = TestProvider::create(3);
+    sender->announce(provider0, *receiver);
+    sender->announce(provider3, *receiver);
+
+    // the wire carries the index rather than the provider handle
+    TestEvent event = createEvent(provider3, 1, 7);
+    sender->send(event);
+    std::string wire = sender->takeWire();
+    {
+      std::string expectedIndex;
+      appendBE64(expectedIndex, 3);
+      TESTING_CHECK(wire.length() > (sizeof(uint32_t)*2) + sizeof(uint64_t));
+      TESTING_CHECK(expectedIndex == wire.substr(sizeof(uint32_t)*2, sizeof(uint64_t)));
+    }
+    receiver->receive(wire);
+    checkReceived(event, capture);
+
+    TestEvent event0 = createEvent(provider0, 1, 8);
+    receiver->receiveFrame(RemoteEventing::MessageType_TraceEvent, eventPayload(event0, 0));
+    checkReceived(event0, capture);
+
+    // unannounced indexes are ignored without dropping the connection
+    receiver->receiveFrame(RemoteEventing::MessageType_TraceEvent, eventPayload(event, 2));
+    receiver->receiveFrame(RemoteEventing::MessageType_TraceEvent, eventPayload(event, 4));
+    receiver->receiveFrame(RemoteEventing::MessageType_TraceEvent, eventPayload(event, 0xFFFFFFFFFFFFFFFFULL));
+
+    // the provider handle is not an index once dense indexes are negotiated
+    receiver->receiveFrame(RemoteEventing::MessageType_TraceEvent, eventPayload(event, static_cast<uint64_t>(provider3.mHandle)));
+
+    TESTING_CHECK(capture->takeEvents().empty());
+    TESTING_EQUAL(IRemoteEventingTypes::State_Connected, receiver->getState());
+  }
+
+  //---------------------------------------------------------------------------
+  void testProviderIndexReuse(
+                              bool denseProviders,
+                              EventCapturePtr capture
+                              )
+  {
+    TESTING_STDOUT() << "  decode: provider index reuse" << (denseProviders ? " (dense)" : "") << "\n";
+
+    RemoteEventingTester::Options options;
+    options.mDenseProviders = denseProviders;
+
+    auto sender = RemoteEventingTester::create(options);
+    auto receiver = RemoteEventingTester::create(options);
+
+    // more registrations than the dense table holds, only one alive at a time
+    uint32_t highestIndex {};
+    for (uint32_t loop = 0; loop <= ZSLIB_EVENTING_TEST_MAX_DENSE_PROVIDERS + 1; ++loop) {
+      // both parties share the process so the announced provider stands in for the writer
+      auto writer = TestProvider::create(0);
+      auto provider = TestProvider::create(0);
+      auto handle = sender->registerLocalWriter(writer, provider.mIndex);
+      highestIndex = std::max(highestIndex, provider.mIndex);
+
+      sender->announce(provider, *receiver);
+      if (0 == (loop % 4096)) {
+        TestEvent event = createEvent(provider, 1, loop);
+        sender->send(event);
+        receiver->receive(sender->takeWire());
+        checkReceived(event, capture);
+      }
+      sender->unannounce(provider, *receiver);
+      sender->unregisterLocalWriter(handle);
+    }
+
+    TESTING_CHECK(0 == highestIndex);
+    TESTING_CHECK(1 == receiver->getRemoteProviderTableSize());
+
+    if (denseProviders) {
+      // an index beyond the table is still decoded through the overflow lookup
+      auto provider = TestProvider::create(ZSLIB_EVENTING_TEST_MAX_DENSE_PROVIDERS + 5);
+      sender->announce(provider, *receiver);
+      TESTING_CHECK(1 == receiver->getRemoteProviderTableSize());
+
+      TestEvent event = createEvent(provider, 1, 9);
+      sender->send(event);
+      receiver->receive(sender->takeWire());
+      checkReceived(event, capture);
+
+      sender->unannounce(provider, *receiver);
+      receiver->receiveFrame(RemoteEventing::MessageType_TraceEvent, eventPayload(event, provider.mIndex));
+      TESTING_CHECK(capture->takeEvents().empty());
+    }
+
+    TESTING_EQUAL(IRemoteEventingTypes::State_Connected, receiver->getState());
+  }
+
+  //---------------------------------------------------------------------------
+  void testHeaderCache(
+                       const char *name,
+                       const RemoteEventingTester::Options &options,
+                       EventCapturePtr capture
+                       )
+  {
+    TESTING_STDOUT() << "  decode: header cache (" << name << ")\n";
+
+    auto sender = RemoteEventingTester::create(options);
+    auto receiver = RemoteEventingTester::create(options);
+
+    auto provider = TestProvider::create(0);
+    sender->announce(provider, *receiver);
+
+    TESTING_CHECK(NULL == receiver->getCachedEventHeader(provider, 5));
+
+    TestEvent event = createEvent(provider, 5, 1);
+    sender->send(event);
+    receiver->receive(sender->takeWire());
+    checkReceived(event, capture);
+
+    auto cached = receiver->getCachedEventHeader(provider, 5);
+    TESTING_CHECK(NULL != cached);
+    if (!cached) return;
+    TESTING_CHECK(cached->mDefined);
+    TESTING_EQUAL(5, cached->mHeader.mDescriptor.Id);
+
+    // hit: the same header bytes reuse the decoded header as is, which the
+    // altered severity proves as decoding the bytes again would restore it
+    cached->mHeader.mSeverity = zsLib::Log::Error;
+
+    TestEvent repeat = createEvent(provider, 5, 2);
+    sender->send(repeat);
+    receiver->receive(sender->takeWire());
+    {
+      TestEvent expected = repeat;
+      expected.mSeverity = zsLib::Log::Error;
+      checkReceived(expected, capture);
+    }
+
+    // miss: a different event mapping to the same slot replaces the entry
+    TestEvent other = createEvent(provider, 5 + 32, 3);
+    other.mLevel = zsLib::Log::Debug;
+    TESTING_CHECK(cached == receiver->getCachedEventHeader(provider, 5 + 32));
+    sender->send(other);
+    receiver->receive(sender->takeWire());
+    checkReceived(other, capture);
+    TESTING_CHECK(cached->mDefined);
+    TESTING_EQUAL(5 + 32, cached->mHeader.mDescriptor.Id);
+
+    // miss: the same event ID with different header bytes is decoded again
+    TestEvent changed = createEvent(provider, 5, 4);
+    changed.addString("extra");
+    sender->send(changed);
+    receiver->receive(sender->takeWire());
+    checkReceived(changed, capture);
+    TESTING_EQUAL(5, cached->mHeader.mDescriptor.Id);
+    TESTING_EQUAL(changed.mParameters.size(), cached->mHeader.mDescriptorCount);
+
+    // a header too short to be cached never touches the slot
+    std::string truncated = eventPayload(event, static_cast<uint64_t>(provider.mHandle));
+    truncated.resize(sizeof(uint64_t) + 4);
+    receiver->receiveFrame(RemoteEventing::MessageType_TraceEvent, truncated);
+    TESTING_CHECK(capture->takeEvents().empty());
+    TESTING_EQUAL(5, cached->mHeader.mDescriptor.Id);
+
+    TESTING_EQUAL(IRemoteEventingTypes::State_Connected, receiver->getState());
+  }
+
+  //---------------------------------------------------------------------------
+  // the receive workers write on their own threads so their progress is polled
+  template <typename Condition>
+  bool waitFor(Condition condition)
+  {
+    auto expires = std::chrono::steady_clock::now() + std::chrono::seconds(ZSLIB_EVENTING_TEST_RECEIVE_WORKER_WAIT_SECONDS);
+    while (!condition()) {
+      if (std::chrono::steady_clock::now() > expires) return false;
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+  }
+
+  //---------------------------------------------------------------------------
+  RemoteEventingTesterPtr createWorkerReceiver(const RemoteEventingTester::Options &options)
+  {
+    // the workers are configured from the settings when the party is created
+    zsLib::ISettings::setUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_RECEIVE_WORKER_THREADS, ZSLIB_EVENTING_TEST_RECEIVE_WORKERS);
+    zsLib::ISettings::setUInt(ZSLIB_EVENTING_SETTING_REMOTE_EVENTING_MAX_RECEIVE_WORKER_QUEUED_EVENTS, ZSLIB_EVENTING_TEST_RECEIVE_WORKER_MAX_QUEUED);
+    auto receiver = RemoteEventingTester::create(options);
+    zsLib::ISettings::applyDefaults();
+    return receiver;
+  }
+
+  //---------------------------------------------------------------------------
+  void waitForShutdown(RemoteEventingTesterPtr receiver)
+  {
+    TESTING_CHECK(waitFor([receiver]() { return IRemoteEventingTypes::State_Shutdown == receiver->getState(); }));
+  }
+
+  //---------------------------------------------------------------------------
+  void testReceiveWorkerOrder(EventCapturePtr capture)
+  {
+    TESTING_STDOUT() << "  receive workers: per provider order\n";
+
+    RemoteEventingTester::Options options;
+    auto sender = RemoteEventingTester::create(options);
+    auto receiver = createWorkerReceiver(options);
+
+    // without an origin the events are spread across the workers by provider
+    TestProvider providers[4];
+    for (size_t index = 0; index < 4; ++index) {
+      providers[index] = TestProvider::create(0);
+      sender->announce(providers[index], *receiver);
+    }
+
+    // far more events than a worker queues so reading pauses and resumes repeatedly
+    std::map<zsLib::String, TestEventList> expected;
+    size_t total = ZSLIB_EVENTING_TEST_RECEIVE_WORKER_MAX_QUEUED * 25;
+    for (size_t loop = 0; loop < total; ++loop) {
+      auto &provider = providers[loop % 4];
+      TestEvent event = createEvent(provider, 1, loop);
+      sender->send(event);
+      expected[provider.mProviderName].push_back(event);
+    }
+
+    size_t totalBefore = capture->getTotalEvents();
+    receiver->receive(sender->takeWire());
+    TESTING_CHECK(waitFor([capture, totalBefore, total]() { return totalBefore + total == capture->getTotalEvents(); }));
+
+    std::map<zsLib::String, TestEventList> received;
+    auto events = capture->takeEvents();
+    for (auto iter = events.begin(); iter != events.end(); ++iter) {
+      received[(*iter).mProviderName].push_back(*iter);
+    }
+
+    TESTING_EQUAL(expected.size(), received.size());
+    for (auto iter = expected.begin(); iter != expected.end(); ++iter) {
+      checkEvents((*iter).second, received[(*iter).first], false);
+    }
+
+    TESTING_EQUAL(IRemoteEventingTypes::State_Connected, receiver->getState());
+    receiver->shutdown();
+    waitForShutdown(receiver);
+  }
+
+  //---------------------------------------------------------------------------
+  void testReceiveWorkerPause(EventCapturePtr capture)
+  {
+    TESTING_STDOUT() << "  receive workers: pause and resume\n";
+
+    RemoteEventingTester::Options options;
+    auto sender = RemoteEventingTester::create(options);
+    auto receiver = createWorkerReceiver(options);
+
+    auto provider = TestProvider::create(0);
+    sender->announce(provider, *receiver);
+
+    // the first event holds up its worker so everything after it stays queued
+    TestEventList expected;
+    size_t totalBefore = capture->getTotalEvents();
+    capture->holdWrites();
+
+    expected.push_back(createEvent(provider, 1, 0));
+    sender->send(expected.back());
+    receiver->receive(sender->takeWire());
+    TESTING_CHECK(waitFor([capture]() { return 1 == capture->getWaitingWrites(); }));
+
+    // one frame per event; reading stops once the queue is full and the
+    // events beyond it are left in the incoming buffer
+    for (size_t loop = 1; loop <= ZSLIB_EVENTING_TEST_RECEIVE_WORKER_MAX_QUEUED + 3; ++loop) {
+      expected.push_back(createEvent(provider, 1, loop));
+      sender->send(expected.back());
+    }
+    receiver->receive(sender->takeWire());
+
+    TESTING_CHECK(receiver->isReceivePaused());
+    TESTING_EQUAL(totalBefore, capture->getTotalEvents());
+
+    // reading resumes only once the queue has drained to half
+    for (size_t release = 1; release <= (ZSLIB_EVENTING_TEST_RECEIVE_WORKER_MAX_QUEUED / 2) + 1; ++release) {
+      capture->releaseWrites(1);
+      TESTING_CHECK(waitFor([capture, totalBefore, release]() { return (totalBefore + release == capture->getTotalEvents()) && (1 == capture->getWaitingWrites()); }));
+      if (release <= (ZSLIB_EVENTING_TEST_RECEIVE_WORKER_MAX_QUEUED / 2)) {
+        TESTING_CHECK(receiver->isReceivePaused());
+      }
+    }
+    TESTING_CHECK(waitFor([receiver]() { return !receiver->isReceivePaused(); }));
+
+    capture->releaseAllWrites();
+    size_t total = expected.size();
+    TESTING_CHECK(waitFor([capture, totalBefore, total]() { return totalBefore + total == capture->getTotalEvents(); }));
+    checkEvents(expected, capture->takeEvents(), false);
+
+    TESTING_EQUAL(IRemoteEventingTypes::State_Connected, receiver->getState());
+    receiver->shutdown();
+    waitForShutdown(receiver);
+  }
+
+  //---------------------------------------------------------------------------
+  void testReceiveWorkerShutdownWhilePaused(EventCapturePtr capture)
+  {
+    TESTING_STDOUT() << "  receive workers: shutdown while paused\n";
+
+    RemoteEventingTester::Options options;
+    auto sender = RemoteEventingTester::create(options);
+    auto receiver = createWorkerReceiver(options);
+
+    auto provider = TestProvider::create(0);
+    sender->announce(provider, *receiver);
+
+    TestEventList expected;
+    size_t totalBefore = capture->getTotalEvents();
+    capture->holdWrites();
+
+    expected.push_back(createEvent(provider, 1, 0));
+    sender->send(expected.back());
+    receiver->receive(sender->takeWire());
+    TESTING_CHECK(waitFor([capture]() { return 1 == capture->getWaitingWrites(); }));
+
+    for (size_t loop = 1; loop <= ZSLIB_EVENTING_TEST_RECEIVE_WORKER_MAX_QUEUED; ++loop) {
+      expected.push_back(createEvent(provider, 1, loop));
+      sender->send(expected.back());
+    }
+    receiver->receive(sender->takeWire());
+    TESTING_CHECK(receiver->isReceivePaused());
+
+    // shutting down may wait on the eventing lock the held up writer is inside
+    // of so it is started from another thread before the writes are released
+    std::thread shutdownThread([receiver]() { receiver->shutdown(); });
+
+    capture->releaseAllWrites();
+    shutdownThread.join();
+    waitForShutdown(receiver);
+
+    // every queued event is written before the workers stop
+    TESTING_EQUAL(totalBefore + expected.size(), capture->getTotalEvents());
+    checkEvents(expected, capture->takeEvents(), false);
+  }
+
+  //---------------------------------------------------------------------------
+  // events per second decoded and written to the listeners; the sender
+  // encodes each round outside of the timed section
+  void benchmarkReceive(
+                        const char *name,
+                        const RemoteEventingTester::Options &options,
+                        bool cacheMisses,
+                        EventCapturePtr capture
+                        )
+  {
+    auto sender = RemoteEventingTester::create(options);
+    auto receiver = RemoteEventingTester::create(options);
+
+    auto provider = TestProvider::create(0);
+    sender->announce(provider, *receiver);
+
+    // alternating between event IDs 32 apart makes every header a cache miss
+    TestEvent events[2] = {createEvent(provider, 1, 1), createEvent(provider, 1 + (cacheMisses ? 32 : 0), 2)};
+
+    size_t totalBefore = capture->getTotalEvents();
+    size_t totalBytes {};
+    std::chrono::steady_clock::duration elapsed {};
+
+    for (size_t round = 0; round < ZSLIB_EVENTING_TEST_BENCHMARK_ROUNDS; ++round) {
+      for (size_t index = 0; index < ZSLIB_EVENTING_TEST_BENCHMARK_EVENTS_PER_ROUND; ++index) {
+        sender->send(events[index % 2]);
+      }
+      std::string wire = sender->takeWire();
+      totalBytes += wire.length();
+
+      auto start = std::chrono::steady_clock::now();
+      receiver->receive(wire);
+      elapsed += std::chrono::steady_clock::now() - start;
+    }
+
+    size_t totalEvents = capture->getTotalEvents() - totalBefore;
+    TESTING_EQUAL(ZSLIB_EVENTING_TEST_BENCHMARK_ROUNDS * ZSLIB_EVENTING_TEST_BENCHMARK_EVENTS_PER_ROUND, totalEvents);
+    TESTING_EQUAL(IRemoteEventingTypes::State_Connected, receiver->getState());
+
+    double seconds = std::chrono::duration<double>(elapsed).count();
+    if (seconds <= 0) seconds = 1e-9;
+
+    TESTING_STDOUT() << "  receive: " << name << ": " << static_cast<uint64_t>(totalEvents / seconds) << " events/s, " << static_cast<uint64_t>(totalBytes / seconds / (1024*1024)) << " MB/s (" << totalBytes / totalEvents << " bytes/event)\n";
+  }
+}
+
+//-----------------------------------------------------------------------------
+void doTestRemoteEventingReceive()
+{
+  EventCapturePtr capture = EventCapture::create();
+
+  testDenseIndexDecode(capture);
+  testProviderIndexReuse(false, capture);
+  testProviderIndexReuse(true, capture);
+  {
+    RemoteEventingTester::Options options;
+    testHeaderCache("single events", options, capture);
+
+    options.mBatches = true;
+    testHeaderCache("batch", options, capture);
+  }
+
+  testReceiveWorkerOrder(capture);
+  testReceiveWorkerPause(capture);
+  testReceiveWorkerShutdownWhilePaused(capture);
+
+  TESTING_CHECK(capture->takeEvents().empty());
+  capture->shutdown();
+}
+
+//-----------------------------------------------------------------------------
+void doBenchmarkRemoteEventingReceive()
+{
+  EventCapturePtr capture = EventCapture::create();
+  capture->setKeepEvents(false);
+
+  {
+    RemoteEventingTester::Options options;
+    benchmarkReceive("single events", options, false, capture);
+    benchmarkReceive("single events (header cache misses)", options, true, capture);
+
+    options.mDenseProviders = true;
+    benchmarkReceive("single events with dense providers", options, false, capture);
+  }
+  {
+    RemoteEventingTester::Options options;
+    options.mBatches = true;
+    benchmarkReceive("batch", options, false, capture);
+    benchmarkReceive("batch (header cache misses)", options, true, capture);
+
+    options.mEventOrigin = true;
+    options.mDenseProviders = true;
+    benchmarkReceive("batch with origin and dense providers", options, false, capture);
+
+    options.mCompact = true;
+    benchmarkReceive("compact with origin and dense providers", options, false, capture);
+  }
+
+  capture->shutdown();
+}
@@ -0,0 +1,255 @@
+/*
+
+Copyright (c) 2016, Robin Raymond
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+*/
+
+#include "RemoteEventingTester.h"
+#include "testing.h"
+
+#include <zsLib/eventing/IHelper.h>
+
+#include <cstdio>
+#include <iterator>
+#include <string>
+
+using zsLib::eventing::IRemoteEventingTypes;
+using zsLib::eventing::internal::RemoteEventing;
+using zsLib::eventing::test::EventCapture;
+using zsLib::eventing::test::EventCapturePtr;
+using zsLib::eventing::test::RemoteEventingTester;
+using zsLib::eventing::test::RemoteEventingTesterPtr;
+using zsLib::eventing::test::TestEvent;
+using zsLib::eventing::test::TestEventList;
+using zsLib::eventing::test::TestProvider;
+
+#define ZSLIB_EVENTING_TEST_SPOOL_PATH "zsLib-eventing-test.spool"
+#define ZSLIB_EVENTING_TEST_SPOOL_WRAP_EVENTS (20)
+
+namespace
+{
+  using zsLib::eventing::test::checkEvents;
+  using zsLib::eventing::test::createSampleEvents;
+
+  //---------------------------------------------------------------------------
+  void testBacklog(
+                   bool remoteSupportsBacklog,
+                   EventCapturePtr capture
+                   )
+  {
+    TESTING_STDOUT() << "  backlog: " << (remoteSupportsBacklog ? "flagged" : "not understood by remote") << "\n";
+
+    RemoteEventingTester::Options options;
+    options.mBatches = true;
+    options.mCompact = true;
+    options.mEventOrigin = true;
+    options.mBacklog = remoteSupportsBacklog;
+
+    auto sender = RemoteEventingTester::create(options);
+    auto receiver = RemoteEventingTester::create(options);
+
+    auto provider1 = TestProvider::create(0);
+    auto provider2 = TestProvider::create(1);
+    sender->announce(provider1, *receiver);
+    sender->announce(provider2, *receiver);
+
+    TESTING_CHECK(sender->attachSpool(ZSLIB_EVENTING_TEST_SPOOL_PATH, 64*1024));
+
+    auto events = createSampleEvents(provider1, provider2);
+    for (auto iter = events.begin(); iter != events.end(); ++iter) {
+      TESTING_CHECK(sender->spool(*iter));
+    }
+
+    TESTING_CHECK(sender->replay());
+    TESTING_CHECK(!sender->replay());
+
+    // backlog events are never batched or compacted
+    std::string wire = sender->takeWire();
+    size_t frames {};
+    for (size_t offset = 0; offset + (sizeof(uint32_t)*2) <= wire.length(); ++frames) {
+      const BYTE *pos = reinterpret_cast<const BYTE *>(wire.c_str()) + offset;
+      uint32_t size = zsLib::eventing::IHelper::getBE32(pos);
+      uint32_t type = zsLib::eventing::IHelper::getBE32(pos + sizeof(uint32_t));
+      TESTING_EQUAL(remoteSupportsBacklog ? RemoteEventing::MessageType_TraceEventBacklog : RemoteEventing::MessageType_TraceEvent, type);
+      offset += sizeof(uint32_t) + size;
+    }
+    TESTING_EQUAL(events.size(), frames);
+
+    receiver->receive(wire);
+
+    auto received = capture->takeEvents();
+    checkEvents(events, received, true);
+    for (auto iter = received.begin(); iter != received.end(); ++iter) {
+      TESTING_EQUAL(remoteSupportsBacklog, (*iter).mOrigin.mBacklog);
+    }
+    TESTING_EQUAL(IRemoteEventingTypes::State_Connected, receiver->getState());
+
+    // live events continue on the compact stream afterwards
+    sender->send(events.front());
+    receiver->receive(sender->takeWire());
+
+    TestEventList expected;
+    expected.push_back(events.front());
+    checkEvents(expected, capture->takeEvents(), true);
+  }
+
+  //---------------------------------------------------------------------------
+  void testListenerBacklog(EventCapturePtr capture)
+  {
+    TESTING_STDOUT() << "  backlog: replayed by a listener\n";
+
+    RemoteEventingTester::Options options;
+    options.mEventOrigin = true;
+    options.mBacklog = true;
+
+    auto listener = RemoteEventingTester::create(options);
+    auto client1 = RemoteEventingTester::create(options);
+    auto client2 = RemoteEventingTester::create(options);
+    auto client3 = RemoteEventingTester::create(options);
+    auto receiver1 = RemoteEventingTester::create(options);
+    auto receiver2 = RemoteEventingTester::create(options);
+
+    auto provider1 = TestProvider::create(0);
+    auto provider2 = TestProvider::create(1);
+    client1->announce(provider1, *receiver1);
+    client1->announce(provider2, *receiver1);
+    client2->announce(provider1, *receiver2);
+    client2->announce(provider2, *receiver2);
+
+    TESTING_CHECK(listener->attachSpool(ZSLIB_EVENTING_TEST_SPOOL_PATH, 64*1024));
+
+    auto events = createSampleEvents(provider1, provider2);
+    TestEventList expected1;
+    TestEventList expected2;
+    for (auto iter = events.begin(); iter != events.end(); ++iter) {
+      TESTING_CHECK(listener->spool(*iter));
+      ((*iter).mHandle == provider1.mHandle ? expected1 : expected2).push_back(*iter);
+    }
+    TESTING_CHECK(!expected1.empty());
+    TESTING_CHECK(!expected2.empty());
+
+    listener->attachClient(client1);
+    listener->attachClient(client2);
+
+    // the backlog waits until some party has subscribed
+    TESTING_CHECK(!listener->replay());
+    TESTING_CHECK(client1->takeWire().empty());
+    TESTING_CHECK(client2->takeWire().empty());
+
+    // each party receives only the spooled events it subscribed to
+    client1->subscribeClient(provider1, 0xFFFFFFFFFFFFFFFFULL);
+    client2->subscribeClient(provider2, 0xFFFFFFFFFFFFFFFFULL);
+    TESTING_CHECK(listener->replay());
+    TESTING_CHECK(!listener->replay());
+
+    receiver1->receive(client1->takeWire());
+    checkEvents(expected1, capture->takeEvents(), true);
+
+    receiver2->receive(client2->takeWire());
+    checkEvents(expected2, capture->takeEvents(), true);
+
+    // a party subscribing after the replay starts with the live events
+    listener->attachClient(client3);
+    client3->subscribeClient(provider1, 0xFFFFFFFFFFFFFFFFULL);
+    TESTING_CHECK(!listener->replay());
+    TESTING_CHECK(client3->takeWire().empty());
+  }
+
+  //---------------------------------------------------------------------------
+  TestEvent createWrapEvent(
+                            const TestProvider &provider,
+                            uint64_t value
+                            )
+  {
+    TestEvent event = TestEvent::create(provider, 1, 1000000 + value);
+    event.addString("spool");
+    event.addInteger(zsLib::eventing::EventParameterType_UnsignedInteger, value, sizeof(uint32_t));
+    return event;
+  }
+
+  //---------------------------------------------------------------------------
+  void testSpoolWrap(EventCapturePtr capture)
+  {
+    TESTING_STDOUT() << "  backlog: spool wraps when full\n";
+
+    RemoteEventingTester::Options options;
+    options.mEventOrigin = true;
+    options.mBacklog = true;
+
+    auto sender = RemoteEventingTester::create(options);
+    auto receiver = RemoteEventingTester::create(options);
+
+    auto provider = TestProvider::create(0);
+    sender->announce(provider, *receiver);
+
+    // room for four and a half events so a message is skipped past the end of the ring
+    size_t eventSize = createWrapEvent(provider, 0).pack().length();
+    TESTING_CHECK(sender->attachSpool(ZSLIB_EVENTING_TEST_SPOOL_PATH, (eventSize * 4) + (eventSize / 2)));
+
+    TestEventList events;
+    for (size_t loop = 0; loop < ZSLIB_EVENTING_TEST_SPOOL_WRAP_EVENTS; ++loop) {
+      events.push_back(createWrapEvent(provider, loop));
+      TESTING_CHECK(sender->spool(events.back()));
+    }
+
+    // the oldest events made room for the newest
+    auto statistics = sender->getStatistics();
+    uint64_t dropped = statistics.mDroppedEvents[IRemoteEventingTypes::DropReason_SpoolFull];
+    TESTING_EQUAL(ZSLIB_EVENTING_TEST_SPOOL_WRAP_EVENTS, statistics.mSpooledEvents);
+    TESTING_CHECK(dropped > 0);
+    TESTING_CHECK(ZSLIB_EVENTING_TEST_SPOOL_WRAP_EVENTS - dropped >= 3);
+
+    TESTING_CHECK(sender->replay());
+    receiver->receive(sender->takeWire());
+
+    TestEventList expected(std::next(events.begin(), static_cast<std::ptrdiff_t>(dropped)), events.end());
+    checkEvents(expected, capture->takeEvents(), true);
+
+    // an event larger than the whole spool is never spooled
+    TestEvent large = createWrapEvent(provider, ZSLIB_EVENTING_TEST_SPOOL_WRAP_EVENTS);
+    large.addString(std::string(eventSize * 5, 'x').c_str());
+    TESTING_CHECK(!sender->spool(large));
+    TESTING_CHECK(!sender->replay());
+  }
+}
+
+//-----------------------------------------------------------------------------
+void doTestRemoteEventingSpool()
+{
+  EventCapturePtr capture = EventCapture::create();
+
+  testBacklog(true, capture);
+  testBacklog(false, capture);
+  testListenerBacklog(capture);
+  testSpoolWrap(capture);
+
+  remove(ZSLIB_EVENTING_TEST_SPOOL_PATH);
+
+  TESTING_CHECK(capture->takeEvents().empty());
+  capture->shutdown();
+}
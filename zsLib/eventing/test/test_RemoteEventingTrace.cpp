@@ -0,0 +1,331 @@
+/*
+
+Copyright (c) 2016, Robin Raymond
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+*/
+
+#include "RemoteEventingTester.h"
+#include "testing.h"
+
+#include <zsLib/eventing/IHelper.h>
+
+#include <cstdio>
+
+using zsLib::eventing::IRemoteEventingTypes;
+using zsLib::eventing::IRemoteEventingTraceDelegate;
+using zsLib::eventing::internal::RemoteEventing;
+using zsLib::eventing::test::EventCapture;
+using zsLib::eventing::test::EventCapturePtr;
+using zsLib::eventing::test::RemoteEventingTester;
+using zsLib::eventing::test::RemoteEventingTesterPtr;
+using zsLib::eventing::test::TestEvent;
+using zsLib::eventing::test::TestEventList;
+using zsLib::eventing::test::TestProvider;
+
+#define ZSLIB_EVENTING_TEST_TRACE_PATH "zsLib-eventing-test.zstrace"
+
+namespace
+{
+  using zsLib::eventing::test::appendBE32;
+  using zsLib::eventing::test::appendBE64;
+  using zsLib::eventing::test::appendVarint;
+  using zsLib::eventing::test::checkEvents;
+  using zsLib::eventing::test::createSampleEvents;
+  using zsLib::eventing::test::loadFile;
+
+  //---------------------------------------------------------------------------
+  // decoded events as delivered by decodeTrace()
+  class TraceCollector : public IRemoteEventingTraceDelegate
+  {
+  public:
+    virtual void onRemoteEventingTraceEvent(
+                                            const TraceProvider &provider,
+                                            const EventOrigin *origin,
+                                            uint64_t receiveTime,
+                                            Severity severity,
+                                            Level level,
+                                            EVENT_DESCRIPTOR_HANDLE descriptor,
+                                            EVENT_PARAMETER_DESCRIPTOR_HANDLE paramDescriptor,
+                                            EVENT_DATA_DESCRIPTOR_HANDLE dataDescriptor,
+                                            size_t dataDescriptorCount
+                                            ) override
+    {
+      TestEvent event = TestEvent::capture(severity, level, descriptor, paramDescriptor, dataDescriptor, dataDescriptorCount);
+      event.mProviderName = provider.mProviderName;
+      event.mHasOrigin = (NULL != origin);
+      if (origin) event.mOrigin = *origin;
+      mEvents.push_back(event);
+    }
+
+    TestEventList mEvents;
+  };
+
+  //---------------------------------------------------------------------------
+  // the sample events received over a batched connection with origins and
+  // dense providers, recorded with a small index interval so the trace
+  // holds several index records
+  std::string recordTrace(
+                          EventCapturePtr capture,
+                          TestEventList &outExpected
+                          )
+  {
+    RemoteEventingTester::Options options;
+    options.mBatches = true;
+    options.mEventOrigin = true;
+    options.mDenseProviders = true;
+
+    {
+      auto sender = RemoteEventingTester::create(options);
+      auto receiver = RemoteEventingTester::create(options);
+
+      auto recorder = RemoteEventing::TraceRecorder::open(ZSLIB_EVENTING_TEST_TRACE_PATH, zsLib::eventing::ElementPtr(), 1024, 256, zsLib::Milliseconds(60000));
+      TESTING_CHECK((bool)recorder);
+      if (!recorder) return std::string();
+
+      receiver->startRecording(recorder);
+
+      auto provider1 = TestProvider::create(0);
+      auto provider2 = TestProvider::create(1);
+      sender->announce(provider1, *receiver);
+      sender->announce(provider2, *receiver);
+
+      for (int loop = 0; loop < 10; ++loop) {
+        auto events = createSampleEvents(provider1, provider2);
+        for (auto iter = events.begin(); iter != events.end(); ++iter) {
+          sender->send(*iter);
+          outExpected.push_back(*iter);
+        }
+        receiver->receive(sender->takeWire());
+      }
+
+      checkEvents(outExpected, capture->takeEvents(), true);
+      receiver->stopRecording();
+    }
+
+    std::string trace = loadFile(ZSLIB_EVENTING_TEST_TRACE_PATH);
+    remove(ZSLIB_EVENTING_TEST_TRACE_PATH);
+    return trace;
+  }
+
+  //---------------------------------------------------------------------------
+  // the header of a recorded trace followed by a frame for a connection
+  // never described, a described connection's garbage frames and a record
+  // size running past the end of the trace
+  std::string garbageTrace(const std::string &trace)
+  {
+    const BYTE *data = reinterpret_cast<const BYTE *>(trace.c_str());
+    size_t headerSize = (sizeof(uint32_t)*3) + static_cast<size_t>(zsLib::eventing::IHelper::getBE32(data + (sizeof(uint32_t)*2)));
+
+    std::string garbage(trace.substr(0, headerSize));
+    {
+      std::string payload;
+      appendBE32(payload, 77);
+      appendBE64(payload, 1);
+      payload.append(RemoteEventingTester::frame(RemoteEventing::MessageType_TraceEvent, std::string(40, '\x01')));
+      appendBE32(garbage, static_cast<uint32_t>(sizeof(BYTE) + payload.length()));
+      garbage.append(1, static_cast<char>(ZSLIB_EVENTING_TEST_TRACE_RECORD_FRAME));
+      garbage.append(payload);
+    }
+    {
+      std::string payload;
+      appendBE32(payload, 1);
+      payload.append(1, '\0');
+      appendVarint(payload, 0);
+      appendBE32(garbage, static_cast<uint32_t>(sizeof(BYTE) + payload.length()));
+      garbage.append(1, static_cast<char>(ZSLIB_EVENTING_TEST_TRACE_RECORD_CONNECTION));
+      garbage.append(payload);
+    }
+    RemoteEventing::MessageTypes frameTypes[] = {RemoteEventing::MessageType_TraceEvent, RemoteEventing::MessageType_TraceEventBatch, RemoteEventing::MessageType_TraceEventBacklog};
+    for (size_t loop = 0; loop < sizeof(frameTypes) / sizeof(frameTypes[0]); ++loop) {
+      std::string payload;
+      appendBE32(payload, 1);
+      appendBE64(payload, 1);
+      payload.append(RemoteEventingTester::frame(frameTypes[loop], std::string(7 + loop, '\xFF')));
+      appendBE32(garbage, static_cast<uint32_t>(sizeof(BYTE) + payload.length()));
+      garbage.append(1, static_cast<char>(ZSLIB_EVENTING_TEST_TRACE_RECORD_FRAME));
+      garbage.append(payload);
+    }
+    appendBE32(garbage, 0x7FFFFFFF);
+    garbage.append(1, static_cast<char>(ZSLIB_EVENTING_TEST_TRACE_RECORD_FRAME));
+    return garbage;
+  }
+
+  //---------------------------------------------------------------------------
+  bool readIndex(
+                 const std::string &trace,
+                 zsLib::eventing::ElementPtr &outHeaderEl,
+                 IRemoteEventingTypes::TraceIndex &outIndex
+                 )
+  {
+    return RemoteEventing::readTraceIndex(reinterpret_cast<const BYTE *>(trace.c_str()), trace.length(), outHeaderEl, outIndex);
+  }
+
+  //---------------------------------------------------------------------------
+  size_t decode(
+                const std::string &trace,
+                uint64_t offset,
+                TraceCollector &collector
+                )
+  {
+    return RemoteEventing::decodeTrace(reinterpret_cast<const BYTE *>(trace.c_str()), trace.length(), offset, trace.length(), collector);
+  }
+
+  //---------------------------------------------------------------------------
+  void testTraceIndex(EventCapturePtr capture)
+  {
+    TESTING_STDOUT() << "  trace index\n";
+
+    TestEventList expected;
+    std::string trace = recordTrace(capture, expected);
+    TESTING_CHECK(trace.length() > 0);
+    if (trace.empty()) return;
+
+    zsLib::eventing::ElementPtr headerEl;
+    IRemoteEventingTypes::TraceIndex index;
+    TESTING_CHECK(readIndex(trace, headerEl, index));
+    TESTING_CHECK((bool)headerEl);
+    TESTING_CHECK(index.size() > 1);
+
+    IRemoteEventingTypes::TraceIndex completeIndex(index);
+
+    // malformed traces
+    {
+      std::string badMagic(trace);
+      badMagic[0] = static_cast<char>(badMagic[0] ^ 0xFF);
+      TESTING_CHECK(!readIndex(badMagic, headerEl, index));
+    }
+    {
+      std::string badVersion(trace);
+      badVersion[7] = static_cast<char>(badVersion[7] + 1);
+      TESTING_CHECK(!readIndex(badVersion, headerEl, index));
+    }
+    {
+      std::string badHeaderLength(trace);
+      badHeaderLength.replace(sizeof(uint32_t)*2, sizeof(uint32_t), std::string(sizeof(uint32_t), '\xFF'));
+      TESTING_CHECK(!readIndex(badHeaderLength, headerEl, index));
+    }
+    {
+      // an unusable trailer falls back to walking the records
+      std::string badTrailer(trace);
+      size_t magicPos = badTrailer.length() - (sizeof(uint32_t)*2);
+      badTrailer[magicPos] = static_cast<char>(badTrailer[magicPos] ^ 0xFF);
+      TESTING_CHECK(readIndex(badTrailer, headerEl, index));
+      TESTING_EQUAL(completeIndex.size(), index.size());
+      if (completeIndex.size() == index.size()) {
+        for (size_t loop = 0; loop < index.size(); ++loop) {
+          TESTING_EQUAL(completeIndex[loop].mOffset, index[loop].mOffset);
+          TESTING_EQUAL(completeIndex[loop].mFrames, index[loop].mFrames);
+        }
+      }
+    }
+    {
+      // a trace cut short mid record is still indexed up to the cut
+      std::string truncated(trace.substr(0, trace.length() / 2));
+      TESTING_CHECK(readIndex(truncated, headerEl, index));
+    }
+    {
+      TESTING_CHECK(readIndex(garbageTrace(trace), headerEl, index));
+      TESTING_CHECK(index.empty());
+    }
+  }
+
+  //---------------------------------------------------------------------------
+  void testTraceDecode(EventCapturePtr capture)
+  {
+    TESTING_STDOUT() << "  trace decode\n";
+
+    TestEventList expected;
+    std::string trace = recordTrace(capture, expected);
+    TESTING_CHECK(trace.length() > 0);
+    if (trace.empty()) return;
+
+    zsLib::eventing::ElementPtr headerEl;
+    IRemoteEventingTypes::TraceIndex index;
+    TESTING_CHECK(readIndex(trace, headerEl, index));
+
+    {
+      TraceCollector collector;
+      TESTING_EQUAL(expected.size(), decode(trace, 0, collector));
+      checkEvents(expected, collector.mEvents, true);
+    }
+
+    if (index.size() > 0) {
+      // decoding may start at any index record
+      TraceCollector collector;
+      size_t total = decode(trace, index.back().mOffset, collector);
+      TESTING_CHECK(total <= expected.size());
+      TESTING_EQUAL(total, collector.mEvents.size());
+
+      TestEventList tail(expected.begin(), expected.end());
+      while (tail.size() > total) tail.pop_front();
+      checkEvents(tail, collector.mEvents, true);
+    }
+
+    // malformed traces
+    {
+      std::string badMagic(trace);
+      badMagic[0] = static_cast<char>(badMagic[0] ^ 0xFF);
+
+      TraceCollector collector;
+      TESTING_CHECK(0 == decode(badMagic, 0, collector));
+    }
+    {
+      std::string badHeaderLength(trace);
+      badHeaderLength.replace(sizeof(uint32_t)*2, sizeof(uint32_t), std::string(sizeof(uint32_t), '\xFF'));
+
+      TraceCollector collector;
+      TESTING_CHECK(0 == decode(badHeaderLength, 0, collector));
+    }
+    {
+      // a trace cut short mid record still decodes up to the cut
+      std::string truncated(trace.substr(0, trace.length() / 2));
+
+      TraceCollector collector;
+      size_t total = decode(truncated, 0, collector);
+      TESTING_CHECK(total < expected.size());
+      TESTING_EQUAL(total, collector.mEvents.size());
+    }
+    {
+      TraceCollector collector;
+      TESTING_CHECK(0 == decode(garbageTrace(trace), 0, collector));
+      TESTING_CHECK(collector.mEvents.empty());
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+void doTestRemoteEventingTrace()
+{
+  EventCapturePtr capture = EventCapture::create();
+
+  testTraceIndex(capture);
+  testTraceDecode(capture);
+
+  TESTING_CHECK(capture->takeEvents().empty());
+  capture->shutdown();
+}
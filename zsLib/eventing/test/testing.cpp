@@ -0,0 +1,151 @@
+/*
+
+Copyright (c) 2016, Robin Raymond
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+*/
+
+#include "testing.h"
+
+#include <zsLib/eventing/IHelper.h>
+
+#include <zsLib/ISettings.h>
+
+#include <atomic>
+#include <cstring>
+
+void doTestRemoteEventingFormats();
+void doTestRemoteEventingSpool();
+void doTestRemoteEventingTrace();
+void doTestRemoteEventingReceive();
+void doBenchmarkRemoteEventingReceive();
+void doTestMonitorJSON();
+void doBenchmarkMonitorJSON();
+
+namespace zsLib
+{
+  namespace eventing
+  {
+    namespace test
+    {
+      //-----------------------------------------------------------------------
+      static std::atomic<size_t> &totalPassed()
+      {
+        static std::atomic<size_t> total {};
+        return total;
+      }
+
+      //-----------------------------------------------------------------------
+      static std::atomic<size_t> &totalFailed()
+      {
+        static std::atomic<size_t> total {};
+        return total;
+      }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark Testing
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      void Testing::passed()
+      {
+        ++totalPassed();
+      }
+
+      //-----------------------------------------------------------------------
+      void Testing::failed()
+      {
+        ++totalFailed();
+      }
+
+      //-----------------------------------------------------------------------
+      size_t Testing::getTotalPassed()
+      {
+        return totalPassed();
+      }
+
+      //-----------------------------------------------------------------------
+      size_t Testing::getTotalFailed()
+      {
+        return totalFailed();
+      }
+    }
+  }
+}
+
+using zsLib::eventing::test::Testing;
+
+namespace
+{
+  struct TestEntry
+  {
+    const char *mName;
+    void (*mFunction)();
+    bool mBenchmark;
+  };
+
+  // benchmarks only run when asked for as their timings are meaningless in a debug build
+  const TestEntry gTests[] =
+  {
+    {"remote eventing formats", &doTestRemoteEventingFormats, false},
+    {"remote eventing spool", &doTestRemoteEventingSpool, false},
+    {"remote eventing trace", &doTestRemoteEventingTrace, false},
+    {"remote eventing receive", &doTestRemoteEventingReceive, false},
+    {"remote eventing receive benchmark", &doBenchmarkRemoteEventingReceive, true},
+    {"monitor json", &doTestMonitorJSON, false},
+    {"monitor json benchmark", &doBenchmarkMonitorJSON, true},
+  };
+}
+
+int main(int argc, char * const argv[])
+{
+  bool benchmarks {};
+  for (int index = 1; index < argc; ++index) {
+    if (0 == strcmp(argv[index], "--benchmark")) benchmarks = true;
+  }
+
+  zsLib::eventing::IHelper::setup();
+  zsLib::ISettings::applyDefaults();
+
+  for (size_t index = 0; index < sizeof(gTests) / sizeof(gTests[0]); ++index) {
+    auto &entry = gTests[index];
+    if ((entry.mBenchmark) &&
+        (!benchmarks)) continue;
+
+    TESTING_STDOUT() << "[ RUN  ] " << entry.mName << "\n";
+    size_t failedBefore = Testing::getTotalFailed();
+    entry.mFunction();
+    TESTING_STDOUT() << (failedBefore == Testing::getTotalFailed() ? "[  OK  ] " : "[ FAIL ] ") << entry.mName << "\n";
+  }
+
+  TESTING_STDOUT() << "passed: " << Testing::getTotalPassed() << " failed: " << Testing::getTotalFailed() << "\n";
+  return 0 == Testing::getTotalFailed() ? 0 : -1;
+}
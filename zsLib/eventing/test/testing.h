@@ -0,0 +1,84 @@
+/*
+
+Copyright (c) 2016, Robin Raymond
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+*/
+
+#pragma once
+
+#include <zsLib/types.h>
+
+#include <iostream>
+
+namespace zsLib
+{
+  namespace eventing
+  {
+    namespace test
+    {
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark Testing
+      #pragma mark
+
+      interaction Testing
+      {
+        static void passed();
+        static void failed();
+
+        static size_t getTotalPassed();
+        static size_t getTotalFailed();
+      };
+    }
+  }
+}
+
+#define TESTING_STDOUT() std::cout
+
+#define TESTING_CHECK(xValue)                                                                                   \
+  {                                                                                                             \
+    if (!(xValue)) {                                                                                            \
+      TESTING_STDOUT() << "***FAILED***: " #xValue " (" << __FILE__ << ":" << __LINE__ << ")\n";                \
+      ::zsLib::eventing::test::Testing::failed();                                                               \
+    } else {                                                                                                    \
+      ::zsLib::eventing::test::Testing::passed();                                                               \
+    }                                                                                                           \
+  }
+
+#define TESTING_EQUAL(xValue1, xValue2)                                                                         \
+  {                                                                                                             \
+    if (!((xValue1) == (xValue2))) {                                                                            \
+      TESTING_STDOUT() << "***FAILED***: " #xValue1 " == " #xValue2 " (" << __FILE__ << ":" << __LINE__ << ")\n"; \
+      ::zsLib::eventing::test::Testing::failed();                                                               \
+    } else {                                                                                                    \
+      ::zsLib::eventing::test::Testing::passed();                                                               \
+    }                                                                                                           \
+  }
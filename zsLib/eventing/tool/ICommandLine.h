@@ -81,8 +81,16 @@ namespace zsLib
           Flag_MonitorJSON,
           Flag_MonitorProvider,
           Flag_MonitorSecret,
-
-          Flag_Last = Flag_MonitorSecret,
+          Flag_MonitorLocal,
+          Flag_MonitorLocalListen,
+          Flag_MonitorEvent,
+          Flag_MonitorRecord,
+          Flag_MonitorReplay,
+          Flag_MonitorCSV,
+          Flag_MonitorStats,
+          Flag_MonitorOutputFile,
+
+          Flag_Last = Flag_MonitorOutputFile,
         };
 
         static Flags toFlag(const char *str);
@@ -99,6 +107,14 @@ namespace zsLib
           bool mOutputJSON {};
           String mSecret;
           StringList mSubscribeProviders;
+          StringList mSubscribeEvents;
+          String mLocalName;
+          bool mLocalListen {};
+          String mRecordFile;
+          String mReplayFile;
+          bool mOutputCSV {};
+          bool mOutputStats {};
+          String mOutputFile;
         };
       };
 
@@ -35,13 +35,27 @@ either expressed or implied, of the FreeBSD Project.
 
 #include <vector>
 #include <map>
+#include <string>
 
+#include <condition_variable>
+#include <cstdio>
 #include <iostream>
+#include <thread>
 
 #ifndef _WIN32
 #define TEXT(xText) xText
 #endif //_WIN32
 
+// output waiting for the writer thread beyond this blocks the writing threads
+#ifndef ZS_EVENTING_TOOL_OUTPUT_MAX_PENDING_BYTES
+#define ZS_EVENTING_TOOL_OUTPUT_MAX_PENDING_BYTES (8*1024*1024)
+#endif //ZS_EVENTING_TOOL_OUTPUT_MAX_PENDING_BYTES
+
+// a thread's partial line is handed to the writer once it grows this long
+#ifndef ZS_EVENTING_TOOL_OUTPUT_MAX_STAGING_BYTES
+#define ZS_EVENTING_TOOL_OUTPUT_MAX_STAGING_BYTES (64*1024)
+#endif //ZS_EVENTING_TOOL_OUTPUT_MAX_STAGING_BYTES
+
 namespace zsLib
 {
   namespace eventing
@@ -50,6 +64,7 @@ namespace zsLib
     {
       ZS_DECLARE_CLASS_PTR(StdOutputStream);
       ZS_DECLARE_CLASS_PTR(DebugOutputStream);
+      ZS_DECLARE_CLASS_PTR(FileOutputStream);
 
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
@@ -63,6 +78,27 @@ namespace zsLib
       {
         virtual void output(const char *str) const = 0;
         virtual void output(const wchar_t *str) const = 0;
+
+        // bulk output (not null terminated) from the writer thread
+        virtual void output(
+                            const char *str,
+                            size_t length
+                            ) const
+        {
+          std::string temp(str, length);
+          output(temp.c_str());
+        }
+
+        virtual void output(
+                            const wchar_t *str,
+                            size_t length
+                            ) const
+        {
+          std::wstring temp(str, length);
+          output(temp.c_str());
+        }
+
+        virtual void flushOutput() const {}
       };
 
       //-----------------------------------------------------------------------
@@ -84,6 +120,82 @@ namespace zsLib
         {
           std::cout << str;
         }
+
+        virtual void output(
+                            const char *str,
+                            size_t length
+                            ) const override
+        {
+          fwrite(str, sizeof(char), length, stdout);
+        }
+
+        virtual void flushOutput() const override
+        {
+          fflush(stdout);
+        }
+      };
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark FileOutputStream
+      #pragma mark
+
+      class FileOutputStream : public IOutputDelegate
+      {
+      public:
+        //---------------------------------------------------------------------
+        FileOutputStream(const char *fileName) :
+          mFile(fopen(fileName, "wb"))
+        {
+        }
+
+        //---------------------------------------------------------------------
+        ~FileOutputStream()
+        {
+          if (mFile) fclose(mFile);
+        }
+
+        //---------------------------------------------------------------------
+        bool isOpen() const {return NULL != mFile;}
+
+      protected:
+        //---------------------------------------------------------------------
+        virtual void output(const char *str) const override
+        {
+          if (!mFile) return;
+          fputs(str, mFile);
+        }
+
+        //---------------------------------------------------------------------
+        virtual void output(const wchar_t *str) const override
+        {
+          if (!mFile) return;
+          String temp(str);
+          fputs(temp.c_str(), mFile);
+        }
+
+        //---------------------------------------------------------------------
+        virtual void output(
+                            const char *str,
+                            size_t length
+                            ) const override
+        {
+          if (!mFile) return;
+          fwrite(str, sizeof(char), length, mFile);
+        }
+
+        //---------------------------------------------------------------------
+        virtual void flushOutput() const override
+        {
+          if (!mFile) return;
+          fflush(mFile);
+        }
+
+      protected:
+        FILE *mFile {};
       };
 
       //-----------------------------------------------------------------------
@@ -121,6 +233,8 @@ namespace zsLib
       #pragma mark tool_basic_streambuf
       #pragma mark
 
+      // every thread stages its own output and hands complete lines to a
+      // single writer thread which delivers them in large writes
       template < typename T, class CharTraits = std::char_traits< T > >
       class tool_basic_streambuf : private std::basic_streambuf< T, CharTraits >
       {
@@ -128,7 +242,20 @@ namespace zsLib
         typedef typename CharTraits::off_type off_type;
         typedef typename CharTraits::char_type char_type;
         typedef typename CharTraits::int_type int_type;
-        typedef std::vector<T> BufferType;
+        typedef std::basic_string<T, CharTraits> BufferType;
+
+      protected:
+        struct Staging
+        {
+          tool_basic_streambuf *mOwner {};
+          BufferType mBuffer;
+
+          // a partial line left by an exiting thread is still written
+          ~Staging()
+          {
+            if ((mOwner) && (!mBuffer.empty())) mOwner->handOff(mBuffer, false);
+          }
+        };
 
       public:
         //---------------------------------------------------------------------
@@ -138,49 +265,175 @@ namespace zsLib
 #ifdef _WIN32
           _Init(NULL, NULL, NULL, &pBegin, &pCurrent, &pLength);
 #endif //_WIN32
-          m_outputBuffer.reserve(32);
+        }
+
+        //---------------------------------------------------------------------
+        ~tool_basic_streambuf()
+        {
+          close();
+        }
+
+        //---------------------------------------------------------------------
+        // stops the writer thread once everything handed off is written
+        void close()
+        {
+          {
+            std::unique_lock<Lock> lock(mWriterLock);
+            mStop = true;
+          }
+          mWriterCondition.notify_all();
+
+          if (mWriter.joinable()) mWriter.join();
+
+          std::unique_lock<Lock> lock(mWriterLock);
+          if (!mPending.empty()) {
+            mOutputer.output(mPending.c_str(), mPending.length());
+            mPending.clear();
+          }
         }
 
       protected:
         //---------------------------------------------------------------------
         virtual int_type overflow(int_type c = CharTraits::eof())
         {
-          AutoRecursiveLock lock(mLock);
-
           if (c == CharTraits::eof())
             return CharTraits::not_eof(c);
 
-          m_outputBuffer.push_back(static_cast<char_type>(c));
-          if (c == TEXT('\n'))
-            sync();
+          auto &staging = getStaging();
+          staging.mBuffer.push_back(static_cast<char_type>(c));
+
+          // a line that never ends is handed off in pieces like in xsputn
+          if ((c == TEXT('\n')) ||
+              (staging.mBuffer.length() >= ZS_EVENTING_TOOL_OUTPUT_MAX_STAGING_BYTES)) {
+            handOff(staging.mBuffer, false);
+          }
 
           return c;
         }
 
         //---------------------------------------------------------------------
-        int sync()
+        virtual std::streamsize xsputn(
+                                       const char_type *str,
+                                       std::streamsize count
+                                       )
         {
-          AutoRecursiveLock lock(mLock);
+          if (count <= 0) return 0;
+
+          auto &staging = getStaging();
+          staging.mBuffer.append(str, static_cast<size_t>(count));
+
+          // only complete lines are handed off so lines written by different
+          // threads never interleave
+          if ((NULL != CharTraits::find(str, static_cast<size_t>(count), TEXT('\n'))) ||
+              (staging.mBuffer.length() >= ZS_EVENTING_TOOL_OUTPUT_MAX_STAGING_BYTES)) {
+            handOff(staging.mBuffer, staging.mBuffer.length() < ZS_EVENTING_TOOL_OUTPUT_MAX_STAGING_BYTES);
+          }
+          return count;
+        }
 
-          m_outputBuffer.push_back(TEXT('\0'));
+        //---------------------------------------------------------------------
+        // waits until everything written so far has reached the outputs
+        virtual int sync()
+        {
+          auto &staging = getStaging();
+          handOff(staging.mBuffer, false);
 
-          mOutputer.output(reinterpret_cast<const T*>(&m_outputBuffer[0]));
+          {
+            std::unique_lock<Lock> lock(mWriterLock);
+            mWriterCondition.wait(lock, [this]() { return (mPending.empty()) && (!mWriting); });
+          }
 
-          m_outputBuffer.clear();
-          m_outputBuffer.reserve(32);
+          mOutputer.flushOutput();
           return 0;
         }
 
-      protected:
         //---------------------------------------------------------------------
-        RecursiveLock mLock;
+        Staging &getStaging()
+        {
+          static thread_local Staging staging;
+          if (this != staging.mOwner) {
+            if ((staging.mOwner) && (!staging.mBuffer.empty())) staging.mOwner->handOff(staging.mBuffer, false);
+            staging.mOwner = this;
+          }
+          return staging;
+        }
+
+        //---------------------------------------------------------------------
+        void handOff(
+                     BufferType &ioBuffer,
+                     bool completeLinesOnly
+                     )
+        {
+          size_t length = ioBuffer.length();
+          if (completeLinesOnly) {
+            auto found = ioBuffer.find_last_of(TEXT('\n'));
+            if (BufferType::npos == found) return;
+            length = found + 1;
+          }
+          if (0 == length) return;
 
+          {
+            std::unique_lock<Lock> lock(mWriterLock);
+
+            // writers wait for the writer thread instead of growing without limit
+            mWriterCondition.wait(lock, [this]() { return (mStop) || (mPending.length() < ZS_EVENTING_TOOL_OUTPUT_MAX_PENDING_BYTES); });
+
+            if (mStop) {
+              // closed so there is no writer thread to hand off to
+              mOutputer.output(ioBuffer.c_str(), length);
+            } else {
+              bool wasEmpty = mPending.empty();
+              mPending.append(ioBuffer, 0, length);
+
+              if (!mWriter.joinable()) {
+                mWriter = std::thread([this]() { writeLoop(); });
+              }
+              if (wasEmpty) mWriterCondition.notify_all();
+            }
+          }
+
+          ioBuffer.erase(0, length);
+        }
+
+        //---------------------------------------------------------------------
+        void writeLoop()
+        {
+          BufferType buffer;
+
+          while (true) {
+            {
+              std::unique_lock<Lock> lock(mWriterLock);
+              mWriting = false;
+              mWriterCondition.notify_all();
+
+              mWriterCondition.wait(lock, [this]() { return (mStop) || (!mPending.empty()); });
+              if (mPending.empty()) return;
+
+              // the buffers trade places so both keep their capacity
+              buffer.swap(mPending);
+              mWriting = true;
+            }
+            mWriterCondition.notify_all();
+
+            mOutputer.output(buffer.c_str(), buffer.length());
+            buffer.clear();
+          }
+        }
+
+      protected:
+        //---------------------------------------------------------------------
         // put begin, put current and put length
         char_type* pBegin;
         char_type *pCurrent;
         int_type pLength;
-        BufferType m_outputBuffer;
         IOutputDelegate &mOutputer;
+
+        Lock mWriterLock;
+        std::condition_variable mWriterCondition;
+        BufferType mPending;
+        bool mWriting {};
+        bool mStop {};
+        std::thread mWriter;
       };
 
       //-----------------------------------------------------------------------
@@ -214,6 +467,13 @@ namespace zsLib
 #endif //_WIN32
         }
 
+        //---------------------------------------------------------------------
+        ~tool_basic_ostream()
+        {
+          // the writer thread must finish before the outputs are released
+          mStreamBuffer.close();
+        }
+
         //---------------------------------------------------------------------
         void install(
                      PUID installID,
@@ -249,6 +509,19 @@ namespace zsLib
           install(mStdOutputInstall, stream);
         }
 
+        //---------------------------------------------------------------------
+        bool installFileOutput(const char *fileName)
+        {
+          auto stream = make_shared<FileOutputStream>(fileName);
+          if (!stream->isOpen()) return false;
+
+          AutoRecursiveLock lock(mLock);
+          remove(mFileOutputInstall);
+          mFileOutputInstall = createPUID();
+          install(mFileOutputInstall, stream);
+          return true;
+        }
+
         //---------------------------------------------------------------------
         void installDebugger()
         {
@@ -298,6 +571,54 @@ namespace zsLib
           }
         }
 
+        //---------------------------------------------------------------------
+        virtual void output(
+                            const char *str,
+                            size_t length
+                            ) const override
+        {
+          OutputDelegateMapPtr temp;
+          {
+            AutoRecursiveLock lock(mLock);
+            temp = mOutputs;
+          }
+          for (auto iter = temp->begin(); iter != temp->end(); ++iter)
+          {
+            (*iter).second->output(str, length);
+          }
+        }
+
+        //---------------------------------------------------------------------
+        virtual void output(
+                            const wchar_t *str,
+                            size_t length
+                            ) const override
+        {
+          OutputDelegateMapPtr temp;
+          {
+            AutoRecursiveLock lock(mLock);
+            temp = mOutputs;
+          }
+          for (auto iter = temp->begin(); iter != temp->end(); ++iter)
+          {
+            (*iter).second->output(str, length);
+          }
+        }
+
+        //---------------------------------------------------------------------
+        virtual void flushOutput() const override
+        {
+          OutputDelegateMapPtr temp;
+          {
+            AutoRecursiveLock lock(mLock);
+            temp = mOutputs;
+          }
+          for (auto iter = temp->begin(); iter != temp->end(); ++iter)
+          {
+            (*iter).second->flushOutput();
+          }
+        }
+
       protected:
         //---------------------------------------------------------------------
         mutable RecursiveLock mLock;
@@ -306,6 +627,7 @@ namespace zsLib
         OutputDelegateMapPtr mOutputs;  // contents are non-mutable
 
         PUID mStdOutputInstall {};
+        PUID mFileOutputInstall {};
         PUID mDebugOutputInstall {};
       };
 
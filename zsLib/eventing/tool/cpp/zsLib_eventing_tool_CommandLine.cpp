@@ -93,6 +93,14 @@ namespace zsLib
           case Flag_MonitorJSON:      return "output-json";
           case Flag_MonitorProvider:  return "provider";
           case Flag_MonitorSecret:    return "secret";
+          case Flag_MonitorLocal:     return "local";
+          case Flag_MonitorLocalListen: return "local-listen";
+          case Flag_MonitorEvent:     return "event";
+          case Flag_MonitorRecord:    return "record";
+          case Flag_MonitorReplay:    return "replay";
+          case Flag_MonitorCSV:       return "output-csv";
+          case Flag_MonitorStats:     return "output-stats";
+          case Flag_MonitorOutputFile: return "output-file";
         }
         return "unknown";
       }
@@ -128,7 +136,15 @@ namespace zsLib
           " -jman         jman_file_name_1...n      - input jman provider file\n"
           " -output-json                            - output events as json events to command line\n"
           " -provider     provider_name1...n        - subscribe to provider events by name\n"
+          " -event        event_name1...n           - only receive the named events (requires -jman)\n"
           " -secret       connection_secret         - shared secret between client and server\n"
+          " -local        local_name                - connect to an eventing server on the same host\n"
+          " -local-listen local_name                - listen for a connection from the same host\n"
+          " -record       trace_file_name           - record received events into a binary .zstrace file\n"
+          " -replay       trace_file_name           - convert a recorded .zstrace file offline (uses -jman)\n"
+          " -output-csv                             - output replayed events as csv rows\n"
+          " -output-stats                           - output replayed event counts only\n"
+          " -output-file  output_file_name          - also write the monitor or replay output to a file\n"
           "\n";
       }
 
@@ -205,6 +221,9 @@ namespace zsLib
         } catch (const ICommandLine::NoopException &) {
           // do nothing expection
         }
+
+        // output is written asynchronously so it must land before exiting
+        output().flush();
         return result;
       }
 
@@ -259,6 +278,11 @@ namespace zsLib
                 flag = ICommandLine::Flag_None;
                 break;
               }
+              case ICommandLine::Flag_MonitorEvent:
+              {
+                flag = ICommandLine::Flag_None;
+                break;
+              }
               default:
               {
                 break;
@@ -305,6 +329,20 @@ namespace zsLib
               }
               case ICommandLine::Flag_MonitorProvider:  goto process_flag;
               case ICommandLine::Flag_MonitorSecret:    goto process_flag;
+              case ICommandLine::Flag_MonitorLocal:     goto process_flag;
+              case ICommandLine::Flag_MonitorLocalListen: goto process_flag;
+              case ICommandLine::Flag_MonitorEvent:     goto process_flag;
+              case ICommandLine::Flag_MonitorRecord:    goto process_flag;
+              case ICommandLine::Flag_MonitorReplay:    goto process_flag;
+              case ICommandLine::Flag_MonitorCSV:       {
+                monitorInfo.mOutputCSV = true;
+                goto processed_flag;
+              }
+              case ICommandLine::Flag_MonitorStats:     {
+                monitorInfo.mOutputStats = true;
+                goto processed_flag;
+              }
+              case ICommandLine::Flag_MonitorOutputFile: goto process_flag;
             }
             ZS_THROW_INVALID_ARGUMENT("Internal error when processing argument: " + arg + " within context: " + processedThusFar);
           }
@@ -378,6 +416,32 @@ namespace zsLib
                 monitorInfo.mSecret = arg;
                 goto processed_flag;
               }
+              case ICommandLine::Flag_MonitorLocal:     {
+                monitorInfo.mLocalName = arg;
+                monitorInfo.mLocalListen = false;
+                goto processed_flag;
+              }
+              case ICommandLine::Flag_MonitorLocalListen: {
+                monitorInfo.mLocalName = arg;
+                monitorInfo.mLocalListen = true;
+                goto processed_flag;
+              }
+              case ICommandLine::Flag_MonitorEvent:     {
+                monitorInfo.mSubscribeEvents.push_back(arg);
+                goto process_flag;
+              }
+              case ICommandLine::Flag_MonitorRecord:    {
+                monitorInfo.mRecordFile = arg;
+                goto processed_flag;
+              }
+              case ICommandLine::Flag_MonitorReplay:    {
+                monitorInfo.mReplayFile = arg;
+                goto processed_flag;
+              }
+              case ICommandLine::Flag_MonitorOutputFile: {
+                monitorInfo.mOutputFile = arg;
+                goto processed_flag;
+              }
               default: break;
             }
 
@@ -407,7 +471,29 @@ namespace zsLib
                                   bool didOutputHelp
                                   ) throw (InvalidArgument, NoopException)
       {
+        if (monitorInfo.mReplayFile.hasData()) {
+          if (monitorInfo.mRecordFile.hasData()) {
+            ZS_THROW_INVALID_ARGUMENT("A trace cannot be recorded while replaying.");
+          }
+          size_t totalOutputs = (monitorInfo.mOutputJSON ? 1 : 0) + (monitorInfo.mOutputCSV ? 1 : 0) + (monitorInfo.mOutputStats ? 1 : 0);
+          if (totalOutputs > 1) {
+            ZS_THROW_INVALID_ARGUMENT("Only one replay output format can be specified.");
+          }
+          if (0 == totalOutputs) monitorInfo.mOutputJSON = true;
+          return;
+        }
+
         if (monitorInfo.mMonitor) {
+          if ((monitorInfo.mSubscribeEvents.size() > 0) &&
+              (monitorInfo.mJMANFiles.size() < 1)) {
+            ZS_THROW_INVALID_ARGUMENT("Event names can only be resolved with a jman file.");
+          }
+          if (monitorInfo.mLocalName.hasData()) {
+            if (!monitorInfo.mIPAddress.isAddressEmpty()) {
+              ZS_THROW_INVALID_ARGUMENT("Local and remote connections cannot be combined.");
+            }
+            return;
+          }
           if (!monitorInfo.mIPAddress.isAddressEmpty()) {
             if (0 == monitorInfo.mIPAddress.getPort()) {
               monitorInfo.mIPAddress.setPort(monitorInfo.mPort);
@@ -423,6 +509,10 @@ namespace zsLib
           return;
         }
 
+        if (monitorInfo.mOutputFile.hasData()) {
+          ZS_THROW_INVALID_ARGUMENT("An output file requires monitoring or replaying.");
+        }
+
         if (config.mConfigFile.isEmpty()) {
           ZS_THROW_CUSTOM_IF(NoopException, didOutputHelp);
           ZS_THROW_INVALID_ARGUMENT("Configuration file must be specified.");
@@ -435,6 +525,16 @@ namespace zsLib
                                  ICompilerTypes::Config &config
                                  ) throw (Failure)
       {
+        if (monitor.mOutputFile.hasData()) {
+          if (!output().installFileOutput(monitor.mOutputFile.c_str())) {
+            ZS_THROW_CUSTOM_PROPERTIES_1(Failure, ZS_EVENTING_TOOL_SYSTEM_ERROR, String("Failed to open output file: ") + monitor.mOutputFile);
+          }
+        }
+
+        if (monitor.mReplayFile.hasData()) {
+          internal::Monitor::replay(monitor);
+          return;
+        }
         if (monitor.mMonitor) {
           internal::Monitor::monitor(monitor);
           return;
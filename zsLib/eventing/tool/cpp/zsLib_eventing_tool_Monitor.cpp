@@ -38,6 +38,18 @@ either expressed or implied, of the FreeBSD Project.
 #include <zsLib/IMessageQueueManager.h>
 #include <zsLib/Numeric.h>
 
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif //ndef _WIN32
+
+#include <cfloat>
+#include <condition_variable>
+#include <sstream>
+#include <thread>
+
 namespace zsLib { namespace eventing { namespace tool { ZS_DECLARE_SUBSYSTEM(zsLib_eventing_tool) } } }
 
 namespace zsLib
@@ -162,49 +174,171 @@ namespace zsLib
         }
         
         //---------------------------------------------------------------------
-        static String valueAsString(
-                                    const USE_EVENT_PARAMETER_DESCRIPTOR &param,
-                                    const USE_EVENT_DATA_DESCRIPTOR &data,
-                                    bool &outIsNumber
-                                    )
+        static bool isNumberType(EventParameterTypes type)
+        {
+          switch (type) {
+            case EventParameterType_UnsignedInteger:
+            case EventParameterType_SignedInteger:
+            case EventParameterType_FloatingPoint:
+            case EventParameterType_Pointer:          return true;
+            default:                                  break;
+          }
+          return false;
+        }
+
+        //---------------------------------------------------------------------
+        static const char *toDecimal(
+                                     char (&buffer)[21],
+                                     uint64_t value
+                                     )
+        {
+          char *pos = &(buffer[sizeof(buffer) - 1]);
+          *pos = 0;
+          do {
+            --pos;
+            *pos = static_cast<char>('0' + (value % 10));
+            value /= 10;
+          } while (0 != value);
+          return pos;
+        }
+
+        //---------------------------------------------------------------------
+        static void appendUnsigned(
+                                   std::string &ioOutput,
+                                   uint64_t value
+                                   )
+        {
+          char buffer[21];
+          ioOutput.append(toDecimal(buffer, value));
+        }
+
+        //---------------------------------------------------------------------
+        static void appendSigned(
+                                 std::string &ioOutput,
+                                 int64_t value
+                                 )
+        {
+          if (value < 0) {
+            ioOutput.push_back('-');
+            appendUnsigned(ioOutput, static_cast<uint64_t>(0) - static_cast<uint64_t>(value));
+            return;
+          }
+          appendUnsigned(ioOutput, static_cast<uint64_t>(value));
+        }
+
+        //---------------------------------------------------------------------
+        static void appendFloat(
+                                std::string &ioOutput,
+                                double value
+                                )
+        {
+          // "%f" is what string(double) produces; the longest double fits
+          char buffer[DBL_MAX_10_EXP + 32];
+          int length = snprintf(buffer, sizeof(buffer), "%f", value);
+          if (length <= 0) return;
+          ioOutput.append(buffer, static_cast<size_t>(length) < sizeof(buffer) ? static_cast<size_t>(length) : sizeof(buffer) - 1);
+        }
+
+        //---------------------------------------------------------------------
+        static void appendHex(
+                              std::string &ioOutput,
+                              const BYTE *buffer,
+                              size_t bufferSize
+                              )
+        {
+          static const char *digits = "0123456789abcdef";
+          for (size_t index = 0; index < bufferSize; ++index) {
+            ioOutput.push_back(digits[(buffer[index] >> 4) & 0xF]);
+            ioOutput.push_back(digits[buffer[index] & 0xF]);
+          }
+        }
+
+        //---------------------------------------------------------------------
+        static void appendUTF8(
+                               std::string &ioOutput,
+                               uint32_t codePoint
+                               )
+        {
+          if (codePoint < 0x80) {
+            ioOutput.push_back(static_cast<char>(codePoint));
+          } else if (codePoint < 0x800) {
+            ioOutput.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+            ioOutput.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+          } else if (codePoint < 0x10000) {
+            ioOutput.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+            ioOutput.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+            ioOutput.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+          } else {
+            ioOutput.push_back(static_cast<char>(0xF0 | ((codePoint >> 18) & 0x07)));
+            ioOutput.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+            ioOutput.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+            ioOutput.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+          }
+        }
+
+        //---------------------------------------------------------------------
+        static void appendWideString(
+                                     std::string &ioOutput,
+                                     const USE_EVENT_DATA_DESCRIPTOR &data
+                                     )
+        {
+          const BYTE *pos = reinterpret_cast<const BYTE *>(data.Ptr);
+          size_t total = data.Size / sizeof(wchar_t);
+
+          // the data is not necessarily aligned for wchar_t
+          for (size_t index = 0; index < total; ++index) {
+            wchar_t value {};
+            memcpy(&value, pos + (index * sizeof(wchar_t)), sizeof(value));
+            if (0 == value) break;
+
+            uint32_t codePoint = static_cast<uint32_t>(value);
+            if ((sizeof(wchar_t) < sizeof(uint32_t)) &&
+                (codePoint >= 0xD800) &&
+                (codePoint <= 0xDBFF) &&
+                (index + 1 < total)) {
+              wchar_t low {};
+              memcpy(&low, pos + ((index + 1) * sizeof(wchar_t)), sizeof(low));
+              uint32_t lowPoint = static_cast<uint32_t>(low);
+              if ((lowPoint >= 0xDC00) &&
+                  (lowPoint <= 0xDFFF)) {
+                codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (lowPoint - 0xDC00);
+                ++index;
+              }
+            }
+            appendUTF8(ioOutput, codePoint);
+          }
+        }
+
+        //---------------------------------------------------------------------
+        static void appendValue(
+                                std::string &ioOutput,
+                                const USE_EVENT_PARAMETER_DESCRIPTOR &param,
+                                const USE_EVENT_DATA_DESCRIPTOR &data
+                                )
         {
-          outIsNumber = true;
-          
           switch (param.Type) {
             case EventParameterType_Boolean:          {
-              outIsNumber = false;
-              if (0 != getUnsignedValue(data)) return "true";
-              return "false";
+              ioOutput.append(0 != getUnsignedValue(data) ? "true" : "false");
+              return;
             }
-            case EventParameterType_UnsignedInteger:  return string(getUnsignedValue(data));
-            case EventParameterType_SignedInteger:    return string(getSignedValue(data));
-            
-            case EventParameterType_FloatingPoint:    return string(getFloatValue(data));
-            case EventParameterType_Pointer:          return string(getUnsignedValue(data));
+            case EventParameterType_UnsignedInteger:  appendUnsigned(ioOutput, getUnsignedValue(data)); return;
+            case EventParameterType_SignedInteger:    appendSigned(ioOutput, getSignedValue(data)); return;
+
+            case EventParameterType_FloatingPoint:    appendFloat(ioOutput, getFloatValue(data)); return;
+            case EventParameterType_Pointer:          appendUnsigned(ioOutput, getUnsignedValue(data)); return;
             case EventParameterType_AString:          {
-              outIsNumber = false;
-              if (!data.Ptr) return String();
-              if (0 == data.Size) return String();
-              auto temp = IHelper::convertToBuffer(reinterpret_cast<const BYTE *>(data.Ptr), data.Size);
-              return String(reinterpret_cast<const char *>(temp->BytePtr()));
+              if (!data.Ptr) return;
+              if (0 == data.Size) return;
+              const char *value = reinterpret_cast<const char *>(data.Ptr);
+              const void *end = memchr(value, 0, data.Size);
+              ioOutput.append(value, end ? static_cast<size_t>(reinterpret_cast<const char *>(end) - value) : data.Size);
+              return;
             }
             case EventParameterType_WString:          {
-              outIsNumber = false;
-              if (!data.Ptr) return String();
-              if (0 == data.Size) return String();
-              size_t total = data.Size / sizeof(wchar_t);
-              
-              if (0 == total) return String();
-              
-              wchar_t *temp = new wchar_t[total+1] {};
-              memcpy(temp, (const void *)(data.Ptr), data.Size);
-              
-              String result(&(temp[0]));
-              
-              delete [] temp;
-              temp = NULL;
-              
-              return result;
+              if (!data.Ptr) return;
+              if (0 == data.Size) return;
+              appendWideString(ioOutput, data);
+              return;
             }
             case EventParameterType_Binary:
             default:
@@ -213,12 +347,494 @@ namespace zsLib
             }
           }
 
-          outIsNumber = false;
-          if (!data.Ptr) return String();
-          if (0 == data.Size) return String();
-          return IHelper::convertToHex(reinterpret_cast<const BYTE *>(data.Ptr), data.Size);
+          if (!data.Ptr) return;
+          if (0 == data.Size) return;
+          appendHex(ioOutput, reinterpret_cast<const BYTE *>(data.Ptr), data.Size);
         }
-        
+
+        //---------------------------------------------------------------------
+        static String valueAsString(
+                                    const USE_EVENT_PARAMETER_DESCRIPTOR &param,
+                                    const USE_EVENT_DATA_DESCRIPTOR &data,
+                                    bool &outIsNumber
+                                    )
+        {
+          outIsNumber = isNumberType(param.Type);
+
+          String result;
+          appendValue(result, param, data);
+          return result;
+        }
+
+        //---------------------------------------------------------------------
+        //---------------------------------------------------------------------
+        //---------------------------------------------------------------------
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark EventJSONWriter
+        #pragma mark
+
+        // appends an event as compact JSON straight into a caller owned buffer;
+        // the output is identical to IHelper::toString() of the equivalent
+        // element tree without its outer {"event": ... } wrapper
+        class EventJSONWriter
+        {
+        public:
+          //-------------------------------------------------------------------
+          EventJSONWriter(std::string &output) :
+            mOutput(output)
+          {
+          }
+
+          //-------------------------------------------------------------------
+          void beginObject(const char *name = NULL)
+          {
+            if (name) appendName(name);
+            mOutput.push_back('{');
+            mSeparate = false;
+          }
+
+          //-------------------------------------------------------------------
+          void endObject()
+          {
+            mOutput.push_back('}');
+            mSeparate = true;
+          }
+
+          //-------------------------------------------------------------------
+          void addText(
+                       const char *name,
+                       const char *value
+                       )
+          {
+            appendName(name);
+            mOutput.push_back('"');
+            size_t start = mOutput.length();
+            mOutput.append(value);
+            encodeFrom(start);
+            mOutput.push_back('"');
+            mSeparate = true;
+          }
+
+          //-------------------------------------------------------------------
+          void addUnsigned(
+                           const char *name,
+                           uint64_t value
+                           )
+          {
+            appendName(name);
+            appendUnsigned(mOutput, value);
+            mSeparate = true;
+          }
+
+          //-------------------------------------------------------------------
+          void addValue(
+                        const char *name,
+                        const USE_EVENT_PARAMETER_DESCRIPTOR &param,
+                        const USE_EVENT_DATA_DESCRIPTOR &data
+                        )
+          {
+            appendName(name);
+
+            if (isNumberType(param.Type)) {
+              appendValue(mOutput, param, data);
+              mSeparate = true;
+              return;
+            }
+
+            mOutput.push_back('"');
+            size_t start = mOutput.length();
+            appendValue(mOutput, param, data);
+            encodeFrom(start);
+            mOutput.push_back('"');
+            mSeparate = true;
+          }
+
+        protected:
+          //-------------------------------------------------------------------
+          void appendName(const char *name)
+          {
+            if (mSeparate) mOutput.push_back(',');
+            mOutput.push_back('"');
+            mOutput.append(name);
+            mOutput.append("\":");
+          }
+
+          //-------------------------------------------------------------------
+          void encodeFrom(size_t start)
+          {
+            for (size_t index = start; index < mOutput.length(); ++index) {
+              unsigned char value = static_cast<unsigned char>(mOutput[index]);
+              if ((value >= 0x20) &&
+                  (value < 0x7F) &&
+                  ('"' != value) &&
+                  ('\\' != value) &&
+                  ('/' != value)) continue;
+
+              // rare so the DOM's own encoder is used to stay identical
+              String encoded = zsLib::XML::Parser::convertToJSONEncoding(String(mOutput.substr(start)));
+              mOutput.resize(start);
+              mOutput.append(encoded);
+              return;
+            }
+          }
+
+        protected:
+          std::string &mOutput;
+          bool mSeparate {};
+        };
+
+        //---------------------------------------------------------------------
+        static void writeEventOrigin(
+                                     EventJSONWriter &writer,
+                                     const IRemoteEventing::EventOrigin *origin
+                                     )
+        {
+          if (!origin) return;
+
+          writer.addUnsigned("timestamp", origin->mTimestamp);
+          writer.addUnsigned("thread", origin->mThreadID);
+          if (IRemoteEventing::CPU_Unknown != origin->mCPU) {
+            writer.addUnsigned("cpu", origin->mCPU);
+          }
+        }
+
+        //---------------------------------------------------------------------
+        static const Monitor::EventPlan *findEventPlan(
+                                                       const Monitor::EventPlanArray *plans,
+                                                       size_t eventID
+                                                       )
+        {
+          if (!plans) return NULL;
+          if (eventID >= plans->size()) return NULL;
+
+          auto &plan = (*plans)[eventID];
+          if (!plan.mEvent) return NULL;
+          return &plan;
+        }
+
+        //---------------------------------------------------------------------
+        bool Monitor::writeEventJSON(
+                                     std::string &ioOutput,
+                                     const EventPlanArray *plans,
+                                     Severity severity,
+                                     Level level,
+                                     const IRemoteEventing::EventOrigin *origin,
+                                     EVENT_DESCRIPTOR_HANDLE descriptor,
+                                     EVENT_PARAMETER_DESCRIPTOR_HANDLE paramDescriptor,
+                                     EVENT_DATA_DESCRIPTOR_HANDLE dataDescriptor,
+                                     size_t dataDescriptorCount,
+                                     bool quietMode,
+                                     std::ostream &warnings
+                                     )
+        {
+          static const char *builtInNames[ZS_EVENTING_TOTAL_BUILT_IN_EVENT_DATA] = {"_subsystemName", "_function", "_line"};
+
+          size_t start = ioOutput.length();
+          EventJSONWriter writer(ioOutput);
+
+          auto plan = findEventPlan(plans, descriptor->Id);
+          if (plan) {
+            auto &event = plan->mEvent;
+
+            writer.beginObject();
+            writer.addText("severity", Log::toString(severity));
+            writer.addText("level", Log::toString(level));
+            writeEventOrigin(writer, origin);
+            writer.addText("name", event->mName.c_str());
+            if (event->mChannel) {
+              writer.addText("channel", event->mChannel->mID.c_str());
+            }
+            if (event->mTask) {
+              writer.addText("task", event->mTask->mName.c_str());
+            }
+            if (event->mOpCode) {
+              writer.addText("opCode", event->mOpCode->mName.c_str());
+            }
+
+            writer.beginObject("values");
+
+            // buffer sizes may or may not have been sent with their buffers
+            if ((plan->mTotalDescriptors != dataDescriptorCount) &&
+                (plan->mTotalDescriptorsWithoutSizes != dataDescriptorCount)) {
+              if (!quietMode) {
+                warnings << "[Warning] Event \"" << event->mName << "\" parameter count does not match: X=" << string(plan->mTotalDescriptorsWithoutSizes) << " Y=" << string(dataDescriptorCount) << "\n";
+                ioOutput.resize(start);
+                return false;
+              }
+            }
+
+            for (size_t index = 0; index < ZS_EVENTING_TOTAL_BUILT_IN_EVENT_DATA; ++index)
+            {
+              writer.addValue(builtInNames[index], paramDescriptor[index], dataDescriptor[index]);
+            }
+
+            size_t totalOps = plan->mOps.size();
+            size_t available = (dataDescriptorCount > ZS_EVENTING_TOTAL_BUILT_IN_EVENT_DATA ? dataDescriptorCount - ZS_EVENTING_TOTAL_BUILT_IN_EVENT_DATA : 0);
+            if (totalOps > available) totalOps = available;
+
+            for (size_t index = 0; index < totalOps; ++index)
+            {
+              auto &op = plan->mOps[index];
+              if (op.mDescriptorIndex >= dataDescriptorCount) {
+                if (!quietMode) {
+                  warnings << "[Warning] Event \"" << event->mName << "\" parameter count buffer missing space for buffer: COUNT=" << string(dataDescriptorCount) << " INDEX=" << string(index + ZS_EVENTING_TOTAL_BUILT_IN_EVENT_DATA) << "\n";
+                }
+                ioOutput.resize(start);
+                return false;
+              }
+              writer.addValue(op.mName, paramDescriptor[op.mDescriptorIndex], dataDescriptor[op.mDescriptorIndex]);
+            }
+
+            writer.endObject();
+            writer.endObject();
+            return true;
+          }
+
+          writer.beginObject();
+          writer.addText("severity", Log::toString(severity));
+          writer.addText("level", Log::toString(level));
+          writeEventOrigin(writer, origin);
+          writer.addUnsigned("name", descriptor->Id);
+          writer.addUnsigned("channel", descriptor->Channel);
+          writer.addUnsigned("task", descriptor->Task);
+          writer.addUnsigned("opCode", descriptor->Opcode);
+
+          writer.beginObject("values");
+
+          for (size_t index = 0; index < ZS_EVENTING_TOTAL_BUILT_IN_EVENT_DATA; ++index)
+          {
+            writer.addValue(builtInNames[index], paramDescriptor[index], dataDescriptor[index]);
+          }
+
+          for (size_t index = ZS_EVENTING_TOTAL_BUILT_IN_EVENT_DATA; index < dataDescriptorCount; ++index)
+          {
+            char buffer[21];
+            writer.addValue(toDecimal(buffer, index - ZS_EVENTING_TOTAL_BUILT_IN_EVENT_DATA), paramDescriptor[index], dataDescriptor[index]);
+          }
+
+          writer.endObject();
+          writer.endObject();
+          return true;
+        }
+
+        //---------------------------------------------------------------------
+        static void appendCSVValue(
+                                   String &ioOutput,
+                                   const String &value,
+                                   bool isNumber
+                                   )
+        {
+          ioOutput.append(",");
+          if (isNumber) {
+            ioOutput.append(value);
+            return;
+          }
+
+          String escaped(value);
+          escaped.replaceAll("\"", "\"\"");
+          ioOutput.append("\"");
+          ioOutput.append(escaped);
+          ioOutput.append("\"");
+        }
+
+        //---------------------------------------------------------------------
+        //---------------------------------------------------------------------
+        //---------------------------------------------------------------------
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark ReplayMapping
+        #pragma mark
+
+        // read only view of an entire trace file
+        class ReplayMapping
+        {
+        public:
+          //-------------------------------------------------------------------
+          ~ReplayMapping()
+          {
+#ifdef _WIN32
+            if (mMapping) UnmapViewOfFile(mMapping);
+            if (NULL != mMappingHandle) CloseHandle(mMappingHandle);
+            if (INVALID_HANDLE_VALUE != mFile) CloseHandle(mFile);
+#else
+            if (mMapping) munmap(mMapping, mSize);
+            if (mDescriptor >= 0) ::close(mDescriptor);
+#endif //_WIN32
+          }
+
+          //-------------------------------------------------------------------
+          bool open(const String &path)
+          {
+#ifdef _WIN32
+            mFile = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+            if (INVALID_HANDLE_VALUE == mFile) return false;
+
+            LARGE_INTEGER fileSize {};
+            if (!GetFileSizeEx(mFile, &fileSize)) return false;
+            if (fileSize.QuadPart < 1) return false;
+            mSize = static_cast<size_t>(fileSize.QuadPart);
+
+            mMappingHandle = CreateFileMappingA(mFile, NULL, PAGE_READONLY, 0, 0, NULL);
+            if (NULL == mMappingHandle) return false;
+            mMapping = MapViewOfFile(mMappingHandle, FILE_MAP_READ, 0, 0, 0);
+            if (NULL == mMapping) return false;
+#else
+            mDescriptor = ::open(path.c_str(), O_RDONLY);
+            if (mDescriptor < 0) return false;
+
+            struct stat info {};
+            if (0 != fstat(mDescriptor, &info)) return false;
+            if (info.st_size < 1) return false;
+            mSize = static_cast<size_t>(info.st_size);
+
+            void *mapping = mmap(NULL, mSize, PROT_READ, MAP_PRIVATE, mDescriptor, 0);
+            if (MAP_FAILED == mapping) return false;
+            mMapping = mapping;
+
+            // every partition is walked front to back
+            madvise(mMapping, mSize, MADV_SEQUENTIAL);
+#endif //_WIN32
+            return true;
+          }
+
+          //-------------------------------------------------------------------
+          const BYTE *data() const  {return reinterpret_cast<const BYTE *>(mMapping);}
+          size_t size() const       {return mSize;}
+
+        protected:
+#ifdef _WIN32
+          HANDLE mFile {INVALID_HANDLE_VALUE};
+          HANDLE mMappingHandle {NULL};
+#else
+          int mDescriptor {-1};
+#endif //_WIN32
+          void *mMapping {};
+          size_t mSize {};
+        };
+
+        //---------------------------------------------------------------------
+        //---------------------------------------------------------------------
+        //---------------------------------------------------------------------
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark ReplayPartition
+        #pragma mark
+
+        struct ReplayProvider
+        {
+          String mUniqueHash;
+          Monitor::EventPlanArray mPlans;
+        };
+
+        typedef std::map<UUID, ReplayProvider> ReplayProviderMap;
+        typedef std::pair<UUID, size_t> ReplayStatsKey;
+        typedef std::map<ReplayStatsKey, size_t> ReplayStatsMap;
+        typedef std::map<UUID, String> ReplayProviderNameMap;
+
+        ZS_DECLARE_CLASS_PTR(ReplayPartition);
+
+        // decodes the events between two index points of a trace into its own
+        // output so partitions can be decoded out of order and merged in order
+        class ReplayPartition : public IRemoteEventingTraceDelegate
+        {
+        public:
+          //-------------------------------------------------------------------
+          ReplayPartition(
+                          const ICommandLineTypes::MonitorInfo &monitorInfo,
+                          const ReplayProviderMap &providers,
+                          uint64_t startOffset,
+                          uint64_t endOffset
+                          ) :
+            mMonitorInfo(monitorInfo),
+            mProviders(providers),
+            mStartOffset(startOffset),
+            mEndOffset(endOffset)
+          {
+          }
+
+          //-------------------------------------------------------------------
+          virtual void onRemoteEventingTraceEvent(
+                                                  const TraceProvider &provider,
+                                                  const EventOrigin *origin,
+                                                  uint64_t receiveTime,
+                                                  Severity severity,
+                                                  Level level,
+                                                  EVENT_DESCRIPTOR_HANDLE descriptor,
+                                                  EVENT_PARAMETER_DESCRIPTOR_HANDLE paramDescriptor,
+                                                  EVENT_DATA_DESCRIPTOR_HANDLE dataDescriptor,
+                                                  size_t dataDescriptorCount
+                                                  ) override
+          {
+            ++mTotalEvents;
+
+            const Monitor::EventPlanArray *plans {};
+            auto found = mProviders.find(provider.mProviderID);
+            if (found != mProviders.end()) {
+              auto &replayProvider = (*found).second;
+              if (replayProvider.mUniqueHash == provider.mProviderUniqueHash) {
+                plans = &(replayProvider.mPlans);
+              } else {
+                mMismatchedProviders.insert(provider.mProviderName);
+              }
+            }
+
+            if (mMonitorInfo.mOutputStats) {
+              if (mProviderNames.end() == mProviderNames.find(provider.mProviderID)) {
+                mProviderNames[provider.mProviderID] = provider.mProviderName;
+              }
+              ++(mStats[ReplayStatsKey(provider.mProviderID, descriptor->Id)]);
+              return;
+            }
+
+            if (mMonitorInfo.mOutputCSV) {
+              auto plan = findEventPlan(plans, descriptor->Id);
+              String name(plan ? plan->mEvent->mName : string(descriptor->Id));
+
+              mOutput.append(string(receiveTime));
+              appendCSVValue(mOutput, origin ? string(origin->mTimestamp) : String(), true);
+              appendCSVValue(mOutput, origin ? string(origin->mThreadID) : String(), true);
+              appendCSVValue(mOutput, (origin) && (IRemoteEventing::CPU_Unknown != origin->mCPU) ? string(origin->mCPU) : String(), true);
+              appendCSVValue(mOutput, Log::toString(severity), false);
+              appendCSVValue(mOutput, Log::toString(level), false);
+              appendCSVValue(mOutput, provider.mProviderName, false);
+              appendCSVValue(mOutput, name, false);
+
+              for (size_t index = 0; index < dataDescriptorCount; ++index) {
+                bool isNumber = false;
+                String value = valueAsString(paramDescriptor[index], dataDescriptor[index], isNumber);
+                appendCSVValue(mOutput, value, isNumber);
+              }
+              mOutput.append("\n");
+              return;
+            }
+
+            // every event is preceded by a separator; the merge drops the very first one
+            size_t start = mOutput.length();
+            mOutput.append(",");
+            if (!Monitor::writeEventJSON(mOutput, plans, severity, level, origin, descriptor, paramDescriptor, dataDescriptor, dataDescriptorCount, mMonitorInfo.mQuietMode, mWarnings)) {
+              mOutput.resize(start);
+              return;
+            }
+            mOutput.append("\n");
+          }
+
+        public:
+          const ICommandLineTypes::MonitorInfo &mMonitorInfo;
+          const ReplayProviderMap &mProviders;
+
+          uint64_t mStartOffset {};
+          uint64_t mEndOffset {};
+
+          bool mDone {};
+          size_t mTotalEvents {};
+          String mOutput;
+          std::stringstream mWarnings;
+          std::set<String> mMismatchedProviders;
+          ReplayStatsMap mStats;
+          ReplayProviderNameMap mProviderNames;
+        };
+
         //---------------------------------------------------------------------
         //---------------------------------------------------------------------
         //---------------------------------------------------------------------
@@ -306,6 +922,174 @@ namespace zsLib
           }
         }
 
+        //---------------------------------------------------------------------
+        void Monitor::replay(const ICommandLineTypes::MonitorInfo &monitorInfo)
+        {
+          static const size_t skipSeparatorLength = strlen(",");
+
+          auto startTime = zsLib::now();
+
+          ProviderMap providers;
+          loadProviders(monitorInfo.mJMANFiles, providers);
+
+          ReplayProviderMap replayProviders;
+          for (auto iter = providers.begin(); iter != providers.end(); ++iter) {
+            auto provider = (*iter).second;
+            auto &replayProvider = replayProviders[provider->mID];
+            replayProvider.mUniqueHash = provider->mUniqueHash;
+            compileEventPlans(provider, replayProvider.mPlans);
+          }
+
+          ReplayMapping mapping;
+          if (!mapping.open(monitorInfo.mReplayFile)) {
+            ZS_THROW_CUSTOM_PROPERTIES_1(Failure, ZS_EVENTING_TOOL_FILE_FAILED_TO_LOAD, "Failed to load trace file: " + monitorInfo.mReplayFile);
+          }
+
+          ElementPtr headerEl;
+          IRemoteEventingTypes::TraceIndex index;
+          if (!IRemoteEventing::readTraceIndex(mapping.data(), mapping.size(), headerEl, index)) {
+            ZS_THROW_CUSTOM_PROPERTIES_1(Failure, ZS_EVENTING_TOOL_INVALID_CONTENT, "Not a valid trace file: " + monitorInfo.mReplayFile);
+          }
+
+          // each index point carries the full connection state so the span
+          // up to the next index point decodes independently of the others
+          std::vector<ReplayPartitionPtr> partitions;
+          for (size_t loop = 0; loop < index.size(); ++loop) {
+            uint64_t endOffset = (loop + 1 < index.size() ? index[loop + 1].mOffset : static_cast<uint64_t>(mapping.size()));
+            partitions.push_back(make_shared<ReplayPartition>(monitorInfo, replayProviders, index[loop].mOffset, endOffset));
+          }
+
+          size_t totalThreads = static_cast<size_t>(std::thread::hardware_concurrency());
+          if (totalThreads < 1) totalThreads = 1;
+          if (totalThreads > partitions.size()) totalThreads = partitions.size();
+
+          // decoding may only run this far ahead of the merge to bound memory
+          size_t maxAhead = totalThreads * 4;
+
+          if (!monitorInfo.mQuietMode) {
+            tool::output() << "[Info] Replaying trace: " << monitorInfo.mReplayFile << " (" << string(partitions.size()) << " partitions on " << string(totalThreads) << " threads)\n";
+          }
+
+          Lock lock;
+          std::condition_variable condition;
+          size_t nextPartition {};
+          size_t totalMerged {};
+
+          std::vector<std::thread> threads;
+          for (size_t loop = 0; loop < totalThreads; ++loop) {
+            threads.push_back(std::thread([&]() {
+              while (true) {
+                ReplayPartitionPtr partition;
+                {
+                  std::unique_lock<Lock> autoLock(lock);
+                  condition.wait(autoLock, [&]() { return (nextPartition >= partitions.size()) || (nextPartition < totalMerged + maxAhead); });
+                  if (nextPartition >= partitions.size()) return;
+                  partition = partitions[nextPartition];
+                  ++nextPartition;
+                }
+
+                IRemoteEventing::decodeTrace(mapping.data(), mapping.size(), partition->mStartOffset, partition->mEndOffset, *partition);
+
+                {
+                  std::unique_lock<Lock> autoLock(lock);
+                  partition->mDone = true;
+                }
+                condition.notify_all();
+              }
+            }));
+          }
+
+          if (monitorInfo.mOutputJSON) {
+            tool::output() << "{ \"events\": { \"event\": [\n";
+          }
+          if (monitorInfo.mOutputCSV) {
+            tool::output() << "receiveTime,timestamp,thread,cpu,severity,level,provider,event,_subsystemName,_function,_line,values\n";
+          }
+
+          bool firstOutput {true};
+          size_t totalEvents {};
+          std::set<String> mismatchedProviders;
+          ReplayStatsMap stats;
+          ReplayProviderNameMap providerNames;
+
+          for (size_t loop = 0; loop < partitions.size(); ++loop) {
+            ReplayPartitionPtr partition;
+            {
+              std::unique_lock<Lock> autoLock(lock);
+              condition.wait(autoLock, [&]() { return partitions[loop]->mDone; });
+              partition = partitions[loop];
+            }
+
+            const char *output = partition->mOutput.c_str();
+            size_t outputLength = partition->mOutput.length();
+            if ((monitorInfo.mOutputJSON) &&
+                (outputLength > 0) &&
+                (firstOutput)) {
+              output += skipSeparatorLength;
+              outputLength -= skipSeparatorLength;
+              firstOutput = false;
+            }
+            if (outputLength > 0) {
+              tool::output().write(output, outputLength);
+            }
+
+            if (!monitorInfo.mQuietMode) {
+              String warnings(partition->mWarnings.str());
+              if (warnings.hasData()) {
+                tool::output() << warnings;
+              }
+            }
+
+            totalEvents += partition->mTotalEvents;
+            mismatchedProviders.insert(partition->mMismatchedProviders.begin(), partition->mMismatchedProviders.end());
+            for (auto iter = partition->mStats.begin(); iter != partition->mStats.end(); ++iter) {
+              stats[(*iter).first] += (*iter).second;
+            }
+            providerNames.insert(partition->mProviderNames.begin(), partition->mProviderNames.end());
+
+            {
+              std::unique_lock<Lock> autoLock(lock);
+              partitions[loop].reset();
+              totalMerged = loop + 1;
+            }
+            condition.notify_all();
+          }
+
+          for (auto iter = threads.begin(); iter != threads.end(); ++iter) {
+            (*iter).join();
+          }
+
+          if (monitorInfo.mOutputJSON) {
+            tool::output() << "\n] } }\n";
+          }
+
+          if (monitorInfo.mOutputStats) {
+            for (auto iter = stats.begin(); iter != stats.end(); ++iter) {
+              auto &key = (*iter).first;
+              String name(string(key.second));
+
+              auto foundProvider = replayProviders.find(key.first);
+              if (foundProvider != replayProviders.end()) {
+                auto plan = findEventPlan(&((*foundProvider).second.mPlans), key.second);
+                if (plan) name = plan->mEvent->mName;
+              }
+
+              tool::output() << providerNames[key.first] << "::" << name << " " << string((*iter).second) << "\n";
+            }
+          }
+
+          if (!monitorInfo.mQuietMode) {
+            for (auto iter = mismatchedProviders.begin(); iter != mismatchedProviders.end(); ++iter) {
+              tool::output() << "[Warning] Provider \"" << (*iter) << "\" hash does not match the jman file.\n";
+            }
+            tool::output() << "\n";
+            tool::output() << "[Info] Total events replayed: " << string(totalEvents) << "\n";
+            tool::output() << "[Info] Replay time (ms): " << string(std::chrono::duration_cast<Milliseconds>(zsLib::now() - startTime).count()) << "\n";
+          }
+
+          tool::output().flush();
+        }
+
         //---------------------------------------------------------------------
         void Monitor::interrupt()
         {
@@ -514,12 +1298,8 @@ namespace zsLib
                   if (existingProvider->mUniqueHash == provider->mProviderUniqueHash) {
                     provider->mExistingProvider = (*found).second;
 
-                    // process all events into a quick lookup map
-                    for (auto iter = provider->mExistingProvider->mEvents.begin(); iter != provider->mExistingProvider->mEvents.end(); ++iter)
-                    {
-                      auto event = (*iter).second;
-                      provider->mEvents[event->mValue] = event;
-                    }
+                    // compile every event once so writing an event is a flat loop
+                    compileEventPlans(provider->mExistingProvider, provider->mPlans);
                   } else {
                     if (!mMonitorInfo.mQuietMode) {
                       tool::output() << "[Warning] Provider \"" << provider->mProviderName << "\" hashes do not match: X=" << existingProvider->mUniqueHash << " Y=" << provider->mProviderUniqueHash << "\n";
@@ -577,187 +1357,30 @@ namespace zsLib
                                       size_t dataDescriptorCount
                                       )
         {
-          static const size_t skipStartLength = strlen("{\"event\":");
-          static const size_t skipEndLength = strlen("}");
-          
+          // reused by every event written from the same thread
+          static thread_local std::string output;
+
           ProviderInfo *provider = reinterpret_cast<ProviderInfo *>(eventingAtomDataArray[mEventingAtom]);
           if (!provider) return;
 
           ++mTotalEvents;
 
-          String output;
-
-          if (provider->mEvents.size() > 0) {
-            auto found = provider->mEvents.find(descriptor->Id);
-            if (found != provider->mEvents.end()) {
-              auto event = (*found).second;
-
-              ElementPtr rootEl = Element::create("event");
-              rootEl->adoptAsLastChild(IHelper::createElementWithText("severity", Log::toString(severity)));
-              rootEl->adoptAsLastChild(IHelper::createElementWithText("level", Log::toString(level)));
-              rootEl->adoptAsLastChild(IHelper::createElementWithTextAndJSONEncode("name", event->mName));
-              if (event->mChannel) {
-                rootEl->adoptAsLastChild(IHelper::createElementWithTextAndJSONEncode("channel", event->mChannel->mID));
-              }
-              if (event->mTask) {
-                rootEl->adoptAsLastChild(IHelper::createElementWithTextAndJSONEncode("task", event->mTask->mName));
-              }
-              if (event->mOpCode) {
-                rootEl->adoptAsLastChild(IHelper::createElementWithTextAndJSONEncode("opCode", event->mOpCode->mName));
-              }
-              
-              ElementPtr valuesEl = Element::create("values");
-              rootEl->adoptAsLastChild(valuesEl);
-
-              size_t totalDataParams = ZS_EVENTING_TOTAL_BUILT_IN_EVENT_DATA;
-
-              if (event->mDataTemplate) {
-                totalDataParams += event->mDataTemplate->mDataTypes.size();
-              }
-
-              if (totalDataParams != dataDescriptorCount) {
-                // reduce total params by number of buffer sizes not included
-                for (auto iter = event->mDataTemplate->mDataTypes.begin(); iter != event->mDataTemplate->mDataTypes.end(); ++iter) {
-                  auto &dataType = (*iter);
-                  if (dataType->mType == IEventingTypes::PredefinedTypedef_size) {
-                    --totalDataParams;
-                  }
-                }
-                if (totalDataParams != dataDescriptorCount) {
-                  if (!mMonitorInfo.mQuietMode) {
-                    tool::output() << "[Warning] Event \"" << event->mName << "\" parameter count does not match: X=" << string(totalDataParams) << " Y=" << string(dataDescriptorCount) << "\n";
-                    return;
-                  }
-                }
-              }
-
-              for (size_t index = 0; index < ZS_EVENTING_TOTAL_BUILT_IN_EVENT_DATA; ++index)
-              {
-                bool isNumber = false;
-                String valueName("unknown");
-                String value = valueAsString(paramDescriptor[index], dataDescriptor[index], isNumber);
-                switch (index) {
-                  case 0: valueName = "_subsystemName"; break;
-                  case 1: valueName = "_function"; break;
-                  case 2: valueName = "_line"; break;
-                }
-                
-                if (isNumber) {
-                  valuesEl->adoptAsLastChild(IHelper::createElementWithNumber(valueName, value));
-                } else {
-                  valuesEl->adoptAsLastChild(IHelper::createElementWithTextAndJSONEncode(valueName, value));
-                }
-              }
-
-              if (event->mDataTemplate) {
-                auto iterDataType = event->mDataTemplate->mDataTypes.begin();
-                for (int index = ZS_EVENTING_TOTAL_BUILT_IN_EVENT_DATA; static_cast<size_t>(index) < dataDescriptorCount; ++iterDataType)
-                {
-                  {
-                    if (iterDataType == event->mDataTemplate->mDataTypes.end()) break;
-                    
-                    auto &dataType = (*iterDataType);
-
-                    bool isNumber = false;
-                    String valueName = dataType->mValueName;
-
-                    int offset = 0;
-                    if (dataType->mType == IEventingTypes::PredefinedTypedef_binary) {
-                      if (static_cast<size_t>(index + 1) >= dataDescriptorCount) {
-                        if (!mMonitorInfo.mQuietMode) {
-                          tool::output() << "[Warning] Event \"" << event->mName << "\" parameter count buffer missing space for buffer: COUNT=" << string(dataDescriptorCount) << " INDEX=" << string(index) << "\n";
-                        }
-                        return;
-                      }
-
-                      // the actual type and value of the buffer is stored just after its size in the array
-                      offset = 1;
-                    } else if (dataType->mType == IEventingTypes::PredefinedTypedef_size) {
-                      if (index < 1) {
-                        if (!mMonitorInfo.mQuietMode) {
-                          tool::output() << "[Warning] Event \"" << event->mName << "\" parameter count buffer missing space for buffer size: COUNT=" << string(dataDescriptorCount) << " INDEX=" << string(index) << "\n";
-                        }
-                        return;
-                      }
-                      offset = -1;
-                    }
-
-                    String value = valueAsString(paramDescriptor[index + offset], dataDescriptor[index + offset], isNumber);
-
-                    if (isNumber) {
-                      valuesEl->adoptAsLastChild(IHelper::createElementWithNumber(valueName, value));
-                    } else {
-                      valuesEl->adoptAsLastChild(IHelper::createElementWithTextAndJSONEncode(valueName, value));
-                    }
-                    goto next_index;
-                  }
-                  
-                next_index:
-                  {
-                    ++index;
-                  }
-                }
-              }
-
-              output = IHelper::toString(rootEl);
-            }
-          }
-          
-          if (!output.hasData()) {
-            ElementPtr rootEl = Element::create("event");
-            rootEl->adoptAsLastChild(IHelper::createElementWithText("severity", Log::toString(severity)));
-            rootEl->adoptAsLastChild(IHelper::createElementWithText("level", Log::toString(level)));
-            rootEl->adoptAsLastChild(IHelper::createElementWithNumber("name", string(descriptor->Id)));
-            rootEl->adoptAsLastChild(IHelper::createElementWithNumber("channel", string(descriptor->Channel)));
-            rootEl->adoptAsLastChild(IHelper::createElementWithNumber("task", string(descriptor->Task)));
-            rootEl->adoptAsLastChild(IHelper::createElementWithNumber("opCode", string(descriptor->Opcode)));
-
-            ElementPtr valuesEl = Element::create("values");
-            rootEl->adoptAsLastChild(valuesEl);
+          IRemoteEventing::EventOrigin origin;
+          bool hasOrigin = IRemoteEventing::getCurrentEventOrigin(origin);
 
-            for (size_t index = 0; index < ZS_EVENTING_TOTAL_BUILT_IN_EVENT_DATA; ++index)
-            {
-              bool isNumber = false;
-              String valueName("unknown");
-              String value = valueAsString(paramDescriptor[index], dataDescriptor[index], isNumber);
-              switch (index) {
-                case 0: valueName = "_subsystemName"; break;
-                case 1: valueName = "_function"; break;
-                case 2: valueName = "_line"; break;
-              }
-              
-              if (isNumber) {
-                valuesEl->adoptAsLastChild(IHelper::createElementWithNumber(valueName, value));
-              } else {
-                valuesEl->adoptAsLastChild(IHelper::createElementWithTextAndJSONEncode(valueName, value));
-              }
-            }
-            
-            for (size_t index = ZS_EVENTING_TOTAL_BUILT_IN_EVENT_DATA; index < dataDescriptorCount; ++index)
-            {
-              bool isNumber = false;
-              String valueName = string(index-ZS_EVENTING_TOTAL_BUILT_IN_EVENT_DATA);
-              String value = valueAsString(paramDescriptor[index], dataDescriptor[index], isNumber);
-              
-              if (isNumber) {
-                valuesEl->adoptAsLastChild(IHelper::createElementWithNumber(valueName, value));
-              } else {
-                valuesEl->adoptAsLastChild(IHelper::createElementWithTextAndJSONEncode(valueName, value));
-              }
-            }
+          output.clear();
+          if (!writeEventJSON(output, &(provider->mPlans), severity, level, hasOrigin ? &origin : NULL, descriptor, paramDescriptor, dataDescriptor, dataDescriptorCount, mMonitorInfo.mQuietMode, tool::output())) return;
 
-            output = IHelper::toString(rootEl);
-          }
+          output.push_back('\n');
 
-          if (output.hasData()) {
+          {
             AutoRecursiveLock lock(mLock);
             if (!mFirstOutputEvent) {
               tool::output() << ",";
             } else {
               mFirstOutputEvent = false;
             }
-            tool::output().write(output.c_str() + skipStartLength, output.length() - skipStartLength - skipEndLength);
-            tool::output() << "\n";
+            tool::output().write(output.c_str(), output.length());
           }
         }
 
@@ -805,6 +1428,20 @@ namespace zsLib
             Log::removeEventingProviderListener(pThis);
           }
 
+          ElementPtr localStatisticsEl;
+          ElementPtr remoteStatisticsEl;
+          if (mRemote) {
+            localStatisticsEl = mRemote->getStatistics().createElement();
+
+            IRemoteEventingTypes::Statistics remoteStatistics;
+            if (mRemote->getRemoteStatistics(remoteStatistics)) {
+              remoteStatisticsEl = remoteStatistics.createElement();
+            }
+          }
+
+          if (mRemote) {
+            mRemote->stopRecording();
+          }
           mRemote.reset();
 
           if (mMonitorInfo.mOutputJSON) {
@@ -814,7 +1451,16 @@ namespace zsLib
             tool::output() << "\n";
             tool::output() << "[Info] Total events dropped: " << string(mTotalEventsDropped) << "\n";
             tool::output() << "[Info] Total events received: " << string(mTotalEvents) << "\n";
+            if (localStatisticsEl) {
+              tool::output() << "[Info] Local transport statistics: " << IHelper::toString(localStatisticsEl) << "\n";
+            }
+            if (remoteStatisticsEl) {
+              tool::output() << "[Info] Remote transport statistics: " << IHelper::toString(remoteStatisticsEl) << "\n";
+            }
           }
+
+          // everything written before quitting is on its way out
+          tool::output().flush();
           mShouldQuit = true;
 
           mGracefulShutdownReference.reset();
@@ -823,7 +1469,163 @@ namespace zsLib
         //---------------------------------------------------------------------
         void Monitor::step()
         {
-          for (auto iter = mMonitorInfo.mJMANFiles.begin(); iter != mMonitorInfo.mJMANFiles.end(); ++iter) {
+          loadProviders(mMonitorInfo.mJMANFiles, mProviders);
+          
+          if (Seconds() != mMonitorInfo.mTimeout) {
+            mAutoQuitTimer = ITimer::create(mThisWeak.lock(), zsLib::now() + mMonitorInfo.mTimeout);
+          }
+          
+          if (mMonitorInfo.mLocalName.hasData()) {
+            if (mMonitorInfo.mLocalListen) {
+              mRemote = IRemoteEventing::listenForLocal(mThisWeak.lock(), mMonitorInfo.mLocalName, mMonitorInfo.mSecret);
+              if (!mMonitorInfo.mQuietMode) {
+                tool::output() << "[Info] Listening for local connection: " << mMonitorInfo.mLocalName << "\n";
+              }
+            } else {
+              mRemote = IRemoteEventing::connectToLocal(mThisWeak.lock(), mMonitorInfo.mLocalName, mMonitorInfo.mSecret);
+              if (!mMonitorInfo.mQuietMode) {
+                tool::output() << "[Info] Connecting to local process: " << mMonitorInfo.mLocalName << "\n";
+              }
+            }
+          } else if (mMonitorInfo.mIPAddress.isAddressEmpty()) {
+            mRemote = IRemoteEventing::listenForRemote(mThisWeak.lock(), mMonitorInfo.mPort, mMonitorInfo.mSecret);
+            if (!mMonitorInfo.mQuietMode) {
+              tool::output() << "[Info] Listening for remote connection: " << string(mMonitorInfo.mPort) << "\n";
+            }
+          } else {
+            mRemote = IRemoteEventing::connectToRemote(mThisWeak.lock(), mMonitorInfo.mIPAddress, mMonitorInfo.mSecret);
+            if (!mMonitorInfo.mQuietMode) {
+              tool::output() << "[Info] Connecting to remote process: " << mMonitorInfo.mIPAddress.string() << "\n";
+            }
+          }
+          
+          if (!mRemote) {
+            cancel();
+            return;
+          }
+
+          if (mMonitorInfo.mRecordFile.hasData()) {
+            // the jman providers (and their hashes) used while recording are kept up front
+            ElementPtr providersEl = Element::create("providers");
+            for (auto iter = mProviders.begin(); iter != mProviders.end(); ++iter) {
+              auto provider = (*iter).second;
+              ElementPtr providerEl = Element::create("provider");
+              providerEl->adoptAsLastChild(IHelper::createElementWithText("id", string(provider->mID)));
+              providerEl->adoptAsLastChild(IHelper::createElementWithText("name", provider->mName));
+              providerEl->adoptAsLastChild(IHelper::createElementWithText("uniqueHash", provider->mUniqueHash));
+              providersEl->adoptAsLastChild(providerEl);
+            }
+
+            if (!mRemote->startRecording(mMonitorInfo.mRecordFile, providersEl)) {
+              ZS_THROW_CUSTOM_PROPERTIES_1(Failure, ZS_EVENTING_TOOL_SYSTEM_ERROR, "Failed to create trace file: " + mMonitorInfo.mRecordFile);
+            }
+            if (!mMonitorInfo.mQuietMode) {
+              tool::output() << "[Info] Recording events: " << mMonitorInfo.mRecordFile << "\n";
+            }
+          }
+          
+          for (auto iter = mProviders.begin(); iter != mProviders.end(); ++iter) {
+            auto provider = (*iter).second;
+            for (auto iterSubsystem = provider->mSubsystems.begin(); iterSubsystem != provider->mSubsystems.end(); ++iterSubsystem) {
+              auto subsystem = (*iterSubsystem).second;
+              mRemote->setRemoteLevel(subsystem->mName, subsystem->mLevel);
+            }
+          }
+
+          if (mMonitorInfo.mSubscribeEvents.size() > 0) {
+            std::set<String> resolvedEvents;
+
+            // the remote party only sends the named events of every provider defining them
+            for (auto iter = mProviders.begin(); iter != mProviders.end(); ++iter) {
+              auto provider = (*iter).second;
+              IRemoteEventingTypes::EventIDSet enabledEventIDs;
+              for (auto iterEvent = provider->mEvents.begin(); iterEvent != provider->mEvents.end(); ++iterEvent) {
+                auto event = (*iterEvent).second;
+                for (auto iterName = mMonitorInfo.mSubscribeEvents.begin(); iterName != mMonitorInfo.mSubscribeEvents.end(); ++iterName) {
+                  auto &name = (*iterName);
+                  if (0 != name.compareNoCase(event->mName)) continue;
+                  enabledEventIDs.insert(static_cast<uint16_t>(event->mValue));
+                  resolvedEvents.insert(name);
+                }
+              }
+              if (enabledEventIDs.size() < 1) continue;
+
+              if (!mMonitorInfo.mQuietMode) {
+                tool::output() << "[Info] Provider \"" << provider->mName << "\" is limited to " << string(enabledEventIDs.size()) << " event(s).\n";
+              }
+              mRemote->setRemoteProviderEvents(provider->mName, enabledEventIDs);
+            }
+
+            if (!mMonitorInfo.mQuietMode) {
+              for (auto iter = mMonitorInfo.mSubscribeEvents.begin(); iter != mMonitorInfo.mSubscribeEvents.end(); ++iter) {
+                auto &name = (*iter);
+                if (resolvedEvents.end() != resolvedEvents.find(name)) continue;
+                tool::output() << "[Warning] Event \"" << name << "\" was not found in any jman file.\n";
+              }
+            }
+          }
+        }
+
+        //---------------------------------------------------------------------
+        void Monitor::compileEventPlans(
+                                        ProviderPtr provider,
+                                        EventPlanArray &outPlans
+                                        )
+        {
+          outPlans.clear();
+          if (!provider) return;
+
+          // event ids are 16 bits on the wire
+          size_t totalPlans = 0;
+          for (auto iter = provider->mEvents.begin(); iter != provider->mEvents.end(); ++iter) {
+            auto event = (*iter).second;
+            if (event->mValue > 0xFFFF) continue;
+            if (event->mValue >= totalPlans) totalPlans = event->mValue + 1;
+          }
+          outPlans.resize(totalPlans);
+
+          for (auto iter = provider->mEvents.begin(); iter != provider->mEvents.end(); ++iter) {
+            auto event = (*iter).second;
+            if (event->mValue > 0xFFFF) continue;
+
+            auto &plan = outPlans[event->mValue];
+            plan.mEvent = event;
+            plan.mTotalDescriptors = ZS_EVENTING_TOTAL_BUILT_IN_EVENT_DATA;
+            plan.mTotalDescriptorsWithoutSizes = ZS_EVENTING_TOTAL_BUILT_IN_EVENT_DATA;
+            plan.mOps.clear();
+
+            if (!event->mDataTemplate) continue;
+
+            plan.mOps.reserve(event->mDataTemplate->mDataTypes.size());
+
+            size_t index = ZS_EVENTING_TOTAL_BUILT_IN_EVENT_DATA;
+            for (auto iterDataType = event->mDataTemplate->mDataTypes.begin(); iterDataType != event->mDataTemplate->mDataTypes.end(); ++iterDataType, ++index) {
+              auto &dataType = (*iterDataType);
+
+              ++plan.mTotalDescriptors;
+              if (dataType->mType != IEventingTypes::PredefinedTypedef_size) ++plan.mTotalDescriptorsWithoutSizes;
+
+              EventPlanOp op;
+              op.mName = dataType->mValueName.c_str();
+              op.mType = dataType->mType;
+              op.mDescriptorIndex = index;
+
+              // the actual type and value of a buffer is stored just after its size in the array
+              if (dataType->mType == IEventingTypes::PredefinedTypedef_binary) ++op.mDescriptorIndex;
+              else if (dataType->mType == IEventingTypes::PredefinedTypedef_size) --op.mDescriptorIndex;
+
+              plan.mOps.push_back(op);
+            }
+          }
+        }
+
+        //---------------------------------------------------------------------
+        void Monitor::loadProviders(
+                                    const ICommandLineTypes::StringList &jmanFiles,
+                                    ProviderMap &outProviders
+                                    )
+        {
+          for (auto iter = jmanFiles.begin(); iter != jmanFiles.end(); ++iter) {
             auto fileName = (*iter);
             
             ProviderPtr provider;
@@ -849,44 +1651,14 @@ namespace zsLib
               ZS_THROW_CUSTOM_PROPERTIES_1(Failure, ZS_EVENTING_TOOL_FILE_FAILED_TO_LOAD, "Failed to parse jman file: " + fileName);
             }
             
-            auto found = mProviders.find(provider->mID);
-            if (found != mProviders.end()) {
+            auto found = outProviders.find(provider->mID);
+            if (found != outProviders.end()) {
               ZS_THROW_CUSTOM_PROPERTIES_1(Failure, ZS_EVENTING_TOOL_INVALID_CONTENT, "Duplicate provider found in jman file: " + fileName);
             }
             
-            mProviders[provider->mID] = provider;
-          }
-          
-          if (Seconds() != mMonitorInfo.mTimeout) {
-            mAutoQuitTimer = ITimer::create(mThisWeak.lock(), zsLib::now() + mMonitorInfo.mTimeout);
-          }
-          
-          if (mMonitorInfo.mIPAddress.isAddressEmpty()) {
-            mRemote = IRemoteEventing::listenForRemote(mThisWeak.lock(), mMonitorInfo.mPort, mMonitorInfo.mSecret);
-            if (!mMonitorInfo.mQuietMode) {
-              tool::output() << "[Info] Listening for remote connection: " << string(mMonitorInfo.mPort) << "\n";
-            }
-          } else {
-            mRemote = IRemoteEventing::connectToRemote(mThisWeak.lock(), mMonitorInfo.mIPAddress, mMonitorInfo.mSecret);
-            if (!mMonitorInfo.mQuietMode) {
-              tool::output() << "[Info] Connecting to remote process: " << mMonitorInfo.mIPAddress.string() << "\n";
-            }
-          }
-          
-          if (!mRemote) {
-            cancel();
-            return;
-          }
-          
-          for (auto iter = mProviders.begin(); iter != mProviders.end(); ++iter) {
-            auto provider = (*iter).second;
-            for (auto iterSubsystem = provider->mSubsystems.begin(); iterSubsystem != provider->mSubsystems.end(); ++iterSubsystem) {
-              auto subsystem = (*iterSubsystem).second;
-              mRemote->setRemoteLevel(subsystem->mName, subsystem->mLevel);
-            }
+            outProviders[provider->mID] = provider;
           }
         }
-        
 
       }
     }
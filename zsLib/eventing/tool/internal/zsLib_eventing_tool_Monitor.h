@@ -93,8 +93,26 @@ namespace zsLib
           typedef std::map<UUID, ProviderPtr> ProviderMap;
           
           typedef size_t ValueID;
-          typedef std::map<ValueID, EventPtr> EventMap;
-          
+
+          // one template value; the descriptor index already accounts for
+          // buffers whose data follows their size in the descriptor array
+          struct EventPlanOp
+          {
+            const char *mName {};
+            IEventingTypes::PredefinedTypedefs mType {IEventingTypes::PredefinedTypedef_First};
+            size_t mDescriptorIndex {};
+          };
+          typedef std::vector<EventPlanOp> EventPlanOpList;
+
+          struct EventPlan
+          {
+            EventPtr mEvent;                        // NULL if the id is not defined in the jman
+            size_t mTotalDescriptors {};            // expected with every buffer size present
+            size_t mTotalDescriptorsWithoutSizes {};
+            EventPlanOpList mOps;
+          };
+          typedef std::vector<EventPlan> EventPlanArray;  // indexed by event id
+
           struct ProviderInfo
           {
             ProviderHandle mHandle {};
@@ -102,7 +120,7 @@ namespace zsLib
             UUID mProviderID {};
             String mProviderName;
             String mProviderUniqueHash;
-            EventMap mEvents;
+            EventPlanArray mPlans;
           };
 
           typedef std::set<ProviderInfo *> ProviderInfoSet;
@@ -121,8 +139,25 @@ namespace zsLib
           #pragma mark
           
           static void monitor(const ICommandLineTypes::MonitorInfo &monitorInfo);
+          static void replay(const ICommandLineTypes::MonitorInfo &monitorInfo);
           static void interrupt();
 
+          // appends the event as compact JSON; false (with nothing appended)
+          // if the event does not match its jman definition
+          static bool writeEventJSON(
+                                     std::string &ioOutput,
+                                     const EventPlanArray *plans,
+                                     Severity severity,
+                                     Level level,
+                                     const IRemoteEventing::EventOrigin *origin,
+                                     EVENT_DESCRIPTOR_HANDLE descriptor,
+                                     EVENT_PARAMETER_DESCRIPTOR_HANDLE paramDescriptor,
+                                     EVENT_DATA_DESCRIPTOR_HANDLE dataDescriptor,
+                                     size_t dataDescriptorCount,
+                                     bool quietMode,
+                                     std::ostream &warnings
+                                     );
+
         protected:
           //-------------------------------------------------------------------
           #pragma mark
@@ -223,6 +258,15 @@ namespace zsLib
           void internalInterrupt();
           void cancel();
           void step();
+
+          static void compileEventPlans(
+                                        ProviderPtr provider,
+                                        EventPlanArray &outPlans
+                                        );
+          static void loadProviders(
+                                    const ICommandLineTypes::StringList &jmanFiles,
+                                    ProviderMap &outProviders
+                                    );
           bool shouldQuit() const { return mShouldQuit; }
 
         protected:
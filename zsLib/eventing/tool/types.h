@@ -51,6 +51,7 @@ namespace zsLib
 
       ZS_DECLARE_CLASS_PTR(StdOutputStream);
       ZS_DECLARE_CLASS_PTR(DebugOutputStream);
+      ZS_DECLARE_CLASS_PTR(FileOutputStream);
     }
   }
 }
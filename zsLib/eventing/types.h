@@ -65,6 +65,7 @@ namespace zsLib
     ZS_DECLARE_INTERACTION_PTR(IHasher);
     ZS_DECLARE_INTERACTION_PTR(IHasherAlgorithm);
     ZS_DECLARE_INTERACTION_PTR(IRemoteEventing);
+    ZS_DECLARE_INTERACTION_PTR(IRemoteEventingTraceDelegate);
 
     ZS_DECLARE_INTERACTION_PROXY(IRemoteEventingDelegate);
   }